@@ -100,12 +100,19 @@ public:
 
     z0 getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill) override
     {
-        if (bufferToFill.buffer->getNumChannels() > 0)
-        {
-            const auto* channelData = bufferToFill.buffer->getReadPointer (0, bufferToFill.startSample);
+        const auto numChannels = jmin ((i32) numAnalysedChannels, bufferToFill.buffer->getNumChannels());
 
+        if (numChannels > 0)
+        {
             for (auto i = 0; i < bufferToFill.numSamples; ++i)
-                pushNextSampleIntoFifo (channelData[i]);
+            {
+                f32 samples[numAnalysedChannels] {};
+
+                for (auto channel = 0; channel < numChannels; ++channel)
+                    samples[channel] = bufferToFill.buffer->getSample (channel, bufferToFill.startSample + i);
+
+                pushNextSamplesIntoFifo (samples);
+            }
 
             bufferToFill.clearActiveBufferRegion();
         }
@@ -130,7 +137,7 @@ public:
         }
     }
 
-    z0 pushNextSampleIntoFifo (f32 sample) noexcept
+    z0 pushNextSamplesIntoFifo (const f32* samples) noexcept
     {
         // if the fifo contains enough data, set a flag to say
         // that the next line should now be rendered..
@@ -139,14 +146,20 @@ public:
             if (! nextFFTBlockReady)
             {
                 zeromem (fftData, sizeof (fftData));
-                memcpy (fftData, fifo, sizeof (fifo));
+
+                for (auto channel = 0; channel < numAnalysedChannels; ++channel)
+                    memcpy (fftData[channel], fifo[channel], sizeof (fifo[channel]));
+
                 nextFFTBlockReady = true;
             }
 
             fifoIndex = 0;
         }
 
-        fifo[fifoIndex++] = sample;
+        for (auto channel = 0; channel < numAnalysedChannels; ++channel)
+            fifo[channel][fifoIndex] = samples[channel];
+
+        ++fifoIndex;
     }
 
     z0 drawNextLineOfSpectrogram()
@@ -157,12 +170,21 @@ public:
         // first, shuffle our image leftwards by 1 pixel..
         spectrogramImage.moveImageSection (0, 0, 1, 0, rightHandEdge, imageHeight);
 
-        // then render our FFT data..
-        forwardFFT.performFrequencyOnlyForwardTransform (fftData);
+        // then render our FFT data, transforming all the channels in one go..
+        f32* channels[numAnalysedChannels];
+
+        for (auto channel = 0; channel < numAnalysedChannels; ++channel)
+            channels[channel] = fftData[channel];
+
+        forwardFFT.performFrequencyOnlyForwardTransforms (channels, numAnalysedChannels);
+
+        // ..and show the loudest channel at each frequency
+        for (auto channel = 1; channel < numAnalysedChannels; ++channel)
+            FloatVectorOperations::max (fftData[0], fftData[0], fftData[channel], fftSize / 2 + 1);
 
         // find the range of values produced, so we can scale our rendering to
         // show up the detail clearly
-        auto maxLevel = FloatVectorOperations::findMinAndMax (fftData, fftSize / 2);
+        auto maxLevel = FloatVectorOperations::findMinAndMax (fftData[0], fftSize / 2);
 
         Image::BitmapData bitmap { spectrogramImage, rightHandEdge, 0, 1, imageHeight, Image::BitmapData::writeOnly };
 
@@ -170,7 +192,7 @@ public:
         {
             auto skewedProportionY = 1.0f - std::exp (std::log ((f32) y / (f32) imageHeight) * 0.2f);
             auto fftDataIndex = jlimit (0, fftSize / 2, (i32) (skewedProportionY * (i32) fftSize / 2));
-            auto level = jmap (fftData[fftDataIndex], 0.0f, jmax (maxLevel.getEnd(), 1e-5f), 0.0f, 1.0f);
+            auto level = jmap (fftData[0][fftDataIndex], 0.0f, jmax (maxLevel.getEnd(), 1e-5f), 0.0f, 1.0f);
 
             bitmap.setPixelColor (0, y, Color::fromHSV (level, 1.0f, level, 1.0f));
         }
@@ -179,15 +201,16 @@ public:
     enum
     {
         fftOrder = 10,
-        fftSize  = 1 << fftOrder
+        fftSize  = 1 << fftOrder,
+        numAnalysedChannels = 2
     };
 
 private:
     dsp::FFT forwardFFT;
     Image spectrogramImage;
 
-    f32 fifo [fftSize];
-    f32 fftData [2 * fftSize];
+    f32 fifo [numAnalysedChannels][fftSize];
+    f32 fftData [numAnalysedChannels][2 * fftSize];
     i32 fifoIndex = 0;
     b8 nextFFTBlockReady = false;
 
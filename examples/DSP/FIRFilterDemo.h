@@ -57,6 +57,29 @@
 
 using namespace dsp;
 
+//==============================================================================
+// Shows a line of text which is refreshed a few times a second
+struct InfoDisplay final : public DSPDemoParameterBase,
+                           private Timer
+{
+    InfoDisplay (std::function<Txt()> getTextToUse, const Txt& labelName)
+        : DSPDemoParameterBase (labelName), getText (std::move (getTextToUse))
+    {
+        startTimerHz (4);
+    }
+
+    Component* getComponent() override    { return &label; }
+
+    i32 getPreferredHeight() override     { return 25; }
+    i32 getPreferredWidth()  override     { return 250; }
+
+private:
+    z0 timerCallback() override          { label.setText (getText(), dontSendNotification); }
+
+    std::function<Txt()> getText;
+    Label label;
+};
+
 //==============================================================================
 struct FIRFilterDemoDSP
 {
@@ -64,14 +87,19 @@ struct FIRFilterDemoDSP
     {
         sampleRate = spec.sampleRate;
 
-        fir.state = FilterDesign<f32>::designFIRLowpassWindowMethod (440.0f, sampleRate, 21,
-                                                                       WindowingFunction<f32>::blackman);
+        updateParameters();
         fir.prepare (spec);
     }
 
     z0 process (const ProcessContextReplacing<f32>& context)
     {
+        const auto start = Time::getHighResolutionTicks();
+
         fir.process (context);
+
+        // Keep a smoothed average of the time taken for each block
+        const auto elapsed = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+        averageBlockTime = averageBlockTime * 0.99 + elapsed * 0.01;
     }
 
     z0 reset()
@@ -85,21 +113,41 @@ struct FIRFilterDemoDSP
         {
             auto cutoff = static_cast<f32> (cutoffParam.getCurrentValue());
             auto windowingMethod = static_cast<WindowingFunction<f32>::WindowingMethod> (typeParam.getCurrentSelectedID() - 1);
+            auto order = static_cast<size_t> (filterOrders[(size_t) jmax (0, lengthParam.getCurrentSelectedID() - 1)]);
+            auto method = methods[(size_t) jmax (0, methodParam.getCurrentSelectedID() - 1)];
 
-            *fir.state = *FilterDesign<f32>::designFIRLowpassWindowMethod (cutoff, sampleRate, 21, windowingMethod);
+            // While the length and method stay the same, this updates the filter in place
+            // and keeps its history, so sweeping the cutoff doesn't click
+            fir.setCoefficients (FilterDesign<f32>::designFIRLowpassWindowMethod (cutoff, sampleRate, order, windowingMethod),
+                                 method);
         }
     }
 
+    Txt getProcessingInfo() const
+    {
+        const auto method = fir.getMethod() == FIR::BlockFilter<f32>::Method::overlapSave ? "overlap-save" : "direct form";
+        return Txt (averageBlockTime.load() * 1.0e6, 1) + " us per block, " + method;
+    }
+
     //==============================================================================
-    ProcessorDuplicator<FIR::Filter<f32>, FIR::Coefficients<f32>> fir;
+    FIR::BlockFilter<f32> fir;
 
     f64 sampleRate = 0.0;
+    std::atomic<f64> averageBlockTime { 0.0 };
+
+    static constexpr std::array<i32, 4> filterOrders { 20, 126, 510, 2046 };
+    static constexpr std::array<FIR::BlockFilter<f32>::Method, 3> methods { FIR::BlockFilter<f32>::Method::automatic,
+                                                                           FIR::BlockFilter<f32>::Method::direct,
+                                                                           FIR::BlockFilter<f32>::Method::overlapSave };
 
     SliderParameter cutoffParam { { 20.0, 20000.0 }, 0.4, 440.0f, "Cutoff", "Hz" };
     ChoiceParameter typeParam { { "Rectangular", "Triangular", "Hann", "Hamming", "Blackman", "Blackman-Harris", "Flat Top", "Kaiser" },
                                 5, "Windowing Function" };
+    ChoiceParameter lengthParam { { "21", "127", "511", "2047" }, 1, "Length" };
+    ChoiceParameter methodParam { { "Automatic", "Direct form", "Overlap-save" }, 1, "Method" };
+    InfoDisplay processingInfo { [this] { return getProcessingInfo(); }, "Processing" };
 
-    std::vector<DSPDemoParameterBase*> parameters { &cutoffParam, &typeParam };
+    std::vector<DSPDemoParameterBase*> parameters { &cutoffParam, &typeParam, &lengthParam, &methodParam, &processingInfo };
 };
 
 struct FIRFilterDemo final : public Component
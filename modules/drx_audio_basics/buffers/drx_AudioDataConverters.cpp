@@ -35,6 +35,341 @@
 namespace drx
 {
 
+//==============================================================================
+namespace AudioDataHelpers
+{
+    // Reads a packed integer sample, returning it shifted up to fill a 32-bit integer
+    static i32 readPackedInt (const u8* p, i32 bytesPerSample, b8 bigEndian) noexcept
+    {
+        u32 v = 0;
+
+        for (i32 i = 0; i < bytesPerSample; ++i)
+            v = (v << 8) | p[bigEndian ? i : bytesPerSample - 1 - i];
+
+        return (i32) (v << (8 * (4 - bytesPerSample)));
+    }
+
+    static z0 writePackedInt (u8* p, i32 value, i32 bytesPerSample, b8 bigEndian) noexcept
+    {
+        for (i32 i = 0; i < bytesPerSample; ++i)
+            p[bigEndian ? bytesPerSample - 1 - i : i] = (u8) ((u32) value >> (8 * i));
+    }
+
+    /*  Without dither, this matches Pointer::convertSamples(), which goes via a 32-bit integer
+        and then drops the extra bits. With dither, the sample is scaled to the destination's
+        range, the dither is added, and then it's rounded.
+    */
+    static i32 convertFloatToInt (f32 value, i32 bytesPerSample, AudioData::Dither* dither) noexcept
+    {
+        if (dither == nullptr)
+            return roundToInt (jlimit (-1.0, 1.0, (f64) value) * (f64) 0x7fffffff) >> (32 - 8 * bytesPerSample);
+
+        const auto maxValue = (f32) ((1 << (8 * bytesPerSample - 1)) - 1);
+        const auto scaled = value * (maxValue + 1.0f) + dither->getNextValue();
+
+        return (i32) std::nearbyint (jlimit (-maxValue, maxValue, scaled));
+    }
+
+    static b8 rangesOverlap (ukk a, i32 aStride, i32 aBytesPerSample,
+                             ukk b, i32 bStride, i32 bBytesPerSample, i32 numSamples) noexcept
+    {
+        const auto* aStart = static_cast<const u8*> (a);
+        const auto* bStart = static_cast<const u8*> (b);
+        const auto* aEnd = aStart + (size_t) (numSamples - 1) * (size_t) aStride + (size_t) aBytesPerSample;
+        const auto* bEnd = bStart + (size_t) (numSamples - 1) * (size_t) bStride + (size_t) bBytesPerSample;
+
+        return aStart < bEnd && bStart < aEnd;
+    }
+
+   #if DRX_USE_AVX_INTRINSICS
+    // Chosen once at startup, like FloatVectorOperations' AVX level
+    static b8 useAvx2 = SystemStats::hasAVX2();
+
+    // Outputs bigger than this are written with non-temporal stores, as they won't fit in the cache anyway
+    constexpr size_t nonTemporalThreshold = 512 * 1024;
+
+   #if DRX_CLANG
+    #pragma clang attribute push (__attribute__ ((target ("avx2"))), apply_to = function)
+   #elif DRX_GCC
+    #pragma GCC push_options
+    #pragma GCC target ("avx2")
+   #endif
+
+    namespace Avx2
+    {
+        /*  A byte shuffle that moves four packed samples in each 128-bit lane, which start
+            'spacing' bytes apart, into the tops of four 32-bit integers.
+        */
+        static __m256i makeUnpackMask (i32 spacing, i32 bytesPerSample, b8 bigEndian) noexcept
+        {
+            alignas (32) i8 mask[32];
+
+            for (i32 i = 0; i < 16; ++i)
+            {
+                const auto significance = (i & 3) - (4 - bytesPerSample);
+                const auto byte = significance < 0 ? -1 : (i >> 2) * spacing + (bigEndian ? bytesPerSample - 1 - significance : significance);
+                mask[i] = mask[i + 16] = (i8) byte;
+            }
+
+            return _mm256_load_si256 (reinterpret_cast<const __m256i*> (mask));
+        }
+
+        /*  The reverse of makeUnpackMask(): packs the low bytes of four 32-bit integers in each
+            128-bit lane into samples that start 'spacing' bytes apart.
+        */
+        static __m256i makePackMask (i32 spacing, i32 bytesPerSample, b8 bigEndian) noexcept
+        {
+            alignas (32) i8 mask[32];
+
+            for (i32 i = 0; i < 16; ++i)
+            {
+                const auto sample = i / spacing, byte = i % spacing;
+                const auto significance = bigEndian ? bytesPerSample - 1 - byte : byte;
+                mask[i] = mask[i + 16] = (i8) (sample < 4 && byte < bytesPerSample ? sample * 4 + significance : -1);
+            }
+
+            return _mm256_load_si256 (reinterpret_cast<const __m256i*> (mask));
+        }
+
+        static __m256i makeOffsets (i32 stride) noexcept
+        {
+            return _mm256_setr_epi32 (0, stride, 2 * stride, 3 * stride, 4 * stride, 5 * stride, 6 * stride, 7 * stride);
+        }
+
+        static z0 convertIntToNative (u8* dest, i32 destStride, b8 destIsFloat,
+                                        const u8* source, i32 sourceStride, i32 bytesPerSample,
+                                        b8 bigEndian, i32 numSamples) noexcept
+        {
+            const auto isPacked = sourceStride == bytesPerSample;
+            const auto mask = makeUnpackMask (isPacked ? bytesPerSample : 4, bytesPerSample, bigEndian);
+            const auto offsets = makeOffsets (sourceStride);
+            const auto scale = _mm256_set1_ps (1.0f / 2147483648.0f);
+
+            // The 16-byte loads of packed samples, and the 4-byte gathers of interleaved ones,
+            // can read past the last sample, so the last few are left for the scalar loop
+            const auto numToVectorise = bytesPerSample == 4 ? numSamples
+                                                            : numSamples - (isPacked ? 4 : 1);
+
+            const auto nonTemporal = destStride == 4 && (size_t) numSamples * 4 >= nonTemporalThreshold;
+
+            const auto convertOne = [&] (i32 i)
+            {
+                const auto value = readPackedInt (source + (size_t) i * (size_t) sourceStride, bytesPerSample, bigEndian);
+                auto* d = dest + (size_t) i * (size_t) destStride;
+
+                if (destIsFloat)
+                    *unalignedPointerCast<f32*> (d) = (f32) value * (1.0f / 2147483648.0f);
+                else
+                    *unalignedPointerCast<i32*> (d) = value;
+            };
+
+            i32 i = 0;
+
+            if (nonTemporal)
+                for (; i < numSamples && (reinterpret_cast<pointer_sized_int> (dest + (size_t) i * 4) & 31) != 0; ++i)
+                    convertOne (i);
+
+            for (; i + 8 <= numToVectorise; i += 8)
+            {
+                const auto* s = source + (size_t) i * (size_t) sourceStride;
+
+                auto v = isPacked ? _mm256_inserti128_si256 (_mm256_castsi128_si256 (_mm_loadu_si128 (reinterpret_cast<const __m128i*> (s))),
+                                                             _mm_loadu_si128 (reinterpret_cast<const __m128i*> (s + 4 * bytesPerSample)), 1)
+                                  : _mm256_i32gather_epi32 (reinterpret_cast<i32k*> (s), offsets, 1);
+
+                v = _mm256_shuffle_epi8 (v, mask);
+
+                if (destIsFloat)
+                    v = _mm256_castps_si256 (_mm256_mul_ps (_mm256_cvtepi32_ps (v), scale));
+
+                auto* d = dest + (size_t) i * (size_t) destStride;
+
+                if (nonTemporal)
+                {
+                    _mm256_stream_si256 (reinterpret_cast<__m256i*> (d), v);
+                }
+                else if (destStride == 4)
+                {
+                    _mm256_storeu_si256 (reinterpret_cast<__m256i*> (d), v);
+                }
+                else
+                {
+                    alignas (32) i32 values[8];
+                    _mm256_store_si256 (reinterpret_cast<__m256i*> (values), v);
+
+                    for (i32 j = 0; j < 8; ++j)
+                        memcpy (d + (size_t) j * (size_t) destStride, values + j, 4);
+                }
+            }
+
+            if (nonTemporal)
+                _mm_sfence();
+
+            for (; i < numSamples; ++i)
+                convertOne (i);
+        }
+
+        static z0 convertFloatToInt (u8* dest, i32 destStride, i32 bytesPerSample, b8 bigEndian,
+                                       const f32* source, i32 sourceStride, i32 numSamples,
+                                       AudioData::Dither* dither, u32* ditherState, u32* ditherPosition) noexcept
+        {
+            const auto isPacked = destStride == bytesPerSample;
+            const auto mask = makePackMask (isPacked ? bytesPerSample : 4, bytesPerSample, bigEndian);
+            const auto offsets = makeOffsets (sourceStride);
+
+            const auto maxValue = bytesPerSample == 4 ? 0.0f : (f32) ((1 << (8 * bytesPerSample - 1)) - 1);
+            const auto scale = _mm256_set1_ps (maxValue + 1.0f);
+            const auto upperLimit = _mm256_set1_ps (maxValue), lowerLimit = _mm256_set1_ps (-maxValue);
+            const auto one = _mm256_set1_pd (1.0), minusOne = _mm256_set1_pd (-1.0), intScale = _mm256_set1_pd ((f64) 0x7fffffff);
+            const auto shift = _mm_cvtsi32_si128 (32 - 8 * bytesPerSample);
+
+            const auto convertOne = [&] (i32 i)
+            {
+                writePackedInt (dest + (size_t) i * (size_t) destStride,
+                                AudioDataHelpers::convertFloatToInt (*addBytesToPointer (source, (size_t) i * (size_t) sourceStride), bytesPerSample, dither),
+                                bytesPerSample, bigEndian);
+            };
+
+            i32 i = 0;
+
+            // The generators have to be lined up with the vector's lanes
+            if (dither != nullptr)
+                for (; i < numSamples && (*ditherPosition & 7) != 0; ++i)
+                    convertOne (i);
+
+            auto generators = dither != nullptr ? _mm256_loadu_si256 (reinterpret_cast<const __m256i*> (ditherState))
+                                                : _mm256_setzero_si256();
+            const auto firstVectorised = i;
+
+            for (; i + 8 <= numSamples; i += 8)
+            {
+                const auto* s = addBytesToPointer (source, (size_t) i * (size_t) sourceStride);
+                const auto samples = sourceStride == 4 ? _mm256_loadu_ps (s) : _mm256_i32gather_ps (s, offsets, 1);
+                __m256i v;
+
+                if (dither == nullptr)
+                {
+                    const auto lo = _mm256_mul_pd (_mm256_min_pd (_mm256_max_pd (_mm256_cvtps_pd (_mm256_castps256_ps128 (samples)), minusOne), one), intScale);
+                    const auto hi = _mm256_mul_pd (_mm256_min_pd (_mm256_max_pd (_mm256_cvtps_pd (_mm256_extractf128_ps (samples, 1)), minusOne), one), intScale);
+                    v = _mm256_inserti128_si256 (_mm256_castsi128_si256 (_mm256_cvtpd_epi32 (lo)), _mm256_cvtpd_epi32 (hi), 1);
+                    v = _mm256_sra_epi32 (v, shift);
+                }
+                else
+                {
+                    generators = _mm256_xor_si256 (generators, _mm256_slli_epi32 (generators, 13));
+                    generators = _mm256_xor_si256 (generators, _mm256_srli_epi32 (generators, 17));
+                    generators = _mm256_xor_si256 (generators, _mm256_slli_epi32 (generators, 5));
+
+                    const auto difference = _mm256_sub_epi32 (_mm256_and_si256 (generators, _mm256_set1_epi32 (0xffff)),
+                                                              _mm256_srli_epi32 (generators, 16));
+
+                    const auto ditherValues = _mm256_mul_ps (_mm256_cvtepi32_ps (difference), _mm256_set1_ps (1.0f / 65536.0f));
+                    const auto scaled = _mm256_add_ps (_mm256_mul_ps (samples, scale), ditherValues);
+
+                    v = _mm256_cvtps_epi32 (_mm256_min_ps (_mm256_max_ps (scaled, lowerLimit), upperLimit));
+                }
+
+                v = _mm256_shuffle_epi8 (v, mask);
+                auto* d = dest + (size_t) i * (size_t) destStride;
+
+                if (isPacked)
+                {
+                    const auto lo = _mm256_castsi256_si128 (v), hi = _mm256_extracti128_si256 (v, 1);
+
+                    switch (bytesPerSample)
+                    {
+                        case 2:
+                            _mm_storel_epi64 (reinterpret_cast<__m128i*> (d), lo);
+                            _mm_storel_epi64 (reinterpret_cast<__m128i*> (d + 8), hi);
+                            break;
+
+                        case 3:
+                        {
+                            _mm_storel_epi64 (reinterpret_cast<__m128i*> (d), lo);
+                            _mm_storel_epi64 (reinterpret_cast<__m128i*> (d + 12), hi);
+                            const auto loTail = _mm_cvtsi128_si32 (_mm_srli_si128 (lo, 8));
+                            const auto hiTail = _mm_cvtsi128_si32 (_mm_srli_si128 (hi, 8));
+                            memcpy (d + 8, &loTail, 4);
+                            memcpy (d + 20, &hiTail, 4);
+                            break;
+                        }
+
+                        default:
+                            _mm256_storeu_si256 (reinterpret_cast<__m256i*> (d), v);
+                            break;
+                    }
+                }
+                else
+                {
+                    alignas (32) u8 bytes[32];
+                    _mm256_store_si256 (reinterpret_cast<__m256i*> (bytes), v);
+
+                    for (i32 j = 0; j < 8; ++j)
+                        memcpy (d + (size_t) j * (size_t) destStride, bytes + j * 4, (size_t) bytesPerSample);
+                }
+            }
+
+            if (dither != nullptr)
+            {
+                _mm256_storeu_si256 (reinterpret_cast<__m256i*> (ditherState), generators);
+                *ditherPosition += (u32) (i - firstVectorised);
+            }
+
+            for (; i < numSamples; ++i)
+                convertOne (i);
+        }
+    }
+
+   #if DRX_CLANG
+    #pragma clang attribute pop
+   #elif DRX_GCC
+    #pragma GCC pop_options
+   #endif
+   #endif
+}
+
+b8 AudioData::convertIntToNative (uk dest, i32 destStride, b8 destIsFloat,
+                                    ukk source, i32 sourceStride, i32 sourceBytesPerSample,
+                                    b8 sourceIsBigEndian, i32 numSamples) noexcept
+{
+   #if DRX_USE_AVX_INTRINSICS
+    if (AudioDataHelpers::useAvx2 && numSamples >= 16
+         && ! AudioDataHelpers::rangesOverlap (dest, destStride, 4, source, sourceStride, sourceBytesPerSample, numSamples))
+    {
+        AudioDataHelpers::Avx2::convertIntToNative (static_cast<u8*> (dest), destStride, destIsFloat,
+                                                    static_cast<const u8*> (source), sourceStride, sourceBytesPerSample,
+                                                    sourceIsBigEndian, numSamples);
+        return true;
+    }
+   #endif
+
+    ignoreUnused (dest, destStride, destIsFloat, source, sourceStride, sourceBytesPerSample, sourceIsBigEndian, numSamples);
+    return false;
+}
+
+b8 AudioData::convertFloatToInt (uk dest, i32 destStride, i32 destBytesPerSample, b8 destIsBigEndian,
+                                   const f32* source, i32 sourceStride, i32 numSamples, Dither* dither) noexcept
+{
+    // 32-bit integers aren't dithered
+    jassert (dither == nullptr || destBytesPerSample < 4);
+
+   #if DRX_USE_AVX_INTRINSICS
+    if (AudioDataHelpers::useAvx2 && numSamples >= 16
+         && ! AudioDataHelpers::rangesOverlap (dest, destStride, destBytesPerSample, source, sourceStride, 4, numSamples))
+    {
+        AudioDataHelpers::Avx2::convertFloatToInt (static_cast<u8*> (dest), destStride, destBytesPerSample, destIsBigEndian,
+                                                   source, sourceStride, numSamples, dither,
+                                                   dither != nullptr ? dither->state : nullptr,
+                                                   dither != nullptr ? &dither->position : nullptr);
+        return true;
+    }
+   #endif
+
+    ignoreUnused (dest, destStride, destBytesPerSample, destIsBigEndian, source, sourceStride, numSamples, dither);
+    return false;
+}
+
+//==============================================================================
 DRX_BEGIN_IGNORE_DEPRECATION_WARNINGS
 
 z0 AudioDataConverters::convertFloatToInt16LE (const f32* source, uk dest, i32 numSamples, i32 destBytesPerSample)
@@ -576,6 +911,136 @@ public:
         }
     };
 
+    //==============================================================================
+    template <class SourceFormat, class SourceEndianness, class DestFormat, class DestEndianness>
+    struct VectorisedTest
+    {
+        using SourceType = AudioData::Pointer<SourceFormat, SourceEndianness, AudioData::Interleaved, AudioData::Const>;
+        using DestType   = AudioData::Pointer<DestFormat,   DestEndianness,   AudioData::Interleaved, AudioData::NonConst>;
+
+        static z0 fillSource (HeapBlock<u8>& data, i32 numBytes, Random& r)
+        {
+            data.calloc ((size_t) numBytes + 32);
+
+            if constexpr (SourceFormat::isFloat)
+            {
+                for (i32 i = 0; i < numBytes / 4; ++i)
+                    reinterpret_cast<f32*> (data.get())[i] = r.nextFloat() * 2.2f - 1.1f;
+            }
+            else
+            {
+                r.fillBitsRandomly (data.get(), (size_t) numBytes);
+            }
+        }
+
+        static z0 convert (u8* dest, i32 numDestChannels, const u8* source, i32 numSourceChannels, i32 numSamples)
+        {
+            for (i32 ch = 0; ch < numDestChannels; ++ch)
+            {
+                DestType d (dest + ch * DestType::getBytesPerSample(), numDestChannels);
+                d.convertSamples (SourceType (source + (ch % numSourceChannels) * SourceType::getBytesPerSample(), numSourceChannels), numSamples);
+            }
+        }
+
+        static z0 test (UnitTest& unitTest, Random& r)
+        {
+            for (auto numSamples : { 16, 17, 100, 1025, 200000 })
+            {
+                for (auto numSourceChannels : { 1, 2, 3, 8 })
+                {
+                    const auto numDestChannels = numSamples > 10000 ? 1 : r.nextInt ({ 1, 5 });
+
+                    HeapBlock<u8> source;
+                    fillSource (source, numSamples * numSourceChannels * SourceType::getBytesPerSample(), r);
+
+                    const auto numDestBytes = (size_t) (numSamples * numDestChannels * DestType::getBytesPerSample());
+                    HeapBlock<u8> vectorised (numDestBytes, true), perSample (numDestBytes, true);
+
+                    convert (vectorised, numDestChannels, source, numSourceChannels, numSamples);
+
+                    {
+                       #if DRX_USE_AVX_INTRINSICS
+                        const ScopedValueSetter<b8> svs (AudioDataHelpers::useAvx2, false);
+                       #endif
+
+                        convert (perSample, numDestChannels, source, numSourceChannels, numSamples);
+                    }
+
+                    unitTest.expect (memcmp (vectorised, perSample, numDestBytes) == 0);
+                }
+            }
+        }
+
+        static f64 timeConversion (const u8* source, u8* dest, i32 numChannels, i32 numSamples)
+        {
+            const auto start = Time::getMillisecondCounterHiRes();
+
+            for (i32 i = 0; i < 20; ++i)
+                convert (dest, 1, source, numChannels, numSamples);
+
+            return (Time::getMillisecondCounterHiRes() - start) / 20.0;
+        }
+
+        static z0 benchmark (UnitTest& unitTest, const Txt& name)
+        {
+            constexpr i32 numSamples = 1 << 16, numChannels = 2;
+
+            Random r (1);
+            HeapBlock<u8> source, dest ((size_t) numSamples * 4, true);
+            fillSource (source, numSamples * numChannels * SourceType::getBytesPerSample(), r);
+
+            auto vectorisedTime = timeConversion (source, dest, numChannels, numSamples);
+            f64 perSampleTime;
+
+            {
+               #if DRX_USE_AVX_INTRINSICS
+                const ScopedValueSetter<b8> svs (AudioDataHelpers::useAvx2, false);
+               #endif
+
+                perSampleTime = timeConversion (source, dest, numChannels, numSamples);
+            }
+
+            unitTest.logMessage (name + ": " + Txt (perSampleTime * 1000.0, 1) + " us per-sample, "
+                                   + Txt (vectorisedTime * 1000.0, 1) + " us vectorised ("
+                                   + Txt (perSampleTime / jmax (vectorisedTime, 1.0e-9), 2) + "x)");
+        }
+    };
+
+    template <class DestFormat>
+    static z0 testDither (UnitTest& unitTest)
+    {
+        using DestType   = AudioData::Pointer<DestFormat, AudioData::LittleEndian, AudioData::NonInterleaved, AudioData::NonConst>;
+        using SourceType = AudioData::Pointer<AudioData::Float32, AudioData::NativeEndian, AudioData::NonInterleaved, AudioData::Const>;
+
+        constexpr i32 numSamples = 100000;
+        const auto lsb = 1.0 / (1.0 + (f64) DestFormat::maxValue);
+        const auto input = (f32) (0.3 * lsb);
+
+        std::vector<f32> source ((size_t) numSamples, input);
+        std::vector<u8> dest ((size_t) numSamples * DestFormat::bytesPerSample);
+
+        AudioData::Dither dither (1234);
+        DestType (dest.data()).convertSamplesWithDither (SourceType (source.data()), numSamples, dither);
+
+        f64 total = 0;
+        b8 allWithinRange = true;
+        DestType d (dest.data());
+
+        for (i32 i = 0; i < numSamples; ++i, ++d)
+        {
+            const auto value = d.getAsFloat() / lsb;
+            total += value;
+            allWithinRange = allWithinRange && std::abs (value - 0.3) < 1.5;
+        }
+
+        unitTest.expect (allWithinRange);
+        unitTest.expectWithinAbsoluteError (total / numSamples, 0.3, 0.02);
+
+        // Without dither, a signal this quiet would just be rounded to silence
+        DestType (dest.data()).convertSamples (SourceType (source.data()), numSamples);
+        unitTest.expectEquals (DestType (dest.data()).findMinAndMax ((size_t) numSamples).getLength(), 0.0f);
+    }
+
     z0 runTest() override
     {
         auto r = getRandom();
@@ -633,6 +1098,65 @@ public:
                 for (i32 i = 0; i < numSamples; ++i)
                     expectEquals (sourceBuffer.getSample (0, ch + (i * numChannels)), destBuffer.getSample (ch, i));
         }
+
+        using LE = AudioData::LittleEndian;
+        using BE = AudioData::BigEndian;
+        using NE = AudioData::NativeEndian;
+
+        beginTest ("Vectorised conversions match the per-sample ones");
+        {
+            VectorisedTest<AudioData::Int16, LE, AudioData::Float32, NE>::test (*this, r);
+            VectorisedTest<AudioData::Int16, BE, AudioData::Float32, NE>::test (*this, r);
+            VectorisedTest<AudioData::Int24, LE, AudioData::Float32, NE>::test (*this, r);
+            VectorisedTest<AudioData::Int24, BE, AudioData::Float32, NE>::test (*this, r);
+            VectorisedTest<AudioData::Int32, LE, AudioData::Float32, NE>::test (*this, r);
+            VectorisedTest<AudioData::Int32, BE, AudioData::Float32, NE>::test (*this, r);
+            VectorisedTest<AudioData::Int16, LE, AudioData::Int32,   NE>::test (*this, r);
+            VectorisedTest<AudioData::Int24, BE, AudioData::Int32,   NE>::test (*this, r);
+            VectorisedTest<AudioData::Int32, BE, AudioData::Int32,   NE>::test (*this, r);
+
+            VectorisedTest<AudioData::Float32, NE, AudioData::Int16, LE>::test (*this, r);
+            VectorisedTest<AudioData::Float32, NE, AudioData::Int16, BE>::test (*this, r);
+            VectorisedTest<AudioData::Float32, NE, AudioData::Int24, LE>::test (*this, r);
+            VectorisedTest<AudioData::Float32, NE, AudioData::Int24, BE>::test (*this, r);
+            VectorisedTest<AudioData::Float32, NE, AudioData::Int32, LE>::test (*this, r);
+            VectorisedTest<AudioData::Float32, NE, AudioData::Int32, BE>::test (*this, r);
+        }
+
+        beginTest ("Dither");
+        {
+            testDither<AudioData::Int16> (*this);
+            testDither<AudioData::Int24> (*this);
+
+            AudioData::Dither d1 (99), d2 (99);
+            std::vector<f32> source (1000, 0.1f);
+            std::vector<i16> dest1 (1000), dest2 (1000);
+
+            using DestType   = AudioData::Pointer<AudioData::Int16, NE, AudioData::NonInterleaved, AudioData::NonConst>;
+            using SourceType = AudioData::Pointer<AudioData::Float32, NE, AudioData::NonInterleaved, AudioData::Const>;
+
+            // The same sequence comes out however the conversion is split into blocks
+            DestType (dest1.data()).convertSamplesWithDither (SourceType (source.data()), 1000, d1);
+            DestType (dest2.data()).convertSamplesWithDither (SourceType (source.data()), 3, d2);
+            DestType (dest2.data() + 3).convertSamplesWithDither (SourceType (source.data() + 3), 997, d2);
+
+            expect (dest1 == dest2);
+        }
+
+        beginTest ("Performance");
+        {
+            VectorisedTest<AudioData::Int16,   LE, AudioData::Float32, NE>::benchmark (*this, "Int16 LE -> Float32");
+            VectorisedTest<AudioData::Int16,   BE, AudioData::Float32, NE>::benchmark (*this, "Int16 BE -> Float32");
+            VectorisedTest<AudioData::Int24,   LE, AudioData::Float32, NE>::benchmark (*this, "Int24 LE -> Float32");
+            VectorisedTest<AudioData::Int24,   BE, AudioData::Float32, NE>::benchmark (*this, "Int24 BE -> Float32");
+            VectorisedTest<AudioData::Int32,   LE, AudioData::Float32, NE>::benchmark (*this, "Int32 LE -> Float32");
+            VectorisedTest<AudioData::Int16,   LE, AudioData::Int32,   NE>::benchmark (*this, "Int16 LE -> Int32");
+            VectorisedTest<AudioData::Int24,   LE, AudioData::Int32,   NE>::benchmark (*this, "Int24 LE -> Int32");
+            VectorisedTest<AudioData::Float32, NE, AudioData::Int16,   LE>::benchmark (*this, "Float32 -> Int16 LE");
+            VectorisedTest<AudioData::Float32, NE, AudioData::Int16,   BE>::benchmark (*this, "Float32 -> Int16 BE");
+            VectorisedTest<AudioData::Float32, NE, AudioData::Int24,   LE>::benchmark (*this, "Float32 -> Int24 LE");
+            VectorisedTest<AudioData::Float32, NE, AudioData::Int32,   LE>::benchmark (*this, "Float32 -> Int32 LE");
+        }
     }
 };
 
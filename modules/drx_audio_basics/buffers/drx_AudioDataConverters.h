@@ -334,6 +334,48 @@ public:
     };
   #endif
 
+    //==============================================================================
+    /**
+        Generates the triangular-PDF dither that Pointer::convertSamplesWithDither() adds to
+        floating point samples before they're rounded to an integer format.
+
+        The sequence of values is repeatable for a given seed. Use a separate Dither for each
+        channel, and keep using the same one from one block to the next.
+    */
+    class Dither
+    {
+    public:
+        /** Creates a Dither with a particular seed. */
+        explicit Dither (u32 seed = 1) noexcept
+        {
+            for (auto& s : state)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                s = seed != 0 ? seed : 1;
+            }
+        }
+
+        /** Returns the next dither value, measured in least significant bits. The values lie
+            between -1 and 1, with a triangular distribution.
+        */
+        f32 getNextValue() noexcept
+        {
+            // Eight interleaved xorshift generators, so that the vectorised conversions can
+            // advance them all at once and still produce the same sequence
+            auto& x = state[position++ & 7];
+            x ^= x << 13;
+            x ^= x >> 17;
+            x ^= x << 5;
+            return (f32) ((i32) (x & 0xffff) - (i32) (x >> 16)) * (1.0f / 65536.0f);
+        }
+
+    private:
+        friend class AudioData;
+
+        u32 state[8];
+        u32 position = 0;
+    };
+
     //==============================================================================
     /**
         A pointer to a block of audio data with a particular encoding.
@@ -366,6 +408,9 @@ public:
     class Pointer  : private InterleavingType  // (inherited for EBCO)
     {
     public:
+        using SampleFormatType = SampleFormat;
+        using EndiannessType   = Endianness;
+
         //==============================================================================
         /** Creates a non-interleaved pointer from some raw data in the appropriate format.
             This constructor is only used if you've specified the AudioData::NonInterleaved option -
@@ -476,6 +521,9 @@ public:
             // trying to write to a const pointer! For a writeable one, use AudioData::NonConst instead!
             static_assert (Constness::isConst == 0, "Attempt to write to a const pointer");
 
+            if (AudioData::convertVectorised (*this, source, numSamples, nullptr))
+                return;
+
             Pointer dest (*this);
 
             if (source.getRawData() != getRawData() || source.getNumBytesBetweenSamples() >= getNumBytesBetweenSamples())
@@ -497,6 +545,42 @@ public:
             }
         }
 
+        /** Writes a stream of floating point samples into this pointer, adding dither before
+            they're rounded to this pointer's integer format.
+
+            Nothing is added for floating point or 32-bit integer formats, so for those this
+            does the same as convertSamples(). The source and destination mustn't overlap.
+
+            @see AudioData::Dither
+        */
+        template <class OtherPointerType>
+        z0 convertSamplesWithDither (OtherPointerType source, i32 numSamples, Dither& dither) const noexcept
+        {
+            // trying to write to a const pointer! For a writeable one, use AudioData::NonConst instead!
+            static_assert (Constness::isConst == 0, "Attempt to write to a const pointer");
+            static_assert (OtherPointerType::SampleFormatType::isFloat, "The source must be floating point");
+
+            if constexpr (SampleFormat::isFloat || SampleFormat::resolution == 1)
+            {
+                ignoreUnused (dither);
+                convertSamples (source, numSamples);
+            }
+            else
+            {
+                if (AudioData::convertVectorised (*this, source, numSamples, &dither))
+                    return;
+
+                const auto lsb = (f32) (1.0 / (1.0 + (f64) SampleFormat::maxValue));
+
+                for (Pointer dest (*this); --numSamples >= 0;)
+                {
+                    dest.setAsFloat (source.getAsFloat() + dither.getNextValue() * lsb);
+                    dest.advance();
+                    ++source;
+                }
+            }
+        }
+
         /** Sets a number of samples to zero. */
         z0 clearSamples (i32 numSamples) const noexcept
         {
@@ -796,8 +880,70 @@ public:
             }
         }
     }
+
+private:
+    //==============================================================================
+    /*  Vectorised versions of the most common conversions: packed 16, 24 and 32-bit integers
+        in either byte order to native floats or 32-bit integers, and native floats back to
+        packed integers, with or without dither, for any interleaving.
+
+        The pairs of formats that can use them are picked at compile time from the
+        FormatTraits specialisations. The routines themselves choose an instruction set at
+        runtime, and return false if they can't handle a particular call, in which case the
+        per-sample code in Pointer is used instead.
+    */
+    template <class SampleFormat>
+    struct FormatTraits
+    {
+        enum { isVectorisable = 0, isFloat = 0, bytesPerSample = 0 };
+    };
+
+    static b8 convertIntToNative (uk dest, i32 destStride, b8 destIsFloat,
+                                  ukk source, i32 sourceStride, i32 sourceBytesPerSample,
+                                  b8 sourceIsBigEndian, i32 numSamples) noexcept;
+
+    static b8 convertFloatToInt (uk dest, i32 destStride, i32 destBytesPerSample, b8 destIsBigEndian,
+                                 const f32* source, i32 sourceStride, i32 numSamples, Dither*) noexcept;
+
+    template <class DestPointerType, class SourcePointerType>
+    static b8 convertVectorised (const DestPointerType& dest, const SourcePointerType& source,
+                                 i32 numSamples, Dither* dither) noexcept
+    {
+        using DestTraits   = FormatTraits<typename DestPointerType::SampleFormatType>;
+        using SourceTraits = FormatTraits<typename SourcePointerType::SampleFormatType>;
+
+        constexpr auto destIsNative   = (i32) DestPointerType::EndiannessType::isBigEndian   == (i32) NativeEndian::isBigEndian;
+        constexpr auto sourceIsNative = (i32) SourcePointerType::EndiannessType::isBigEndian == (i32) NativeEndian::isBigEndian;
+
+        if constexpr (DestTraits::isVectorisable && SourceTraits::isVectorisable)
+        {
+            if constexpr (! SourceTraits::isFloat && destIsNative && DestTraits::bytesPerSample == 4)
+            {
+                if (dither == nullptr)
+                    return convertIntToNative (const_cast<uk> (dest.getRawData()), dest.getNumBytesBetweenSamples(), DestTraits::isFloat,
+                                               source.getRawData(), source.getNumBytesBetweenSamples(), SourceTraits::bytesPerSample,
+                                               SourcePointerType::isBigEndian(), numSamples);
+            }
+            else if constexpr (SourceTraits::isFloat && sourceIsNative && ! DestTraits::isFloat)
+            {
+                return convertFloatToInt (const_cast<uk> (dest.getRawData()), dest.getNumBytesBetweenSamples(), DestTraits::bytesPerSample,
+                                          DestPointerType::isBigEndian(), static_cast<const f32*> (source.getRawData()),
+                                          source.getNumBytesBetweenSamples(), numSamples, dither);
+            }
+        }
+
+        ignoreUnused (dest, source, numSamples, dither);
+        return false;
+    }
 };
 
+#ifndef DOXYGEN
+template <> struct AudioData::FormatTraits<AudioData::Int16>    { enum { isVectorisable = 1, isFloat = 0, bytesPerSample = 2 }; };
+template <> struct AudioData::FormatTraits<AudioData::Int24>    { enum { isVectorisable = 1, isFloat = 0, bytesPerSample = 3 }; };
+template <> struct AudioData::FormatTraits<AudioData::Int32>    { enum { isVectorisable = 1, isFloat = 0, bytesPerSample = 4 }; };
+template <> struct AudioData::FormatTraits<AudioData::Float32>  { enum { isVectorisable = 1, isFloat = 1, bytesPerSample = 4 }; };
+#endif
+
 //==============================================================================
 #ifndef DOXYGEN
 /**
@@ -503,6 +503,177 @@ namespace FloatVectorHelpers
     };
    #endif
 
+   #if DRX_USE_AVX_INTRINSICS
+    //==============================================================================
+    /*  AVX2 and AVX-512 versions of the operations, picked at runtime by checking the CPU.
+
+        These are compiled with target pragmas rather than per-file compiler flags, so nothing
+        in the Avx2 or Avx512 namespaces may be called unless avxLevel says it's safe. FMA is
+        deliberately avoided so that every instruction set gives bit-identical results.
+    */
+    enum class AvxLevel { none, avx2, avx512 };
+
+    static AvxLevel detectAvxLevel() noexcept
+    {
+        if (SystemStats::hasAVX512F())   return AvxLevel::avx512;
+        if (SystemStats::hasAVX2())      return AvxLevel::avx2;
+
+        return AvxLevel::none;
+    }
+
+    // Chosen once at startup - anything that runs before this is initialised just gets the SSE path
+    static AvxLevel avxLevel = detectAvxLevel();
+
+   #if DRX_CLANG
+    #pragma clang attribute push (__attribute__ ((target ("avx2"))), apply_to = function)
+   #elif DRX_GCC
+    #pragma GCC push_options
+    #pragma GCC target ("avx2")
+   #endif
+
+    namespace Avx2
+    {
+        struct BasicOps32
+        {
+            using Type = f32;
+            using ParallelType = __m256;
+            enum { numParallel = 8 };
+
+            static forcedinline ParallelType load1 (Type v) noexcept                        { return _mm256_set1_ps (v); }
+            static forcedinline ParallelType loadU (const Type* v) noexcept                 { return _mm256_loadu_ps (v); }
+            static forcedinline ParallelType loadInt (i32k* v) noexcept                     { return _mm256_cvtepi32_ps (_mm256_loadu_si256 (reinterpret_cast<const __m256i*> (v))); }
+            static forcedinline z0 storeU (Type* dest, ParallelType a) noexcept           { _mm256_storeu_ps (dest, a); }
+
+            static forcedinline ParallelType add (ParallelType a, ParallelType b) noexcept  { return _mm256_add_ps (a, b); }
+            static forcedinline ParallelType sub (ParallelType a, ParallelType b) noexcept  { return _mm256_sub_ps (a, b); }
+            static forcedinline ParallelType mul (ParallelType a, ParallelType b) noexcept  { return _mm256_mul_ps (a, b); }
+            static forcedinline ParallelType max (ParallelType a, ParallelType b) noexcept  { return _mm256_max_ps (a, b); }
+            static forcedinline ParallelType min (ParallelType a, ParallelType b) noexcept  { return _mm256_min_ps (a, b); }
+
+            static forcedinline ParallelType bit_and (ParallelType a, ParallelType b) noexcept  { return _mm256_and_ps (a, b); }
+            static forcedinline ParallelType absMask() noexcept                             { return _mm256_castsi256_ps (_mm256_set1_epi32 (0x7fffffff)); }
+
+            static forcedinline Type max (ParallelType a) noexcept  { Type v[numParallel]; storeU (v, a); return *std::max_element (v, v + numParallel); }
+            static forcedinline Type min (ParallelType a) noexcept  { Type v[numParallel]; storeU (v, a); return *std::min_element (v, v + numParallel); }
+        };
+
+        struct BasicOps64
+        {
+            using Type = f64;
+            using ParallelType = __m256d;
+            enum { numParallel = 4 };
+
+            static forcedinline ParallelType load1 (Type v) noexcept                        { return _mm256_set1_pd (v); }
+            static forcedinline ParallelType loadU (const Type* v) noexcept                 { return _mm256_loadu_pd (v); }
+            static forcedinline z0 storeU (Type* dest, ParallelType a) noexcept           { _mm256_storeu_pd (dest, a); }
+
+            static forcedinline ParallelType add (ParallelType a, ParallelType b) noexcept  { return _mm256_add_pd (a, b); }
+            static forcedinline ParallelType sub (ParallelType a, ParallelType b) noexcept  { return _mm256_sub_pd (a, b); }
+            static forcedinline ParallelType mul (ParallelType a, ParallelType b) noexcept  { return _mm256_mul_pd (a, b); }
+            static forcedinline ParallelType max (ParallelType a, ParallelType b) noexcept  { return _mm256_max_pd (a, b); }
+            static forcedinline ParallelType min (ParallelType a, ParallelType b) noexcept  { return _mm256_min_pd (a, b); }
+
+            static forcedinline ParallelType bit_and (ParallelType a, ParallelType b) noexcept  { return _mm256_and_pd (a, b); }
+            static forcedinline ParallelType absMask() noexcept                             { return _mm256_castsi256_pd (_mm256_set1_epi64x (0x7fffffffffffffffLL)); }
+
+            static forcedinline Type max (ParallelType a) noexcept  { Type v[numParallel]; storeU (v, a); return *std::max_element (v, v + numParallel); }
+            static forcedinline Type min (ParallelType a) noexcept  { Type v[numParallel]; storeU (v, a); return *std::min_element (v, v + numParallel); }
+        };
+
+        template <typename Type> struct ModeType       { using Mode = BasicOps32; };
+        template <>              struct ModeType<f64>  { using Mode = BasicOps64; };
+
+        #include "drx_FloatVectorOperations_avx.h"
+    }
+
+   #if DRX_CLANG
+    #pragma clang attribute pop
+    #pragma clang attribute push (__attribute__ ((target ("avx512f"))), apply_to = function)
+   #elif DRX_GCC
+    #pragma GCC pop_options
+    #pragma GCC push_options
+    #pragma GCC target ("avx512f")
+   #endif
+
+    // GCC's avx512fintrin.h builds its masked intrinsics on deliberately undefined registers,
+    // which trips -Wmaybe-uninitialized once they're inlined into the kernels below
+    DRX_BEGIN_IGNORE_WARNINGS_GCC_LIKE ("-Wmaybe-uninitialized")
+
+    namespace Avx512
+    {
+        // AVX-512F has no floating point logic ops (those are in DQ), so abs goes via the integer unit
+        struct BasicOps32
+        {
+            using Type = f32;
+            using ParallelType = __m512;
+            enum { numParallel = 16 };
+
+            static forcedinline ParallelType load1 (Type v) noexcept                        { return _mm512_set1_ps (v); }
+            static forcedinline ParallelType loadU (const Type* v) noexcept                 { return _mm512_loadu_ps (v); }
+            static forcedinline ParallelType loadInt (i32k* v) noexcept                     { return _mm512_cvtepi32_ps (_mm512_loadu_si512 (v)); }
+            static forcedinline z0 storeU (Type* dest, ParallelType a) noexcept           { _mm512_storeu_ps (dest, a); }
+
+            static forcedinline ParallelType add (ParallelType a, ParallelType b) noexcept  { return _mm512_add_ps (a, b); }
+            static forcedinline ParallelType sub (ParallelType a, ParallelType b) noexcept  { return _mm512_sub_ps (a, b); }
+            static forcedinline ParallelType mul (ParallelType a, ParallelType b) noexcept  { return _mm512_mul_ps (a, b); }
+            static forcedinline ParallelType max (ParallelType a, ParallelType b) noexcept  { return _mm512_max_ps (a, b); }
+            static forcedinline ParallelType min (ParallelType a, ParallelType b) noexcept  { return _mm512_min_ps (a, b); }
+
+            static forcedinline ParallelType bit_and (ParallelType a, ParallelType b) noexcept  { return _mm512_castsi512_ps (_mm512_and_si512 (_mm512_castps_si512 (a), _mm512_castps_si512 (b))); }
+            static forcedinline ParallelType absMask() noexcept                             { return _mm512_castsi512_ps (_mm512_set1_epi32 (0x7fffffff)); }
+
+            static forcedinline Type max (ParallelType a) noexcept  { Type v[numParallel]; storeU (v, a); return *std::max_element (v, v + numParallel); }
+            static forcedinline Type min (ParallelType a) noexcept  { Type v[numParallel]; storeU (v, a); return *std::min_element (v, v + numParallel); }
+        };
+
+        struct BasicOps64
+        {
+            using Type = f64;
+            using ParallelType = __m512d;
+            enum { numParallel = 8 };
+
+            static forcedinline ParallelType load1 (Type v) noexcept                        { return _mm512_set1_pd (v); }
+            static forcedinline ParallelType loadU (const Type* v) noexcept                 { return _mm512_loadu_pd (v); }
+            static forcedinline z0 storeU (Type* dest, ParallelType a) noexcept           { _mm512_storeu_pd (dest, a); }
+
+            static forcedinline ParallelType add (ParallelType a, ParallelType b) noexcept  { return _mm512_add_pd (a, b); }
+            static forcedinline ParallelType sub (ParallelType a, ParallelType b) noexcept  { return _mm512_sub_pd (a, b); }
+            static forcedinline ParallelType mul (ParallelType a, ParallelType b) noexcept  { return _mm512_mul_pd (a, b); }
+            static forcedinline ParallelType max (ParallelType a, ParallelType b) noexcept  { return _mm512_max_pd (a, b); }
+            static forcedinline ParallelType min (ParallelType a, ParallelType b) noexcept  { return _mm512_min_pd (a, b); }
+
+            static forcedinline ParallelType bit_and (ParallelType a, ParallelType b) noexcept  { return _mm512_castsi512_pd (_mm512_and_si512 (_mm512_castpd_si512 (a), _mm512_castpd_si512 (b))); }
+            static forcedinline ParallelType absMask() noexcept                             { return _mm512_castsi512_pd (_mm512_set1_epi64 (0x7fffffffffffffffLL)); }
+
+            static forcedinline Type max (ParallelType a) noexcept  { Type v[numParallel]; storeU (v, a); return *std::max_element (v, v + numParallel); }
+            static forcedinline Type min (ParallelType a) noexcept  { Type v[numParallel]; storeU (v, a); return *std::min_element (v, v + numParallel); }
+        };
+
+        template <typename Type> struct ModeType       { using Mode = BasicOps32; };
+        template <>              struct ModeType<f64>  { using Mode = BasicOps64; };
+
+        #include "drx_FloatVectorOperations_avx.h"
+    }
+
+    DRX_END_IGNORE_WARNINGS_GCC_LIKE
+
+   #if DRX_CLANG
+    #pragma clang attribute pop
+   #elif DRX_GCC
+    #pragma GCC pop_options
+   #endif
+
+    #define DRX_DISPATCH_TO_AVX(function, ...) \
+        switch (FloatVectorHelpers::avxLevel) \
+        { \
+            case FloatVectorHelpers::AvxLevel::avx512:  return FloatVectorHelpers::Avx512::function (__VA_ARGS__); \
+            case FloatVectorHelpers::AvxLevel::avx2:    return FloatVectorHelpers::Avx2::function (__VA_ARGS__); \
+            case FloatVectorHelpers::AvxLevel::none:    break; \
+        }
+   #else
+    #define DRX_DISPATCH_TO_AVX(function, ...)
+   #endif
+
 //==============================================================================
 namespace
 {
@@ -1196,6 +1367,7 @@ z0 DRX_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::fill (FloatType
                                                                           FloatType valueToFill,
                                                                           CountType numValues) noexcept
 {
+    DRX_DISPATCH_TO_AVX (fill, dest, valueToFill, numValues)
     FloatVectorHelpers::fill (dest, valueToFill, numValues);
 }
 
@@ -1213,6 +1385,7 @@ z0 DRX_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::copyWithMultipl
                                                                                       FloatType multiplier,
                                                                                       CountType numValues) noexcept
 {
+    DRX_DISPATCH_TO_AVX (copyWithMultiply, dest, src, multiplier, numValues)
     FloatVectorHelpers::copyWithMultiply (dest, src, multiplier, numValues);
 }
 
@@ -1221,6 +1394,7 @@ z0 DRX_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::add (FloatType*
                                                                          FloatType amountToAdd,
                                                                          CountType numValues) noexcept
 {
+    DRX_DISPATCH_TO_AVX (add, dest, amountToAdd, numValues)
     FloatVectorHelpers::add (dest, amountToAdd, numValues);
 }
 
@@ -1230,6 +1404,7 @@ z0 DRX_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::add (FloatType*
                                                                          FloatType amount,
                                                                          CountType numValues) noexcept
 {
+    DRX_DISPATCH_TO_AVX (add, dest, src, amount, numValues)
     FloatVectorHelpers::add (dest, src, amount, numValues);
 }
 
@@ -1238,6 +1413,7 @@ z0 DRX_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::add (FloatType*
                                                                          const FloatType* src,
                                                                          CountType numValues) noexcept
 {
+    DRX_DISPATCH_TO_AVX (add, dest, src, numValues)
     FloatVectorHelpers::add (dest, src, numValues);
 }
 
@@ -1247,6 +1423,7 @@ z0 DRX_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::add (FloatType*
                                                                          const FloatType* src2,
                                                                          CountType num) noexcept
 {
+    DRX_DISPATCH_TO_AVX (add, dest, src1, src2, num)
     FloatVectorHelpers::add (dest, src1, src2, num);
 }
 
@@ -1255,6 +1432,7 @@ z0 DRX_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::subtract (Float
                                                                               const FloatType* src,
                                                                               CountType numValues) noexcept
 {
+    DRX_DISPATCH_TO_AVX (subtract, dest, src, numValues)
     FloatVectorHelpers::subtract (dest, src, numValues);
 }
 
@@ -1264,6 +1442,7 @@ z0 DRX_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::subtract (Float
                                                                               const FloatType* src2,
                                                                               CountType num) noexcept
 {
+    DRX_DISPATCH_TO_AVX (subtract, dest, src1, src2, num)
     FloatVectorHelpers::subtract (dest, src1, src2, num);
 }
 
@@ -1273,6 +1452,7 @@ z0 DRX_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::addWithMultiply
                                                                                      FloatType multiplier,
                                                                                      CountType numValues) noexcept
 {
+    DRX_DISPATCH_TO_AVX (addWithMultiply, dest, src, multiplier, numValues)
     FloatVectorHelpers::addWithMultiply (dest, src, multiplier, numValues);
 }
 
@@ -1282,6 +1462,7 @@ z0 DRX_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::addWithMultiply
                                                                                      const FloatType* src2,
                                                                                      CountType num) noexcept
 {
+    DRX_DISPATCH_TO_AVX (addWithMultiply, dest, src1, src2, num)
     FloatVectorHelpers::addWithMultiply (dest, src1, src2, num);
 }
 
@@ -1291,6 +1472,7 @@ z0 DRX_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::subtractWithMul
                                                                                           FloatType multiplier,
                                                                                           CountType numValues) noexcept
 {
+    DRX_DISPATCH_TO_AVX (subtractWithMultiply, dest, src, multiplier, numValues)
     FloatVectorHelpers::subtractWithMultiply (dest, src, multiplier, numValues);
 }
 
@@ -1300,6 +1482,7 @@ z0 DRX_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::subtractWithMul
                                                                                           const FloatType* src2,
                                                                                           CountType num) noexcept
 {
+    DRX_DISPATCH_TO_AVX (subtractWithMultiply, dest, src1, src2, num)
     FloatVectorHelpers::subtractWithMultiply (dest, src1, src2, num);
 }
 
@@ -1308,6 +1491,7 @@ z0 DRX_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::multiply (Float
                                                                               const FloatType* src,
                                                                               CountType numValues) noexcept
 {
+    DRX_DISPATCH_TO_AVX (multiply, dest, src, numValues)
     FloatVectorHelpers::multiply (dest, src, numValues);
 }
 
@@ -1317,6 +1501,7 @@ z0 DRX_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::multiply (Float
                                                                               const FloatType* src2,
                                                                               CountType numValues) noexcept
 {
+    DRX_DISPATCH_TO_AVX (multiply, dest, src1, src2, numValues)
     FloatVectorHelpers::multiply (dest, src1, src2, numValues);
 }
 
@@ -1325,6 +1510,7 @@ z0 DRX_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::multiply (Float
                                                                               FloatType multiplier,
                                                                               CountType numValues) noexcept
 {
+    DRX_DISPATCH_TO_AVX (multiply, dest, multiplier, numValues)
     FloatVectorHelpers::multiply (dest, multiplier, numValues);
 }
 
@@ -1334,6 +1520,7 @@ z0 DRX_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::multiply (Float
                                                                               FloatType multiplier,
                                                                               CountType num) noexcept
 {
+    DRX_DISPATCH_TO_AVX (multiply, dest, src, multiplier, num)
     FloatVectorHelpers::multiply (dest, src, multiplier, num);
 }
 
@@ -1342,6 +1529,7 @@ z0 DRX_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::negate (FloatTy
                                                                             const FloatType* src,
                                                                             CountType numValues) noexcept
 {
+    DRX_DISPATCH_TO_AVX (negate, dest, src, numValues)
     FloatVectorHelpers::negate (dest, src, numValues);
 }
 
@@ -1350,6 +1538,7 @@ z0 DRX_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::abs (FloatType*
                                                                          const FloatType* src,
                                                                          CountType numValues) noexcept
 {
+    DRX_DISPATCH_TO_AVX (abs, dest, src, numValues)
     FloatVectorHelpers::abs (dest, src, numValues);
 }
 
@@ -1359,6 +1548,7 @@ z0 DRX_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::min (FloatType*
                                                                          FloatType comp,
                                                                          CountType num) noexcept
 {
+    DRX_DISPATCH_TO_AVX (min, dest, src, comp, num)
     FloatVectorHelpers::min (dest, src, comp, num);
 }
 
@@ -1368,6 +1558,7 @@ z0 DRX_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::min (FloatType*
                                                                          const FloatType* src2,
                                                                          CountType num) noexcept
 {
+    DRX_DISPATCH_TO_AVX (min, dest, src1, src2, num)
     FloatVectorHelpers::min (dest, src1, src2, num);
 }
 
@@ -1377,6 +1568,7 @@ z0 DRX_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::max (FloatType*
                                                                          FloatType comp,
                                                                          CountType num) noexcept
 {
+    DRX_DISPATCH_TO_AVX (max, dest, src, comp, num)
     FloatVectorHelpers::max (dest, src, comp, num);
 }
 
@@ -1386,6 +1578,7 @@ z0 DRX_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::max (FloatType*
                                                                          const FloatType* src2,
                                                                          CountType num) noexcept
 {
+    DRX_DISPATCH_TO_AVX (max, dest, src1, src2, num)
     FloatVectorHelpers::max (dest, src1, src2, num);
 }
 
@@ -1396,6 +1589,7 @@ z0 DRX_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::clip (FloatType
                                                                           FloatType high,
                                                                           CountType num) noexcept
 {
+    DRX_DISPATCH_TO_AVX (clip, dest, src, low, high, num)
     FloatVectorHelpers::clip (dest, src, low, high, num);
 }
 
@@ -1403,6 +1597,7 @@ template <typename FloatType, typename CountType>
 Range<FloatType> DRX_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::findMinAndMax (const FloatType* src,
                                                                                                CountType numValues) noexcept
 {
+    DRX_DISPATCH_TO_AVX (findMinAndMax, src, numValues)
     return FloatVectorHelpers::findMinAndMax (src, numValues);
 }
 
@@ -1410,6 +1605,7 @@ template <typename FloatType, typename CountType>
 FloatType DRX_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::findMinimum (const FloatType* src,
                                                                                       CountType numValues) noexcept
 {
+    DRX_DISPATCH_TO_AVX (findMinimum, src, numValues)
     return FloatVectorHelpers::findMinimum (src, numValues);
 }
 
@@ -1417,6 +1613,7 @@ template <typename FloatType, typename CountType>
 FloatType DRX_CALLTYPE FloatVectorOperationsBase<FloatType, CountType>::findMaximum (const FloatType* src,
                                                                                       CountType numValues) noexcept
 {
+    DRX_DISPATCH_TO_AVX (findMaximum, src, numValues)
     return FloatVectorHelpers::findMaximum (src, numValues);
 }
 
@@ -1427,11 +1624,13 @@ template struct FloatVectorOperationsBase<f64, size_t>;
 
 z0 DRX_CALLTYPE FloatVectorOperations::convertFixedToFloat (f32* dest, i32k* src, f32 multiplier, size_t num) noexcept
 {
+   DRX_DISPATCH_TO_AVX (convertFixedToFloat, dest, src, multiplier, num)
    FloatVectorHelpers::convertFixedToFloat (dest, src, multiplier, num);
 }
 
 z0 DRX_CALLTYPE FloatVectorOperations::convertFixedToFloat (f32* dest, i32k* src, f32 multiplier, i32 num) noexcept
 {
+    DRX_DISPATCH_TO_AVX (convertFixedToFloat, dest, src, multiplier, num)
     FloatVectorHelpers::convertFixedToFloat (dest, src, multiplier, num);
 }
 
@@ -1709,6 +1908,142 @@ public:
         }
     };
 
+   #if DRX_USE_AVX_INTRINSICS
+    template <typename ValueType>
+    struct AvxTestRunner
+    {
+        using Op = std::function<Range<ValueType> (ValueType*, const ValueType*, const ValueType*, i32)>;
+
+        struct NamedOp
+        {
+            tukk name;
+            Op op;
+        };
+
+        static std::vector<NamedOp> createOps (ValueType k)
+        {
+            return
+            {
+                { "fill", [=] (ValueType* d, const ValueType*, const ValueType*, i32 n)    { FloatVectorOperations::fill (d, k, n); return Range<ValueType>(); } },
+                { "copyWithMultiply", [=] (ValueType* d, const ValueType* a, const ValueType*, i32 n)  { FloatVectorOperations::copyWithMultiply (d, a, k, n); return Range<ValueType>(); } },
+                { "add (scalar)", [=] (ValueType* d, const ValueType*, const ValueType*, i32 n)    { FloatVectorOperations::add (d, k, n); return Range<ValueType>(); } },
+                { "add (src, scalar)", [=] (ValueType* d, const ValueType* a, const ValueType*, i32 n)  { FloatVectorOperations::add (d, a, k, n); return Range<ValueType>(); } },
+                { "add (src)", [=] (ValueType* d, const ValueType* a, const ValueType*, i32 n)  { FloatVectorOperations::add (d, a, n); return Range<ValueType>(); } },
+                { "add (src1, src2)", [=] (ValueType* d, const ValueType* a, const ValueType* b, i32 n) { FloatVectorOperations::add (d, a, b, n); return Range<ValueType>(); } },
+                { "subtract (src)", [=] (ValueType* d, const ValueType* a, const ValueType*, i32 n)  { FloatVectorOperations::subtract (d, a, n); return Range<ValueType>(); } },
+                { "subtract (src1, src2)", [=] (ValueType* d, const ValueType* a, const ValueType* b, i32 n) { FloatVectorOperations::subtract (d, a, b, n); return Range<ValueType>(); } },
+                { "addWithMultiply (scalar)", [=] (ValueType* d, const ValueType* a, const ValueType*, i32 n)  { FloatVectorOperations::addWithMultiply (d, a, k, n); return Range<ValueType>(); } },
+                { "addWithMultiply (src1, src2)", [=] (ValueType* d, const ValueType* a, const ValueType* b, i32 n) { FloatVectorOperations::addWithMultiply (d, a, b, n); return Range<ValueType>(); } },
+                { "subtractWithMultiply (scalar)", [=] (ValueType* d, const ValueType* a, const ValueType*, i32 n)  { FloatVectorOperations::subtractWithMultiply (d, a, k, n); return Range<ValueType>(); } },
+                { "subtractWithMultiply (src1, src2)", [=] (ValueType* d, const ValueType* a, const ValueType* b, i32 n) { FloatVectorOperations::subtractWithMultiply (d, a, b, n); return Range<ValueType>(); } },
+                { "multiply (src)", [=] (ValueType* d, const ValueType* a, const ValueType*, i32 n)  { FloatVectorOperations::multiply (d, a, n); return Range<ValueType>(); } },
+                { "multiply (src1, src2)", [=] (ValueType* d, const ValueType* a, const ValueType* b, i32 n) { FloatVectorOperations::multiply (d, a, b, n); return Range<ValueType>(); } },
+                { "multiply (scalar)", [=] (ValueType* d, const ValueType*, const ValueType*, i32 n)    { FloatVectorOperations::multiply (d, k, n); return Range<ValueType>(); } },
+                { "multiply (src, scalar)", [=] (ValueType* d, const ValueType* a, const ValueType*, i32 n)  { FloatVectorOperations::multiply (d, a, k, n); return Range<ValueType>(); } },
+                { "negate", [=] (ValueType* d, const ValueType* a, const ValueType*, i32 n)  { FloatVectorOperations::negate (d, a, n); return Range<ValueType>(); } },
+                { "abs", [=] (ValueType* d, const ValueType* a, const ValueType*, i32 n)  { FloatVectorOperations::abs (d, a, n); return Range<ValueType>(); } },
+                { "min (scalar)", [=] (ValueType* d, const ValueType* a, const ValueType*, i32 n)  { FloatVectorOperations::min (d, a, k, n); return Range<ValueType>(); } },
+                { "min (src1, src2)", [=] (ValueType* d, const ValueType* a, const ValueType* b, i32 n) { FloatVectorOperations::min (d, a, b, n); return Range<ValueType>(); } },
+                { "max (scalar)", [=] (ValueType* d, const ValueType* a, const ValueType*, i32 n)  { FloatVectorOperations::max (d, a, k, n); return Range<ValueType>(); } },
+                { "max (src1, src2)", [=] (ValueType* d, const ValueType* a, const ValueType* b, i32 n) { FloatVectorOperations::max (d, a, b, n); return Range<ValueType>(); } },
+                { "clip", [=] (ValueType* d, const ValueType* a, const ValueType*, i32 n)  { FloatVectorOperations::clip (d, a, (ValueType) -100, (ValueType) 100, n); return Range<ValueType>(); } },
+                { "findMinAndMax", [=] (ValueType*, const ValueType* a, const ValueType*, i32 n)    { return FloatVectorOperations::findMinAndMax (a, n); } },
+                { "findMinimum", [=] (ValueType*, const ValueType* a, const ValueType*, i32 n)    { return Range<ValueType>::emptyRange (FloatVectorOperations::findMinimum (a, n)); } },
+                { "findMaximum", [=] (ValueType*, const ValueType* a, const ValueType*, i32 n)    { return Range<ValueType>::emptyRange (FloatVectorOperations::findMaximum (a, n)); } }
+            };
+        }
+
+        static z0 runTest (UnitTest& u, Random random, FloatVectorHelpers::AvxLevel level)
+        {
+            i32k num = random.nextInt (100) + 1;
+            HeapBlock<ValueType> buffer1 (num + 16), buffer2 (num + 16);
+
+            // Deliberately misaligned, as the wider paths only use unaligned loads and stores
+            const ValueType* const src1 = addBytesToPointer (buffer1.get(), random.nextInt (16));
+            const ValueType* const src2 = addBytesToPointer (buffer2.get(), random.nextInt (16));
+
+            for (i32 i = 0; i < num; ++i)
+            {
+                const_cast<ValueType*> (src1)[i] = (ValueType) (random.nextDouble() * 2000.0 - 1000.0);
+                const_cast<ValueType*> (src2)[i] = (ValueType) (random.nextDouble() * 2000.0 - 1000.0);
+            }
+
+            const ValueType k = (ValueType) (random.nextDouble() * 10.0 - 5.0);
+            const auto ops = createOps (k);
+
+            std::vector<ValueType> expected ((size_t) num), actual ((size_t) num);
+
+            for (auto& namedOp : ops)
+            {
+                const auto run = [&] (FloatVectorHelpers::AvxLevel levelToUse, std::vector<ValueType>& result)
+                {
+                    const ScopedValueSetter<FloatVectorHelpers::AvxLevel> svs (FloatVectorHelpers::avxLevel, levelToUse);
+                    std::copy (src2, src2 + num, result.begin());
+                    return namedOp.op (result.data(), src1, src2, num);
+                };
+
+                const auto expectedRange = run (FloatVectorHelpers::AvxLevel::none, expected);
+                const auto actualRange = run (level, actual);
+
+                u.expect (expectedRange == actualRange);
+                u.expect (memcmp (expected.data(), actual.data(), (size_t) num * sizeof (ValueType)) == 0);
+            }
+        }
+
+        static z0 logTimings (UnitTest& u, FloatVectorHelpers::AvxLevel level, StringRef levelName)
+        {
+            // Every kernel is timed at a few block sizes, so that the fixed cost of the
+            // scalar tail shows up for short buffers as well as the throughput of long ones
+            constexpr i32 sizes[] = { 64, 512, 4096 };
+            constexpr i32 samplesPerMeasurement = 1 << 20;
+
+            // Unit inputs keep the repeatedly applied kernels away from denormals and overflow
+            std::vector<ValueType> dest ((size_t) sizes[numElementsInArray (sizes) - 1], (ValueType) 1),
+                                   src1 (dest.size(), (ValueType) 1),
+                                   src2 (dest.size(), (ValueType) 1);
+
+            const auto timeOp = [&] (const std::function<z0 (i32)>& op, FloatVectorHelpers::AvxLevel levelToUse, i32 num)
+            {
+                const ScopedValueSetter<FloatVectorHelpers::AvxLevel> svs (FloatVectorHelpers::avxLevel, levelToUse);
+                const auto start = Time::getHighResolutionTicks();
+
+                for (i32 i = samplesPerMeasurement / num; --i >= 0;)
+                    op (num);
+
+                return Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+            };
+
+            const auto logSpeedups = [&] (StringRef opName, const std::function<z0 (i32)>& op)
+            {
+                Txt message;
+                message << (i32) (sizeof (ValueType) * 8) << "-bit " << levelName << " " << opName << " speedup over SSE:";
+
+                for (auto num : sizes)
+                {
+                    const auto sseTime = timeOp (op, FloatVectorHelpers::AvxLevel::none, num);
+                    const auto avxTime = timeOp (op, level, num);
+                    message << " " << num << ": " << Txt (sseTime / jmax (avxTime, 1.0e-9), 2) << "x";
+                }
+
+                u.logMessage (message);
+            };
+
+            for (auto& namedOp : createOps ((ValueType) 1))
+                logSpeedups (namedOp.name, [&] (i32 num) { namedOp.op (dest.data(), src1.data(), src2.data(), num); });
+
+            if constexpr (std::is_same_v<ValueType, f32>)
+            {
+                const std::vector<i32> fixed (dest.size(), 1 << 20);
+
+                logSpeedups ("convertFixedToFloat", [&] (i32 num)
+                {
+                    FloatVectorOperations::convertFixedToFloat (dest.data(), fixed.data(), 1.0f / (f32) 0x7fffffff, num);
+                });
+            }
+        }
+    };
+   #endif
+
     z0 runTest() override
     {
         beginTest ("FloatVectorOperations");
@@ -1718,6 +2053,28 @@ public:
             TestRunner<f32>::runTest (*this, getRandom());
             TestRunner<f64>::runTest (*this, getRandom());
         }
+
+       #if DRX_USE_AVX_INTRINSICS
+        const auto testAvxLevel = [this] (FloatVectorHelpers::AvxLevel level, StringRef levelName)
+        {
+            beginTest (Txt (levelName) + " matches SSE");
+
+            for (i32 i = 100; --i >= 0;)
+            {
+                AvxTestRunner<f32>::runTest (*this, getRandom(), level);
+                AvxTestRunner<f64>::runTest (*this, getRandom(), level);
+            }
+
+            AvxTestRunner<f32>::logTimings (*this, level, levelName);
+            AvxTestRunner<f64>::logTimings (*this, level, levelName);
+        };
+
+        if (SystemStats::hasAVX2())
+            testAvxLevel (FloatVectorHelpers::AvxLevel::avx2, "AVX2");
+
+        if (SystemStats::hasAVX512F())
+            testAvxLevel (FloatVectorHelpers::AvxLevel::avx512, "AVX-512");
+       #endif
     }
 };
 
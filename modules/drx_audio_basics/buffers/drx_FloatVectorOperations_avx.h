@@ -0,0 +1,319 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+/*  This file is included once per instruction set by drx_FloatVectorOperations.cpp,
+    between target pragmas and inside a namespace that provides ModeType<Type>::Mode.
+    Don't include it anywhere else.
+*/
+
+template <typename Mode, typename Size, typename VecOp, typename ScalarOp>
+forcedinline z0 perform (typename Mode::Type* dest, Size num, VecOp&& vecOp, ScalarOp&& scalarOp) noexcept
+{
+    auto i = (Size) 0;
+
+    for (; i + (Size) Mode::numParallel <= num; i += (Size) Mode::numParallel)
+        Mode::storeU (dest + i, vecOp (i));
+
+    // GCC doesn't insert vzeroupper into functions that only get AVX from a target pragma, and
+    // the callers are built for SSE, so leaving the upper halves dirty costs them a transition stall
+    _mm256_zeroupper();
+
+    for (; i < num; ++i)
+        dest[i] = scalarOp (i);
+}
+
+template <typename Type, typename Size>
+z0 fill (Type* dest, Type valueToFill, Size num) noexcept
+{
+    using Mode = typename ModeType<Type>::Mode;
+    const auto val = Mode::load1 (valueToFill);
+
+    perform<Mode> (dest, num, [=] (Size)   { return val; },
+                              [=] (Size)   { return valueToFill; });
+}
+
+template <typename Type, typename Size>
+z0 copyWithMultiply (Type* dest, const Type* src, Type multiplier, Size num) noexcept
+{
+    using Mode = typename ModeType<Type>::Mode;
+    const auto mult = Mode::load1 (multiplier);
+
+    perform<Mode> (dest, num, [=] (Size i) { return Mode::mul (mult, Mode::loadU (src + i)); },
+                              [=] (Size i) { return src[i] * multiplier; });
+}
+
+template <typename Type, typename Size>
+z0 add (Type* dest, Type amount, Size num) noexcept
+{
+    using Mode = typename ModeType<Type>::Mode;
+    const auto amountToAdd = Mode::load1 (amount);
+
+    perform<Mode> (dest, num, [=] (Size i) { return Mode::add (Mode::loadU (dest + i), amountToAdd); },
+                              [=] (Size i) { return dest[i] + amount; });
+}
+
+template <typename Type, typename Size>
+z0 add (Type* dest, const Type* src, Type amount, Size num) noexcept
+{
+    using Mode = typename ModeType<Type>::Mode;
+    const auto am = Mode::load1 (amount);
+
+    perform<Mode> (dest, num, [=] (Size i) { return Mode::add (am, Mode::loadU (src + i)); },
+                              [=] (Size i) { return src[i] + amount; });
+}
+
+template <typename Type, typename Size>
+z0 add (Type* dest, const Type* src, Size num) noexcept
+{
+    using Mode = typename ModeType<Type>::Mode;
+
+    perform<Mode> (dest, num, [=] (Size i) { return Mode::add (Mode::loadU (dest + i), Mode::loadU (src + i)); },
+                              [=] (Size i) { return dest[i] + src[i]; });
+}
+
+template <typename Type, typename Size>
+z0 add (Type* dest, const Type* src1, const Type* src2, Size num) noexcept
+{
+    using Mode = typename ModeType<Type>::Mode;
+
+    perform<Mode> (dest, num, [=] (Size i) { return Mode::add (Mode::loadU (src1 + i), Mode::loadU (src2 + i)); },
+                              [=] (Size i) { return src1[i] + src2[i]; });
+}
+
+template <typename Type, typename Size>
+z0 subtract (Type* dest, const Type* src, Size num) noexcept
+{
+    using Mode = typename ModeType<Type>::Mode;
+
+    perform<Mode> (dest, num, [=] (Size i) { return Mode::sub (Mode::loadU (dest + i), Mode::loadU (src + i)); },
+                              [=] (Size i) { return dest[i] - src[i]; });
+}
+
+template <typename Type, typename Size>
+z0 subtract (Type* dest, const Type* src1, const Type* src2, Size num) noexcept
+{
+    using Mode = typename ModeType<Type>::Mode;
+
+    perform<Mode> (dest, num, [=] (Size i) { return Mode::sub (Mode::loadU (src1 + i), Mode::loadU (src2 + i)); },
+                              [=] (Size i) { return src1[i] - src2[i]; });
+}
+
+template <typename Type, typename Size>
+z0 addWithMultiply (Type* dest, const Type* src, Type multiplier, Size num) noexcept
+{
+    using Mode = typename ModeType<Type>::Mode;
+    const auto mult = Mode::load1 (multiplier);
+
+    perform<Mode> (dest, num, [=] (Size i) { return Mode::add (Mode::loadU (dest + i), Mode::mul (mult, Mode::loadU (src + i))); },
+                              [=] (Size i) { return dest[i] + src[i] * multiplier; });
+}
+
+template <typename Type, typename Size>
+z0 addWithMultiply (Type* dest, const Type* src1, const Type* src2, Size num) noexcept
+{
+    using Mode = typename ModeType<Type>::Mode;
+
+    perform<Mode> (dest, num, [=] (Size i) { return Mode::add (Mode::loadU (dest + i), Mode::mul (Mode::loadU (src1 + i), Mode::loadU (src2 + i))); },
+                              [=] (Size i) { return dest[i] + src1[i] * src2[i]; });
+}
+
+template <typename Type, typename Size>
+z0 subtractWithMultiply (Type* dest, const Type* src, Type multiplier, Size num) noexcept
+{
+    using Mode = typename ModeType<Type>::Mode;
+    const auto mult = Mode::load1 (multiplier);
+
+    perform<Mode> (dest, num, [=] (Size i) { return Mode::sub (Mode::loadU (dest + i), Mode::mul (mult, Mode::loadU (src + i))); },
+                              [=] (Size i) { return dest[i] - src[i] * multiplier; });
+}
+
+template <typename Type, typename Size>
+z0 subtractWithMultiply (Type* dest, const Type* src1, const Type* src2, Size num) noexcept
+{
+    using Mode = typename ModeType<Type>::Mode;
+
+    perform<Mode> (dest, num, [=] (Size i) { return Mode::sub (Mode::loadU (dest + i), Mode::mul (Mode::loadU (src1 + i), Mode::loadU (src2 + i))); },
+                              [=] (Size i) { return dest[i] - src1[i] * src2[i]; });
+}
+
+template <typename Type, typename Size>
+z0 multiply (Type* dest, const Type* src, Size num) noexcept
+{
+    using Mode = typename ModeType<Type>::Mode;
+
+    perform<Mode> (dest, num, [=] (Size i) { return Mode::mul (Mode::loadU (dest + i), Mode::loadU (src + i)); },
+                              [=] (Size i) { return dest[i] * src[i]; });
+}
+
+template <typename Type, typename Size>
+z0 multiply (Type* dest, const Type* src1, const Type* src2, Size num) noexcept
+{
+    using Mode = typename ModeType<Type>::Mode;
+
+    perform<Mode> (dest, num, [=] (Size i) { return Mode::mul (Mode::loadU (src1 + i), Mode::loadU (src2 + i)); },
+                              [=] (Size i) { return src1[i] * src2[i]; });
+}
+
+template <typename Type, typename Size>
+z0 multiply (Type* dest, Type multiplier, Size num) noexcept
+{
+    using Mode = typename ModeType<Type>::Mode;
+    const auto mult = Mode::load1 (multiplier);
+
+    perform<Mode> (dest, num, [=] (Size i) { return Mode::mul (Mode::loadU (dest + i), mult); },
+                              [=] (Size i) { return dest[i] * multiplier; });
+}
+
+template <typename Type, typename Size>
+z0 multiply (Type* dest, const Type* src, Type multiplier, Size num) noexcept
+{
+    copyWithMultiply (dest, src, multiplier, num);
+}
+
+template <typename Type, typename Size>
+z0 negate (Type* dest, const Type* src, Size num) noexcept
+{
+    copyWithMultiply (dest, src, (Type) -1, num);
+}
+
+template <typename Type, typename Size>
+z0 abs (Type* dest, const Type* src, Size num) noexcept
+{
+    using Mode = typename ModeType<Type>::Mode;
+    const auto mask = Mode::absMask();
+
+    perform<Mode> (dest, num, [=] (Size i) { return Mode::bit_and (Mode::loadU (src + i), mask); },
+                              [=] (Size i) { return std::abs (src[i]); });
+}
+
+template <typename Type, typename Size>
+z0 min (Type* dest, const Type* src, Type comp, Size num) noexcept
+{
+    using Mode = typename ModeType<Type>::Mode;
+    const auto cmp = Mode::load1 (comp);
+
+    perform<Mode> (dest, num, [=] (Size i) { return Mode::min (Mode::loadU (src + i), cmp); },
+                              [=] (Size i) { return jmin (src[i], comp); });
+}
+
+template <typename Type, typename Size>
+z0 min (Type* dest, const Type* src1, const Type* src2, Size num) noexcept
+{
+    using Mode = typename ModeType<Type>::Mode;
+
+    perform<Mode> (dest, num, [=] (Size i) { return Mode::min (Mode::loadU (src1 + i), Mode::loadU (src2 + i)); },
+                              [=] (Size i) { return jmin (src1[i], src2[i]); });
+}
+
+template <typename Type, typename Size>
+z0 max (Type* dest, const Type* src, Type comp, Size num) noexcept
+{
+    using Mode = typename ModeType<Type>::Mode;
+    const auto cmp = Mode::load1 (comp);
+
+    perform<Mode> (dest, num, [=] (Size i) { return Mode::max (Mode::loadU (src + i), cmp); },
+                              [=] (Size i) { return jmax (src[i], comp); });
+}
+
+template <typename Type, typename Size>
+z0 max (Type* dest, const Type* src1, const Type* src2, Size num) noexcept
+{
+    using Mode = typename ModeType<Type>::Mode;
+
+    perform<Mode> (dest, num, [=] (Size i) { return Mode::max (Mode::loadU (src1 + i), Mode::loadU (src2 + i)); },
+                              [=] (Size i) { return jmax (src1[i], src2[i]); });
+}
+
+template <typename Type, typename Size>
+z0 clip (Type* dest, const Type* src, Type low, Type high, Size num) noexcept
+{
+    jassert (high >= low);
+
+    using Mode = typename ModeType<Type>::Mode;
+    const auto lo = Mode::load1 (low);
+    const auto hi = Mode::load1 (high);
+
+    perform<Mode> (dest, num, [=] (Size i) { return Mode::max (Mode::min (Mode::loadU (src + i), hi), lo); },
+                              [=] (Size i) { return jmax (jmin (src[i], high), low); });
+}
+
+template <typename Type, typename Size>
+Range<Type> findMinAndMax (const Type* src, Size num) noexcept
+{
+    using Mode = typename ModeType<Type>::Mode;
+
+    if (num < (Size) Mode::numParallel * 2)
+        return Range<Type>::findMinAndMax (src, num);
+
+    auto mn = Mode::loadU (src);
+    auto mx = mn;
+    auto i = (Size) Mode::numParallel;
+
+    for (; i + (Size) Mode::numParallel <= num; i += (Size) Mode::numParallel)
+    {
+        const auto v = Mode::loadU (src + i);
+        mn = Mode::min (mn, v);
+        mx = Mode::max (mx, v);
+    }
+
+    Range<Type> result (Mode::min (mn), Mode::max (mx));
+    _mm256_zeroupper();
+
+    for (; i < num; ++i)
+        result = result.getUnionWith (src[i]);
+
+    return result;
+}
+
+template <typename Type, typename Size>
+Type findMinimum (const Type* src, Size num) noexcept
+{
+    return num > 0 ? findMinAndMax (src, num).getStart() : Type();
+}
+
+template <typename Type, typename Size>
+Type findMaximum (const Type* src, Size num) noexcept
+{
+    return num > 0 ? findMinAndMax (src, num).getEnd() : Type();
+}
+
+template <typename Size>
+z0 convertFixedToFloat (f32* dest, i32k* src, f32 multiplier, Size num) noexcept
+{
+    using Mode = typename ModeType<f32>::Mode;
+    const auto mult = Mode::load1 (multiplier);
+
+    perform<Mode> (dest, num, [=] (Size i) { return Mode::mul (mult, Mode::loadInt (src + i)); },
+                              [=] (Size i) { return (f32) src[i] * multiplier; });
+}
@@ -62,6 +62,15 @@
  #undef DRX_USE_VDSP_FRAMEWORK
 #endif
 
+// vDSP already picks the best instruction set for the machine it's running on
+#if DRX_USE_AVX_INTRINSICS && DRX_USE_VDSP_FRAMEWORK
+ #undef DRX_USE_AVX_INTRINSICS
+#endif
+
+#if DRX_USE_AVX_INTRINSICS
+ #include <immintrin.h>
+#endif
+
 #if DRX_USE_ARM_NEON
  #include <arm_neon.h>
 #endif
@@ -74,7 +83,9 @@
 #include "utilities/drx_LagrangeInterpolator.cpp"
 #include "utilities/drx_WindowedSincInterpolator.cpp"
 #include "utilities/drx_Interpolators.cpp"
+#include "utilities/drx_PolyphaseResampler.cpp"
 #include "utilities/drx_SmoothedValue.cpp"
+#include "utilities/drx_RealtimeWorkerThreads.cpp"
 #include "midi/drx_MidiBuffer.cpp"
 #include "midi/drx_MidiFile.cpp"
 #include "midi/drx_MidiKeyboardState.cpp"
@@ -90,6 +101,7 @@
 #include "mpe/drx_MPESynthesiserVoice.cpp"
 #include "mpe/drx_MPESynthesiser.cpp"
 #include "mpe/drx_MPEUtils.cpp"
+#include "sources/drx_ReadAheadScheduler.cpp"
 #include "sources/drx_BufferingAudioSource.cpp"
 #include "sources/drx_ChannelRemappingAudioSource.cpp"
 #include "sources/drx_IIRFilterAudioSource.cpp"
@@ -99,6 +111,7 @@
 #include "sources/drx_ReverbAudioSource.cpp"
 #include "sources/drx_ToneGeneratorAudioSource.cpp"
 #include "sources/drx_PositionableAudioSource.cpp"
+#include "synthesisers/drx_ParallelVoiceRenderer.cpp"
 #include "synthesisers/drx_Synthesiser.cpp"
 #include "audio_play_head/drx_AudioPlayHead.cpp"
 #include "midi/drx_MidiDataConcatenator.h"
@@ -78,6 +78,17 @@
  #undef DRX_USE_SSE_INTRINSICS
 #endif
 
+/*  When enabled, FloatVectorOperations checks the CPU at startup and uses AVX2 or AVX-512
+    versions of its functions where they're available, falling back to SSE otherwise.
+*/
+#ifndef DRX_USE_AVX_INTRINSICS
+ #define DRX_USE_AVX_INTRINSICS 1
+#endif
+
+#if ! DRX_USE_SSE_INTRINSICS
+ #undef DRX_USE_AVX_INTRINSICS
+#endif
+
 #if __ARM_NEON__ && ! (DRX_USE_VDSP_FRAMEWORK || defined (DRX_USE_ARM_NEON))
  #define DRX_USE_ARM_NEON 1
 #endif
@@ -101,9 +112,12 @@ DRX_END_IGNORE_WARNINGS_MSVC
 #include "utilities/drx_IIRFilter.h"
 #include "utilities/drx_GenericInterpolator.h"
 #include "utilities/drx_Interpolators.h"
+#include "utilities/drx_PolyphaseResampler.h"
 #include "utilities/drx_SmoothedValue.h"
 #include "utilities/drx_Reverb.h"
 #include "utilities/drx_ADSR.h"
+#include "utilities/drx_RealtimeWorkerThreads.h"
+#include "synthesisers/drx_ParallelVoiceRenderer.h"
 #include "midi/drx_MidiMessage.h"
 #include "midi/drx_MidiBuffer.h"
 #include "midi/drx_MidiMessageSequence.h"
@@ -121,6 +135,7 @@ DRX_END_IGNORE_WARNINGS_MSVC
 #include "mpe/drx_MPEUtils.h"
 #include "sources/drx_AudioSource.h"
 #include "sources/drx_PositionableAudioSource.h"
+#include "sources/drx_ReadAheadScheduler.h"
 #include "sources/drx_BufferingAudioSource.h"
 #include "sources/drx_ChannelRemappingAudioSource.h"
 #include "sources/drx_IIRFilterAudioSource.h"
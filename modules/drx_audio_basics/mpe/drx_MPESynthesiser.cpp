@@ -276,6 +276,7 @@ z0 MPESynthesiser::addVoice (MPESynthesiserVoice* const newVoice)
         const ScopedLock sl (voicesLock);
         newVoice->setCurrentSampleRate (getSampleRate());
         voices.add (newVoice);
+        voicesToRender.ensureStorageAllocated (voices.size());
     }
 
     {
@@ -340,9 +341,34 @@ z0 MPESynthesiser::turnOffAllVoices (b8 allowTailOff)
 
 //==============================================================================
 z0 MPESynthesiser::renderNextSubBlock (AudioBuffer<f32>& buffer, i32 startSample, i32 numSamples)
+{
+    renderActiveVoices (buffer, startSample, numSamples);
+}
+
+z0 MPESynthesiser::renderNextSubBlock (AudioBuffer<f64>& buffer, i32 startSample, i32 numSamples)
+{
+    renderActiveVoices (buffer, startSample, numSamples);
+}
+
+template <typename FloatType>
+z0 MPESynthesiser::renderActiveVoices (AudioBuffer<FloatType>& buffer, i32 startSample, i32 numSamples)
 {
     const ScopedLock sl (voicesLock);
 
+    if (parallelRenderer != nullptr)
+    {
+        voicesToRender.clearQuick();
+
+        for (auto* voice : voices)
+            if (voice->isActive())
+                voicesToRender.add (voice);
+
+        if (voicesToRender.size() > 1
+             && parallelRenderer->render (voicesToRender.getRawDataPointer(), voicesToRender.size(),
+                                          buffer, startSample, numSamples))
+            return;
+    }
+
     for (auto* voice : voices)
     {
         if (voice->isActive())
@@ -350,15 +376,22 @@ z0 MPESynthesiser::renderNextSubBlock (AudioBuffer<f32>& buffer, i32 startSample
     }
 }
 
-z0 MPESynthesiser::renderNextSubBlock (AudioBuffer<f64>& buffer, i32 startSample, i32 numSamples)
+//==============================================================================
+z0 MPESynthesiser::setNumParallelRenderThreads (i32 numThreads, i32 maxNumChannels)
 {
+    jassert (numThreads >= 0);
+
+    auto newRenderer = numThreads > 0 ? std::make_unique<ParallelVoiceRenderer> (numThreads, maxNumChannels)
+                                      : nullptr;
+
     const ScopedLock sl (voicesLock);
+    voicesToRender.ensureStorageAllocated (voices.size());
+    std::swap (parallelRenderer, newRenderer);
+}
 
-    for (auto* voice : voices)
-    {
-        if (voice->isActive())
-            voice->renderNextBlock (buffer, startSample, numSamples);
-    }
+i32 MPESynthesiser::getNumParallelRenderThreads() const noexcept
+{
+    return parallelRenderer != nullptr ? parallelRenderer->getNumThreads() : 0;
 }
 
 } // namespace drx
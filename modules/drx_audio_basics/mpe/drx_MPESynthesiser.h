@@ -147,6 +147,28 @@ public:
     */
     z0 setCurrentPlaybackSampleRate (f64 newRate) override;
 
+    //==============================================================================
+    /** Makes the synthesiser render its voices on several threads at once.
+
+        Once this is enabled, the default renderNextSubBlock() methods share the active
+        voices out between the audio thread and a set of realtime worker threads, using a
+        ParallelVoiceRenderer. The voices must not share any state that they modify while
+        rendering, and the output can differ from a serial render by rounding errors.
+
+        This starts or stops threads, so don't call it from the audio thread.
+
+        @param numThreads       the number of worker threads to start, or 0 to go back
+                                to rendering all the voices on the audio thread
+        @param maxNumChannels   the largest number of channels that will be rendered. Blocks
+                                with more channels than this are rendered serially
+
+        @see Synthesiser::setNumParallelRenderThreads
+    */
+    z0 setNumParallelRenderThreads (i32 numThreads, i32 maxNumChannels = 2);
+
+    /** Returns the number of worker threads set by setNumParallelRenderThreads(). */
+    i32 getNumParallelRenderThreads() const noexcept;
+
     //==============================================================================
     /** Handle incoming MIDI events.
 
@@ -318,6 +340,11 @@ private:
     u32 lastNoteOnCounter = 0;
     mutable CriticalSection stealLock;
     mutable Array<MPESynthesiserVoice*> usableVoicesToStealArray;
+    std::unique_ptr<ParallelVoiceRenderer> parallelRenderer;
+    Array<MPESynthesiserVoice*> voicesToRender;
+
+    template <typename FloatType>
+    z0 renderActiveVoices (AudioBuffer<FloatType>&, i32 startSample, i32 numSamples);
 
     DRX_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MPESynthesiser)
 };
@@ -41,8 +41,32 @@ BufferingAudioSource::BufferingAudioSource (PositionableAudioSource* s,
                                             i32 bufferSizeSamples,
                                             i32 numChannels,
                                             b8 prefillBufferOnPrepareToPlay)
+    : BufferingAudioSource (s, &thread, nullptr, deleteSourceWhenDeleted,
+                            bufferSizeSamples, numChannels, prefillBufferOnPrepareToPlay)
+{
+}
+
+BufferingAudioSource::BufferingAudioSource (PositionableAudioSource* s,
+                                            ReadAheadScheduler& readAheadScheduler,
+                                            b8 deleteSourceWhenDeleted,
+                                            i32 bufferSizeSamples,
+                                            i32 numChannels,
+                                            b8 prefillBufferOnPrepareToPlay)
+    : BufferingAudioSource (s, nullptr, &readAheadScheduler, deleteSourceWhenDeleted,
+                            bufferSizeSamples, numChannels, prefillBufferOnPrepareToPlay)
+{
+}
+
+BufferingAudioSource::BufferingAudioSource (PositionableAudioSource* s,
+                                            TimeSliceThread* thread,
+                                            ReadAheadScheduler* readAheadScheduler,
+                                            b8 deleteSourceWhenDeleted,
+                                            i32 bufferSizeSamples,
+                                            i32 numChannels,
+                                            b8 prefillBufferOnPrepareToPlay)
     : source (s, deleteSourceWhenDeleted),
       backgroundThread (thread),
+      scheduler (readAheadScheduler),
       numberOfSamplesToBuffer (jmax (1024, bufferSizeSamples)),
       numberOfChannels (numChannels),
       prefillBuffer (prefillBufferOnPrepareToPlay)
@@ -67,7 +91,7 @@ z0 BufferingAudioSource::prepareToPlay (i32 samplesPerBlockExpected, f64 newSamp
          || bufferSizeNeeded != buffer.getNumSamples()
          || ! isPrepared)
     {
-        backgroundThread.removeTimeSliceClient (this);
+        stopBackgroundReading();
 
         isPrepared = true;
         sampleRate = newSampleRate;
@@ -79,16 +103,14 @@ z0 BufferingAudioSource::prepareToPlay (i32 samplesPerBlockExpected, f64 newSamp
 
         const ScopedLock sl (bufferRangeLock);
 
-        bufferValidStart = 0;
-        bufferValidEnd = 0;
-
-        backgroundThread.addTimeSliceClient (this);
+        setValidBufferRange (0, 0);
+        startBackgroundReading();
 
         do
         {
             const ScopedUnlock ul (bufferRangeLock);
 
-            backgroundThread.moveToFrontOfQueue (this);
+            prioritiseBackgroundReading();
             Thread::sleep (5);
         }
         while (prefillBuffer
@@ -99,7 +121,7 @@ z0 BufferingAudioSource::prepareToPlay (i32 samplesPerBlockExpected, f64 newSamp
 z0 BufferingAudioSource::releaseResources()
 {
     isPrepared = false;
-    backgroundThread.removeTimeSliceClient (this);
+    stopBackgroundReading();
 
     buffer.setSize (numberOfChannels, 0);
 
@@ -227,7 +249,7 @@ z0 BufferingAudioSource::setNextReadPosition (z64 newPosition)
     const ScopedLock sl (bufferRangeLock);
 
     nextPlayPos = newPosition;
-    backgroundThread.moveToFrontOfQueue (this);
+    prioritiseBackgroundReading();
 }
 
 Range<i32> BufferingAudioSource::getValidBufferRange (i32 numSamples) const
@@ -240,6 +262,13 @@ Range<i32> BufferingAudioSource::getValidBufferRange (i32 numSamples) const
              (i32) (jlimit (bufferValidStart, bufferValidEnd, pos + numSamples) - pos) };
 }
 
+z0 BufferingAudioSource::setValidBufferRange (z64 start, z64 end) noexcept
+{
+    bufferValidStart = start;
+    bufferValidEnd = end;
+    bufferedEnd = end;
+}
+
 b8 BufferingAudioSource::readNextBufferChunk()
 {
     z64 newBVS, newBVE, sectionToReadStart, sectionToReadEnd;
@@ -250,8 +279,7 @@ b8 BufferingAudioSource::readNextBufferChunk()
         if (wasSourceLooping != isLooping())
         {
             wasSourceLooping = isLooping();
-            bufferValidStart = 0;
-            bufferValidEnd = 0;
+            setValidBufferRange (0, 0);
         }
 
         newBVS = jmax ((z64) 0, nextPlayPos.load());
@@ -268,8 +296,7 @@ b8 BufferingAudioSource::readNextBufferChunk()
             sectionToReadStart = newBVS;
             sectionToReadEnd = newBVE;
 
-            bufferValidStart = 0;
-            bufferValidEnd = 0;
+            setValidBufferRange (0, 0);
         }
         else if (std::abs ((i32) (newBVS - bufferValidStart)) > 512
                   || std::abs ((i32) (newBVE - bufferValidEnd)) > 512)
@@ -279,8 +306,7 @@ b8 BufferingAudioSource::readNextBufferChunk()
             sectionToReadStart = bufferValidEnd;
             sectionToReadEnd = newBVE;
 
-            bufferValidStart = newBVS;
-            bufferValidEnd = jmin (bufferValidEnd, newBVE);
+            setValidBufferRange (newBVS, jmin (bufferValidEnd, newBVE));
         }
     }
 
@@ -313,9 +339,7 @@ b8 BufferingAudioSource::readNextBufferChunk()
 
     {
         const ScopedLock sl2 (bufferRangeLock);
-
-        bufferValidStart = newBVS;
-        bufferValidEnd = newBVE;
+        setValidBufferRange (newBVS, newBVE);
     }
 
     bufferReadyEvent.signal();
@@ -333,9 +357,60 @@ z0 BufferingAudioSource::readBufferSection (z64 start, i32 length, i32 bufferOff
     source->getNextAudioBlock (info);
 }
 
+//==============================================================================
+z0 BufferingAudioSource::startBackgroundReading()
+{
+    if (scheduler != nullptr)
+        scheduler->addClient (this);
+    else
+        backgroundThread->addTimeSliceClient (this);
+}
+
+z0 BufferingAudioSource::stopBackgroundReading()
+{
+    if (scheduler != nullptr)
+        scheduler->removeClient (this);
+    else
+        backgroundThread->removeTimeSliceClient (this);
+}
+
+z0 BufferingAudioSource::prioritiseBackgroundReading()
+{
+    if (scheduler != nullptr)
+        scheduler->notify (this);
+    else
+        backgroundThread->moveToFrontOfQueue (this);
+}
+
 i32 BufferingAudioSource::useTimeSlice()
 {
     return readNextBufferChunk() ? 1 : 100;
 }
 
+b8 BufferingAudioSource::readAhead()
+{
+    return readNextBufferChunk();
+}
+
+// These two are called by the scheduler without taking bufferRangeLock, so they only use
+// the atomic copies of the buffer state. The sample rate and buffer size only change while
+// the source is unregistered.
+f64 BufferingAudioSource::getSecondsBuffered() const
+{
+    if (sampleRate <= 0)
+        return 0.0;
+
+    return (f64) jmax ((z64) 0, bufferedEnd.load() - nextPlayPos.load()) / sampleRate;
+}
+
+f32 BufferingAudioSource::getBufferFillLevel() const
+{
+    const auto size = buffer.getNumSamples();
+
+    if (size <= 0)
+        return 0.0f;
+
+    return jlimit (0.0f, 1.0f, (f32) (bufferedEnd.load() - nextPlayPos.load()) / (f32) size);
+}
+
 } // namespace drx
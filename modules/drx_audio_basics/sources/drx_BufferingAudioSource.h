@@ -43,12 +43,16 @@ namespace drx
     a background thread to smooth out playback. You can either create one of these
     directly, or use it indirectly using an AudioTransportSource.
 
-    @see PositionableAudioSource, AudioTransportSource
+    The read-ahead can either be done by a TimeSliceThread, or by a ReadAheadScheduler,
+    which is a better choice when many sources are being streamed at once.
+
+    @see PositionableAudioSource, AudioTransportSource, ReadAheadScheduler
 
     @tags{Audio}
 */
 class DRX_API  BufferingAudioSource  : public PositionableAudioSource,
-                                        private TimeSliceClient
+                                        private TimeSliceClient,
+                                        private ReadAheadScheduler::Client
 {
 public:
     //==============================================================================
@@ -73,6 +77,19 @@ public:
                           i32 numberOfChannels = 2,
                           b8 prefillBufferOnPrepareToPlay = true);
 
+    /** Creates a BufferingAudioSource which is read by a ReadAheadScheduler.
+
+        The scheduler must not be deleted until after any BufferingAudioSources that are
+        using it have been deleted. The other parameters are the same as for the constructor
+        which takes a TimeSliceThread.
+    */
+    BufferingAudioSource (PositionableAudioSource* source,
+                          ReadAheadScheduler& scheduler,
+                          b8 deleteSourceWhenDeleted,
+                          i32 numberOfSamplesToBuffer,
+                          i32 numberOfChannels = 2,
+                          b8 prefillBufferOnPrepareToPlay = true);
+
     /** Destructor.
 
         The input source may be deleted depending on whether the deleteSourceWhenDeleted
@@ -111,20 +128,33 @@ public:
 
 private:
     //==============================================================================
+    BufferingAudioSource (PositionableAudioSource*, TimeSliceThread*, ReadAheadScheduler*,
+                          b8 deleteSourceWhenDeleted, i32 numberOfSamplesToBuffer,
+                          i32 numberOfChannels, b8 prefillBufferOnPrepareToPlay);
+
     Range<i32> getValidBufferRange (i32 numSamples) const;
+    z0 setValidBufferRange (z64 start, z64 end) noexcept;
     b8 readNextBufferChunk();
     z0 readBufferSection (z64 start, i32 length, i32 bufferOffset);
+    z0 startBackgroundReading();
+    z0 stopBackgroundReading();
+    z0 prioritiseBackgroundReading();
+
     i32 useTimeSlice() override;
+    b8 readAhead() override;
+    f64 getSecondsBuffered() const override;
+    f32 getBufferFillLevel() const override;
 
     //==============================================================================
     OptionalScopedPointer<PositionableAudioSource> source;
-    TimeSliceThread& backgroundThread;
+    TimeSliceThread* backgroundThread = nullptr;
+    ReadAheadScheduler* scheduler = nullptr;
     i32 numberOfSamplesToBuffer, numberOfChannels;
     AudioBuffer<f32> buffer;
     CriticalSection callbackLock, bufferRangeLock;
     WaitableEvent bufferReadyEvent;
     z64 bufferValidStart = 0, bufferValidEnd = 0;
-    std::atomic<z64> nextPlayPos { 0 };
+    std::atomic<z64> nextPlayPos { 0 }, bufferedEnd { 0 };
     f64 sampleRate = 0;
     b8 wasSourceLooping = false, isPrepared = false;
     const b8 prefillBuffer;
@@ -0,0 +1,580 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace drx
+{
+
+class ReadAheadScheduler::Worker final : public Thread
+{
+public:
+    Worker (ReadAheadScheduler& s, const Txt& name)  : Thread (name), owner (s) {}
+
+    z0 run() override     { owner.runWorker (*this); }
+
+private:
+    ReadAheadScheduler& owner;
+
+    DRX_DECLARE_NON_COPYABLE (Worker)
+};
+
+//==============================================================================
+ReadAheadScheduler::ReadAheadScheduler (const Txt& name, i32 numThreads)
+{
+    if (numThreads <= 0)
+        numThreads = jlimit (1, 8, SystemStats::getNumCpus());
+
+    for (i32 i = 0; i < numThreads; ++i)
+        workers.add (new Worker (*this, name + " " + Txt (i + 1)))->startThread (Thread::Priority::high);
+}
+
+ReadAheadScheduler::~ReadAheadScheduler()
+{
+    // You need to remove all your clients before deleting the scheduler!
+    jassert (clients.isEmpty());
+
+    for (auto* w : workers)
+        w->signalThreadShouldExit();
+
+    wakeAllWorkers();
+
+    for (auto* w : workers)
+        w->stopThread (4000);
+}
+
+//==============================================================================
+z0 ReadAheadScheduler::addClient (Client* clientToAdd)
+{
+    if (clientToAdd == nullptr)
+        return;
+
+    {
+        const ScopedLock sl (lock);
+
+        if (findClientInfo (clientToAdd) != nullptr)
+            return;
+
+        clients.add (new ClientInfo { clientToAdd });
+    }
+
+    wakeAllWorkers();
+}
+
+z0 ReadAheadScheduler::removeClient (Client* clientToRemove)
+{
+    const ScopedLock sl (lock);
+
+    if (auto* info = findClientInfo (clientToRemove))
+    {
+        info->isBeingRemoved = true;
+
+        while (info->isBeingCalled)
+        {
+            const ScopedUnlock ul (lock);
+            callFinishedEvent.wait (5);
+        }
+
+        clients.removeObject (info);
+    }
+}
+
+b8 ReadAheadScheduler::contains (const Client* client) const
+{
+    const ScopedLock sl (lock);
+    return findClientInfo (client) != nullptr;
+}
+
+i32 ReadAheadScheduler::getNumClients() const
+{
+    const ScopedLock sl (lock);
+    return clients.size();
+}
+
+z0 ReadAheadScheduler::notify (Client* client)
+{
+    {
+        const ScopedLock sl (lock);
+
+        auto* info = findClientInfo (client);
+
+        if (info == nullptr)
+            return;
+
+        info->nextCallTime = 0;
+        info->wasNotifiedDuringCall = info->isBeingCalled;
+    }
+
+    wakeAllWorkers();
+}
+
+z0 ReadAheadScheduler::setPollInterval (i32 milliseconds) noexcept
+{
+    pollIntervalMs = jlimit (1, idleIntervalMs, milliseconds);
+}
+
+ReadAheadScheduler::Metrics ReadAheadScheduler::getMetrics() const
+{
+    const ScopedLock sl (lock);
+
+    Metrics m;
+    m.numClients = clients.size();
+    m.numReads = numReads;
+    m.numReadsWhileEmpty = numReadsWhileEmpty;
+
+    if (clients.isEmpty())
+        return m;
+
+    m.minimumFillLevel = 1.0f;
+    m.minimumSecondsBuffered = std::numeric_limits<f64>::max();
+    f64 totalFillLevel = 0;
+
+    for (auto* info : clients)
+    {
+        const auto fillLevel = info->client->getBufferFillLevel();
+        m.minimumFillLevel = jmin (m.minimumFillLevel, fillLevel);
+        m.maximumFillLevel = jmax (m.maximumFillLevel, fillLevel);
+        m.minimumSecondsBuffered = jmin (m.minimumSecondsBuffered, info->client->getSecondsBuffered());
+        totalFillLevel += fillLevel;
+
+        if (info->isBeingCalled)
+            ++m.numActiveReads;
+    }
+
+    m.averageFillLevel = (f32) (totalFillLevel / clients.size());
+    return m;
+}
+
+//==============================================================================
+ReadAheadScheduler::ClientInfo* ReadAheadScheduler::findClientInfo (const Client* client) const noexcept
+{
+    for (auto* info : clients)
+        if (info->client == client)
+            return info;
+
+    return nullptr;
+}
+
+ReadAheadScheduler::ClientInfo* ReadAheadScheduler::chooseNextClient (f64 now, f64& msUntilNextClient)
+{
+    ClientInfo* best = nullptr;
+    f64 bestSecondsBuffered = 0;
+
+    for (auto* info : clients)
+    {
+        if (info->isBeingCalled || info->isBeingRemoved)
+            continue;
+
+        if (info->nextCallTime > now && ! info->client->isReadAheadNeeded())
+        {
+            msUntilNextClient = jmin (msUntilNextClient, info->nextCallTime - now);
+            continue;
+        }
+
+        // The client that will run out of data soonest gets served first
+        const auto secondsBuffered = info->client->getSecondsBuffered();
+
+        if (best == nullptr || secondsBuffered < bestSecondsBuffered)
+        {
+            best = info;
+            bestSecondsBuffered = secondsBuffered;
+        }
+    }
+
+    if (best != nullptr)
+    {
+        best->isBeingCalled = true;
+        ++numReads;
+
+        if (bestSecondsBuffered <= 0)
+            ++numReadsWhileEmpty;
+    }
+
+    return best;
+}
+
+z0 ReadAheadScheduler::wakeAllWorkers()
+{
+    for (auto* w : workers)
+        w->notify();
+}
+
+z0 ReadAheadScheduler::runWorker (Thread& thread)
+{
+    while (! thread.threadShouldExit())
+    {
+        ClientInfo* info = nullptr;
+        auto msToWait = (f64) pollIntervalMs.load();
+
+        {
+            const ScopedLock sl (lock);
+            info = chooseNextClient (Time::getMillisecondCounterHiRes(), msToWait);
+        }
+
+        if (info == nullptr)
+        {
+            thread.wait (jmax (1, roundToInt (msToWait)));
+            continue;
+        }
+
+        const auto hasMoreToRead = info->client->readAhead();
+
+        {
+            const ScopedLock sl (lock);
+            const auto needsAnotherCall = hasMoreToRead || info->wasNotifiedDuringCall;
+            info->isBeingCalled = false;
+            info->wasNotifiedDuringCall = false;
+            info->nextCallTime = needsAnotherCall ? 0.0 : Time::getMillisecondCounterHiRes() + idleIntervalMs;
+        }
+
+        callFinishedEvent.signal();
+    }
+}
+
+//==============================================================================
+#if DRX_UNIT_TESTS
+
+class ReadAheadSchedulerTests final : public UnitTest
+{
+public:
+    ReadAheadSchedulerTests()
+        : UnitTest ("ReadAheadScheduler", UnitTestCategories::audio)
+    {
+    }
+
+    struct TestClient final : public ReadAheadScheduler::Client
+    {
+        explicit TestClient (f64 seconds)  : secondsBuffered (seconds) {}
+
+        b8 readAhead() override
+        {
+            const auto active = ++numActiveCalls;
+            wasCalledConcurrently = wasCalledConcurrently || active > 1;
+
+            if (onRead != nullptr)
+                onRead (*this);
+
+            ++numCalls;
+            --numActiveCalls;
+            return numCalls < numReadsWanted;
+        }
+
+        f64 getSecondsBuffered() const override     { return secondsBuffered; }
+        f32 getBufferFillLevel() const override     { return (f32) jmin (1.0, secondsBuffered.load() / 10.0); }
+        b8 isReadAheadNeeded() const override      { return needsRead; }
+
+        std::atomic<f64> secondsBuffered;
+        std::atomic<b8> needsRead { false };
+        std::atomic<i32> numCalls { 0 }, numActiveCalls { 0 };
+        std::atomic<b8> wasCalledConcurrently { false };
+        i32 numReadsWanted = 1;
+        std::function<z0 (TestClient&)> onRead;
+    };
+
+    static b8 waitUntil (std::function<b8()> condition)
+    {
+        for (i32 i = 0; i < 2000; ++i)
+        {
+            if (condition())
+                return true;
+
+            Thread::sleep (1);
+        }
+
+        return false;
+    }
+
+    z0 runTest() override
+    {
+        beginTest ("The client with the least buffered is served first");
+        {
+            ReadAheadScheduler scheduler ("Test", 1);
+
+            // This keeps the only thread busy while the other clients are added
+            WaitableEvent blockerStarted, releaseBlocker;
+            TestClient blocker (100.0);
+            blocker.onRead = [&] (TestClient&) { blockerStarted.signal(); releaseBlocker.wait (5000); };
+
+            scheduler.addClient (&blocker);
+            expect (blockerStarted.wait (5000));
+
+            CriticalSection orderLock;
+            Array<i32> order;
+            TestClient clients[] = { TestClient (2.0), TestClient (0.1), TestClient (1.0), TestClient (0.0) };
+
+            for (i32 i = 0; i < 4; ++i)
+            {
+                clients[i].onRead = [&, i] (TestClient&) { const ScopedLock sl (orderLock); order.add (i); };
+                scheduler.addClient (&clients[i]);
+            }
+
+            releaseBlocker.signal();
+            expect (waitUntil ([&] { const ScopedLock sl (orderLock); return order.size() == 4; }));
+            expect (order == Array<i32> (3, 1, 2, 0));
+
+            for (auto& c : clients)
+                scheduler.removeClient (&c);
+
+            scheduler.removeClient (&blocker);
+            expectEquals (scheduler.getNumClients(), 0);
+        }
+
+        beginTest ("Slow clients don't hold up the others");
+        {
+            ReadAheadScheduler scheduler ("Test", 4);
+            expectEquals (scheduler.getNumThreads(), 4);
+
+            OwnedArray<TestClient> clients;
+            std::atomic<i32> numActive { 0 }, maxActive { 0 };
+
+            for (i32 i = 0; i < 8; ++i)
+            {
+                auto* c = clients.add (new TestClient (0.0));
+                c->numReadsWanted = 5;
+                c->onRead = [&] (TestClient&)
+                {
+                    const auto active = ++numActive;
+
+                    for (auto m = maxActive.load(); active > m && ! maxActive.compare_exchange_weak (m, active);)
+                    {}
+
+                    Thread::sleep (10);
+                    --numActive;
+                };
+
+                scheduler.addClient (c);
+            }
+
+            expect (waitUntil ([&] { return std::all_of (clients.begin(), clients.end(), [] (auto* c) { return c->numCalls >= 5; }); }));
+            expect (maxActive > 1);
+
+            for (auto* c : clients)
+            {
+                expect (! c->wasCalledConcurrently);
+                scheduler.removeClient (c);
+            }
+
+            const auto metrics = scheduler.getMetrics();
+            expectEquals (metrics.numClients, 0);
+            expect (metrics.numReads >= 40);
+        }
+
+        beginTest ("Removing a client waits for its current read to finish");
+        {
+            ReadAheadScheduler scheduler ("Test", 2);
+
+            WaitableEvent started;
+            std::atomic<b8> finished { false };
+            TestClient client (0.0);
+            client.onRead = [&] (TestClient&) { started.signal(); Thread::sleep (50); finished = true; };
+
+            scheduler.addClient (&client);
+            expect (started.wait (5000));
+            scheduler.removeClient (&client);
+            expect (finished.load());
+            expect (! scheduler.contains (&client));
+        }
+
+        beginTest ("Notifying a client wakes it up");
+        {
+            ReadAheadScheduler scheduler ("Test", 1);
+            TestClient client (1.0);
+
+            scheduler.addClient (&client);
+            expect (waitUntil ([&] { return client.numCalls == 1; }));
+
+            // Without a notification, a full client isn't called again until its idle period expires
+            Thread::sleep (20);
+            expectEquals (client.numCalls.load(), 1);
+
+            scheduler.notify (&client);
+            expect (waitUntil ([&] { return client.numCalls == 2; }));
+
+            scheduler.removeClient (&client);
+        }
+
+        beginTest ("A client can ask for a read without notifying");
+        {
+            ReadAheadScheduler scheduler ("Test", 1);
+            scheduler.setPollInterval (2);
+            expectEquals (scheduler.getPollInterval(), 2);
+
+            TestClient client (1.0);
+            scheduler.addClient (&client);
+            expect (waitUntil ([&] { return client.numCalls == 1; }));
+
+            Thread::sleep (20);
+            expectEquals (client.numCalls.load(), 1);
+
+            client.needsRead = true;
+            expect (waitUntil ([&] { return client.numCalls >= 2; }));
+            client.needsRead = false;
+
+            scheduler.removeClient (&client);
+        }
+
+        beginTest ("Metrics");
+        {
+            ReadAheadScheduler scheduler ("Test", 1);
+            TestClient a (0.5), b (5.0);
+
+            scheduler.addClient (&a);
+            scheduler.addClient (&b);
+            expect (waitUntil ([&] { return a.numCalls == 1 && b.numCalls == 1; }));
+
+            const auto metrics = scheduler.getMetrics();
+            expectEquals (metrics.numClients, 2);
+            expect (metrics.numReads >= 2);
+            expectEquals (metrics.numReadsWhileEmpty, (z64) 0);
+            expectWithinAbsoluteError (metrics.minimumSecondsBuffered, 0.5, 1.0e-9);
+            expectWithinAbsoluteError (metrics.minimumFillLevel, 0.05f, 1.0e-6f);
+            expectWithinAbsoluteError (metrics.maximumFillLevel, 0.5f, 1.0e-6f);
+            expectWithinAbsoluteError (metrics.averageFillLevel, 0.275f, 1.0e-6f);
+
+            scheduler.removeClient (&a);
+            scheduler.removeClient (&b);
+        }
+
+        beginTest ("BufferingAudioSource can use a scheduler");
+        {
+            ReadAheadScheduler scheduler ("Test", 2);
+            auto random = getRandom();
+
+            AudioBuffer<f32> data (2, 50000);
+
+            for (i32 ch = 0; ch < data.getNumChannels(); ++ch)
+                for (i32 i = 0; i < data.getNumSamples(); ++i)
+                    data.setSample (ch, i, random.nextFloat());
+
+            BufferingAudioSource source (new MemoryAudioSource (data, false), scheduler, true, 8192);
+            source.prepareToPlay (512, 44100.0);
+            expectEquals (scheduler.getNumClients(), 1);
+
+            AudioBuffer<f32> block (2, 512);
+            b8 allMatch = true;
+
+            for (i32 pos = 0; pos + 512 <= data.getNumSamples(); pos += 512)
+            {
+                const AudioSourceChannelInfo info (block);
+                expect (source.waitForNextAudioBlockReady (info, 5000));
+                source.getNextAudioBlock (info);
+
+                for (i32 ch = 0; ch < 2; ++ch)
+                    allMatch = allMatch && std::equal (block.getReadPointer (ch), block.getReadPointer (ch) + 512, data.getReadPointer (ch, pos));
+            }
+
+            expect (allMatch);
+
+            source.releaseResources();
+            expectEquals (scheduler.getNumClients(), 0);
+        }
+
+        beginTest ("Comparison with a TimeSliceThread when one stream is slow");
+        {
+            // 31 streams each need 10 reads of 1ms, while one stream takes 30ms for each read
+            constexpr i32 numClients = 32, numReadsEach = 10;
+
+            auto makeClients = [] (OwnedArray<TestClient>& clients)
+            {
+                for (i32 i = 0; i < numClients; ++i)
+                {
+                    auto* c = clients.add (new TestClient (0.0));
+                    c->numReadsWanted = numReadsEach;
+                    c->onRead = [delay = i == 0 ? 30 : 1] (TestClient& self)
+                    {
+                        Thread::sleep (delay);
+                        self.secondsBuffered = self.secondsBuffered + 0.1;
+                    };
+                }
+            };
+
+            auto fastClientsFinished = [] (const OwnedArray<TestClient>& clients)
+            {
+                return std::all_of (clients.begin() + 1, clients.end(), [] (auto* c) { return c->numCalls >= numReadsEach; });
+            };
+
+            f64 schedulerMs = 0, threadMs = 0;
+
+            {
+                OwnedArray<TestClient> clients;
+                makeClients (clients);
+
+                ReadAheadScheduler scheduler ("Test", 4);
+                const auto start = Time::getMillisecondCounterHiRes();
+
+                for (auto* c : clients)
+                    scheduler.addClient (c);
+
+                expect (waitUntil ([&] { return fastClientsFinished (clients); }));
+                schedulerMs = Time::getMillisecondCounterHiRes() - start;
+
+                for (auto* c : clients)
+                    scheduler.removeClient (c);
+            }
+
+            {
+                struct SliceClient final : public TimeSliceClient
+                {
+                    explicit SliceClient (TestClient& c)  : client (c) {}
+                    i32 useTimeSlice() override   { return client.readAhead() ? 0 : 100; }
+                    TestClient& client;
+                };
+
+                OwnedArray<TestClient> clients;
+                makeClients (clients);
+
+                OwnedArray<SliceClient> sliceClients;
+                TimeSliceThread thread ("Test");
+                thread.startThread();
+                const auto start = Time::getMillisecondCounterHiRes();
+
+                for (auto* c : clients)
+                    thread.addTimeSliceClient (sliceClients.add (new SliceClient (*c)));
+
+                expect (waitUntil ([&] { return fastClientsFinished (clients); }));
+                threadMs = Time::getMillisecondCounterHiRes() - start;
+                thread.removeAllClients();
+            }
+
+            logMessage ("  time for the fast streams to fill: ReadAheadScheduler " + Txt (schedulerMs, 1)
+                          + " ms, TimeSliceThread " + Txt (threadMs, 1) + " ms");
+            expect (schedulerMs < threadMs);
+        }
+    }
+};
+
+static ReadAheadSchedulerTests readAheadSchedulerTests;
+
+#endif
+
+} // namespace drx
@@ -0,0 +1,219 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace drx
+{
+
+//==============================================================================
+/**
+    Runs background read-ahead for a set of streaming clients on a pool of threads.
+
+    A TimeSliceThread visits its clients in turn on a single thread, so one slow
+    client holds up all the others. A ReadAheadScheduler instead keeps several threads
+    busy, and whenever a thread becomes free it serves the client that has the least
+    audio buffered, so that the stream which is closest to running dry is always
+    refilled first. While one thread is blocked on a slow disk read or decode, the
+    others carry on refilling the other streams.
+
+    A client is never called by more than one thread at a time, so its readAhead()
+    method doesn't need to be re-entrant.
+
+    BufferingAudioSource and BufferingAudioReader can both be given one of these
+    instead of a TimeSliceThread.
+
+    @see BufferingAudioSource, TimeSliceThread
+
+    @tags{Audio}
+*/
+class DRX_API  ReadAheadScheduler
+{
+public:
+    //==============================================================================
+    /** A stream that can be registered with a ReadAheadScheduler. */
+    class DRX_API  Client
+    {
+    public:
+        /** Destructor. */
+        virtual ~Client() = default;
+
+        /** Reads the next chunk of data into the client's buffer.
+
+            This is called on one of the scheduler's threads, and should do a reasonably
+            small amount of work before returning.
+
+            @returns true if there's more data to read, or false if the buffer is full, in
+                     which case the client won't be called again for a short while, unless
+                     ReadAheadScheduler::notify() is called for it.
+        */
+        virtual b8 readAhead() = 0;
+
+        /** Returns the number of seconds of audio which are ready to be played, beyond
+            the client's current play position.
+
+            The scheduler uses this to decide which client to serve next. It's called
+            frequently, from any thread, while the scheduler holds its internal lock, so it
+            must be quick, and must not block or call back into the scheduler.
+        */
+        virtual f64 getSecondsBuffered() const = 0;
+
+        /** Returns how full the client's buffer is, from 0 to 1.
+
+            This is only used to report the scheduler's metrics, and has the same threading
+            requirements as getSecondsBuffered().
+        */
+        virtual f32 getBufferFillLevel() const = 0;
+
+        /** Lets a client ask for a read without calling ReadAheadScheduler::notify().
+
+            notify() takes a lock, so it can't be used from a real-time thread. A client
+            can instead return true from this method once it has work to do, and the next
+            scheduler thread to wake up will call it even if its idle period hasn't expired.
+            The threads wake up at least as often as the poll interval, see
+            ReadAheadScheduler::setPollInterval().
+
+            This has the same threading requirements as getSecondsBuffered().
+        */
+        virtual b8 isReadAheadNeeded() const                { return false; }
+    };
+
+    //==============================================================================
+    /** Creates a scheduler and starts its threads.
+
+        @param name         the name to give the scheduler's threads
+        @param numThreads   the number of threads to run. If this is 0 or less, one thread
+                            will be used for each CPU core, up to a maximum of 8
+    */
+    explicit ReadAheadScheduler (const Txt& name, i32 numThreads = 0);
+
+    /** Destructor.
+
+        All clients must have been removed before the scheduler is deleted.
+    */
+    ~ReadAheadScheduler();
+
+    //==============================================================================
+    /** Registers a client. Its first read may happen before this method returns. */
+    z0 addClient (Client* clientToAdd);
+
+    /** Unregisters a client.
+
+        If one of the scheduler's threads is currently calling the client, this will wait
+        for that call to finish, so after it returns the client can safely be deleted.
+    */
+    z0 removeClient (Client* clientToRemove);
+
+    /** Возвращает true, если the client is currently registered. */
+    b8 contains (const Client* client) const;
+
+    /** Returns the number of registered clients. */
+    i32 getNumClients() const;
+
+    /** Returns the number of threads that the scheduler is running. */
+    i32 getNumThreads() const noexcept                  { return workers.size(); }
+
+    /** Tells the scheduler that a client has work to do.
+
+        Call this when a client's buffer has become invalid, e.g. after its play position
+        has been moved, so that it gets read as soon as possible instead of waiting for
+        its idle period to expire.
+    */
+    z0 notify (Client* client);
+
+    /** Sets the longest time that an idle thread will sleep before checking whether any
+        of its clients' isReadAheadNeeded() methods are returning true.
+
+        The default is 100ms. Clients that are started from a real-time thread will want
+        this to be a few milliseconds.
+    */
+    z0 setPollInterval (i32 milliseconds) noexcept;
+
+    /** Returns the current poll interval, in milliseconds. */
+    i32 getPollInterval() const noexcept                { return pollIntervalMs; }
+
+    //==============================================================================
+    /** A snapshot of the state of a scheduler's clients. */
+    struct Metrics
+    {
+        /** The number of registered clients. */
+        i32 numClients = 0;
+
+        /** The number of clients that a thread is currently reading for. */
+        i32 numActiveReads = 0;
+
+        /** The total number of calls made to Client::readAhead() so far. */
+        z64 numReads = 0;
+
+        /** The number of reads that were made for a client which had nothing buffered. */
+        z64 numReadsWhileEmpty = 0;
+
+        /** The fullest and emptiest buffer fill levels, and the average across all clients. */
+        f32 minimumFillLevel = 0, averageFillLevel = 0, maximumFillLevel = 0;
+
+        /** The smallest amount of audio that any client has buffered. */
+        f64 minimumSecondsBuffered = 0;
+    };
+
+    /** Returns the current metrics. */
+    Metrics getMetrics() const;
+
+private:
+    //==============================================================================
+    struct ClientInfo
+    {
+        Client* client;
+        f64 nextCallTime = 0;
+        b8 isBeingCalled = false, isBeingRemoved = false, wasNotifiedDuringCall = false;
+    };
+
+    class Worker;
+
+    z0 runWorker (Thread&);
+    ClientInfo* findClientInfo (const Client*) const noexcept;
+    ClientInfo* chooseNextClient (f64 now, f64& msUntilNextClient);
+    z0 wakeAllWorkers();
+
+    static constexpr i32 idleIntervalMs = 100;
+
+    std::atomic<i32> pollIntervalMs { idleIntervalMs };
+    CriticalSection lock;
+    OwnedArray<ClientInfo> clients;
+    OwnedArray<Worker> workers;
+    WaitableEvent callFinishedEvent;
+    z64 numReads = 0, numReadsWhileEmpty = 0;
+
+    DRX_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ReadAheadScheduler)
+};
+
+} // namespace drx
@@ -69,6 +69,15 @@ z0 ResamplingAudioSource::prepareToPlay (i32 samplesPerBlockExpected, f64 sample
     destBuffers.calloc (numChannels);
     createLowPass (ratio);
 
+    {
+        const ScopedLock csl (callbackLock);
+
+        if (polyphaseResampler != nullptr)
+            polyphaseResampler->prepare (numChannels, ratio);
+
+        spareOutputChannels.setSize (numChannels, samplesPerBlockExpected);
+    }
+
     flushBuffers();
 }
 
@@ -81,6 +90,62 @@ z0 ResamplingAudioSource::flushBuffers()
     sampsInBuffer = 0;
     subSampleOffset = 0.0;
     resetFilters();
+
+    if (polyphaseResampler != nullptr)
+        polyphaseResampler->reset();
+}
+
+z0 ResamplingAudioSource::setQuality (PolyphaseResampler::Quality newQuality)
+{
+    auto newResampler = std::make_unique<PolyphaseResampler> (newQuality);
+    newResampler->prepare (numChannels, getResamplingRatio());
+
+    const ScopedLock sl (callbackLock);
+    std::swap (newResampler, polyphaseResampler);
+}
+
+z0 ResamplingAudioSource::useLinearInterpolation()
+{
+    std::unique_ptr<PolyphaseResampler> oldResampler;
+
+    const ScopedLock sl (callbackLock);
+    std::swap (oldResampler, polyphaseResampler);
+    flushBuffers();
+}
+
+i32 ResamplingAudioSource::getLatencyInInputSamples() const noexcept
+{
+    const ScopedLock sl (callbackLock);
+    return polyphaseResampler != nullptr ? polyphaseResampler->getLatencyInInputSamples() : 0;
+}
+
+z0 ResamplingAudioSource::getNextPolyphaseBlock (const AudioSourceChannelInfo& info, f64 localRatio)
+{
+    polyphaseResampler->setRatio (localRatio);
+    const auto numNeeded = polyphaseResampler->getNumInputSamplesNeeded (info.numSamples);
+
+    if (buffer.getNumSamples() < numNeeded)
+        buffer.setSize (numChannels, numNeeded, false, false, true);
+
+    if (numNeeded > 0)
+    {
+        AudioSourceChannelInfo readInfo (&buffer, 0, numNeeded);
+        input->getNextAudioBlock (readInfo);
+    }
+
+    // Any channels that the destination doesn't have still need to be processed, to keep
+    // the resampler's history in step
+    if (spareOutputChannels.getNumSamples() < info.numSamples)
+        spareOutputChannels.setSize (numChannels, info.numSamples, false, false, true);
+
+    for (i32 channel = 0; channel < numChannels; ++channel)
+    {
+        srcBuffers[channel] = buffer.getReadPointer (channel);
+        destBuffers[channel] = channel < info.buffer->getNumChannels() ? info.buffer->getWritePointer (channel, info.startSample)
+                                                                       : spareOutputChannels.getWritePointer (channel);
+    }
+
+    polyphaseResampler->process (srcBuffers, destBuffers, info.numSamples);
 }
 
 z0 ResamplingAudioSource::releaseResources()
@@ -100,6 +165,12 @@ z0 ResamplingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
         localRatio = ratio;
     }
 
+    if (polyphaseResampler != nullptr)
+    {
+        getNextPolyphaseBlock (info, localRatio);
+        return;
+    }
+
     if (! approximatelyEqual (lastRatio, localRatio))
     {
         createLowPass (localRatio);
@@ -39,7 +39,11 @@ namespace drx
 /**
     A type of AudioSource that takes an input source and changes its sample rate.
 
-    @see AudioSource, LagrangeInterpolator, CatmullRomInterpolator
+    By default this uses linear interpolation with a simple IIR anti-aliasing filter,
+    which is cheap but adds audible distortion and aliasing. Call setQuality() to switch
+    to a PolyphaseResampler instead.
+
+    @see AudioSource, PolyphaseResampler, LagrangeInterpolator, CatmullRomInterpolator
 
     @tags{Audio}
 */
@@ -80,6 +84,18 @@ public:
     /** Clears any buffers and filters that the resampler is using. */
     z0 flushBuffers();
 
+    /** Switches to a PolyphaseResampler with the given quality.
+        If the source is already playing, this takes effect immediately, but resets the
+        resampler's state, so there may be a glitch.
+    */
+    z0 setQuality (PolyphaseResampler::Quality newQuality);
+
+    /** Goes back to the original linear interpolation, which is the default. */
+    z0 useLinearInterpolation();
+
+    /** Returns the number of input samples by which the output is delayed. */
+    i32 getLatencyInInputSamples() const noexcept;
+
     //==============================================================================
     z0 prepareToPlay (i32 samplesPerBlockExpected, f64 sampleRate) override;
     z0 releaseResources() override;
@@ -112,6 +128,10 @@ private:
 
     z0 applyFilter (f32* samples, i32 num, FilterState& fs);
 
+    std::unique_ptr<PolyphaseResampler> polyphaseResampler;
+    AudioBuffer<f32> spareOutputChannels;
+    z0 getNextPolyphaseBlock (const AudioSourceChannelInfo&, f64 localRatio);
+
     DRX_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ResamplingAudioSource)
 };
 
@@ -0,0 +1,386 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace drx
+{
+
+ParallelVoiceRenderer::ParallelVoiceRenderer (i32 numThreads, i32 numChannels, i32 blockSize)
+    : maxNumChannels (jmax (1, numChannels)),
+      maxBlockSize (jmax (1, blockSize)),
+      threads (jmax (1, numThreads), "Voice render thread")
+{
+    jassert (numThreads > 0);
+
+    // One scratch buffer for the calling thread, and one for each worker
+    for (i32 i = 0; i <= threads.getNumThreads(); ++i)
+    {
+        floatScratch.emplace_back (maxNumChannels, maxBlockSize);
+        doubleScratch.emplace_back (maxNumChannels, maxBlockSize);
+    }
+
+    scratchUsed.resize (floatScratch.size());
+}
+
+ParallelVoiceRenderer::~ParallelVoiceRenderer() = default;
+
+//==============================================================================
+#if DRX_UNIT_TESTS
+
+class ParallelVoiceRendererTests final : public UnitTest
+{
+public:
+    ParallelVoiceRendererTests()
+        : UnitTest ("ParallelVoiceRenderer", UnitTestCategories::audio)
+    {
+    }
+
+    // A plucked string with some dispersion filters, to make each voice reasonably expensive
+    struct StringModel
+    {
+        z0 start (f64 frequency, f64 sampleRate, f32 velocity, i32 seed)
+        {
+            length = jlimit (2, (i32) delay.size(), roundToInt (sampleRate / frequency));
+            Random random (seed);
+
+            for (i32 i = 0; i < length; ++i)
+                delay[(size_t) i] = velocity * (random.nextFloat() * 2.0f - 1.0f);
+
+            std::fill (std::begin (allpassState), std::end (allpassState), 0.0f);
+            position = 0;
+            level = 1.0f;
+            releasing = false;
+        }
+
+        f32 next() noexcept
+        {
+            const auto nextPosition = (position + 1) % length;
+            auto sample = 0.498f * (delay[(size_t) position] + delay[(size_t) nextPosition]);
+
+            for (auto& state : allpassState)
+            {
+                const auto out = state - 0.3f * sample;
+                state = sample + 0.3f * out;
+                sample = out;
+            }
+
+            delay[(size_t) position] = sample;
+            position = nextPosition;
+
+            if (releasing)
+                level *= 0.995f;
+
+            return sample * level;
+        }
+
+        std::vector<f32> delay = std::vector<f32> (4096);
+        f32 allpassState[16] {};
+        i32 length = 2, position = 0;
+        f32 level = 1.0f;
+        b8 releasing = false;
+    };
+
+    struct AnySound final : public SynthesiserSound
+    {
+        b8 appliesToNote (i32) override     { return true; }
+        b8 appliesToChannel (i32) override  { return true; }
+    };
+
+    class StringVoice final : public SynthesiserVoice
+    {
+    public:
+        b8 canPlaySound (SynthesiserSound*) override     { return true; }
+
+        z0 startNote (i32 midiNoteNumber, f32 velocity, SynthesiserSound*, i32) override
+        {
+            model.start (MidiMessage::getMidiNoteInHertz (midiNoteNumber), getSampleRate(), velocity, midiNoteNumber);
+        }
+
+        z0 stopNote (f32, b8 allowTailOff) override
+        {
+            if (allowTailOff)
+                model.releasing = true;
+            else
+                clearCurrentNote();
+        }
+
+        z0 pitchWheelMoved (i32) override {}
+        z0 controllerMoved (i32, i32) override {}
+
+        z0 renderNextBlock (AudioBuffer<f32>& output, i32 startSample, i32 numSamples) override
+        {
+            renderTo (output, startSample, numSamples);
+        }
+
+        z0 renderNextBlock (AudioBuffer<f64>& output, i32 startSample, i32 numSamples) override
+        {
+            renderTo (output, startSample, numSamples);
+        }
+
+    private:
+        template <typename FloatType>
+        z0 renderTo (AudioBuffer<FloatType>& output, i32 startSample, i32 numSamples)
+        {
+            if (! isVoiceActive())
+                return;
+
+            for (i32 i = startSample; i < startSample + numSamples; ++i)
+            {
+                const auto sample = (FloatType) model.next();
+
+                for (i32 ch = 0; ch < output.getNumChannels(); ++ch)
+                    output.addSample (ch, i, sample);
+
+                if (model.level < 1.0e-3f)
+                {
+                    clearCurrentNote();
+                    break;
+                }
+            }
+        }
+
+        StringModel model;
+    };
+
+    class MPEStringVoice final : public MPESynthesiserVoice
+    {
+    public:
+        z0 noteStarted() override
+        {
+            const auto& note = getCurrentlyPlayingNote();
+            model.start (note.getFrequencyInHertz(), currentSampleRate, note.noteOnVelocity.asUnsignedFloat(), note.initialNote);
+        }
+
+        z0 noteStopped (b8 allowTailOff) override
+        {
+            if (allowTailOff)
+                model.releasing = true;
+            else
+                clearCurrentNote();
+        }
+
+        z0 notePressureChanged() override {}
+        z0 notePitchbendChanged() override {}
+        z0 noteTimbreChanged() override {}
+        z0 noteKeyStateChanged() override {}
+
+        z0 renderNextBlock (AudioBuffer<f32>& output, i32 startSample, i32 numSamples) override
+        {
+            renderTo (output, startSample, numSamples);
+        }
+
+        z0 renderNextBlock (AudioBuffer<f64>& output, i32 startSample, i32 numSamples) override
+        {
+            renderTo (output, startSample, numSamples);
+        }
+
+    private:
+        template <typename FloatType>
+        z0 renderTo (AudioBuffer<FloatType>& output, i32 startSample, i32 numSamples)
+        {
+            for (i32 i = startSample; i < startSample + numSamples; ++i)
+            {
+                const auto sample = (FloatType) model.next();
+
+                for (i32 ch = 0; ch < output.getNumChannels(); ++ch)
+                    output.addSample (ch, i, sample);
+
+                if (model.level < 1.0e-3f)
+                {
+                    clearCurrentNote();
+                    break;
+                }
+            }
+        }
+
+        StringModel model;
+    };
+
+    static MidiBuffer createRandomNotes (Random& random, i32 numSamples, i32 numNotes, b8 useManyChannels)
+    {
+        MidiBuffer midi;
+
+        for (i32 i = 0; i < numNotes; ++i)
+        {
+            const auto channel = useManyChannels ? 2 + i % 15 : 1;
+            const auto note = 36 + random.nextInt (48);
+            const auto start = random.nextInt (numSamples);
+
+            midi.addEvent (MidiMessage::noteOn (channel, note, 0.2f + 0.8f * random.nextFloat()), start);
+            midi.addEvent (MidiMessage::noteOff (channel, note), jmin (numSamples - 1, start + random.nextInt (20000)));
+        }
+
+        return midi;
+    }
+
+    template <typename SynthType, typename FloatType>
+    static z0 renderInBlocks (SynthType& synth, const MidiBuffer& midi, AudioBuffer<FloatType>& output, i32 blockSize)
+    {
+        output.clear();
+
+        for (i32 pos = 0; pos < output.getNumSamples(); pos += blockSize)
+        {
+            const auto numThisTime = jmin (blockSize, output.getNumSamples() - pos);
+            MidiBuffer blockMidi;
+            blockMidi.addEvents (midi, pos, numThisTime, 0);
+            synth.renderNextBlock (output, blockMidi, pos, numThisTime);
+        }
+    }
+
+    template <typename FloatType>
+    static FloatType getMaxDifference (const AudioBuffer<FloatType>& a, const AudioBuffer<FloatType>& b)
+    {
+        FloatType maxDifference = 0;
+
+        for (i32 ch = 0; ch < a.getNumChannels(); ++ch)
+            for (i32 i = 0; i < a.getNumSamples(); ++i)
+                maxDifference = jmax (maxDifference, std::abs (a.getSample (ch, i) - b.getSample (ch, i)));
+
+        return maxDifference;
+    }
+
+    static z0 setUpSynth (Synthesiser& synth, i32 numVoices, i32 numThreads)
+    {
+        synth.setCurrentPlaybackSampleRate (44100.0);
+        synth.addSound (new AnySound());
+
+        for (i32 i = 0; i < numVoices; ++i)
+            synth.addVoice (new StringVoice());
+
+        synth.setNumParallelRenderThreads (numThreads);
+    }
+
+    static z0 setUpSynth (MPESynthesiser& synth, i32 numVoices, i32 numThreads)
+    {
+        synth.enableLegacyMode (24);
+        synth.setCurrentPlaybackSampleRate (44100.0);
+
+        for (i32 i = 0; i < numVoices; ++i)
+            synth.addVoice (new MPEStringVoice());
+
+        synth.setNumParallelRenderThreads (numThreads);
+    }
+
+    template <typename SynthType, typename FloatType>
+    z0 testMatchesSerialRender (b8 useManyChannels)
+    {
+        auto random = getRandom();
+        const auto numSamples = 88200;
+        const auto midi = createRandomNotes (random, numSamples, 200, useManyChannels);
+
+        SynthType serial, parallel;
+        setUpSynth (serial, 32, 0);
+        setUpSynth (parallel, 32, 3);
+        expectEquals (serial.getNumParallelRenderThreads(), 0);
+        expectEquals (parallel.getNumParallelRenderThreads(), 3);
+
+        // An odd block size and a short sub-block size mean that most of the notes start
+        // in the middle of a block
+        serial.setMinimumRenderingSubdivisionSize (8);
+        parallel.setMinimumRenderingSubdivisionSize (8);
+
+        AudioBuffer<FloatType> expected (2, numSamples), actual (2, numSamples);
+        renderInBlocks (serial, midi, expected, 333);
+        renderInBlocks (parallel, midi, actual, 333);
+
+        expect (expected.getMagnitude (0, numSamples) > (FloatType) 0.1);
+        expectLessThan (getMaxDifference (expected, actual), (FloatType) 1.0e-4);
+    }
+
+    z0 runTest() override
+    {
+        beginTest ("Synthesiser renders the same output in parallel");
+        {
+            testMatchesSerialRender<Synthesiser, f32> (false);
+            testMatchesSerialRender<Synthesiser, f64> (false);
+        }
+
+        beginTest ("MPESynthesiser renders the same output in parallel");
+        {
+            testMatchesSerialRender<MPESynthesiser, f32> (true);
+            testMatchesSerialRender<MPESynthesiser, f64> (true);
+        }
+
+        beginTest ("Blocks with more channels than the renderer supports are rendered serially");
+        {
+            Synthesiser synth;
+            setUpSynth (synth, 8, 2);
+            synth.noteOn (1, 60, 1.0f);
+            synth.noteOn (1, 64, 1.0f);
+
+            AudioBuffer<f32> buffer (4, 512);
+            buffer.clear();
+            synth.renderNextBlock (buffer, MidiBuffer(), 0, 512);
+
+            for (i32 ch = 0; ch < 4; ++ch)
+                expect (buffer.getMagnitude (ch, 0, 512) > 0.0f);
+        }
+
+        beginTest ("Scaling");
+        {
+            const auto numVoices = 64;
+            const auto numSamples = 5 * 44100;
+            Txt results;
+
+            for (auto numThreads : { 0, 1, 3, 7 })
+            {
+                Synthesiser synth;
+                setUpSynth (synth, numVoices, numThreads);
+
+                for (i32 i = 0; i < numVoices; ++i)
+                    synth.noteOn (1, 30 + i, 1.0f);
+
+                AudioBuffer<f32> buffer (2, 512);
+                const auto start = Time::getMillisecondCounterHiRes();
+
+                for (i32 pos = 0; pos < numSamples; pos += 512)
+                {
+                    buffer.clear();
+                    synth.renderNextBlock (buffer, MidiBuffer(), 0, 512);
+                }
+
+                results << " " << (numThreads + 1) << (numThreads == 0 ? " thread " : " threads ")
+                        << Txt (Time::getMillisecondCounterHiRes() - start, 1) << " ms,";
+            }
+
+            logMessage ("  " + Txt (numVoices) + " string voices, 5 seconds on " + Txt (SystemStats::getNumCpus())
+                        + " CPUs:" + results.dropLastCharacters (1));
+        }
+    }
+};
+
+static ParallelVoiceRendererTests parallelVoiceRendererTests;
+
+#endif
+
+} // namespace drx
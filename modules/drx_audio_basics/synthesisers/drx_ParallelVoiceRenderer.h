@@ -0,0 +1,192 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace drx
+{
+
+//==============================================================================
+/**
+    Renders a set of synthesiser voices on several threads at once.
+
+    Synthesiser and MPESynthesiser use one of these after their
+    setNumParallelRenderThreads() method has been called, but it can also be used by
+    custom synthesisers.
+
+    The voices are shared out between the calling thread and a fixed set of realtime
+    worker threads. Each thread takes the next voice that hasn't been rendered yet and
+    renders it into that thread's own scratch buffer, so expensive voices are spread evenly
+    however long each one takes. When all the voices are done, the scratch buffers are added
+    to the output with FloatVectorOperations.
+
+    The threads are a RealtimeWorkerThreads, so handing a block to them doesn't allocate or
+    lock, and idle workers sleep rather than spin.
+
+    The voices are summed in a different order from a serial render, so the output can
+    differ from it by rounding errors.
+
+    @see Synthesiser::setNumParallelRenderThreads, MPESynthesiser::setNumParallelRenderThreads
+
+    @tags{Audio}
+*/
+class DRX_API  ParallelVoiceRenderer
+{
+public:
+    //==============================================================================
+    /** Creates a renderer and starts its threads.
+
+        @param numThreads       the number of worker threads to start. The thread that calls
+                                render() does some of the work too
+        @param maxNumChannels   the largest number of output channels that render() will be
+                                given
+        @param maxBlockSize     the size of each thread's scratch buffer. Longer blocks are
+                                rendered in several pieces
+    */
+    ParallelVoiceRenderer (i32 numThreads, i32 maxNumChannels, i32 maxBlockSize = 512);
+
+    /** Destructor. */
+    ~ParallelVoiceRenderer();
+
+    //==============================================================================
+    /** Returns the number of worker threads. */
+    i32 getNumThreads() const noexcept                         { return threads.getNumThreads(); }
+
+    /** Returns the largest number of channels that render() can handle. */
+    i32 getMaxNumChannels() const noexcept                     { return maxNumChannels; }
+
+    /** Renders some voices and adds their output to a buffer.
+
+        This calls renderNextBlock() on each of the voices, which can be SynthesiserVoice
+        or MPESynthesiserVoice objects, or anything else with the same method. Each voice is
+        rendered by exactly one thread.
+
+        This doesn't allocate or lock. It returns false without rendering anything if the
+        output has more channels than getMaxNumChannels().
+    */
+    template <typename VoiceType, typename FloatType>
+    b8 render (VoiceType* const* voices, i32 numVoices,
+                 AudioBuffer<FloatType>& outputBuffer, i32 startSample, i32 numSamples)
+    {
+        const auto numChannels = outputBuffer.getNumChannels();
+
+        if (numChannels > maxNumChannels)
+            return false;
+
+        while (numSamples > 0)
+        {
+            const auto numThisTime = jmin (numSamples, maxBlockSize);
+
+            for (auto& s : getScratchBuffers<FloatType>())
+                s.setSize (numChannels, numThisTime, false, false, true);
+
+            VoiceJob<VoiceType, FloatType> job (*this, voices, numVoices, numThisTime);
+            threads.run (job);
+
+            for (size_t i = 0; i < scratchUsed.size(); ++i)
+            {
+                if (scratchUsed[i] == 0)
+                    continue;
+
+                const auto& scratch = getScratchBuffers<FloatType>()[i];
+
+                for (i32 ch = 0; ch < numChannels; ++ch)
+                    FloatVectorOperations::add (outputBuffer.getWritePointer (ch, startSample),
+                                                scratch.getReadPointer (ch), numThisTime);
+            }
+
+            startSample += numThisTime;
+            numSamples -= numThisTime;
+        }
+
+        return true;
+    }
+
+private:
+    //==============================================================================
+    template <typename VoiceType, typename FloatType>
+    struct VoiceJob final : public RealtimeWorkerThreads::Work
+    {
+        VoiceJob (ParallelVoiceRenderer& r, VoiceType* const* v, i32 num, i32 samples)
+            : owner (r), voices (v), numVoices (num), numSamples (samples)
+        {
+            std::fill (owner.scratchUsed.begin(), owner.scratchUsed.end(), (u8) 0);
+        }
+
+        // Called at the same time on every thread; renders voices until there are none left
+        z0 participate (i32 threadIndex) override
+        {
+            auto& scratch = owner.getScratchBuffers<FloatType>()[(size_t) threadIndex];
+
+            for (auto index = nextVoice++; index < numVoices; index = nextVoice++)
+            {
+                if (owner.scratchUsed[(size_t) threadIndex] == 0)
+                {
+                    scratch.clear();
+                    owner.scratchUsed[(size_t) threadIndex] = 1;
+                }
+
+                voices[index]->renderNextBlock (scratch, 0, numSamples);
+                ++numVoicesDone;
+            }
+        }
+
+        b8 isFinished() const override
+        {
+            return numVoicesDone.load() >= numVoices;
+        }
+
+        ParallelVoiceRenderer& owner;
+        VoiceType* const* voices;
+        i32k numVoices, numSamples;
+        std::atomic<i32> nextVoice { 0 }, numVoicesDone { 0 };
+    };
+
+    template <typename FloatType>
+    std::vector<AudioBuffer<FloatType>>& getScratchBuffers() noexcept
+    {
+        if constexpr (std::is_same_v<FloatType, f32>)
+            return floatScratch;
+        else
+            return doubleScratch;
+    }
+
+    const i32 maxNumChannels, maxBlockSize;
+    std::vector<AudioBuffer<f32>> floatScratch;
+    std::vector<AudioBuffer<f64>> doubleScratch;
+    std::vector<u8> scratchUsed;
+    RealtimeWorkerThreads threads;
+
+    DRX_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ParallelVoiceRenderer)
+};
+
+} // namespace drx
@@ -116,6 +116,7 @@ SynthesiserVoice* Synthesiser::addVoice (SynthesiserVoice* const newVoice)
         const ScopedLock sl (lock);
         newVoice->setCurrentPlaybackSampleRate (sampleRate);
         voice = voices.add (newVoice);
+        voicesToRender.ensureStorageAllocated (voices.size());
     }
 
     {
@@ -162,6 +163,23 @@ z0 Synthesiser::setMinimumRenderingSubdivisionSize (i32 numSamples, b8 shouldBeS
     subBlockSubdivisionIsStrict = shouldBeStrict;
 }
 
+z0 Synthesiser::setNumParallelRenderThreads (i32 numThreads, i32 maxNumChannels)
+{
+    jassert (numThreads >= 0);
+
+    auto newRenderer = numThreads > 0 ? std::make_unique<ParallelVoiceRenderer> (numThreads, maxNumChannels)
+                                      : nullptr;
+
+    const ScopedLock sl (lock);
+    voicesToRender.ensureStorageAllocated (voices.size());
+    std::swap (parallelRenderer, newRenderer);
+}
+
+i32 Synthesiser::getNumParallelRenderThreads() const noexcept
+{
+    return parallelRenderer != nullptr ? parallelRenderer->getNumThreads() : 0;
+}
+
 //==============================================================================
 z0 Synthesiser::setCurrentPlaybackSampleRate (const f64 newRate)
 {
@@ -251,14 +269,45 @@ z0 Synthesiser::renderNextBlock (AudioBuffer<f64>& outputAudio, const MidiBuffer
     processNextBlock (outputAudio, inputMidi, startSample, numSamples);
 }
 
+template <typename floatType>
+b8 Synthesiser::renderVoicesInParallel (AudioBuffer<floatType>& buffer, i32 startSample, i32 numSamples)
+{
+    if (parallelRenderer == nullptr)
+        return false;
+
+    voicesToRender.clearQuick();
+
+    for (auto* voice : voices)
+        if (voice->isVoiceActive())
+            voicesToRender.add (voice);
+
+    // With only one voice there's nothing to gain from waking the workers
+    if (voicesToRender.size() < 2)
+    {
+        for (auto* voice : voicesToRender)
+            voice->renderNextBlock (buffer, startSample, numSamples);
+
+        return true;
+    }
+
+    return parallelRenderer->render (voicesToRender.getRawDataPointer(), voicesToRender.size(),
+                                     buffer, startSample, numSamples);
+}
+
 z0 Synthesiser::renderVoices (AudioBuffer<f32>& buffer, i32 startSample, i32 numSamples)
 {
+    if (renderVoicesInParallel (buffer, startSample, numSamples))
+        return;
+
     for (auto* voice : voices)
         voice->renderNextBlock (buffer, startSample, numSamples);
 }
 
 z0 Synthesiser::renderVoices (AudioBuffer<f64>& buffer, i32 startSample, i32 numSamples)
 {
+    if (renderVoicesInParallel (buffer, startSample, numSamples))
+        return;
+
     for (auto* voice : voices)
         voice->renderNextBlock (buffer, startSample, numSamples);
 }
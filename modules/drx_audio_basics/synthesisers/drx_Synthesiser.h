@@ -569,6 +569,31 @@ public:
     */
     z0 setMinimumRenderingSubdivisionSize (i32 numSamples, b8 shouldBeStrict = false) noexcept;
 
+    //==============================================================================
+    /** Makes the synthesiser render its voices on several threads at once.
+
+        Once this is enabled, the default renderVoices() method shares the active voices
+        out between the audio thread and a set of realtime worker threads, using a
+        ParallelVoiceRenderer. MIDI events are still handled on the audio thread between
+        sub-blocks, so timing is just as accurate as a serial render. Voices that aren't
+        active aren't called, and the voices must not share any state that they modify
+        while rendering.
+
+        Because the voices are summed in a different order, the output can differ from a
+        serial render by rounding errors.
+
+        This starts or stops threads, so don't call it from the audio thread.
+
+        @param numThreads       the number of worker threads to start, or 0 to go back
+                                to rendering all the voices on the audio thread
+        @param maxNumChannels   the largest number of channels that will be rendered. Blocks
+                                with more channels than this are rendered serially
+    */
+    z0 setNumParallelRenderThreads (i32 numThreads, i32 maxNumChannels = 2);
+
+    /** Returns the number of worker threads set by setNumParallelRenderThreads(). */
+    i32 getNumParallelRenderThreads() const noexcept;
+
 protected:
     //==============================================================================
     /** This is used to control access to the rendering callback and the note trigger methods. */
@@ -641,10 +666,15 @@ private:
     BigInteger sustainPedalsDown;
     mutable CriticalSection stealLock;
     mutable Array<SynthesiserVoice*> usableVoicesToStealArray;
+    std::unique_ptr<ParallelVoiceRenderer> parallelRenderer;
+    Array<SynthesiserVoice*> voicesToRender;
 
     template <typename floatType>
     z0 processNextBlock (AudioBuffer<floatType>&, const MidiBuffer&, i32 startSample, i32 numSamples);
 
+    template <typename floatType>
+    b8 renderVoicesInParallel (AudioBuffer<floatType>&, i32 startSample, i32 numSamples);
+
     DRX_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Synthesiser)
 };
 
@@ -0,0 +1,617 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace drx
+{
+
+namespace PolyphaseResamplerHelpers
+{
+    struct QualitySpec
+    {
+        i32 numTaps;
+        f64 attenuationDb;
+        i32 numPhases;
+    };
+
+    // The number of phases is chosen so that the error from interpolating between them
+    // stays below the stopband level
+    static QualitySpec getSpec (PolyphaseResampler::Quality quality) noexcept
+    {
+        switch (quality)
+        {
+            case PolyphaseResampler::Quality::draft:      return { 16,  60.0,  64 };
+            case PolyphaseResampler::Quality::normal:     return { 32,  80.0,  128 };
+            case PolyphaseResampler::Quality::mastering:  return { 128, 120.0, 1024 };
+            case PolyphaseResampler::Quality::high:
+            default:                                      return { 64,  100.0, 256 };
+        }
+    }
+
+    static constexpr i32 maxNumTaps = 1024;
+
+    // The zeroth-order modified Bessel function, which the Kaiser window is built from
+    static f64 besselI0 (f64 x) noexcept
+    {
+        f64 sum = 1.0, term = 1.0;
+        const auto halfX = x * 0.5;
+
+        for (i32 k = 1; k < 50 && term > sum * 1.0e-12; ++k)
+        {
+            const auto t = halfX / k;
+            term *= t * t;
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    static f64 getKaiserBeta (f64 attenuationDb) noexcept
+    {
+        return attenuationDb > 50.0 ? 0.1102 * (attenuationDb - 8.7)
+                                    : 0.5842 * std::pow (attenuationDb - 21.0, 0.4) + 0.07886 * (attenuationDb - 21.0);
+    }
+
+    /*  Calculates two dot products against the same window of samples in a single pass, which
+        is what each output sample needs for the two coefficient sets on either side of it.
+        numValues is always a multiple of 8.
+    */
+    static forcedinline z0 dotProductPair (const f32* coeffsA, const f32* coeffsB, const f32* samples,
+                                           i32 numValues, f32& resultA, f32& resultB) noexcept
+    {
+       #if DRX_USE_SSE_INTRINSICS
+        auto a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps(), b0 = _mm_setzero_ps(), b1 = _mm_setzero_ps();
+
+        for (i32 i = 0; i < numValues; i += 8)
+        {
+            const auto s0 = _mm_loadu_ps (samples + i);
+            const auto s1 = _mm_loadu_ps (samples + i + 4);
+            a0 = _mm_add_ps (a0, _mm_mul_ps (_mm_loadu_ps (coeffsA + i), s0));
+            a1 = _mm_add_ps (a1, _mm_mul_ps (_mm_loadu_ps (coeffsA + i + 4), s1));
+            b0 = _mm_add_ps (b0, _mm_mul_ps (_mm_loadu_ps (coeffsB + i), s0));
+            b1 = _mm_add_ps (b1, _mm_mul_ps (_mm_loadu_ps (coeffsB + i + 4), s1));
+        }
+
+        alignas (16) f32 sums[8];
+        _mm_store_ps (sums, _mm_add_ps (a0, a1));
+        _mm_store_ps (sums + 4, _mm_add_ps (b0, b1));
+        resultA = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+        resultB = (sums[4] + sums[5]) + (sums[6] + sums[7]);
+       #elif DRX_USE_ARM_NEON
+        auto a0 = vdupq_n_f32 (0), a1 = vdupq_n_f32 (0), b0 = vdupq_n_f32 (0), b1 = vdupq_n_f32 (0);
+
+        for (i32 i = 0; i < numValues; i += 8)
+        {
+            const auto s0 = vld1q_f32 (samples + i);
+            const auto s1 = vld1q_f32 (samples + i + 4);
+            a0 = vmlaq_f32 (a0, vld1q_f32 (coeffsA + i), s0);
+            a1 = vmlaq_f32 (a1, vld1q_f32 (coeffsA + i + 4), s1);
+            b0 = vmlaq_f32 (b0, vld1q_f32 (coeffsB + i), s0);
+            b1 = vmlaq_f32 (b1, vld1q_f32 (coeffsB + i + 4), s1);
+        }
+
+        f32 sums[8];
+        vst1q_f32 (sums, vaddq_f32 (a0, a1));
+        vst1q_f32 (sums + 4, vaddq_f32 (b0, b1));
+        resultA = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+        resultB = (sums[4] + sums[5]) + (sums[6] + sums[7]);
+       #else
+        f32 a[4] = {}, b[4] = {};
+
+        for (i32 i = 0; i < numValues; i += 4)
+        {
+            for (i32 j = 0; j < 4; ++j)
+            {
+                a[j] += coeffsA[i + j] * samples[i + j];
+                b[j] += coeffsB[i + j] * samples[i + j];
+            }
+        }
+
+        resultA = (a[0] + a[1]) + (a[2] + a[3]);
+        resultB = (b[0] + b[1]) + (b[2] + b[3]);
+       #endif
+    }
+}
+
+//==============================================================================
+PolyphaseResampler::PolyphaseResampler (Quality q)  : quality (q) {}
+PolyphaseResampler::~PolyphaseResampler() = default;
+
+z0 PolyphaseResampler::prepare (i32 newNumChannels, f64 samplesInPerOutputSample)
+{
+    jassert (newNumChannels > 0 && samplesInPerOutputSample > 0);
+
+    numChannels = jmax (1, newNumChannels);
+    currentRatio = targetRatio = samplesInPerOutputSample;
+    numTaps = 0;
+    updateFilter (true);
+    reset();
+}
+
+z0 PolyphaseResampler::reset() noexcept
+{
+    if (history != nullptr)
+        history.clear ((size_t) (numChannels * numTaps * 2));
+
+    historyPos = 0;
+    position = 0.0;
+    currentRatio = targetRatio;
+}
+
+z0 PolyphaseResampler::setQuality (Quality newQuality)
+{
+    if (quality != newQuality)
+    {
+        quality = newQuality;
+
+        if (numChannels > 0)
+            prepare (numChannels, targetRatio);
+    }
+}
+
+z0 PolyphaseResampler::setRatio (f64 samplesInPerOutputSample)
+{
+    jassert (samplesInPerOutputSample > 0);
+
+    targetRatio = jmax (1.0e-6, samplesInPerOutputSample);
+
+    if (numChannels > 0)
+        updateFilter (false);
+}
+
+z0 PolyphaseResampler::updateFilter (b8 forceRebuild)
+{
+    using namespace PolyphaseResamplerHelpers;
+
+    const auto downsamplingFactor = jmax (1.0, targetRatio);
+
+    // Small ratio changes don't need a new filter, which lets a ratio be automated cheaply
+    if (! forceRebuild && std::abs (downsamplingFactor / filterRatio - 1.0) < 0.02)
+        return;
+
+    filterRatio = downsamplingFactor;
+
+    const auto spec = getSpec (quality);
+    const auto newNumTaps = jlimit (8, maxNumTaps, ((roundToInt (spec.numTaps * downsamplingFactor) + 7) / 8) * 8);
+
+    if (newNumTaps != numTaps || numPhases != spec.numPhases)
+    {
+        // Keep as much of the recent input as possible, so that the output doesn't jump
+        HeapBlock<f32> newHistory ((size_t) (numChannels * newNumTaps * 2), true);
+
+        if (history != nullptr)
+        {
+            const auto numToKeep = jmin (numTaps, newNumTaps);
+
+            for (i32 ch = 0; ch < numChannels; ++ch)
+            {
+                const auto* oldWindow = history + ch * numTaps * 2 + historyPos + numTaps - numToKeep;
+                auto* newChannel = newHistory + ch * newNumTaps * 2;
+
+                FloatVectorOperations::copy (newChannel + newNumTaps - numToKeep, oldWindow, numToKeep);
+                FloatVectorOperations::copy (newChannel + newNumTaps * 2 - numToKeep, oldWindow, numToKeep);
+            }
+        }
+
+        history.swapWith (newHistory);
+        historyPos = 0;
+        numTaps = newNumTaps;
+        numPhases = spec.numPhases;
+        coefficients.malloc ((size_t) ((numPhases + 1) * numTaps));
+    }
+
+    // The transition band is placed so that the stopband starts at the output's Nyquist frequency
+    const auto transitionWidth = (spec.attenuationDb - 7.95) / (14.36 * spec.numTaps);
+    const auto cutoff = (0.5 - transitionWidth * 0.5) / downsamplingFactor;
+    const auto beta = getKaiserBeta (spec.attenuationDb);
+    const auto windowScale = 1.0 / besselI0 (beta);
+    const auto halfLength = numTaps * 0.5;
+
+    for (i32 phase = 0; phase <= numPhases; ++phase)
+    {
+        auto* row = coefficients + phase * numTaps;
+        const auto frac = phase / (f64) numPhases;
+        f64 sum = 0;
+
+        for (i32 k = 0; k < numTaps; ++k)
+        {
+            const auto t = halfLength - 1.0 - k + frac;
+            const auto x = t / halfLength;
+            const auto window = std::abs (x) < 1.0 ? besselI0 (beta * std::sqrt (1.0 - x * x)) * windowScale : 0.0;
+            const auto arg = MathConstants<f64>::twoPi * cutoff * t;
+            const auto sinc = std::abs (arg) < 1.0e-9 ? 1.0 : std::sin (arg) / arg;
+            const auto value = sinc * window;
+
+            row[k] = (f32) value;
+            sum += value;
+        }
+
+        // Normalising each row gives every fractional position exactly unity gain at DC
+        FloatVectorOperations::multiply (row, (f32) (1.0 / sum), numTaps);
+    }
+}
+
+f64 PolyphaseResampler::getRatioStep (i32 numOutputSamples) const noexcept
+{
+    return numOutputSamples > 0 ? (targetRatio - currentRatio) / numOutputSamples : 0.0;
+}
+
+i32 PolyphaseResampler::getNumInputSamplesNeeded (i32 numOutputSamples) const noexcept
+{
+    // This has to follow exactly the same arithmetic as process()
+    const auto step = getRatioStep (numOutputSamples);
+    auto ratio = currentRatio;
+    auto pos = position;
+    i32 numNeeded = 0;
+
+    for (i32 i = 0; i < numOutputSamples; ++i)
+    {
+        ratio += step;
+        pos += ratio;
+
+        while (pos >= 1.0)
+        {
+            pos -= 1.0;
+            ++numNeeded;
+        }
+    }
+
+    return numNeeded;
+}
+
+i32 PolyphaseResampler::process (const f32* const* inputs, f32* const* outputs, i32 numOutputSamples) noexcept
+{
+    // You need to call prepare() first!
+    jassert (numTaps > 0);
+
+    const auto step = getRatioStep (numOutputSamples);
+    const auto historySize = numTaps * 2;
+    auto ratio = currentRatio;
+    i32 numUsed = 0;
+
+    for (i32 i = 0; i < numOutputSamples; ++i)
+    {
+        const auto phase = position * numPhases;
+        const auto phaseIndex = jmin (numPhases - 1, (i32) phase);
+        const auto alpha = (f32) (phase - phaseIndex);
+        const auto* coeffsA = coefficients + phaseIndex * numTaps;
+        const auto* coeffsB = coeffsA + numTaps;
+
+        for (i32 ch = 0; ch < numChannels; ++ch)
+        {
+            f32 a, b;
+            PolyphaseResamplerHelpers::dotProductPair (coeffsA, coeffsB, history + ch * historySize + historyPos, numTaps, a, b);
+            outputs[ch][i] = a + alpha * (b - a);
+        }
+
+        ratio += step;
+        position += ratio;
+
+        while (position >= 1.0)
+        {
+            position -= 1.0;
+
+            // Each sample is written twice, so that the latest numTaps samples are always contiguous
+            for (i32 ch = 0; ch < numChannels; ++ch)
+            {
+                auto* h = history + ch * historySize;
+                h[historyPos] = h[historyPos + numTaps] = inputs[ch][numUsed];
+            }
+
+            if (++historyPos == numTaps)
+                historyPos = 0;
+
+            ++numUsed;
+        }
+    }
+
+    currentRatio = targetRatio;
+    return numUsed;
+}
+
+//==============================================================================
+#if DRX_UNIT_TESTS
+
+class PolyphaseResamplerTests final : public UnitTest
+{
+public:
+    PolyphaseResamplerTests()
+        : UnitTest ("PolyphaseResampler", UnitTestCategories::audio)
+    {
+    }
+
+    z0 runTest() override
+    {
+        using Quality = PolyphaseResampler::Quality;
+        const Quality qualities[] = { Quality::draft, Quality::normal, Quality::high, Quality::mastering };
+        tukk qualityNames[] = { "draft", "normal", "high", "mastering" };
+
+        beginTest ("Input sample count matches getNumInputSamplesNeeded");
+        {
+            auto random = getRandom();
+            PolyphaseResampler resampler (Quality::normal);
+            resampler.prepare (2, 44100.0 / 48000.0);
+
+            std::vector<f32> in (8192, 0.25f), out (8192);
+            const f32* inputs[] = { in.data(), in.data() };
+            f32* outputs[] = { out.data(), out.data() + 4096 };
+
+            for (i32 i = 0; i < 200; ++i)
+            {
+                if (random.nextInt (4) == 0)
+                    resampler.setRatio (0.25 + random.nextDouble() * 3.5);
+
+                const auto numOut = random.nextInt (1000);
+                const auto numNeeded = resampler.getNumInputSamplesNeeded (numOut);
+                expect (numNeeded <= (i32) in.size());
+                expectEquals (resampler.process (inputs, outputs, numOut), numNeeded);
+            }
+        }
+
+        beginTest ("Unity ratio is a pure delay");
+        {
+            for (auto quality : qualities)
+            {
+                PolyphaseResampler resampler (quality);
+                resampler.prepare (1, 1.0);
+
+                const auto input = makeSine (4096, 0.01, 0.5);
+                std::vector<f32> output (4096);
+                process (resampler, input, output);
+
+                const auto latency = resampler.getLatencyInInputSamples();
+                f32 maxError = 0;
+
+                for (size_t i = (size_t) latency + 256; i < output.size(); ++i)
+                    maxError = jmax (maxError, std::abs (output[i] - input[i - (size_t) latency]));
+
+                expectLessThan (maxError, 1.0e-3f);
+            }
+        }
+
+        beginTest ("DC passes with unity gain");
+        {
+            for (auto quality : qualities)
+            {
+                for (auto ratio : { 0.37, 0.9187, 1.0883, 2.5 })
+                {
+                    PolyphaseResampler resampler (quality);
+                    resampler.prepare (1, ratio);
+
+                    std::vector<f32> input (16384, 0.5f), output (2048);
+                    process (resampler, input, output);
+
+                    for (size_t i = 1024; i < output.size(); ++i)
+                        if (std::abs (output[i] - 0.5f) > 1.0e-4f)
+                            expectWithinAbsoluteError (output[i], 0.5f, 1.0e-4f);
+                }
+            }
+        }
+
+        beginTest ("Splitting into blocks doesn't change the output");
+        {
+            auto random = getRandom();
+            PolyphaseResampler whole (Quality::high), split (Quality::high);
+            whole.prepare (1, 0.7);
+            split.prepare (1, 0.7);
+
+            const auto input = makeSine (16384, 0.031, 0.5);
+            std::vector<f32> expected (8192), actual (8192);
+            process (whole, input, expected);
+
+            i32 inPos = 0, outPos = 0;
+
+            while (outPos < (i32) actual.size())
+            {
+                const auto numOut = jmin ((i32) actual.size() - outPos, 1 + random.nextInt (300));
+                const f32* inputs[] = { input.data() + inPos };
+                f32* outputs[] = { actual.data() + outPos };
+                inPos += split.process (inputs, outputs, numOut);
+                outPos += numOut;
+            }
+
+            expect (expected == actual);
+        }
+
+        beginTest ("Sine conversion from 44.1kHz to 48kHz");
+        {
+            const auto ratio = 44100.0 / 48000.0;
+            const auto frequency = 997.0 / 44100.0;
+            const auto input = makeSine (110000, frequency, 0.5);
+            const f64 limits[] = { -60.0, -80.0, -100.0, -120.0 };
+
+            for (size_t q = 0; q < std::size (qualities); ++q)
+            {
+                PolyphaseResampler resampler (qualities[q]);
+                resampler.prepare (1, ratio);
+
+                std::vector<f32> output (96000);
+                process (resampler, input, output);
+
+                const auto thdN = getTHDPlusNoise (output, 4096, frequency * ratio);
+                logMessage (Txt ("  ") + qualityNames[q] + ": THD+N " + Txt (thdN, 1) + " dB");
+                expectLessThan (thdN, limits[q]);
+            }
+
+            auto legacyTHDPlusNoise = [&] (b8 usePolyphase)
+            {
+                AudioBuffer<f32> source (1, (i32) input.size());
+                source.copyFrom (0, 0, input.data(), (i32) input.size());
+
+                MemoryAudioSource memorySource (source, false);
+                ResamplingAudioSource resamplingSource (&memorySource, false, 1);
+
+                if (usePolyphase)
+                    resamplingSource.setQuality (Quality::high);
+
+                resamplingSource.setResamplingRatio (ratio);
+                resamplingSource.prepareToPlay (512, 48000.0);
+
+                AudioBuffer<f32> block (1, 512);
+                std::vector<f32> output;
+
+                while (output.size() < 96000)
+                {
+                    resamplingSource.getNextAudioBlock (AudioSourceChannelInfo (block));
+                    output.insert (output.end(), block.getReadPointer (0), block.getReadPointer (0) + 512);
+                }
+
+                return getTHDPlusNoise (output, 4096, frequency * ratio);
+            };
+
+            const auto linear = legacyTHDPlusNoise (false);
+            const auto polyphase = legacyTHDPlusNoise (true);
+            logMessage ("  ResamplingAudioSource: linear " + Txt (linear, 1) + " dB, polyphase " + Txt (polyphase, 1) + " dB");
+            expectLessThan (polyphase, -100.0);
+            expectLessThan (polyphase, linear - 30.0);
+        }
+
+        beginTest ("Aliasing when downsampling from 96kHz to 44.1kHz");
+        {
+            // A 30kHz tone is above the output Nyquist frequency, so all of it should be removed
+            const auto input = makeSine (100000, 30000.0 / 96000.0, 0.5);
+            const f64 limits[] = { -60.0, -80.0, -100.0, -120.0 };
+
+            for (size_t q = 0; q < std::size (qualities); ++q)
+            {
+                PolyphaseResampler resampler (qualities[q]);
+                resampler.prepare (1, 96000.0 / 44100.0);
+
+                std::vector<f32> output (40000);
+                process (resampler, input, output);
+
+                f64 sumOfSquares = 0;
+
+                for (size_t i = 4096; i < output.size(); ++i)
+                    sumOfSquares += (f64) output[i] * output[i];
+
+                const auto level = Decibels::gainToDecibels (std::sqrt (sumOfSquares / (f64) (output.size() - 4096)) / (0.5 / MathConstants<f64>::sqrt2), -300.0);
+                logMessage (Txt ("  ") + qualityNames[q] + ": alias level " + Txt (level, 1) + " dB");
+                expectLessThan (level, limits[q]);
+            }
+        }
+
+        beginTest ("Performance");
+        {
+            const auto input = makeSine (70000, 0.0123, 0.5);
+            std::vector<f32> left (65536), right (65536);
+            const auto ratio = 44100.0 / 48000.0;
+
+            auto logThroughput = [&] (const Txt& label, auto&& render)
+            {
+                const auto start = Time::getHighResolutionTicks();
+                render();
+                const auto seconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+                logMessage ("  " + label + ": " + Txt (2.0 * (f64) left.size() / (seconds * 1.0e6), 1) + " Msamples/s");
+            };
+
+            for (size_t q = 0; q < std::size (qualities); ++q)
+            {
+                PolyphaseResampler resampler (qualities[q]);
+                resampler.prepare (2, ratio);
+
+                logThroughput (qualityNames[q], [&]
+                {
+                    const f32* inputs[] = { input.data(), input.data() };
+                    f32* outputs[] = { left.data(), right.data() };
+                    resampler.process (inputs, outputs, (i32) left.size());
+                });
+            }
+
+            logThroughput ("WindowedSincInterpolator", [&]
+            {
+                WindowedSincInterpolator interpolators[2];
+                interpolators[0].process (ratio, input.data(), left.data(), (i32) left.size());
+                interpolators[1].process (ratio, input.data(), right.data(), (i32) right.size());
+            });
+        }
+    }
+
+private:
+    static std::vector<f32> makeSine (size_t numSamples, f64 cyclesPerSample, f64 amplitude)
+    {
+        std::vector<f32> result (numSamples);
+
+        for (size_t i = 0; i < numSamples; ++i)
+            result[i] = (f32) (amplitude * std::sin (MathConstants<f64>::twoPi * cyclesPerSample * (f64) i));
+
+        return result;
+    }
+
+    static z0 process (PolyphaseResampler& resampler, const std::vector<f32>& input, std::vector<f32>& output)
+    {
+        jassert (resampler.getNumInputSamplesNeeded ((i32) output.size()) <= (i32) input.size());
+
+        const f32* inputs[] = { input.data() };
+        f32* outputs[] = { output.data() };
+        resampler.process (inputs, outputs, (i32) output.size());
+    }
+
+    // Fits a sine of a known frequency to the signal with least squares, and returns the level
+    // of whatever is left over, relative to the fitted sine
+    static f64 getTHDPlusNoise (const std::vector<f32>& signal, size_t start, f64 cyclesPerSample)
+    {
+        f64 ss = 0, sc = 0, cc = 0, ys = 0, yc = 0;
+
+        for (size_t i = start; i < signal.size(); ++i)
+        {
+            const auto angle = MathConstants<f64>::twoPi * cyclesPerSample * (f64) i;
+            const auto s = std::sin (angle), c = std::cos (angle);
+            ss += s * s;  sc += s * c;  cc += c * c;
+            ys += signal[i] * s;
+            yc += signal[i] * c;
+        }
+
+        const auto det = ss * cc - sc * sc;
+        const auto a = (ys * cc - yc * sc) / det;
+        const auto b = (yc * ss - ys * sc) / det;
+
+        f64 residual = 0, fitted = 0;
+
+        for (size_t i = start; i < signal.size(); ++i)
+        {
+            const auto angle = MathConstants<f64>::twoPi * cyclesPerSample * (f64) i;
+            const auto fit = a * std::sin (angle) + b * std::cos (angle);
+            residual += (signal[i] - fit) * (signal[i] - fit);
+            fitted += fit * fit;
+        }
+
+        return Decibels::gainToDecibels (std::sqrt (residual / fitted), -300.0);
+    }
+};
+
+static PolyphaseResamplerTests polyphaseResamplerTests;
+
+#endif
+
+} // namespace drx
@@ -0,0 +1,150 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace drx
+{
+
+//==============================================================================
+/**
+    A polyphase FIR sample-rate converter, for high-quality resampling at any ratio.
+
+    The anti-aliasing filter is a Kaiser-windowed sinc, precalculated as a bank of
+    coefficient sets for a number of fractional positions between input samples. Each
+    output sample is made by interpolating between the two nearest sets, which means
+    the ratio can be anything, and can change smoothly from one block to the next.
+
+    When the ratio is greater than 1 (i.e. the signal is being down-sampled), the
+    filter's cutoff is lowered to the output's Nyquist frequency, and it gets
+    proportionally longer so that the stopband attenuation stays the same.
+
+    The class works in a "pull" style: ask getNumInputSamplesNeeded() how much input is
+    needed to produce a block of output, then pass exactly that much to process().
+
+    @see ResamplingAudioSource, WindowedSincInterpolator
+    @tags{Audio}
+*/
+class DRX_API  PolyphaseResampler
+{
+public:
+    //==============================================================================
+    /** The available trade-offs between quality and CPU use. */
+    enum class Quality
+    {
+        draft,      /**< 16 taps, about 60dB of stopband attenuation. */
+        normal,     /**< 32 taps, about 80dB of stopband attenuation. */
+        high,       /**< 64 taps, about 100dB of stopband attenuation. */
+        mastering   /**< 128 taps, about 120dB of stopband attenuation. */
+    };
+
+    /** Creates a resampler. You'll need to call prepare() before using it. */
+    explicit PolyphaseResampler (Quality quality = Quality::high);
+
+    /** Destructor. */
+    ~PolyphaseResampler();
+
+    //==============================================================================
+    /** Allocates the buffers and filters needed for a number of channels and a ratio.
+        This also resets the resampler's state.
+        @param numChannels                  the number of channels that process() will be given
+        @param samplesInPerOutputSample     the initial resampling ratio, see setRatio()
+    */
+    z0 prepare (i32 numChannels, f64 samplesInPerOutputSample);
+
+    /** Clears the history of input samples, as if the resampler had just been prepared. */
+    z0 reset() noexcept;
+
+    /** Changes the quality. This reallocates the filter, and resets the resampler. */
+    z0 setQuality (Quality newQuality);
+
+    /** Returns the current quality setting. */
+    Quality getQuality() const noexcept                     { return quality; }
+
+    /** Changes the resampling ratio.
+
+        The change is made gradually over the course of the next call to process(), so
+        the ratio can be automated without clicks.
+
+        If the signal is being down-sampled, the filter has to be redesigned for the new
+        ratio, which happens here whenever it moves by more than a few percent. That will
+        allocate memory if the filter gets longer.
+
+        @param samplesInPerOutputSample     if set to 1.0, the input is passed through; higher
+                                            values will speed it up; lower values will slow it
+                                            down. The ratio must be greater than 0
+    */
+    z0 setRatio (f64 samplesInPerOutputSample);
+
+    /** Returns the ratio that was last set with setRatio(). */
+    f64 getRatio() const noexcept                           { return targetRatio; }
+
+    //==============================================================================
+    /** Returns the number of input samples that process() will consume to create the
+        given number of output samples.
+    */
+    i32 getNumInputSamplesNeeded (i32 numOutputSamples) const noexcept;
+
+    /** Resamples a block of audio.
+
+        @param inputs               one pointer per channel, each of which must contain
+                                    getNumInputSamplesNeeded (numOutputSamples) samples
+        @param outputs              one pointer per channel, for the results
+        @param numOutputSamples     the number of samples to write to each output channel
+        @returns the number of input samples that were used
+    */
+    i32 process (const f32* const* inputs, f32* const* outputs, i32 numOutputSamples) noexcept;
+
+    /** Returns the delay that the filter introduces, measured in input samples. */
+    i32 getLatencyInInputSamples() const noexcept           { return numTaps / 2 + 1; }
+
+    /** Returns the number of filter taps that each output sample currently uses. */
+    i32 getNumTaps() const noexcept                         { return numTaps; }
+
+private:
+    //==============================================================================
+    Quality quality;
+    i32 numChannels = 0, numTaps = 0, numPhases = 0;
+    f64 currentRatio = 1.0, targetRatio = 1.0, filterRatio = 0.0;
+    f64 position = 0.0;
+
+    HeapBlock<f32> coefficients;
+    HeapBlock<f32> history;
+    i32 historyPos = 0;
+
+    z0 updateFilter (b8 forceRebuild);
+    f64 getRatioStep (i32 numOutputSamples) const noexcept;
+
+    DRX_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PolyphaseResampler)
+};
+
+} // namespace drx
@@ -0,0 +1,151 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace drx
+{
+
+class RealtimeWorkerThreads::Worker final : public Thread
+{
+public:
+    Worker (RealtimeWorkerThreads& o, const Txt& name, i32 index)
+        : Thread (name + " " + Txt (index)), owner (o), threadIndex (index) {}
+
+    z0 run() override
+    {
+        u32 lastGeneration = 0;
+
+        while (! threadShouldExit())
+        {
+            ++owner.numActiveWorkers;
+
+            if (owner.isNewWorkAvailable (lastGeneration))
+            {
+                lastGeneration = owner.generation.load();
+
+                // Match the calling thread, so that the results don't depend on which
+                // thread happened to pick up each piece of work
+                const auto disabled = owner.denormalsDisabled.load();
+
+                if (FloatVectorOperations::areDenormalsDisabled() != disabled)
+                    FloatVectorOperations::disableDenormalisedNumberSupport (disabled);
+
+                owner.currentWork.load()->participate (threadIndex);
+            }
+
+            --owner.numActiveWorkers;
+
+            ++owner.numSleeping;
+
+            // The calling thread only wakes the workers that it has counted as sleeping, so
+            // check again after being counted, in case some work arrived in the meantime.
+            // If the calling thread has already claimed this worker, the semaphore has been
+            // posted and the wait below returns straight away.
+            if (owner.isNewWorkAvailable (lastGeneration) && owner.claimSleepingWorker())
+                continue;
+
+            owner.wakeUpSignal.wait (-1);
+        }
+    }
+
+private:
+    RealtimeWorkerThreads& owner;
+    i32k threadIndex;
+};
+
+//==============================================================================
+RealtimeWorkerThreads::RealtimeWorkerThreads (i32 numThreads, const Txt& threadName)
+{
+    jassert (numThreads > 0);
+
+    for (i32 i = 0; i < numThreads; ++i)
+        workers.push_back (std::make_unique<Worker> (*this, threadName, i + 1));
+
+    for (auto& worker : workers)
+        if (! worker->startRealtimeThread (Thread::RealtimeOptions{}))
+            worker->startThread (Thread::Priority::highest);
+}
+
+RealtimeWorkerThreads::~RealtimeWorkerThreads()
+{
+    for (auto& worker : workers)
+        worker->signalThreadShouldExit();
+
+    wakeUpSignal.signal ((i32) workers.size());
+
+    for (auto& worker : workers)
+        worker->stopThread (-1);
+}
+
+i32 RealtimeWorkerThreads::getNumThreads() const noexcept
+{
+    return (i32) workers.size();
+}
+
+z0 RealtimeWorkerThreads::run (Work& work)
+{
+    denormalsDisabled = FloatVectorOperations::areDenormalsDisabled();
+    currentWork = &work;
+    ++generation;
+    workOpen = true;
+
+    if (const auto numToWake = numSleeping.exchange (0); numToWake > 0)
+        wakeUpSignal.signal (numToWake);
+
+    work.participate (0);
+
+    // The only waiting done here is for work that a worker has already started
+    while (! work.isFinished())
+        Thread::yield();
+
+    workOpen = false;
+
+    while (numActiveWorkers.load() > 0)
+        Thread::yield();
+}
+
+b8 RealtimeWorkerThreads::isNewWorkAvailable (u32 lastGeneration) const noexcept
+{
+    return workOpen.load() && generation.load() != lastGeneration;
+}
+
+b8 RealtimeWorkerThreads::claimSleepingWorker() noexcept
+{
+    for (auto n = numSleeping.load(); n > 0;)
+        if (numSleeping.compare_exchange_weak (n, n - 1))
+            return true;
+
+    return false;
+}
+
+} // namespace drx
@@ -0,0 +1,114 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace drx
+{
+
+//==============================================================================
+/**
+    A fixed set of realtime worker threads that share some work with an audio thread.
+
+    Each call to run() hands a Work object to the workers and takes part in it on the calling
+    thread, then returns once every thread has finished with it. Handing the work over only
+    touches atomics, and idle workers sleep on a Semaphore, which the calling thread posts
+    once for each sleeping worker. So run() neither allocates nor locks, and the workers don't
+    burn CPU time between blocks.
+
+    ParallelVoiceRenderer and AudioProcessorGraph both use one of these.
+
+    @tags{Audio}
+*/
+class DRX_API  RealtimeWorkerThreads
+{
+public:
+    //==============================================================================
+    /** A unit of work that can be shared between the calling thread and the workers. */
+    struct Work
+    {
+        virtual ~Work() = default;
+
+        /** Called at the same time on the thread that called run() and on each worker.
+
+            The calling thread gets index 0, and the workers get indices from 1 to
+            getNumThreads(). This should return as soon as there's nothing left for the
+            calling thread to pick up.
+        */
+        virtual z0 participate (i32 threadIndex) = 0;
+
+        /** Возвращает true, если all of the work has been completed. */
+        virtual b8 isFinished() const = 0;
+    };
+
+    //==============================================================================
+    /** Starts some worker threads.
+
+        If the threads can't be given realtime priority, they run at the highest normal
+        priority instead. Each one is named after threadName, followed by its index.
+    */
+    RealtimeWorkerThreads (i32 numThreads, const Txt& threadName);
+
+    /** Destructor. Stops the threads, so this mustn't be called while run() is running. */
+    ~RealtimeWorkerThreads();
+
+    //==============================================================================
+    /** Returns the number of worker threads. */
+    i32 getNumThreads() const noexcept;
+
+    /** Runs some work on the calling thread and all of the workers.
+
+        This returns once the work has finished and no worker is still touching it. The
+        workers use the same denormal handling as the calling thread while they do it.
+
+        Only one thread may call this at a time.
+    */
+    z0 run (Work& work);
+
+private:
+    //==============================================================================
+    class Worker;
+
+    b8 isNewWorkAvailable (u32 lastGeneration) const noexcept;
+    b8 claimSleepingWorker() noexcept;
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<Work*> currentWork { nullptr };
+    std::atomic<u32> generation { 0 };
+    std::atomic<b8> workOpen { false }, denormalsDisabled { false };
+    std::atomic<i32> numActiveWorkers { 0 }, numSleeping { 0 };
+    Semaphore wakeUpSignal;
+
+    DRX_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RealtimeWorkerThreads)
+};
+
+} // namespace drx
@@ -1031,4 +1031,129 @@ AudioFormatWriter* AiffAudioFormat::createWriterFor (OutputStream* out,
     return nullptr;
 }
 
+//==============================================================================
+#if DRX_UNIT_TESTS
+
+class AiffAudioFormatTests final : public UnitTest
+{
+public:
+    AiffAudioFormatTests()
+        : UnitTest ("AiffAudioFormat", UnitTestCategories::audio)
+    {
+    }
+
+    z0 runTest() override
+    {
+        const auto folder = File::createTempFile ("AiffAudioFormatTests");
+        folder.createDirectory();
+
+        auto random = getRandom();
+        AiffAudioFormat aiff;
+        WavAudioFormat wav;
+
+        beginTest ("Big-endian samples are converted correctly");
+        {
+            for (auto bitDepth : { 8, 16, 24 })
+            {
+                for (i32 numChannels = 1; numChannels <= 3; ++numChannels)
+                {
+                    AudioBuffer<f32> source (numChannels, 10007);
+
+                    for (i32 ch = 0; ch < numChannels; ++ch)
+                        for (i32 i = 0; i < source.getNumSamples(); ++i)
+                            source.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+                    const auto aiffFile = folder.getChildFile ("test.aiff");
+                    const auto wavFile  = folder.getChildFile ("test.wav");
+                    writeFile (aiff, aiffFile, source, bitDepth);
+                    writeFile (wav,  wavFile,  source, bitDepth);
+
+                    // The same samples stored little-endian in a WAV are used as the reference
+                    std::unique_ptr<AudioFormatReader> reference (wav.createReaderFor (wavFile.createInputStream().release(), true));
+                    std::unique_ptr<AudioFormatReader> streamed  (aiff.createReaderFor (aiffFile.createInputStream().release(), true));
+                    std::unique_ptr<MemoryMappedAudioFormatReader> mapped (aiff.createMemoryMappedReader (aiffFile));
+                    expect (reference != nullptr && streamed != nullptr && mapped != nullptr);
+                    expect (mapped->mapEntireFile());
+
+                    // An odd start and length, plus one more destination channel than the file has
+                    const auto numToRead = source.getNumSamples() - 20;
+                    auto expected = readAsInts (*reference, numChannels + 1, 13, numToRead);
+
+                    expect (readAsInts (*streamed, numChannels + 1, 13, numToRead) == expected);
+                    expect (readAsInts (*mapped,   numChannels + 1, 13, numToRead) == expected);
+                }
+            }
+        }
+
+        beginTest ("Performance");
+        {
+            AudioBuffer<f32> source (2, 2000000);
+
+            for (i32 ch = 0; ch < 2; ++ch)
+                for (i32 i = 0; i < source.getNumSamples(); ++i)
+                    source.setSample (ch, i, random.nextFloat() * 2.0f - 1.0f);
+
+            for (auto bitDepth : { 16, 24 })
+            {
+                const auto aiffFile = folder.getChildFile ("test.aiff");
+                const auto wavFile  = folder.getChildFile ("test.wav");
+                writeFile (aiff, aiffFile, source, bitDepth);
+                writeFile (wav,  wavFile,  source, bitDepth);
+
+                std::unique_ptr<MemoryMappedAudioFormatReader> aiffReader (aiff.createMemoryMappedReader (aiffFile));
+                std::unique_ptr<MemoryMappedAudioFormatReader> wavReader (wav.createMemoryMappedReader (wavFile));
+                aiffReader->mapEntireFile();
+                wavReader->mapEntireFile();
+
+                AudioBuffer<f32> buffer (2, 4096);
+
+                auto timeReads = [&] (AudioFormatReader& reader)
+                {
+                    const auto start = Time::getHighResolutionTicks();
+
+                    for (i32 pos = 0; pos < source.getNumSamples(); pos += buffer.getNumSamples())
+                        reader.read (&buffer, 0, buffer.getNumSamples(), pos, true, true);
+
+                    return Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start) * 1000.0;
+                };
+
+                const auto wavMs = timeReads (*wavReader);
+                const auto aiffMs = timeReads (*aiffReader);
+
+                logMessage ("  " + Txt (bitDepth) + "-bit stereo, mapped: WAV " + Txt (wavMs, 2)
+                              + " ms, AIFF " + Txt (aiffMs, 2) + " ms");
+            }
+        }
+
+        folder.deleteRecursively();
+    }
+
+private:
+    static z0 writeFile (AudioFormat& format, const File& file, const AudioBuffer<f32>& data, i32 bitDepth)
+    {
+        file.deleteFile();
+
+        std::unique_ptr<AudioFormatWriter> writer (format.createWriterFor (file.createOutputStream().release(), 44100.0,
+                                                                           (u32) data.getNumChannels(), bitDepth, {}, 0));
+        jassert (writer != nullptr);
+        writer->writeFromAudioSampleBuffer (data, 0, data.getNumSamples());
+    }
+
+    static std::vector<std::vector<i32>> readAsInts (AudioFormatReader& reader, i32 numChannels, z64 start, i32 numSamples)
+    {
+        std::vector<std::vector<i32>> result ((size_t) numChannels, std::vector<i32> ((size_t) numSamples, 12345));
+        std::vector<i32*> channels;
+
+        for (auto& c : result)
+            channels.push_back (c.data());
+
+        reader.read (channels.data(), numChannels, start, numSamples, false);
+        return result;
+    }
+};
+
+static AiffAudioFormatTests aiffAudioFormatTests;
+
+#endif
+
 } // namespace drx
@@ -240,6 +240,22 @@ public:
         FlacNamespace::FLAC__stream_decoder_delete (decoder);
     }
 
+    std::unique_ptr<AudioFormatReader> createDuplicateReader() const override
+    {
+        if (input != nullptr)
+        {
+            if (auto stream = createDuplicateStream (*input))
+            {
+                auto duplicate = std::make_unique<FlacReader> (stream.release());
+
+                if (duplicate->sampleRate > 0)
+                    return duplicate;
+            }
+        }
+
+        return {};
+    }
+
     z0 useMetadata (const FlacNamespace::FLAC__StreamMetadata_StreamInfo& info)
     {
         sampleRate = info.sample_rate;
@@ -164,6 +164,22 @@ public:
         ov_clear (&ovFile);
     }
 
+    std::unique_ptr<AudioFormatReader> createDuplicateReader() const override
+    {
+        if (input != nullptr)
+        {
+            if (auto stream = createDuplicateStream (*input))
+            {
+                auto duplicate = std::make_unique<OggReader> (stream.release());
+
+                if (duplicate->sampleRate > 0)
+                    return duplicate;
+            }
+        }
+
+        return {};
+    }
+
     z0 addMetadataItem (OggVorbisNamespace::vorbis_comment* comment, tukk name, tukk metadataName)
     {
         if (auto* value = vorbis_comment_query (comment, name, 0))
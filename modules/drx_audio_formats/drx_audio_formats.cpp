@@ -47,6 +47,14 @@
 
 #include "drx_audio_formats.h"
 
+#if DRX_USE_SSE_INTRINSICS
+ #include <emmintrin.h>
+#endif
+
+#if DRX_USE_ARM_NEON
+ #include <arm_neon.h>
+#endif
+
 //==============================================================================
 #if DRX_MAC
  #include <AudioToolbox/AudioToolbox.h>
@@ -68,7 +76,9 @@
 #include "format/drx_AudioFormatWriter.cpp"
 #include "format/drx_AudioSubsectionReader.cpp"
 #include "format/drx_BufferingAudioFormatReader.cpp"
+#include "format/drx_AudioLevelPyramid.cpp"
 #include "sampler/drx_Sampler.cpp"
+#include "sampler/drx_StreamingSampler.cpp"
 #include "codecs/drx_AiffAudioFormat.cpp"
 #include "codecs/drx_CoreAudioFormat.cpp"
 #include "codecs/drx_FlacAudioFormat.cpp"
@@ -76,6 +86,7 @@
 #include "codecs/drx_OggVorbisAudioFormat.cpp"
 #include "codecs/drx_WavAudioFormat.cpp"
 #include "codecs/drx_LAMEEncoderAudioFormat.cpp"
+#include "format/drx_DecodedAudioFileCache.cpp"
 
 #if DrxPlugin_Enable_ARA
  #include "drx_audio_processors/utilities/ARA/drx_ARADocumentControllerCommon.cpp"
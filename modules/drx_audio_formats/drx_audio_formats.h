@@ -128,6 +128,7 @@
 #include "format/drx_AudioFormatReaderSource.h"
 #include "format/drx_AudioSubsectionReader.h"
 #include "format/drx_BufferingAudioFormatReader.h"
+#include "format/drx_AudioLevelPyramid.h"
 #include "codecs/drx_AiffAudioFormat.h"
 #include "codecs/drx_CoreAudioFormat.h"
 #include "codecs/drx_FlacAudioFormat.h"
@@ -136,7 +137,9 @@
 #include "codecs/drx_OggVorbisAudioFormat.h"
 #include "codecs/drx_WavAudioFormat.h"
 #include "codecs/drx_WindowsMediaAudioFormat.h"
+#include "format/drx_DecodedAudioFileCache.h"
 #include "sampler/drx_Sampler.h"
+#include "sampler/drx_StreamingSampler.h"
 
 #if DrxPlugin_Enable_ARA
  #include <drx_audio_processors/drx_audio_processors.h>
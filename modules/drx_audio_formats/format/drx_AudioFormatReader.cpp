@@ -131,6 +131,115 @@ b8 AudioFormatReader::read (i32* const* destChannels,
     return true;
 }
 
+//==============================================================================
+std::unique_ptr<AudioFormatReader> AudioFormatReader::createDuplicateReader() const
+{
+    return {};
+}
+
+std::unique_ptr<InputStream> AudioFormatReader::createDuplicateStream (const InputStream& stream)
+{
+    if (auto* fileStream = dynamic_cast<const FileInputStream*> (&stream))
+    {
+        auto duplicate = std::make_unique<FileInputStream> (fileStream->getFile());
+
+        if (duplicate->openedOk())
+            return duplicate;
+
+        return {};
+    }
+
+    if (auto* memoryStream = dynamic_cast<const MemoryInputStream*> (&stream))
+        return std::make_unique<MemoryInputStream> (memoryStream->getData(), memoryStream->getDataSize(), false);
+
+    return {};
+}
+
+b8 AudioFormatReader::readInParallel (AudioBuffer<f32>& buffer,
+                                        i32 startSample,
+                                        i32 numSamples,
+                                        z64 readerStartSample,
+                                        ThreadPool& threadPool)
+{
+    jassert (startSample >= 0 && startSample + numSamples <= buffer.getNumSamples());
+
+    // Chunk boundaries are kept to multiples of this in the source, which lines them up with
+    // the block sizes that compressed formats use, so that seeking to them is cheap
+    constexpr i32 chunkAlignment = 4096;
+    constexpr i32 minSamplesPerChunk = 65536;
+
+    const auto numChunksWanted = jmin (threadPool.getNumThreads() + 1, numSamples / minSamplesPerChunk);
+    const auto numTargetChannels = buffer.getNumChannels();
+
+    std::vector<std::unique_ptr<AudioFormatReader>> duplicates;
+
+    for (i32 i = 1; i < numChunksWanted; ++i)
+    {
+        auto duplicate = createDuplicateReader();
+
+        if (duplicate == nullptr)
+            break;
+
+        duplicates.push_back (std::move (duplicate));
+    }
+
+    if (duplicates.empty() || numTargetChannels == 0)
+        return read (&buffer, startSample, numSamples, readerStartSample, true, true);
+
+    const auto numChunks = (i32) duplicates.size() + 1;
+
+    // The write pointers are all fetched here, so that the jobs don't touch the buffer object
+    std::vector<i32*> channels ((size_t) numTargetChannels);
+
+    for (i32 ch = 0; ch < numTargetChannels; ++ch)
+        channels[(size_t) ch] = reinterpret_cast<i32*> (buffer.getWritePointer (ch, startSample));
+
+    std::vector<z64> boundaries;
+    boundaries.push_back (0);
+
+    for (i32 i = 1; i < numChunks; ++i)
+    {
+        const auto ideal = readerStartSample + (z64) numSamples * i / numChunks;
+        const auto aligned = ((ideal + chunkAlignment / 2) / chunkAlignment) * chunkAlignment;
+        boundaries.push_back (jlimit (boundaries.back(), (z64) numSamples, aligned - readerStartSample));
+    }
+
+    boundaries.push_back (numSamples);
+
+    std::atomic<b8> allOk { true };
+
+    auto readChunk = [&] (AudioFormatReader& reader, i32 chunk)
+    {
+        const auto offset = (i32) boundaries[(size_t) chunk];
+        const auto length = (i32) boundaries[(size_t) chunk + 1] - offset;
+
+        if (length <= 0)
+            return;
+
+        std::vector<i32*> dest ((size_t) numTargetChannels);
+
+        for (i32 ch = 0; ch < numTargetChannels; ++ch)
+            dest[(size_t) ch] = channels[(size_t) ch] + offset;
+
+        if (! reader.read (dest.data(), numTargetChannels, readerStartSample + offset, length, true))
+            allOk = false;
+
+        if (! reader.usesFloatingPointData)
+            convertFixedToFloat (dest.data(), numTargetChannels, length);
+    };
+
+    {
+        // This thread reads the first chunk itself while the pool reads the others
+        TaskGraph graph (threadPool);
+        auto otherChunks = graph.parallelFor (1, numChunks, [&] (i32 i) { readChunk (*duplicates[(size_t) i - 1], i); }, 1);
+
+        readChunk (*this, 0);
+        otherChunks.wait();
+    }
+
+    return allOk;
+}
+
 static b8 readChannels (AudioFormatReader& reader, i32** chans, AudioBuffer<f32>* buffer,
                           i32 startSample, i32 numSamples, z64 readerStartSample, i32 numTargetChannels,
                           b8 convertToFloat)
@@ -442,4 +551,167 @@ z0 MemoryMappedAudioFormatReader::touchSample (z64 sample) const noexcept
         jassertfalse; // you must make sure that the window contains all the samples you're going to attempt to read.
 }
 
+//==============================================================================
+#if DRX_UNIT_TESTS
+
+class AudioFormatReaderParallelReadTests final : public UnitTest
+{
+public:
+    AudioFormatReaderParallelReadTests()
+        : UnitTest ("AudioFormatReader parallel reading", UnitTestCategories::audio)
+    {
+    }
+
+    z0 runTest() override
+    {
+        ThreadPool pool (ThreadPoolOptions{}.withNumberOfThreads (3));
+        auto random = getRandom();
+
+        beginTest ("Readers that can't be duplicated are read serially");
+        {
+            const auto source = createTestSignal (random, 2, 300000);
+            WavAudioFormat format;
+            const auto data = encode (format, source, 24, 0);
+            auto reader = createReader (format, data);
+            expect (reader != nullptr);
+            expect (reader->createDuplicateReader() == nullptr);
+
+            compareWithSerialRead (*reader, pool, 0.0f);
+        }
+
+       #if DRX_USE_FLAC
+        beginTest ("FLAC");
+        {
+            const auto source = createTestSignal (random, 2, 1000000);
+            FlacAudioFormat format;
+            const auto data = encode (format, source, 24, 5);
+            auto reader = createReader (format, data);
+            expect (reader != nullptr);
+            expect (reader->createDuplicateReader() != nullptr);
+
+            compareWithSerialRead (*reader, pool, 0.0f);
+        }
+       #endif
+
+       #if DRX_USE_OGGVORBIS
+        beginTest ("Ogg Vorbis");
+        {
+            const auto source = createTestSignal (random, 2, 1000000);
+            OggVorbisAudioFormat format;
+            const auto data = encode (format, source, 16, 4);
+            auto reader = createReader (format, data);
+            expect (reader != nullptr);
+            expect (reader->createDuplicateReader() != nullptr);
+
+            compareWithSerialRead (*reader, pool, 1.0e-4f);
+        }
+       #endif
+
+       #if DRX_USE_FLAC
+        beginTest ("Performance");
+        {
+            // Ten minutes of stereo audio at 44.1kHz
+            const auto source = createTestSignal (random, 2, 44100 * 600);
+            FlacAudioFormat format;
+            const auto data = encode (format, source, 16, 5);
+            auto reader = createReader (format, data);
+            const auto length = (i32) reader->lengthInSamples;
+            AudioBuffer<f32> serial (2, length), parallel (2, length);
+
+            auto start = Time::getHighResolutionTicks();
+            reader->read (&serial, 0, length, 0, true, true);
+            const auto serialSeconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+
+            start = Time::getHighResolutionTicks();
+            reader->readInParallel (parallel, 0, length, 0, pool);
+            const auto parallelSeconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+
+            expect (serial == parallel);
+            logMessage ("  10 minutes of FLAC: serial " + Txt (serialSeconds * 1000.0, 1) + " ms, parallel "
+                          + Txt (parallelSeconds * 1000.0, 1) + " ms with " + Txt (pool.getNumThreads() + 1)
+                          + " threads on " + Txt (SystemStats::getNumCpus()) + " CPUs");
+        }
+       #endif
+    }
+
+private:
+    static AudioBuffer<f32> createTestSignal (Random& random, i32 numChannels, i32 numSamples)
+    {
+        AudioBuffer<f32> buffer (numChannels, numSamples);
+
+        for (i32 ch = 0; ch < numChannels; ++ch)
+        {
+            auto* d = buffer.getWritePointer (ch);
+            const auto frequency = 0.01 + 0.02 * ch;
+
+            for (i32 i = 0; i < numSamples; ++i)
+                d[i] = 0.5f * (f32) std::sin (frequency * i) + 0.1f * (random.nextFloat() - 0.5f);
+        }
+
+        return buffer;
+    }
+
+    static MemoryBlock encode (AudioFormat& format, const AudioBuffer<f32>& source, i32 bitDepth, i32 quality)
+    {
+        MemoryBlock data;
+
+        {
+            std::unique_ptr<AudioFormatWriter> writer (format.createWriterFor (new MemoryOutputStream (data, false), 44100.0,
+                                                                               (u32) source.getNumChannels(), bitDepth, {}, quality));
+            jassert (writer != nullptr);
+            writer->writeFromAudioSampleBuffer (source, 0, source.getNumSamples());
+        }
+
+        return data;
+    }
+
+    static std::unique_ptr<AudioFormatReader> createReader (AudioFormat& format, const MemoryBlock& data)
+    {
+        return std::unique_ptr<AudioFormatReader> (format.createReaderFor (new MemoryInputStream (data, false), true));
+    }
+
+    z0 compareWithSerialRead (AudioFormatReader& reader, ThreadPool& pool, f32 tolerance)
+    {
+        const auto length = (i32) reader.lengthInSamples;
+
+        // Some unaligned ranges, including ones that go past the end of the stream
+        const Range<z64> ranges[] = { { 0, length }, { 12345, 712345 }, { length - 100000, length + 5000 }, { -3000, 200000 } };
+
+        for (auto range : ranges)
+        {
+            const auto numSamples = (i32) range.getLength();
+            AudioBuffer<f32> expected (2, numSamples + 10), actual (2, numSamples + 10);
+            expected.clear();
+            actual.clear();
+
+            expect (reader.read (&expected, 10, numSamples, range.getStart(), true, true));
+            expect (reader.readInParallel (actual, 10, numSamples, range.getStart(), pool));
+
+            f32 maxError = 0;
+
+            for (i32 ch = 0; ch < 2; ++ch)
+                for (i32 i = 0; i < expected.getNumSamples(); ++i)
+                    maxError = jmax (maxError, std::abs (expected.getSample (ch, i) - actual.getSample (ch, i)));
+
+            expect (maxError <= tolerance, "Error " + Txt (maxError) + " reading from " + Txt (range.getStart()));
+        }
+
+        // A mono destination only gets the first channel
+        AudioBuffer<f32> expected (1, 300000), actual (1, 300000);
+        reader.read (&expected, 0, 300000, 1000, true, true);
+        reader.readInParallel (actual, 0, 300000, 1000, pool);
+
+        f32 maxError = 0;
+
+        for (i32 i = 0; i < 300000; ++i)
+            maxError = jmax (maxError, std::abs (expected.getSample (0, i) - actual.getSample (0, i)));
+
+        expect (maxError <= tolerance);
+    }
+};
+
+static AudioFormatReaderParallelReadTests audioFormatReaderParallelReadTests;
+
+#endif
+
 } // namespace drx
@@ -160,6 +160,33 @@ public:
                b8 useReaderLeftChan,
                b8 useReaderRightChan);
 
+    /** Fills a section of an AudioBuffer from this reader, decoding several parts of it at once.
+
+        The range is split into chunks, one for each of the pool's threads plus one for the
+        calling thread, and each chunk is decoded by its own reader, created with
+        createDuplicateReader(). The result is the same as calling
+        read (&buffer, startSampleInDestBuffer, numSamples, readerStartSample, true, true).
+
+        If this reader can't be duplicated, or the range is too short to be worth splitting,
+        it's read serially on the calling thread instead.
+
+        @returns    true if the operation succeeded, false if there was an error
+        @see createDuplicateReader
+    */
+    b8 readInParallel (AudioBuffer<f32>& buffer,
+                         i32 startSampleInDestBuffer,
+                         i32 numSamples,
+                         z64 readerStartSample,
+                         ThreadPool& threadPool);
+
+    /** Creates another reader for the same data, which can be used independently of this one.
+
+        This is what readInParallel() uses to decode different parts of a stream at the same
+        time. Formats that can do this override it; the default returns nullptr, which means
+        that the reader can only be used serially.
+    */
+    virtual std::unique_ptr<AudioFormatReader> createDuplicateReader() const;
+
     /** Finds the highest and lowest sample levels from a section of the audio stream.
 
         This will read a block of samples from the stream, and measure the
@@ -285,6 +312,11 @@ public:
 
 protected:
     //==============================================================================
+    /** Creates a new stream for the same data as the given one, if it's a FileInputStream
+        or a MemoryInputStream. This can be used to implement createDuplicateReader().
+    */
+    static std::unique_ptr<InputStream> createDuplicateStream (const InputStream&);
+
     /** Used by AudioFormatReader subclasses to copy data to different formats. */
     template <class DestSampleType, class SourceSampleType, class SourceEndianness>
     struct ReadHelper
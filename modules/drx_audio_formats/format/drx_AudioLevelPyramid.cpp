@@ -0,0 +1,843 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace drx
+{
+
+AudioLevelPyramid::Bucket AudioLevelPyramid::Bucket::fromLevels (f32 minValue, f32 maxValue, f32 meanSquare) noexcept
+{
+    // The minimum is rounded down and the maximum up, so that the stored range always
+    // includes the samples that it came from
+    Bucket b;
+    b.minimum = (i16) jlimit (-32767, 32767, (i32) std::floor (minValue * 32767.0f));
+    b.maximum = (i16) jlimit (-32767, 32767, (i32) std::ceil  (maxValue * 32767.0f));
+    b.rms = (u16) jlimit (0, 65535, roundToInt (std::sqrt (meanSquare) * 65535.0f));
+    return b;
+}
+
+f32 AudioLevelPyramid::Bucket::getMeanSquare() const noexcept
+{
+    return square ((f32) rms / 65535.0f);
+}
+
+AudioLevelPyramid::Levels AudioLevelPyramid::Bucket::toLevels() const noexcept
+{
+    if (isEmpty())
+        return {};
+
+    return { (f32) minimum / 32767.0f, (f32) maximum / 32767.0f, (f32) rms / 65535.0f, true };
+}
+
+//==============================================================================
+AudioLevelPyramid::AudioLevelPyramid (i32 numSamplesPerBucket)
+    : samplesPerBucket (jmax (1, numSamplesPerBucket))
+{
+}
+
+AudioLevelPyramid::~AudioLevelPyramid() = default;
+AudioLevelPyramid::AudioLevelPyramid (AudioLevelPyramid&&) noexcept = default;
+AudioLevelPyramid& AudioLevelPyramid::operator= (AudioLevelPyramid&&) noexcept = default;
+
+z0 AudioLevelPyramid::reset (i32 newNumChannels, z64 newTotalSamples)
+{
+    jassert (newNumChannels >= 0 && newTotalSamples >= 0);
+
+    numChannels = jmax (0, newNumChannels);
+    totalSamples = jmax ((z64) 0, newTotalSamples);
+    layers.clear();
+    createLayers ((i32) ((totalSamples + samplesPerBucket - 1) / samplesPerBucket));
+}
+
+AudioLevelPyramid::Bucket* AudioLevelPyramid::getBuckets (i32 layer, i32 channel) noexcept
+{
+    auto& l = layers[(size_t) layer];
+    return l.buckets.data() + (size_t) channel * (size_t) l.numBuckets;
+}
+
+const AudioLevelPyramid::Bucket* AudioLevelPyramid::getBuckets (i32 layer, i32 channel) const noexcept
+{
+    auto& l = layers[(size_t) layer];
+    return l.buckets.data() + (size_t) channel * (size_t) l.numBuckets;
+}
+
+z0 AudioLevelPyramid::createLayers (i32 numBaseBuckets)
+{
+    std::vector<Layer> newLayers;
+    auto numBuckets = jmax (1, numBaseBuckets);
+    auto bucketSize = (z64) samplesPerBucket;
+
+    for (;;)
+    {
+        Layer layer;
+        layer.samplesPerBucket = bucketSize;
+        layer.numBuckets = numBuckets;
+        layer.buckets.resize ((size_t) numBuckets * (size_t) numChannels);
+        newLayers.push_back (std::move (layer));
+
+        if (numBuckets == 1)
+            break;
+
+        numBuckets = (numBuckets + bucketsPerParent - 1) / bucketsPerParent;
+        bucketSize *= bucketsPerParent;
+    }
+
+    std::swap (layers, newLayers);
+
+    if (newLayers.empty())
+        return;
+
+    // Growing: keep the data that's already been added, and rebuild the layers above it
+    const auto numToKeep = jmin (newLayers.front().numBuckets, layers.front().numBuckets);
+
+    for (i32 ch = 0; ch < numChannels; ++ch)
+    {
+        auto* src = newLayers.front().buckets.data() + (size_t) ch * (size_t) newLayers.front().numBuckets;
+        std::copy (src, src + numToKeep, getBuckets (0, ch));
+    }
+
+    if (numToKeep > 0)
+        updateLayersAbove (0, numToKeep - 1);
+}
+
+z0 AudioLevelPyramid::ensureSize (z64 numSamples)
+{
+    const auto numBucketsNeeded = (i32) ((numSamples + samplesPerBucket - 1) / samplesPerBucket);
+    const auto numBucketsAllocated = layers.empty() ? 0 : layers.front().numBuckets;
+
+    // Grows geometrically, so that adding a stream in small blocks doesn't keep rebuilding it
+    if (numBucketsNeeded > numBucketsAllocated)
+        createLayers (jmax (numBucketsNeeded, numBucketsAllocated * 2));
+}
+
+z0 AudioLevelPyramid::updateLayersAbove (i32 firstBucket, i32 lastBucket)
+{
+    for (i32 layer = 1; layer < (i32) layers.size(); ++layer)
+    {
+        firstBucket /= bucketsPerParent;
+        lastBucket  /= bucketsPerParent;
+
+        const auto numBelow = layers[(size_t) layer - 1].numBuckets;
+
+        for (i32 ch = 0; ch < numChannels; ++ch)
+        {
+            const auto* below = getBuckets (layer - 1, ch);
+            auto* dest = getBuckets (layer, ch);
+
+            for (auto i = firstBucket; i <= lastBucket; ++i)
+            {
+                Bucket result;
+                f32 sumOfMeanSquares = 0;
+                i32 numUsed = 0;
+
+                for (auto child = i * bucketsPerParent; child < jmin (numBelow, (i + 1) * bucketsPerParent); ++child)
+                {
+                    const auto& b = below[child];
+
+                    if (! b.isEmpty())
+                    {
+                        result.minimum = jmin (result.minimum, b.minimum);
+                        result.maximum = jmax (result.maximum, b.maximum);
+                        sumOfMeanSquares += b.getMeanSquare();
+                        ++numUsed;
+                    }
+                }
+
+                if (numUsed > 0)
+                    result.rms = (u16) jlimit (0, 65535, roundToInt (std::sqrt (sumOfMeanSquares / (f32) numUsed) * 65535.0f));
+
+                dest[i] = result;
+            }
+        }
+    }
+}
+
+AudioLevelPyramid::BlockLevels AudioLevelPyramid::analyseBlock (i32 bucketSize, z64 startSample, const AudioBuffer<f32>& source,
+                                                                i32 startOffsetInBuffer, i32 numSamples)
+{
+    jassert (bucketSize > 0
+              && startSample >= 0
+              && startOffsetInBuffer >= 0
+              && startOffsetInBuffer + numSamples <= source.getNumSamples());
+
+    const auto sumOfSquares = [] (const f32* data, i32 num) noexcept
+    {
+        // Four separate sums, which the compiler can keep in one vector register
+        f32 sums[4] {};
+        i32 i = 0;
+
+        for (; i + 4 <= num; i += 4)
+            for (i32 j = 0; j < 4; ++j)
+                sums[j] += data[i + j] * data[i + j];
+
+        for (; i < num; ++i)
+            sums[0] += data[i] * data[i];
+
+        return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+    };
+
+    BlockLevels result;
+
+    if (numSamples <= 0 || bucketSize <= 0)
+        return result;
+
+    const auto endSample = startSample + numSamples;
+    const auto firstBucket = startSample / bucketSize;
+
+    result.startSample = startSample;
+    result.numSamples = numSamples;
+    result.samplesPerBucket = bucketSize;
+    result.numChannels = source.getNumChannels();
+    result.numBuckets = (i32) ((endSample - 1) / bucketSize - firstBucket + 1);
+    result.sections.resize ((size_t) result.numChannels * (size_t) result.numBuckets);
+
+    for (i32 ch = 0; ch < result.numChannels; ++ch)
+    {
+        const auto* data = source.getReadPointer (ch, startOffsetInBuffer);
+        auto* section = result.sections.data() + (size_t) ch * (size_t) result.numBuckets;
+
+        for (auto pos = startSample; pos < endSample; ++section)
+        {
+            const auto bucketEnd = (pos / bucketSize + 1) * bucketSize;
+            const auto num = (i32) (jmin (bucketEnd, endSample) - pos);
+            const auto* samples = data + (pos - startSample);
+            const auto range = FloatVectorOperations::findMinAndMax (samples, num);
+
+            *section = { range.getStart(), range.getEnd(), sumOfSquares (samples, num), num };
+            pos += num;
+        }
+    }
+
+    return result;
+}
+
+z0 AudioLevelPyramid::setBuckets (const BlockLevels& block) noexcept
+{
+    jassert (block.samplesPerBucket == samplesPerBucket);
+
+    const auto firstBucket = (i32) (block.startSample / samplesPerBucket);
+
+    // Only the first bucket can start before the block. The samples before it are assumed
+    // to be the ones that are already in it, so it's merged with them, and every other
+    // bucket that the block covers is replaced.
+    const auto numBefore = (i32) (block.startSample - (z64) firstBucket * samplesPerBucket);
+
+    for (i32 ch = 0; ch < jmin (numChannels, block.numChannels); ++ch)
+    {
+        const auto* sections = block.sections.data() + (size_t) ch * (size_t) block.numBuckets;
+        auto* buckets = getBuckets (0, ch) + firstBucket;
+
+        for (i32 i = 0; i < block.numBuckets; ++i)
+        {
+            const auto& section = sections[i];
+            auto range = Range<f32> (section.minimum, section.maximum);
+            auto meanSquare = section.sumOfSquares / (f32) section.numSamples;
+            auto& bucket = buckets[i];
+
+            if (i == 0 && numBefore > 0 && ! bucket.isEmpty())
+            {
+                const auto existing = bucket.toLevels();
+                range = range.getUnionWith ({ existing.minimum, existing.maximum });
+                meanSquare = (section.sumOfSquares + bucket.getMeanSquare() * (f32) numBefore)
+                               / (f32) (numBefore + section.numSamples);
+            }
+
+            bucket = Bucket::fromLevels (range.getStart(), range.getEnd(), meanSquare);
+        }
+    }
+}
+
+z0 AudioLevelPyramid::addBlock (const BlockLevels& block)
+{
+    // A block measured for a different bucket size is ignored, as the pyramid may have been
+    // reloaded with another size since the block was analysed
+    if (block.numBuckets == 0 || block.samplesPerBucket != samplesPerBucket)
+        return;
+
+    const auto endSample = block.startSample + block.numSamples;
+
+    ensureSize (endSample);
+    totalSamples = jmax (totalSamples, endSample);
+
+    setBuckets (block);
+    updateLayersAbove ((i32) (block.startSample / samplesPerBucket), (i32) ((endSample - 1) / samplesPerBucket));
+}
+
+z0 AudioLevelPyramid::addBlock (z64 startSample, const AudioBuffer<f32>& source,
+                                  i32 startOffsetInBuffer, i32 numSamples)
+{
+    addBlock (analyseBlock (samplesPerBucket, startSample, source, startOffsetInBuffer, numSamples));
+}
+
+z0 AudioLevelPyramid::setBucketLevels (i32 channel, i32 firstBucket, const Levels* levels, i32 numBuckets)
+{
+    jassert (firstBucket >= 0);
+
+    if (! isPositiveAndBelow (channel, numChannels) || numBuckets <= 0)
+        return;
+
+    const auto endSample = (z64) (firstBucket + numBuckets) * samplesPerBucket;
+    ensureSize (endSample);
+    totalSamples = jmax (totalSamples, endSample);
+
+    auto* dest = getBuckets (0, channel) + firstBucket;
+
+    for (i32 i = 0; i < numBuckets; ++i)
+        dest[i] = levels[i].hasData ? Bucket::fromLevels (levels[i].minimum, levels[i].maximum, square (levels[i].rms))
+                                    : Bucket();
+
+    updateLayersAbove (firstBucket, firstBucket + numBuckets - 1);
+}
+
+b8 AudioLevelPyramid::build (AudioFormatReader& reader, ThreadPool* threadPool)
+{
+    reset ((i32) reader.numChannels, reader.lengthInSamples);
+
+    if (numChannels == 0 || totalSamples == 0)
+        return true;
+
+    // Chunks are whole numbers of buckets, so that no two threads write to the same bucket
+    const auto samplesPerChunk = (z64) samplesPerBucket * jmax (1, 65536 / samplesPerBucket);
+    const auto numChunks = (i32) ((totalSamples + samplesPerChunk - 1) / samplesPerChunk);
+
+    std::vector<std::unique_ptr<AudioFormatReader>> duplicates;
+
+    if (threadPool != nullptr)
+    {
+        for (i32 i = 0; i < jmin (threadPool->getNumThreads(), numChunks - 1); ++i)
+        {
+            auto duplicate = reader.createDuplicateReader();
+
+            if (duplicate == nullptr)
+                break;
+
+            duplicates.push_back (std::move (duplicate));
+        }
+    }
+
+    std::atomic<i32> nextChunk { 0 };
+    std::atomic<b8> allOk { true };
+
+    const auto analyseChunks = [&] (AudioFormatReader& chunkReader)
+    {
+        AudioBuffer<f32> buffer (numChannels, (i32) samplesPerChunk);
+
+        for (auto chunk = nextChunk++; chunk < numChunks; chunk = nextChunk++)
+        {
+            const auto start = chunk * samplesPerChunk;
+            const auto num = (i32) jmin (samplesPerChunk, totalSamples - start);
+
+            if (! chunkReader.read (&buffer, 0, num, start, true, true))
+                allOk = false;
+
+            setBuckets (analyseBlock (samplesPerBucket, start, buffer, 0, num));
+        }
+    };
+
+    if (duplicates.empty())
+    {
+        analyseChunks (reader);
+    }
+    else
+    {
+        ThreadPool::JobGroup group (*threadPool);
+
+        for (auto& duplicate : duplicates)
+            group.addJob ([&analyseChunks, r = duplicate.get()] { analyseChunks (*r); });
+
+        analyseChunks (reader);
+        group.wait();
+    }
+
+    updateLayersAbove (0, getNumBucketsUsed (0) - 1);
+    return allOk;
+}
+
+//==============================================================================
+size_t AudioLevelPyramid::getMemoryUsage() const noexcept
+{
+    size_t total = 0;
+
+    for (auto& layer : layers)
+        total += layer.buckets.size() * sizeof (Bucket);
+
+    return total;
+}
+
+i32 AudioLevelPyramid::getNumBucketsUsed (i32 layer) const noexcept
+{
+    const auto& l = layers[(size_t) layer];
+    return (i32) jmin ((z64) l.numBuckets, (totalSamples + l.samplesPerBucket - 1) / l.samplesPerBucket);
+}
+
+i32 AudioLevelPyramid::findLayerFor (f64 numSamples) const noexcept
+{
+    i32 layer = 0;
+
+    while (layer + 1 < (i32) layers.size() && (f64) layers[(size_t) layer + 1].samplesPerBucket <= numSamples)
+        ++layer;
+
+    return layer;
+}
+
+AudioLevelPyramid::Levels AudioLevelPyramid::getLevelsFromLayer (i32 layer, i32 channel,
+                                                                 z64 startSample, z64 endSample) const noexcept
+{
+    const auto bucketSize = layers[(size_t) layer].samplesPerBucket;
+    const auto first = jmax ((z64) 0, startSample) / bucketSize;
+    const auto last  = jmin ((z64) getNumBucketsUsed (layer) - 1, (endSample - 1) / bucketSize);
+
+    if (endSample <= 0 || first > last)
+        return {};
+
+    const auto* buckets = getBuckets (layer, channel);
+    Bucket result;
+    f32 sumOfMeanSquares = 0;
+    i32 numUsed = 0;
+
+    for (auto i = (i32) first; i <= (i32) last; ++i)
+    {
+        const auto& b = buckets[i];
+
+        if (! b.isEmpty())
+        {
+            result.minimum = jmin (result.minimum, b.minimum);
+            result.maximum = jmax (result.maximum, b.maximum);
+            sumOfMeanSquares += b.getMeanSquare();
+            ++numUsed;
+        }
+    }
+
+    if (numUsed == 0)
+        return {};
+
+    auto levels = result.toLevels();
+    levels.rms = std::sqrt (sumOfMeanSquares / (f32) numUsed);
+    return levels;
+}
+
+AudioLevelPyramid::Levels AudioLevelPyramid::getLevels (i32 channel, z64 startSample, z64 endSample) const noexcept
+{
+    if (! isPositiveAndBelow (channel, numChannels) || endSample <= startSample)
+        return {};
+
+    return getLevelsFromLayer (findLayerFor ((f64) (endSample - startSample)), channel, startSample, endSample);
+}
+
+z0 AudioLevelPyramid::getLevels (i32 channel, f64 startSample, f64 samplesPerPixel,
+                                   Levels* results, i32 numPixels) const noexcept
+{
+    if (! isPositiveAndBelow (channel, numChannels) || samplesPerPixel <= 0)
+    {
+        std::fill (results, results + numPixels, Levels());
+        return;
+    }
+
+    const auto layer = findLayerFor (samplesPerPixel);
+    auto start = (z64) std::floor (startSample);
+
+    for (i32 i = 0; i < numPixels; ++i)
+    {
+        const auto end = jmax (start + 1, (z64) std::floor (startSample + (i + 1) * samplesPerPixel));
+        results[i] = getLevelsFromLayer (layer, channel, start, end);
+        start = end;
+    }
+}
+
+//==============================================================================
+static constexpr tukk levelPyramidMagic = "jalp";
+
+z0 AudioLevelPyramid::writeTo (OutputStream& output) const
+{
+    const auto numBuckets = layers.empty() ? 0 : getNumBucketsUsed (0);
+
+    output.write (levelPyramidMagic, 4);
+    output.writeInt (samplesPerBucket);
+    output.writeInt (numChannels);
+    output.writeInt64 (totalSamples);
+    output.writeInt (numBuckets);
+
+    for (i32 ch = 0; ch < numChannels; ++ch)
+    {
+        const auto* buckets = getBuckets (0, ch);
+
+        for (i32 i = 0; i < numBuckets; ++i)
+        {
+            output.writeShort (buckets[i].minimum);
+            output.writeShort (buckets[i].maximum);
+            output.writeByte ((t8) roundToInt (std::sqrt ((f32) buckets[i].rms / 65535.0f) * 255.0f));
+        }
+    }
+}
+
+b8 AudioLevelPyramid::readFrom (InputStream& input)
+{
+    char magic[4] = {};
+    const auto isValid = input.read (magic, 4) == 4 && memcmp (magic, levelPyramidMagic, 4) == 0;
+
+    const auto newSamplesPerBucket = input.readInt();
+    const auto newNumChannels = input.readInt();
+    const auto newTotalSamples = input.readInt64();
+    const auto numBuckets = input.readInt();
+
+    const auto numBytesNeeded = (z64) numBuckets * newNumChannels * 5;
+    const auto streamLength = input.getTotalLength();
+
+    if (! isValid
+         || newSamplesPerBucket <= 0
+         || ! isPositiveAndNotGreaterThan (newNumChannels, 1024)
+         || newTotalSamples < 0
+         || numBuckets != (newTotalSamples + newSamplesPerBucket - 1) / newSamplesPerBucket
+         || (streamLength >= 0 && input.getNumBytesRemaining() < numBytesNeeded))
+    {
+        reset (0, 0);
+        return false;
+    }
+
+    samplesPerBucket = newSamplesPerBucket;
+    reset (newNumChannels, newTotalSamples);
+
+    for (i32 ch = 0; ch < numChannels; ++ch)
+    {
+        auto* buckets = getBuckets (0, ch);
+
+        for (i32 i = 0; i < numBuckets; ++i)
+        {
+            buckets[i].minimum = input.readShort();
+            buckets[i].maximum = input.readShort();
+            buckets[i].rms = (u16) roundToInt (square ((f32) (u8) input.readByte() / 255.0f) * 65535.0f);
+        }
+    }
+
+    if (numBuckets > 0)
+        updateLayersAbove (0, numBuckets - 1);
+
+    return true;
+}
+
+//==============================================================================
+#if DRX_UNIT_TESTS
+
+class AudioLevelPyramidTests final : public UnitTest
+{
+public:
+    AudioLevelPyramidTests()
+        : UnitTest ("AudioLevelPyramid", UnitTestCategories::audio)
+    {
+    }
+
+    z0 runTest() override
+    {
+        auto random = getRandom();
+
+        beginTest ("Levels match the audio");
+        {
+            const auto source = createTestSignal (random, 2, 100000);
+            AudioLevelPyramid pyramid (64);
+            pyramid.reset (2, source.getNumSamples());
+            pyramid.addBlock (0, source, 0, source.getNumSamples());
+
+            expectEquals (pyramid.getTotalSamples(), (z64) source.getNumSamples());
+            expectEquals (pyramid.getNumLayers(), 7);
+
+            for (i32 i = 0; i < 200; ++i)
+            {
+                const auto channel = random.nextInt (2);
+                const auto start = (z64) random.nextInt (source.getNumSamples());
+                const auto end = jmin ((z64) source.getNumSamples(), start + 1 + random.nextInt (30000));
+                const auto levels = pyramid.getLevels (channel, start, end);
+                const auto actual = source.findMinMax (channel, (i32) start, (i32) (end - start));
+
+                // The result may include a little of the audio either side, but never less
+                expect (levels.hasData);
+                expect (levels.minimum <= actual.getStart() && levels.maximum >= actual.getEnd());
+            }
+
+            // Sections that are whole buckets of some layer give exact results
+            for (i32 layerSize : { 64, 256, 1024, 4096, 16384 })
+            {
+                const auto start = (z64) layerSize * random.nextInt (source.getNumSamples() / layerSize);
+                const auto levels = pyramid.getLevels (1, start, start + layerSize);
+                const auto actual = source.findMinMax (1, (i32) start, layerSize);
+
+                expectWithinAbsoluteError (levels.minimum, actual.getStart(), 1.0e-4f);
+                expectWithinAbsoluteError (levels.maximum, actual.getEnd(), 1.0e-4f);
+                expectWithinAbsoluteError (levels.rms, source.getRMSLevel (1, (i32) start, layerSize), 1.0e-3f);
+            }
+
+            expect (! pyramid.getLevels (0, 200000, 300000).hasData);
+            expect (! pyramid.getLevels (2, 0, 1000).hasData);
+        }
+
+        beginTest ("Blocks of any size give the same result");
+        {
+            const auto source = createTestSignal (random, 2, 50000);
+            AudioLevelPyramid expected (100), actual (100);
+            expected.reset (2, source.getNumSamples());
+            expected.addBlock (0, source, 0, source.getNumSamples());
+
+            // Starting with no length set, so that the pyramid has to grow as the blocks arrive.
+            // The second pass replaces the first, which has different content.
+            actual.reset (2, 0);
+            const auto earlierContent = createTestSignal (random, 2, source.getNumSamples());
+
+            for (const auto* pass : { &earlierContent, &source })
+            {
+                for (i32 pos = 0; pos < source.getNumSamples();)
+                {
+                    const auto num = jmin (source.getNumSamples() - pos, 100 + random.nextInt (900));
+                    actual.addBlock (pos, *pass, pos, num);
+                    pos += num;
+                }
+            }
+
+            expectEquals (actual.getTotalSamples(), expected.getTotalSamples());
+
+            for (i32 ch = 0; ch < 2; ++ch)
+            {
+                for (z64 pos = 0; pos < source.getNumSamples(); pos += 100)
+                {
+                    const auto a = actual.getLevels (ch, pos, pos + 100);
+                    const auto e = expected.getLevels (ch, pos, pos + 100);
+
+                    expectEquals (a.minimum, e.minimum);
+                    expectEquals (a.maximum, e.maximum);
+                    expectWithinAbsoluteError (a.rms, e.rms, 1.0e-4f);
+                }
+            }
+        }
+
+        beginTest ("Pixel queries");
+        {
+            const auto source = createTestSignal (random, 1, 200000);
+            AudioLevelPyramid pyramid (32);
+            pyramid.reset (1, source.getNumSamples());
+            pyramid.addBlock (0, source, 0, source.getNumSamples());
+
+            for (auto samplesPerPixel : { 10.0, 32.0, 77.7, 512.0, 1999.0 })
+            {
+                std::vector<AudioLevelPyramid::Levels> pixels (80);
+                const auto start = 12345.6;
+                pyramid.getLevels (0, start, samplesPerPixel, pixels.data(), (i32) pixels.size());
+
+                for (i32 i = 0; i < (i32) pixels.size(); ++i)
+                {
+                    const auto s0 = (i32) std::floor (start + i * samplesPerPixel);
+                    const auto s1 = jmax (s0 + 1, (i32) std::floor (start + (i + 1) * samplesPerPixel));
+                    const auto actual = source.findMinMax (0, s0, s1 - s0);
+
+                    expect (pixels[(size_t) i].minimum <= actual.getStart() && pixels[(size_t) i].maximum >= actual.getEnd());
+                }
+            }
+        }
+
+        beginTest ("Building from a reader");
+        {
+            const auto source = createTestSignal (random, 2, 400000);
+            AudioLevelPyramid expected (256);
+            expected.reset (2, source.getNumSamples());
+            expected.addBlock (0, source, 0, source.getNumSamples());
+
+            ThreadPool pool (ThreadPoolOptions{}.withNumberOfThreads (3));
+
+            WavAudioFormat wav;
+            const auto wavData = encode (wav, source, 32);
+            auto wavReader = createReader (wav, wavData);
+
+            AudioLevelPyramid fromWav (256);
+            expect (fromWav.build (*wavReader, &pool));
+            expectSimilar (fromWav, expected);
+
+           #if DRX_USE_FLAC
+            FlacAudioFormat flac;
+            const auto flacData = encode (flac, source, 24);
+            auto flacReader = createReader (flac, flacData);
+
+            AudioLevelPyramid serial (256), parallel (256);
+            expect (serial.build (*flacReader));
+            expect (parallel.build (*flacReader, &pool));
+            expect (getData (serial) == getData (parallel));
+            expectSimilar (parallel, expected);
+           #endif
+        }
+
+        beginTest ("Saving and loading");
+        {
+            const auto source = createTestSignal (random, 3, 12345);
+            AudioLevelPyramid original (50);
+            original.reset (3, 0);
+            original.addBlock (0, source, 0, source.getNumSamples());
+
+            const auto data = getData (original);
+            AudioLevelPyramid loaded (1000);
+            MemoryInputStream in (data, false);
+            expect (loaded.readFrom (in));
+
+            expectEquals (loaded.getSamplesPerBucket(), 50);
+            expectEquals (loaded.getNumChannels(), 3);
+            expectEquals (loaded.getTotalSamples(), (z64) 12345);
+            expectEquals (loaded.getNumLayers(), original.getNumLayers());
+            expect (getData (loaded) == data);
+
+            for (i32 ch = 0; ch < 3; ++ch)
+            {
+                const auto a = loaded.getLevels (ch, 0, 12345);
+                const auto e = original.getLevels (ch, 0, 12345);
+                expectEquals (a.minimum, e.minimum);
+                expectEquals (a.maximum, e.maximum);
+
+                // The RMS level is saved to 8 bits
+                expectWithinAbsoluteError (a.rms, e.rms, 0.005f);
+            }
+
+            MemoryInputStream truncated (data.getData(), data.getSize() - 10, false);
+            expect (! loaded.readFrom (truncated));
+            expectEquals (loaded.getNumChannels(), 0);
+
+            MemoryInputStream garbage ("not a pyramid", 13, false);
+            expect (! loaded.readFrom (garbage));
+        }
+
+        beginTest ("Performance");
+        {
+            // An hour of mono audio, added in blocks
+            const auto block = createTestSignal (random, 1, 65536);
+            const auto totalLength = (z64) 44100 * 3600;
+            AudioLevelPyramid pyramid (256);
+            pyramid.reset (1, totalLength);
+
+            auto start = Time::getHighResolutionTicks();
+
+            for (z64 pos = 0; pos < totalLength; pos += block.getNumSamples())
+                pyramid.addBlock (pos, block, 0, (i32) jmin ((z64) block.getNumSamples(), totalLength - pos));
+
+            const auto buildSeconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+            Txt results;
+
+            std::vector<AudioLevelPyramid::Levels> pixels (1000);
+
+            for (auto secondsVisible : { 0.1, 10.0, 600.0, 3600.0 })
+            {
+                const auto samplesPerPixel = secondsVisible * 44100.0 / (f64) pixels.size();
+                constexpr i32 numRepeats = 100;
+                start = Time::getHighResolutionTicks();
+
+                for (i32 i = 0; i < numRepeats; ++i)
+                    pyramid.getLevels (0, 1000.0 * i, samplesPerPixel, pixels.data(), (i32) pixels.size());
+
+                const auto seconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+                results << " " << secondsVisible << "s " << Txt (seconds * 1.0e6 / numRepeats, 1) << " us,";
+            }
+
+            logMessage ("  1 hour: built in " + Txt (buildSeconds * 1000.0, 1) + " ms, "
+                        + Txt ((f64) pyramid.getMemoryUsage() / (1024.0 * 1024.0), 2) + " MB; 1000 pixels:"
+                        + results.dropLastCharacters (1));
+        }
+    }
+
+private:
+    static AudioBuffer<f32> createTestSignal (Random& random, i32 numChannels, i32 numSamples)
+    {
+        AudioBuffer<f32> buffer (numChannels, numSamples);
+
+        for (i32 ch = 0; ch < numChannels; ++ch)
+        {
+            auto* d = buffer.getWritePointer (ch);
+            const auto frequency = 0.01 + 0.02 * ch;
+
+            // A sine with a slowly changing level, plus some noise
+            for (i32 i = 0; i < numSamples; ++i)
+                d[i] = 0.8f * (f32) (std::sin (frequency * i) * std::sin (0.0001 * i))
+                         + 0.1f * (random.nextFloat() - 0.5f);
+        }
+
+        return buffer;
+    }
+
+    static MemoryBlock encode (AudioFormat& format, const AudioBuffer<f32>& source, i32 bitDepth)
+    {
+        MemoryBlock data;
+
+        {
+            std::unique_ptr<AudioFormatWriter> writer (format.createWriterFor (new MemoryOutputStream (data, false), 44100.0,
+                                                                               (u32) source.getNumChannels(), bitDepth, {}, 0));
+            jassert (writer != nullptr);
+            writer->writeFromAudioSampleBuffer (source, 0, source.getNumSamples());
+        }
+
+        return data;
+    }
+
+    static std::unique_ptr<AudioFormatReader> createReader (AudioFormat& format, const MemoryBlock& data)
+    {
+        return std::unique_ptr<AudioFormatReader> (format.createReaderFor (new MemoryInputStream (data, false), true));
+    }
+
+    z0 expectSimilar (const AudioLevelPyramid& actual, const AudioLevelPyramid& expected)
+    {
+        expectEquals (actual.getTotalSamples(), expected.getTotalSamples());
+        expectEquals (actual.getNumChannels(), expected.getNumChannels());
+
+        const auto bucketSize = expected.getSamplesPerBucket();
+        f32 maxError = 0;
+
+        for (i32 ch = 0; ch < expected.getNumChannels(); ++ch)
+        {
+            for (z64 pos = 0; pos < expected.getTotalSamples(); pos += bucketSize)
+            {
+                const auto a = actual.getLevels (ch, pos, pos + bucketSize);
+                const auto e = expected.getLevels (ch, pos, pos + bucketSize);
+
+                maxError = jmax (maxError, std::abs (a.minimum - e.minimum), std::abs (a.maximum - e.maximum));
+                maxError = jmax (maxError, std::abs (a.rms - e.rms));
+            }
+        }
+
+        // The levels are only stored to 16 bits, so a rounding difference in the source can
+        // move them by one step
+        expectLessOrEqual (maxError, 2.0f / 32767.0f);
+    }
+
+    static MemoryBlock getData (const AudioLevelPyramid& pyramid)
+    {
+        MemoryOutputStream out;
+        pyramid.writeTo (out);
+        return out.getMemoryBlock();
+    }
+};
+
+static AudioLevelPyramidTests audioLevelPyramidTests;
+
+#endif
+
+} // namespace drx
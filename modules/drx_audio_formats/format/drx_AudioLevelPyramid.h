@@ -0,0 +1,250 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace drx
+{
+
+//==============================================================================
+/**
+    A multi-resolution summary of the levels in a piece of audio, for drawing waveforms.
+
+    The audio is divided into buckets of a fixed number of samples, and the lowest and
+    highest sample and the RMS level of each bucket are stored, to 16 bits. Above that,
+    each layer of the pyramid summarises four buckets of the layer below, so the levels
+    of any section can be found by looking at only a handful of buckets in whichever layer
+    best matches its length. Drawing a waveform from it takes time proportional to the
+    number of pixels, whatever the zoom level, and the whole pyramid takes about a third
+    more memory than its lowest layer.
+
+    It can be filled in from blocks of audio with addBlock(), or from a reader with
+    build(), which can decode and analyse several parts of the stream at once. A block can
+    also be measured with analyseBlock() first, which doesn't touch the pyramid, so that
+    only the cheap step of adding the result needs to hold whatever lock protects it.
+
+    @see AudioThumbnail
+
+    @tags{Audio}
+*/
+class DRX_API  AudioLevelPyramid
+{
+public:
+    //==============================================================================
+    /** Creates an empty pyramid.
+
+        @param samplesPerBucket     the number of source samples that each bucket in the
+                                    lowest layer summarises
+    */
+    explicit AudioLevelPyramid (i32 samplesPerBucket = 256);
+
+    /** Destructor. */
+    ~AudioLevelPyramid();
+
+    AudioLevelPyramid (AudioLevelPyramid&&) noexcept;
+    AudioLevelPyramid& operator= (AudioLevelPyramid&&) noexcept;
+
+    //==============================================================================
+    /** The levels of a section of audio. */
+    struct Levels
+    {
+        /** The lowest and highest sample values. */
+        f32 minimum = 0, maximum = 0;
+
+        /** The RMS level. */
+        f32 rms = 0;
+
+        /** False if none of the section has been analysed yet. */
+        b8 hasData = false;
+    };
+
+    //==============================================================================
+    /** Clears the pyramid and sets the format of the audio it will hold.
+
+        The length is only a hint that avoids reallocating as data is added. Blocks can be
+        added beyond it, and the pyramid will grow to fit them.
+    */
+    z0 reset (i32 numChannels, z64 totalSamples);
+
+    /** The levels of a block of audio, measured by analyseBlock(). */
+    class BlockLevels
+    {
+    public:
+        BlockLevels() = default;
+
+    private:
+        friend class AudioLevelPyramid;
+
+        struct Section
+        {
+            f32 minimum, maximum, sumOfSquares;
+            i32 numSamples;
+        };
+
+        z64 startSample = 0;
+        i32 numSamples = 0, samplesPerBucket = 0, numChannels = 0, numBuckets = 0;
+        std::vector<Section> sections; // numBuckets for each channel, one channel after another
+    };
+
+    /** Measures a block of audio for a pyramid with the given bucket size, without adding
+        it to one. Pass the result to addBlock().
+    */
+    static BlockLevels analyseBlock (i32 samplesPerBucket, z64 startSample, const AudioBuffer<f32>& source,
+                                     i32 startOffsetInBuffer, i32 numSamples);
+
+    /** Adds a block of audio that was measured by analyseBlock() to the pyramid.
+
+        The block doesn't have to line up with the bucket boundaries. A bucket that the
+        block starts is replaced, and one that it continues is merged with what the
+        bucket already holds, so a stream can be added in blocks of any size, and a part
+        of it can be added again to replace it.
+
+        A block that was measured for a different bucket size is ignored.
+    */
+    z0 addBlock (const BlockLevels& block);
+
+    /** Analyses a block of audio and adds it to the pyramid.
+        This is the same as calling analyseBlock() and then the other addBlock().
+    */
+    z0 addBlock (z64 startSample, const AudioBuffer<f32>& source,
+                   i32 startOffsetInBuffer, i32 numSamples);
+
+    /** Sets the levels of some buckets in the lowest layer directly.
+
+        This is for loading levels that have been measured elsewhere.
+    */
+    z0 setBucketLevels (i32 channel, i32 firstBucket, const Levels* levels, i32 numBuckets);
+
+    /** Clears the pyramid and fills it with the whole of a reader's stream.
+
+        If a thread pool is supplied and the reader supports createDuplicateReader(), the
+        stream is split into chunks that are decoded and analysed by the pool's threads and
+        the calling thread at the same time. Otherwise it's read on the calling thread.
+
+        @returns false if the reader failed
+    */
+    b8 build (AudioFormatReader& reader, ThreadPool* threadPool = nullptr);
+
+    //==============================================================================
+    /** Returns the number of channels. */
+    i32 getNumChannels() const noexcept                         { return numChannels; }
+
+    /** Returns the number of source samples that the pyramid covers. */
+    z64 getTotalSamples() const noexcept                        { return totalSamples; }
+
+    /** Returns the number of source samples summarised by each bucket in the lowest layer. */
+    i32 getSamplesPerBucket() const noexcept                    { return samplesPerBucket; }
+
+    /** Returns the number of layers, including the lowest one. */
+    i32 getNumLayers() const noexcept                           { return (i32) layers.size(); }
+
+    /** Returns the number of bytes used by all the layers. */
+    size_t getMemoryUsage() const noexcept;
+
+    //==============================================================================
+    /** Finds the levels of a section of one channel.
+
+        The result comes from the coarsest layer whose buckets are no longer than the
+        section, so it can include up to one of that layer's buckets either side of it.
+    */
+    Levels getLevels (i32 channel, z64 startSample, z64 endSample) const noexcept;
+
+    /** Finds the levels for a row of pixels.
+
+        Pixel i covers the source samples from startSample + i * samplesPerPixel to
+        startSample + (i + 1) * samplesPerPixel. This looks at no more than a few buckets
+        for each pixel, so it takes the same time at any zoom level.
+    */
+    z0 getLevels (i32 channel, f64 startSample, f64 samplesPerPixel,
+                    Levels* results, i32 numPixels) const noexcept;
+
+    //==============================================================================
+    /** Writes the lowest layer to a stream, in a compact format that can be reloaded
+        with readFrom(). The other layers are rebuilt from it when it's loaded.
+
+        Each bucket takes 5 bytes per channel. The lowest and highest samples keep all 16
+        bits, as 8-bit peaks flatten anything quieter than about -42dB, which is often
+        what zooming in on a waveform is for. The RMS level is only drawn as a shade
+        inside the peaks, so it's stored in 8 bits, with a square-root curve that keeps
+        the steps small at low levels.
+    */
+    z0 writeTo (OutputStream& output) const;
+
+    /** Reloads data that was written by writeTo().
+
+        @returns false if the stream didn't contain a valid pyramid, in which case the
+                 pyramid is left empty
+    */
+    b8 readFrom (InputStream& input);
+
+private:
+    //==============================================================================
+    struct Bucket
+    {
+        static Bucket fromLevels (f32 minimum, f32 maximum, f32 meanSquare) noexcept;
+        f32 getMeanSquare() const noexcept;
+        Levels toLevels() const noexcept;
+
+        b8 isEmpty() const noexcept     { return maximum < minimum; }
+
+        i16 minimum = 32767, maximum = -32768;
+        u16 rms = 0;
+    };
+
+    struct Layer
+    {
+        z64 samplesPerBucket = 0;
+        i32 numBuckets = 0;
+        std::vector<Bucket> buckets; // numBuckets for each channel, one channel after another
+    };
+
+    Bucket* getBuckets (i32 layer, i32 channel) noexcept;
+    const Bucket* getBuckets (i32 layer, i32 channel) const noexcept;
+    z0 ensureSize (z64 numSamples);
+    z0 createLayers (i32 numBaseBuckets);
+    z0 updateLayersAbove (i32 firstBucket, i32 lastBucket);
+    z0 setBuckets (const BlockLevels&) noexcept;
+    i32 getNumBucketsUsed (i32 layer) const noexcept;
+    i32 findLayerFor (f64 numSamples) const noexcept;
+    Levels getLevelsFromLayer (i32 layer, i32 channel, z64 startSample, z64 endSample) const noexcept;
+
+    static constexpr i32 bucketsPerParent = 4;
+
+    i32 samplesPerBucket;
+    i32 numChannels = 0;
+    z64 totalSamples = 0;
+    std::vector<Layer> layers;
+
+    DRX_LEAK_DETECTOR (AudioLevelPyramid)
+};
+
+} // namespace drx
@@ -38,8 +38,23 @@ namespace drx
 BufferingAudioReader::BufferingAudioReader (AudioFormatReader* sourceReader,
                                             TimeSliceThread& timeSliceThread,
                                             i32 samplesToBuffer)
+    : BufferingAudioReader (sourceReader, &timeSliceThread, nullptr, samplesToBuffer)
+{
+}
+
+BufferingAudioReader::BufferingAudioReader (AudioFormatReader* sourceReader,
+                                            ReadAheadScheduler& readAheadScheduler,
+                                            i32 samplesToBuffer)
+    : BufferingAudioReader (sourceReader, nullptr, &readAheadScheduler, samplesToBuffer)
+{
+}
+
+BufferingAudioReader::BufferingAudioReader (AudioFormatReader* sourceReader,
+                                            TimeSliceThread* timeSliceThread,
+                                            ReadAheadScheduler* readAheadScheduler,
+                                            i32 samplesToBuffer)
     : AudioFormatReader (nullptr, sourceReader->getFormatName()),
-      source (sourceReader), thread (timeSliceThread),
+      source (sourceReader), thread (timeSliceThread), scheduler (readAheadScheduler),
       numBlocks (1 + (samplesToBuffer / samplesPerBlock))
 {
     sampleRate            = source->sampleRate;
@@ -49,12 +64,18 @@ BufferingAudioReader::BufferingAudioReader (AudioFormatReader* sourceReader,
     bitsPerSample         = 32;
     usesFloatingPointData = true;
 
-    timeSliceThread.addTimeSliceClient (this);
+    if (scheduler != nullptr)
+        scheduler->addClient (this);
+    else
+        thread->addTimeSliceClient (this);
 }
 
 BufferingAudioReader::~BufferingAudioReader()
 {
-    thread.removeTimeSliceClient (this);
+    if (scheduler != nullptr)
+        scheduler->removeClient (this);
+    else
+        thread->removeTimeSliceClient (this);
 }
 
 z0 BufferingAudioReader::setReadTimeout (i32 timeoutMilliseconds) noexcept
@@ -114,6 +135,10 @@ b8 BufferingAudioReader::readSamples (i32* const* destSamples, i32 numDestChanne
             else
             {
                 ScopedUnlock ul (lock);
+
+                if (scheduler != nullptr)
+                    scheduler->notify (this);
+
                 Thread::yield();
             }
         }
@@ -143,6 +168,31 @@ i32 BufferingAudioReader::useTimeSlice()
     return readNextBufferChunk() ? 1 : 100;
 }
 
+b8 BufferingAudioReader::readAhead()
+{
+    return readNextBufferChunk();
+}
+
+f64 BufferingAudioReader::getSecondsBuffered() const
+{
+    const auto pos = nextReadPosition.load();
+
+    if (sampleRate <= 0 || pos < bufferedStart.load())
+        return 0.0;
+
+    return (f64) jmax ((z64) 0, bufferedEnd.load() - pos) / sampleRate;
+}
+
+f32 BufferingAudioReader::getBufferFillLevel() const
+{
+    const auto wanted = jmin ((z64) numBlocks * samplesPerBlock, lengthInSamples - nextReadPosition.load());
+
+    if (wanted <= 0)
+        return 1.0f;
+
+    return jlimit (0.0f, 1.0f, (f32) (getSecondsBuffered() * sampleRate / (f64) wanted));
+}
+
 b8 BufferingAudioReader::readNextBufferChunk()
 {
     auto pos = (nextReadPosition.load() / samplesPerBlock) * samplesPerBlock;
@@ -157,6 +207,8 @@ b8 BufferingAudioReader::readNextBufferChunk()
     if (newBlocks.size() == numBlocks)
     {
         newBlocks.clear (false);
+        bufferedStart = pos;
+        bufferedEnd = endPos;
         return false;
     }
 
@@ -177,6 +229,16 @@ b8 BufferingAudioReader::readNextBufferChunk()
     for (i32 i = blocks.size(); --i >= 0;)
         newBlocks.removeObject (blocks.getUnchecked (i), false);
 
+    // Keep track of how far the contiguous run of blocks from the read position extends,
+    // so that the scheduler can see how close this reader is to running dry
+    auto end = pos;
+
+    while (end < endPos && getBlockContaining (end) != nullptr)
+        end += samplesPerBlock;
+
+    bufferedStart = pos;
+    bufferedEnd = jmin (end, lengthInSamples);
+
     return true;
 }
 
@@ -321,6 +383,33 @@ public:
                 expect (source == destination);
             }
         }
+
+        beginTest ("Reading through a ReadAheadScheduler should produce the same samples as the source");
+        {
+            Random random { getRandom() };
+            ReadAheadScheduler scheduler ("TestScheduler", 2);
+
+            const auto source = generateTestBuffer (random, 200000);
+            OwnedArray<BufferingAudioReader> readers;
+
+            for (i32 i = 0; i < 4; ++i)
+            {
+                readers.add (new BufferingAudioReader (new TestAudioFormatReader (&source), scheduler, 65536))
+                    ->setReadTimeout (-1);
+            }
+
+            expectEquals (scheduler.getNumClients(), 4);
+
+            for (auto* reader : readers)
+            {
+                auto destination = generateTestBuffer (random, source.getNumSamples());
+                read (*reader, destination);
+                expect (source == destination);
+            }
+
+            readers.clear();
+            expectEquals (scheduler.getNumClients(), 0);
+        }
     }
 
 private:
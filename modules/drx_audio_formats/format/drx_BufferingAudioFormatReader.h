@@ -40,12 +40,17 @@ namespace drx
     An AudioFormatReader that uses a background thread to pre-read data from
     another reader.
 
-    @see AudioFormatReader
+    The background reading can either be done by a TimeSliceThread, or by a
+    ReadAheadScheduler, which is a better choice when many readers are being
+    streamed at once.
+
+    @see AudioFormatReader, ReadAheadScheduler
 
     @tags{Audio}
 */
 class DRX_API  BufferingAudioReader  : public AudioFormatReader,
-                                        private TimeSliceClient
+                                        private TimeSliceClient,
+                                        private ReadAheadScheduler::Client
 {
 public:
     /** Creates a reader.
@@ -62,6 +67,20 @@ public:
                           TimeSliceThread& timeSliceThread,
                           i32 samplesToBuffer);
 
+    /** Creates a reader which is read by a ReadAheadScheduler.
+
+        @param sourceReader     the source reader to wrap. This BufferingAudioReader
+                                takes ownership of this object and will delete it later
+                                when no longer needed
+        @param scheduler        the scheduler that should be used to do the background reading.
+                                Make sure that it won't be deleted while the reader object
+                                still exists.
+        @param samplesToBuffer  the total number of samples to buffer ahead.
+    */
+    BufferingAudioReader (AudioFormatReader* sourceReader,
+                          ReadAheadScheduler& scheduler,
+                          i32 samplesToBuffer);
+
     ~BufferingAudioReader() override;
 
     /** Sets a number of milliseconds that the reader can block for in its readSamples()
@@ -85,15 +104,22 @@ private:
         b8 allSamplesRead = false;
     };
 
+    BufferingAudioReader (AudioFormatReader*, TimeSliceThread*, ReadAheadScheduler*, i32 samplesToBuffer);
+
     i32 useTimeSlice() override;
+    b8 readAhead() override;
+    f64 getSecondsBuffered() const override;
+    f32 getBufferFillLevel() const override;
+
     BufferedBlock* getBlockContaining (z64 pos) const noexcept;
     b8 readNextBufferChunk();
 
     static constexpr i32 samplesPerBlock = 32768;
 
     std::unique_ptr<AudioFormatReader> source;
-    TimeSliceThread& thread;
-    std::atomic<z64> nextReadPosition { 0 };
+    TimeSliceThread* thread = nullptr;
+    ReadAheadScheduler* scheduler = nullptr;
+    std::atomic<z64> nextReadPosition { 0 }, bufferedStart { 0 }, bufferedEnd { 0 };
     i32k numBlocks;
     i32 timeoutMs = 0;
 
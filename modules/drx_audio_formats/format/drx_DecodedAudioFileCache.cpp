@@ -0,0 +1,320 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace drx
+{
+
+static tukk const decodedAudioCacheSuffix = ".pcmcache.wav";
+
+DecodedAudioFileCache::DecodedAudioFileCache (const File& cacheDirectory)
+    : directory (cacheDirectory)
+{
+    directory.createDirectory();
+}
+
+DecodedAudioFileCache::~DecodedAudioFileCache() = default;
+
+//==============================================================================
+File DecodedAudioFileCache::getCacheFileFor (const File& sourceFile) const
+{
+    const auto key = sourceFile.getFullPathName()
+                       + "|" + Txt (sourceFile.getSize())
+                       + "|" + Txt (sourceFile.getLastModificationTime().toMilliseconds());
+
+    return directory.getChildFile (sourceFile.getFileNameWithoutExtension().substring (0, 32)
+                                     + "_" + Txt::toHexString (key.hashCode64())
+                                     + decodedAudioCacheSuffix);
+}
+
+b8 DecodedAudioFileCache::isCached (const File& sourceFile) const
+{
+    return getCacheFileFor (sourceFile).existsAsFile();
+}
+
+std::unique_ptr<MemoryMappedAudioFormatReader> DecodedAudioFileCache::createMemoryMappedReader (AudioFormatManager& formatManager,
+                                                                                                const File& sourceFile)
+{
+    if (! sourceFile.existsAsFile())
+        return {};
+
+    if (auto* format = formatManager.findFormatForFileExtension (sourceFile.getFileExtension()))
+        if (auto* directReader = format->createMemoryMappedReader (sourceFile))
+            return std::unique_ptr<MemoryMappedAudioFormatReader> (directReader);
+
+    const auto cacheFile = getCacheFileFor (sourceFile);
+
+    if (cacheFile.existsAsFile())
+    {
+        if (auto* cachedReader = wavFormat.createMemoryMappedReader (cacheFile))
+        {
+            cacheFile.setLastAccessTime (Time::getCurrentTime());
+            return std::unique_ptr<MemoryMappedAudioFormatReader> (cachedReader);
+        }
+    }
+
+    if (! decodeIntoCache (formatManager, sourceFile, cacheFile))
+        return {};
+
+    return std::unique_ptr<MemoryMappedAudioFormatReader> (wavFormat.createMemoryMappedReader (cacheFile));
+}
+
+b8 DecodedAudioFileCache::decodeIntoCache (AudioFormatManager& formatManager, const File& sourceFile, const File& cacheFile)
+{
+    std::unique_ptr<AudioFormatReader> reader (formatManager.createReaderFor (sourceFile));
+
+    if (reader == nullptr || reader->numChannels == 0)
+        return false;
+
+    // Floating-point sources are stored as floats, and integer ones at the smallest
+    // bit depth that holds them without loss
+    auto bitDepth = 32;
+
+    if (! reader->usesFloatingPointData)
+        for (auto depth : { 8, 16, 24 })
+            if ((i32) reader->bitsPerSample <= depth)
+                { bitDepth = depth; break; }
+
+    // Decoding into a temporary file means that another thread or process will never
+    // see a half-written cache file
+    TemporaryFile temp (cacheFile);
+
+    {
+        std::unique_ptr<OutputStream> out (temp.getFile().createOutputStream());
+
+        if (out == nullptr)
+            return false;
+
+        std::unique_ptr<AudioFormatWriter> writer (wavFormat.createWriterFor (out.get(), reader->sampleRate,
+                                                                              reader->numChannels, bitDepth, {}, 0));
+
+        if (writer == nullptr)
+            return false;
+
+        out.release();
+
+        if (! writer->writeFromAudioReader (*reader, 0, -1))
+            return false;
+    }
+
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+//==============================================================================
+Array<File> DecodedAudioFileCache::getCacheFiles() const
+{
+    return directory.findChildFiles (File::findFiles, false, Txt ("*") + decodedAudioCacheSuffix);
+}
+
+z0 DecodedAudioFileCache::trimToSize (z64 maximumTotalBytes)
+{
+    auto files = getCacheFiles();
+
+    std::sort (files.begin(), files.end(), [] (const File& a, const File& b)
+    {
+        return a.getLastAccessTime() > b.getLastAccessTime();
+    });
+
+    z64 totalBytes = 0;
+
+    for (auto& f : files)
+    {
+        totalBytes += f.getSize();
+
+        if (totalBytes > maximumTotalBytes)
+            f.deleteFile();
+    }
+}
+
+z0 DecodedAudioFileCache::clear()
+{
+    for (auto& f : getCacheFiles())
+        f.deleteFile();
+}
+
+//==============================================================================
+#if DRX_UNIT_TESTS
+
+class DecodedAudioFileCacheTests final : public UnitTest
+{
+public:
+    DecodedAudioFileCacheTests()
+        : UnitTest ("DecodedAudioFileCache", UnitTestCategories::audio)
+    {
+    }
+
+    z0 runTest() override
+    {
+        const auto folder = File::createTempFile ("DecodedAudioFileCacheTests");
+        folder.createDirectory();
+
+        AudioFormatManager formats;
+        formats.registerBasicFormats();
+
+        auto random = getRandom();
+        AudioBuffer<f32> source (2, 500000);
+
+        for (i32 ch = 0; ch < source.getNumChannels(); ++ch)
+            for (i32 i = 0; i < source.getNumSamples(); ++i)
+                source.setSample (ch, i, 0.5f * std::sin ((f32) i * (0.01f + 0.01f * (f32) ch)) + 0.1f * random.nextFloat());
+
+        DecodedAudioFileCache cache (folder.getChildFile ("cache"));
+
+       #if DRX_USE_FLAC
+        const auto flacFile = folder.getChildFile ("test.flac");
+        FlacAudioFormat flacFormat;
+        writeFile (flacFormat, flacFile, source, 24);
+
+        beginTest ("Compressed files are decoded into the cache");
+        {
+            expect (! cache.isCached (flacFile));
+
+            auto reader = cache.createMemoryMappedReader (formats, flacFile);
+            expect (reader != nullptr);
+            expect (cache.isCached (flacFile));
+            expect (reader->getFile() == cache.getCacheFileFor (flacFile));
+            expect (reader->mapEntireFile());
+
+            std::unique_ptr<AudioFormatReader> flacReader (formats.createReaderFor (flacFile));
+            expectEquals (reader->lengthInSamples, flacReader->lengthInSamples);
+            expectEquals ((i32) reader->bitsPerSample, 24);
+
+            AudioBuffer<f32> expected (2, source.getNumSamples()), actual (2, source.getNumSamples());
+            flacReader->read (&expected, 0, source.getNumSamples(), 0, true, true);
+            reader->read (&actual, 0, source.getNumSamples(), 0, true, true);
+            expect (expected == actual);
+        }
+
+        beginTest ("Cached files are reused");
+        {
+            const auto cacheFile = cache.getCacheFileFor (flacFile);
+            const auto modificationTime = cacheFile.getLastModificationTime();
+
+            Thread::sleep (20);
+            auto reader = cache.createMemoryMappedReader (formats, flacFile);
+            expect (reader != nullptr);
+            expect (cacheFile.getLastModificationTime() == modificationTime);
+        }
+
+        beginTest ("Changing the source file gives it a new cache file");
+        {
+            const auto oldCacheFile = cache.getCacheFileFor (flacFile);
+
+            AudioBuffer<f32> shorter (2, 100000);
+            shorter.copyFrom (0, 0, source, 0, 0, shorter.getNumSamples());
+            shorter.copyFrom (1, 0, source, 1, 0, shorter.getNumSamples());
+            writeFile (flacFormat, flacFile, shorter, 16);
+
+            expect (cache.getCacheFileFor (flacFile) != oldCacheFile);
+            expect (! cache.isCached (flacFile));
+
+            auto reader = cache.createMemoryMappedReader (formats, flacFile);
+            expect (reader != nullptr);
+            expectEquals (reader->lengthInSamples, (z64) shorter.getNumSamples());
+            expectEquals ((i32) reader->bitsPerSample, 16);
+        }
+
+        beginTest ("Performance");
+        {
+            writeFile (flacFormat, flacFile, source, 16);
+            std::unique_ptr<AudioFormatReader> flacReader (formats.createReaderFor (flacFile));
+            auto mappedReader = cache.createMemoryMappedReader (formats, flacFile);
+            mappedReader->mapEntireFile();
+
+            AudioBuffer<f32> buffer (2, 4096);
+
+            auto timeReads = [&] (AudioFormatReader& reader)
+            {
+                const auto start = Time::getHighResolutionTicks();
+
+                for (i32 pos = 0; pos < source.getNumSamples(); pos += buffer.getNumSamples())
+                    reader.read (&buffer, 0, buffer.getNumSamples(), pos, true, true);
+
+                return Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start) * 1000.0;
+            };
+
+            const auto decodingMs = timeReads (*flacReader);
+            const auto mappedMs = timeReads (*mappedReader);
+
+            logMessage ("  reading " + Txt (source.getNumSamples()) + " stereo samples: FLAC decoder "
+                          + Txt (decodingMs, 2) + " ms, cached mapped file " + Txt (mappedMs, 2) + " ms");
+        }
+       #endif
+
+        beginTest ("Formats that can be mapped aren't copied");
+        {
+            const auto wavFile = folder.getChildFile ("test.wav");
+            WavAudioFormat wavFormat;
+            writeFile (wavFormat, wavFile, source, 16);
+
+            auto reader = cache.createMemoryMappedReader (formats, wavFile);
+            expect (reader != nullptr);
+            expect (reader->getFile() == wavFile);
+            expect (! cache.isCached (wavFile));
+        }
+
+        beginTest ("Trimming and clearing");
+        {
+            const auto cacheFiles = cache.getDirectory().findChildFiles (File::findFiles, false);
+            expect (cacheFiles.size() >= 1);
+
+            cache.trimToSize (std::numeric_limits<z64>::max());
+            expectEquals (cache.getDirectory().getNumberOfChildFiles (File::findFiles), cacheFiles.size());
+
+            cache.trimToSize (0);
+            expectEquals (cache.getDirectory().getNumberOfChildFiles (File::findFiles), 0);
+
+            cache.clear();
+        }
+
+        folder.deleteRecursively();
+    }
+
+private:
+    static z0 writeFile (AudioFormat& format, const File& file, const AudioBuffer<f32>& data, i32 bitDepth)
+    {
+        file.deleteFile();
+
+        std::unique_ptr<AudioFormatWriter> writer (format.createWriterFor (file.createOutputStream().release(), 44100.0,
+                                                                           (u32) data.getNumChannels(), bitDepth, {}, 0));
+        jassert (writer != nullptr);
+        writer->writeFromAudioSampleBuffer (data, 0, data.getNumSamples());
+    }
+};
+
+static DecodedAudioFileCacheTests decodedAudioFileCacheTests;
+
+#endif
+
+} // namespace drx
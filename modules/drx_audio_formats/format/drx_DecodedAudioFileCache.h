@@ -0,0 +1,116 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace drx
+{
+
+//==============================================================================
+/**
+    Keeps decoded copies of compressed audio files on disk, so that they can be
+    memory-mapped.
+
+    Compressed formats such as FLAC and Ogg Vorbis can't be memory-mapped, so every
+    read has to go through their decoders. The first time one of these files is requested
+    from the cache, it's decoded into an uncompressed WAV file in the cache directory.
+    After that, the cached copy is opened with a MemoryMappedAudioFormatReader, so reading
+    from it is just a conversion straight out of mapped memory.
+
+    Formats that can already be memory-mapped, like WAV and AIFF, are opened directly
+    rather than being copied.
+
+    Cache files are named after a hash of the source file's path, size and modification
+    time, so a source file that changes gets a new cache file rather than a stale one.
+    Old cache files can be deleted with trimToSize().
+
+    @see MemoryMappedAudioFormatReader, AudioFormat::createMemoryMappedReader
+
+    @tags{Audio}
+*/
+class DRX_API  DecodedAudioFileCache
+{
+public:
+    //==============================================================================
+    /** Creates a cache which keeps its files in the given directory.
+        The directory will be created if it doesn't exist.
+    */
+    explicit DecodedAudioFileCache (const File& cacheDirectory);
+
+    /** Destructor. This doesn't delete any of the cache files. */
+    ~DecodedAudioFileCache();
+
+    //==============================================================================
+    /** Returns a memory-mapped reader for an audio file, decoding it into the cache first
+        if it's in a format that can't be mapped directly, and isn't already cached.
+
+        The reader's data won't have been mapped yet, so you'll need to call mapEntireFile()
+        or mapSectionOfFile() on it before reading.
+
+        This is safe to call from several threads at once. Decoding a long file can take
+        a while, so avoid calling it on the message thread or the audio thread.
+
+        Returns nullptr if none of the manager's formats can read the file.
+    */
+    std::unique_ptr<MemoryMappedAudioFormatReader> createMemoryMappedReader (AudioFormatManager& formatManager,
+                                                                             const File& sourceFile);
+
+    /** Returns the file that the decoded copy of a source file would be kept in. */
+    File getCacheFileFor (const File& sourceFile) const;
+
+    /** Возвращает true, если an up-to-date decoded copy of the file is in the cache. */
+    b8 isCached (const File& sourceFile) const;
+
+    /** Deletes the least recently used cache files, until the total size of the ones that
+        are left is no more than the given number of bytes.
+    */
+    z0 trimToSize (z64 maximumTotalBytes);
+
+    /** Deletes all the cache files. */
+    z0 clear();
+
+    /** Returns the directory that the cache files are kept in. */
+    const File& getDirectory() const noexcept           { return directory; }
+
+private:
+    //==============================================================================
+    b8 decodeIntoCache (AudioFormatManager&, const File& sourceFile, const File& cacheFile);
+    Array<File> getCacheFiles() const;
+
+    File directory;
+    WavAudioFormat wavFormat;
+
+    DRX_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DecodedAudioFileCache)
+};
+
+} // namespace drx
@@ -0,0 +1,629 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace drx
+{
+
+class StreamingSamplerSound::Stream final : public ReferenceCountedObject
+{
+public:
+    explicit Stream (std::unique_ptr<AudioFormatReader> r)
+        : reader (std::move (r))
+    {
+        if (auto* mapped = dynamic_cast<MemoryMappedAudioFormatReader*> (reader.get()))
+            isMapped = concurrent = mapped->mapEntireFile();
+    }
+
+    b8 read (f32* const* dest, i32 numDestChannels, z64 startSample, i32 numSamples)
+    {
+        if (concurrent)
+            return reader->read (dest, numDestChannels, startSample, numSamples);
+
+        const ScopedLock sl (readLock);
+        return reader->read (dest, numDestChannels, startSample, numSamples);
+    }
+
+    std::unique_ptr<AudioFormatReader> reader;
+    CriticalSection readLock;
+    b8 isMapped = false, concurrent = false;
+
+    DRX_DECLARE_NON_COPYABLE (Stream)
+};
+
+//==============================================================================
+StreamingSamplerSound::StreamingSamplerSound (const Txt& soundName,
+                                              std::unique_ptr<AudioFormatReader> source,
+                                              const BigInteger& notes,
+                                              i32 midiNoteForNormalPitch,
+                                              f64 attackTimeSecs,
+                                              f64 releaseTimeSecs,
+                                              i32 numSamplesToPreload)
+    : name (soundName),
+      midiNotes (notes),
+      midiRootNote (midiNoteForNormalPitch)
+{
+    if (source == nullptr || source->sampleRate <= 0 || source->lengthInSamples <= 0)
+        return;
+
+    // A memory-mapped reader can't read anything unless its file can be mapped
+    if (auto* mapped = dynamic_cast<MemoryMappedAudioFormatReader*> (source.get()))
+        if (! mapped->mapEntireFile())
+            return;
+
+    sourceSampleRate = source->sampleRate;
+    length = source->lengthInSamples;
+
+    const auto numChannels = jmin (2, (i32) source->numChannels);
+    stream = new Stream (std::move (source));
+
+    // Like SamplerSound, a few samples of silence are kept after the end for the interpolator
+    preload.setSize (numChannels, (i32) jmin ((z64) jmax (1, numSamplesToPreload), length + 4));
+    stream->read (preload.getArrayOfWritePointers(), numChannels, 0, preload.getNumSamples());
+
+    params.attack  = static_cast<f32> (attackTimeSecs);
+    params.release = static_cast<f32> (releaseTimeSecs);
+}
+
+StreamingSamplerSound::~StreamingSamplerSound()
+{
+}
+
+b8 StreamingSamplerSound::canReadConcurrently() const noexcept
+{
+    return stream != nullptr && stream->concurrent;
+}
+
+b8 StreamingSamplerSound::appliesToNote (i32 midiNoteNumber)
+{
+    return midiNotes[midiNoteNumber];
+}
+
+b8 StreamingSamplerSound::appliesToChannel (i32 /*midiChannel*/)
+{
+    return true;
+}
+
+//==============================================================================
+StreamingSamplerVoice::StreamingSamplerVoice (ReadAheadScheduler& s, i32 ringBufferSamples)
+    : scheduler (s),
+      ringSize (nextPowerOfTwo (jmax (readChunkSize * 2, ringBufferSamples)))
+{
+    ring.setSize (2, ringSize);
+    scheduler.addClient (this);
+}
+
+StreamingSamplerVoice::~StreamingSamplerVoice()
+{
+    scheduler.removeClient (this);
+
+    if (auto* pending = pendingStream.exchange (nullptr))
+        pending->decReferenceCount();
+
+    releaseRetiredStreams();
+}
+
+size_t StreamingSamplerVoice::getMemoryUsage() const noexcept
+{
+    return (size_t) ring.getNumChannels() * (size_t) ringSize * sizeof (f32);
+}
+
+b8 StreamingSamplerVoice::canPlaySound (SynthesiserSound* sound)
+{
+    return dynamic_cast<const StreamingSamplerSound*> (sound) != nullptr;
+}
+
+z0 StreamingSamplerVoice::startNote (i32 midiNoteNumber, f32 velocity, SynthesiserSound* s, i32 /*currentPitchWheelPosition*/)
+{
+    if (auto* sound = dynamic_cast<const StreamingSamplerSound*> (s))
+    {
+        pitchRatio = std::pow (2.0, (midiNoteNumber - sound->midiRootNote) / 12.0)
+                        * sound->sourceSampleRate / getSampleRate();
+
+        sourceSamplePosition = 0.0;
+        lgain = velocity;
+        rgain = velocity;
+
+        adsr.setSampleRate (sound->sourceSampleRate);
+        adsr.setParameters (sound->params);
+
+        adsr.noteOn();
+
+        if (sound->stream == nullptr)
+        {
+            endStream();
+            return;
+        }
+
+        // The reference taken here is handed over to the scheduler's thread
+        auto* stream = sound->stream.get();
+        stream->incReferenceCount();
+
+        if (auto* previous = pendingStream.exchange (stream))
+            retireStream (previous, stream);
+
+        ++generation;
+        readPosition = 0;
+        streamEnd = sound->length + 4;
+        sourceSamplesPerSecond = jmax (1.0, pitchRatio * getSampleRate());
+
+        // Publishing the new state last means a read that was in progress for the previous
+        // note will fail to publish its data.
+        streamState.store ((generation << generationShift) | (u64) sound->preload.getNumSamples(), std::memory_order_release);
+    }
+    else
+    {
+        jassertfalse; // this object can only play StreamingSamplerSounds!
+    }
+}
+
+z0 StreamingSamplerVoice::stopNote (f32 /*velocity*/, b8 allowTailOff)
+{
+    if (allowTailOff)
+    {
+        adsr.noteOff();
+    }
+    else
+    {
+        clearCurrentNote();
+        adsr.reset();
+        endStream();
+    }
+}
+
+z0 StreamingSamplerVoice::retireStream (StreamingSamplerSound::Stream* previous, StreamingSamplerSound::Stream* current) noexcept
+{
+    // If the scheduler never picked up the previous note's stream, it can only be released
+    // here when it's the same as the new one, as this note's sound still holds a reference
+    // to that. Any other stream might belong to a sound that has since been removed, so
+    // dropping the last reference would delete its reader on the audio thread.
+    if (previous == current)
+    {
+        previous->decReferenceCount();
+        return;
+    }
+
+    for (auto& slot : retiredStreams)
+    {
+        StreamingSamplerSound::Stream* expected = nullptr;
+
+        if (slot.compare_exchange_strong (expected, previous))
+            return;
+    }
+
+    // The scheduler hasn't run while this voice started more notes than there are slots,
+    // so there's nowhere left to put the stream
+    jassertfalse;
+    previous->decReferenceCount();
+}
+
+z0 StreamingSamplerVoice::releaseRetiredStreams()
+{
+    for (auto& slot : retiredStreams)
+        if (auto* stream = slot.exchange (nullptr))
+            stream->decReferenceCount();
+}
+
+z0 StreamingSamplerVoice::endStream() noexcept
+{
+    ++generation;
+    streamEnd = 0;
+    streamState.store (generation << generationShift, std::memory_order_release);
+}
+
+z0 StreamingSamplerVoice::pitchWheelMoved (i32 /*newValue*/) {}
+z0 StreamingSamplerVoice::controllerMoved (i32 /*controllerNumber*/, i32 /*newValue*/) {}
+
+//==============================================================================
+z64 StreamingSamplerVoice::getReadLimit() const noexcept
+{
+    // The slot holding readPosition is still in use, so the ring can hold one sample less
+    // than a full cycle beyond it
+    return jmin (streamEnd.load(), readPosition.load() + ringSize);
+}
+
+b8 StreamingSamplerVoice::isBufferFull() const noexcept
+{
+    const auto end = (z64) (streamState.load() & positionMask);
+    const auto limit = getReadLimit();
+
+    // Reads are only made in whole chunks, except for the last one in the sample
+    return limit - end < readChunkSize && (end >= limit || limit < streamEnd.load());
+}
+
+b8 StreamingSamplerVoice::isReadAheadNeeded() const
+{
+    return ! isBufferFull();
+}
+
+f64 StreamingSamplerVoice::getSecondsBuffered() const
+{
+    if (streamEnd.load() == 0)
+        return std::numeric_limits<f64>::max();
+
+    const auto end = (z64) (streamState.load() & positionMask);
+    return (f64) jmax ((z64) 0, end - readPosition.load()) / sourceSamplesPerSecond.load();
+}
+
+f32 StreamingSamplerVoice::getBufferFillLevel() const
+{
+    if (streamEnd.load() == 0)
+        return 1.0f;
+
+    const auto end = (z64) (streamState.load() & positionMask);
+    return jlimit (0.0f, 1.0f, (f32) (end - readPosition.load()) / (f32) ringSize);
+}
+
+b8 StreamingSamplerVoice::readAhead()
+{
+    const auto state = streamState.load (std::memory_order_acquire);
+
+    releaseRetiredStreams();
+
+    if (auto* pending = pendingStream.exchange (nullptr))
+    {
+        activeStream = pending;
+        pending->decReferenceCount();
+    }
+    else if (streamEnd.load() == 0)
+    {
+        // Nothing is playing, so let go of the last sound's reader
+        activeStream = nullptr;
+        return false;
+    }
+
+    if (activeStream == nullptr)
+        return false;
+
+    const auto end = (z64) (state & positionMask);
+    const auto numToRead = (i32) jmin ((z64) readChunkSize, getReadLimit() - end);
+
+    if (numToRead <= 0 || isBufferFull())
+        return false;
+
+    const auto numChannels = jmin (2, (i32) activeStream->reader->numChannels);
+    const auto ringMask = (z64) ringSize - 1;
+    i32 numDone = 0;
+
+    while (numDone < numToRead)
+    {
+        const auto ringPos = (i32) ((end + numDone) & ringMask);
+        const auto numThisTime = jmin (numToRead - numDone, ringSize - ringPos);
+
+        f32* dest[] = { ring.getWritePointer (0, ringPos), ring.getWritePointer (1, ringPos) };
+        activeStream->read (dest, numChannels, end + numDone, numThisTime);
+        numDone += numThisTime;
+    }
+
+    // If the note was restarted while this was reading, the data belongs to the old note
+    // and this exchange fails, so it's never published
+    auto expected = state;
+    streamState.compare_exchange_strong (expected, state + (u64) numToRead, std::memory_order_release);
+
+    return ! isBufferFull();
+}
+
+//==============================================================================
+z0 StreamingSamplerVoice::renderNextBlock (AudioBuffer<f32>& outputBuffer, i32 startSample, i32 numSamples)
+{
+    if (auto* playingSound = static_cast<StreamingSamplerSound*> (getCurrentlyPlayingSound().get()))
+    {
+        const auto& preload = playingSound->preload;
+        const f32* const preL = preload.getReadPointer (0);
+        const f32* const preR = preload.getNumChannels() > 1 ? preload.getReadPointer (1) : nullptr;
+        const f32* const ringL = ring.getReadPointer (0);
+        const f32* const ringR = ring.getReadPointer (1);
+
+        const auto numPreloaded = (z64) preload.getNumSamples();
+        const auto ringMask = (z64) ringSize - 1;
+
+        const auto state = streamState.load (std::memory_order_acquire);
+        const auto isCurrentNote = ((state ^ (generation << generationShift)) >> generationShift) == 0;
+        const auto available = isCurrentNote ? (z64) (state & positionMask) : numPreloaded;
+        b8 hadUnderrun = false;
+
+        auto getSample = [&] (const f32* pre, const f32* fromRing, z64 index)
+        {
+            if (index < numPreloaded)
+                return pre[index];
+
+            if (index < available)
+                return fromRing[index & ringMask];
+
+            hadUnderrun = true;
+            return 0.0f;
+        };
+
+        f32* outL = outputBuffer.getWritePointer (0, startSample);
+        f32* outR = outputBuffer.getNumChannels() > 1 ? outputBuffer.getWritePointer (1, startSample) : nullptr;
+
+        while (--numSamples >= 0)
+        {
+            auto pos = (z64) sourceSamplePosition;
+            auto alpha = (f32) (sourceSamplePosition - (f64) pos);
+            auto invAlpha = 1.0f - alpha;
+
+            // the same linear interpolation as SamplerVoice
+            f32 l = (getSample (preL, ringL, pos) * invAlpha + getSample (preL, ringL, pos + 1) * alpha);
+            f32 r = (preR != nullptr) ? (getSample (preR, ringR, pos) * invAlpha + getSample (preR, ringR, pos + 1) * alpha)
+                                      : l;
+
+            auto envelopeValue = adsr.getNextSample();
+
+            l *= lgain * envelopeValue;
+            r *= rgain * envelopeValue;
+
+            if (outR != nullptr)
+            {
+                *outL++ += l;
+                *outR++ += r;
+            }
+            else
+            {
+                *outL++ += (l + r) * 0.5f;
+            }
+
+            sourceSamplePosition += pitchRatio;
+
+            if (sourceSamplePosition > (f64) playingSound->length)
+            {
+                stopNote (0.0f, false);
+                break;
+            }
+        }
+
+        if (hadUnderrun)
+            ++numUnderruns;
+
+        // Everything before the current position can now be overwritten
+        if (isVoiceActive())
+            readPosition.store ((z64) sourceSamplePosition, std::memory_order_release);
+    }
+}
+
+//==============================================================================
+#if DRX_UNIT_TESTS
+
+class StreamingSamplerTests final : public UnitTest
+{
+public:
+    StreamingSamplerTests()
+        : UnitTest ("StreamingSampler", UnitTestCategories::audio)
+    {
+    }
+
+    z0 runTest() override
+    {
+        const auto folder = File::createTempFile ("StreamingSamplerTests");
+        folder.createDirectory();
+
+        const auto file = folder.getChildFile ("sample.wav");
+        const auto numSamples = 441000;
+        auto random = getRandom();
+
+        {
+            AudioBuffer<f32> data (2, numSamples);
+
+            for (i32 ch = 0; ch < data.getNumChannels(); ++ch)
+                for (i32 i = 0; i < numSamples; ++i)
+                    data.setSample (ch, i, 0.5f * std::sin ((f32) i * (0.01f + 0.003f * (f32) ch)) + 0.1f * random.nextFloat());
+
+            WavAudioFormat wav;
+            std::unique_ptr<AudioFormatWriter> writer (wav.createWriterFor (file.createOutputStream().release(), 44100.0,
+                                                                            2, 16, {}, 0));
+            expect (writer != nullptr);
+            writer->writeFromAudioSampleBuffer (data, 0, numSamples);
+        }
+
+        WavAudioFormat wav;
+        BigInteger allNotes;
+        allNotes.setRange (0, 128, true);
+
+        beginTest ("Streamed notes match SamplerVoice");
+        {
+            ReadAheadScheduler scheduler ("Test", 1);
+            scheduler.setPollInterval (1);
+
+            for (auto preloadSize : { 1000, 50000 })
+            {
+                for (auto note : { 60, 67, 50 })
+                {
+                    Synthesiser reference, streaming;
+                    reference.setCurrentPlaybackSampleRate (48000.0);
+                    streaming.setCurrentPlaybackSampleRate (48000.0);
+
+                    std::unique_ptr<AudioFormatReader> reader (wav.createReaderFor (file.createInputStream().release(), true));
+                    reference.addSound (new SamplerSound ("ref", *reader, allNotes, 60, 0.01, 0.1, 100.0));
+                    reference.addVoice (new SamplerVoice());
+
+                    auto* sound = new StreamingSamplerSound ("stream", std::unique_ptr<AudioFormatReader> (wav.createMemoryMappedReader (file)),
+                                                             allNotes, 60, 0.01, 0.1, preloadSize);
+                    expect (sound->canReadConcurrently());
+                    expectEquals (sound->getLengthInSamples(), (z64) numSamples);
+                    streaming.addSound (sound);
+
+                    // A small ring buffer makes sure that it wraps around many times
+                    auto* voice = new StreamingSamplerVoice (scheduler, 8192);
+                    streaming.addVoice (voice);
+
+                    AudioBuffer<f32> expected (2, 512), actual (2, 512);
+                    MidiBuffer midi;
+                    midi.addEvent (MidiMessage::noteOn (1, note, 0.8f), 0);
+                    b8 allMatch = true;
+
+                    for (i32 block = 0; block < 2000 && allMatch; ++block)
+                    {
+                        // Waiting for the scheduler makes the test independent of thread timing
+                        for (i32 i = 0; i < 5000 && ! voice->isBufferFull(); ++i)
+                            Thread::sleep (1);
+
+                        expected.clear();
+                        actual.clear();
+                        reference.renderNextBlock (expected, midi, 0, 512);
+                        streaming.renderNextBlock (actual, midi, 0, 512);
+                        midi.clear();
+
+                        for (i32 ch = 0; ch < 2; ++ch)
+                            allMatch = allMatch && std::equal (expected.getReadPointer (ch), expected.getReadPointer (ch) + 512,
+                                                               actual.getReadPointer (ch));
+                    }
+
+                    expect (allMatch);
+                    expect (! voice->isVoiceActive());
+                    expectEquals (voice->getNumUnderruns(), (z64) 0);
+                }
+            }
+        }
+
+        beginTest ("Retriggering a voice while it's streaming");
+        {
+            ReadAheadScheduler scheduler ("Test", 1);
+            scheduler.setPollInterval (1);
+
+            Synthesiser synth;
+            synth.setCurrentPlaybackSampleRate (44100.0);
+            synth.addSound (new StreamingSamplerSound ("stream", std::unique_ptr<AudioFormatReader> (wav.createMemoryMappedReader (file)),
+                                                       allNotes, 60, 0.0, 0.0, 2000));
+            auto* voice = new StreamingSamplerVoice (scheduler, 8192);
+            synth.addVoice (voice);
+
+            AudioBuffer<f32> buffer (2, 512);
+            MidiBuffer midi;
+
+            for (i32 block = 0; block < 200; ++block)
+            {
+                if (block % 10 == 0)
+                    midi.addEvent (MidiMessage::noteOn (1, 48 + block % 24, 1.0f), 0);
+
+                for (i32 i = 0; i < 5000 && ! voice->isBufferFull(); ++i)
+                    Thread::sleep (1);
+
+                synth.renderNextBlock (buffer, midi, 0, 512);
+                midi.clear();
+            }
+
+            expectEquals (voice->getNumUnderruns(), (z64) 0);
+        }
+
+        beginTest ("512 streaming voices");
+        {
+            const auto numVoices = 512;
+            const auto blockSize = 512;
+            const auto sampleRate = 44100.0;
+
+            ReadAheadScheduler scheduler ("Test");
+            scheduler.setPollInterval (2);
+
+            Synthesiser synth;
+            synth.setCurrentPlaybackSampleRate (sampleRate);
+            synth.addSound (new StreamingSamplerSound ("stream", std::unique_ptr<AudioFormatReader> (wav.createMemoryMappedReader (file)),
+                                                       allNotes, 60, 0.0, 0.0, 32768));
+
+            Array<StreamingSamplerVoice*> voices;
+            size_t memoryUsage = 0;
+
+            for (i32 i = 0; i < numVoices; ++i)
+            {
+                auto* voice = new StreamingSamplerVoice (scheduler);
+                voices.add (voice);
+                memoryUsage += voice->getMemoryUsage();
+                synth.addVoice (voice);
+            }
+
+            MidiBuffer midi;
+
+            for (i32 i = 0; i < numVoices; ++i)
+                midi.addEvent (MidiMessage::noteOn (1 + i / 32, 48 + i % 32, 0.01f), 0);
+
+            AudioBuffer<f32> buffer (2, blockSize);
+            const auto blockMs = 1000.0 * blockSize / sampleRate;
+            const auto numBlocks = 200;
+            f64 renderMs = 0, worstBlockMs = 0;
+            auto deadline = Time::getMillisecondCounterHiRes();
+
+            for (i32 block = 0; block < numBlocks; ++block)
+            {
+                // Pace the blocks like an audio callback, so that the scheduler gets the
+                // time in between to refill the voices
+                deadline += blockMs;
+
+                const auto start = Time::getMillisecondCounterHiRes();
+                buffer.clear();
+                synth.renderNextBlock (buffer, midi, 0, blockSize);
+                midi.clear();
+                const auto elapsed = Time::getMillisecondCounterHiRes() - start;
+
+                renderMs += elapsed;
+                worstBlockMs = jmax (worstBlockMs, elapsed);
+
+                const auto msLeft = deadline - Time::getMillisecondCounterHiRes();
+
+                if (msLeft > 1.0)
+                    Thread::sleep ((i32) msLeft);
+            }
+
+            i32 numActive = 0;
+            z64 numUnderruns = 0;
+
+            for (auto* voice : voices)
+            {
+                numActive += voice->isVoiceActive() ? 1 : 0;
+                numUnderruns += voice->getNumUnderruns();
+            }
+
+            const auto metrics = scheduler.getMetrics();
+
+            logMessage ("  " + Txt (numVoices) + " voices, " + Txt (scheduler.getNumThreads()) + " threads, "
+                        + Txt ((f64) memoryUsage / (1024.0 * 1024.0), 1) + " MB of ring buffers");
+            logMessage ("  render: " + Txt (renderMs / numBlocks, 3) + " ms per " + Txt (blockMs, 1)
+                        + " ms block on average, worst " + Txt (worstBlockMs, 3) + " ms");
+            logMessage ("  reads: " + Txt (metrics.numReads) + ", while empty: " + Txt (metrics.numReadsWhileEmpty)
+                        + ", underruns: " + Txt (numUnderruns));
+
+            expectEquals (numActive, numVoices);
+            expectEquals (numUnderruns, (z64) 0);
+            expectEquals (memoryUsage, (size_t) numVoices * 2 * 16384 * sizeof (f32));
+
+            synth.clearVoices();
+        }
+
+        folder.deleteRecursively();
+    }
+};
+
+static StreamingSamplerTests streamingSamplerTests;
+
+#endif
+
+} // namespace drx
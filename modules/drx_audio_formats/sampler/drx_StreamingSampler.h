@@ -0,0 +1,247 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+
+namespace drx
+{
+
+//==============================================================================
+/**
+    A SynthesiserSound that plays a sample by streaming it from disk.
+
+    A SamplerSound loads the whole of its sample into memory. This class only keeps
+    the first part of the sample (the "preload") in memory, and a StreamingSamplerVoice
+    reads the rest from the sound's AudioFormatReader while the note plays, on the
+    threads of a ReadAheadScheduler. The preload has to be long enough to cover the time
+    it takes the scheduler to start filling a newly started voice's buffer.
+
+    If the reader is a MemoryMappedAudioFormatReader, the whole file is mapped and the
+    voices can all read from it at the same time. Any other kind of reader is shared
+    between the voices under a lock, so it'll be slower when many voices are streaming
+    the same sound.
+
+    @see StreamingSamplerVoice, SamplerSound, DecodedAudioFileCache
+
+    @tags{Audio}
+*/
+class DRX_API  StreamingSamplerSound    : public SynthesiserSound
+{
+public:
+    //==============================================================================
+    /** Creates a streaming sound.
+
+        @param name         a name for the sample
+        @param source       the reader to stream the audio from. The sound takes ownership
+                            of this, and keeps it open for as long as the sound, or any
+                            voice that has played it, still exists
+        @param midiNotes    the set of midi keys that this sound should be played on. This
+                            is used by the SynthesiserSound::appliesToNote() method
+        @param midiNoteForNormalPitch   the midi note at which the sample should be played
+                                        with its natural rate. All other notes will be pitched
+                                        up or down relative to this one
+        @param attackTimeSecs   the attack (fade-in) time, in seconds
+        @param releaseTimeSecs  the decay (fade-out) time, in seconds
+        @param numSamplesToPreload  the number of samples from the start of the sample
+                                    to keep in memory
+    */
+    StreamingSamplerSound (const Txt& name,
+                           std::unique_ptr<AudioFormatReader> source,
+                           const BigInteger& midiNotes,
+                           i32 midiNoteForNormalPitch,
+                           f64 attackTimeSecs,
+                           f64 releaseTimeSecs,
+                           i32 numSamplesToPreload = 32768);
+
+    /** Destructor. */
+    ~StreamingSamplerSound() override;
+
+    //==============================================================================
+    /** Returns the sample's name */
+    const Txt& getName() const noexcept                  { return name; }
+
+    /** Returns the length of the sample, in samples.
+        This will be 0 if there was a problem opening the source.
+    */
+    z64 getLengthInSamples() const noexcept                { return length; }
+
+    /** Returns the part of the sample that is kept in memory. */
+    const AudioBuffer<f32>& getPreloadedData() const noexcept  { return preload; }
+
+    /** Возвращает true, если the voices can read from the source concurrently, i.e. if it's
+        a memory-mapped reader whose whole file could be mapped.
+    */
+    b8 canReadConcurrently() const noexcept;
+
+    //==============================================================================
+    /** Changes the parameters of the ADSR envelope which will be applied to the sample. */
+    z0 setEnvelopeParameters (ADSR::Parameters parametersToUse)    { params = parametersToUse; }
+
+    //==============================================================================
+    b8 appliesToNote (i32 midiNoteNumber) override;
+    b8 appliesToChannel (i32 midiChannel) override;
+
+private:
+    //==============================================================================
+    friend class StreamingSamplerVoice;
+    class Stream;
+
+    Txt name;
+    ReferenceCountedObjectPtr<Stream> stream;
+    AudioBuffer<f32> preload;
+    f64 sourceSampleRate = 0;
+    BigInteger midiNotes;
+    z64 length = 0;
+    i32 midiRootNote = 0;
+
+    ADSR::Parameters params;
+
+    DRX_LEAK_DETECTOR (StreamingSamplerSound)
+};
+
+
+//==============================================================================
+/**
+    A SynthesiserVoice that plays a StreamingSamplerSound.
+
+    Each voice owns a fixed-size ring buffer, which is allocated when the voice is
+    created, so the memory used by a synthesiser's voices doesn't grow with the length
+    or number of its samples. While a note plays, the voice is served by a
+    ReadAheadScheduler, whose threads keep the ring buffer filled from the sound's reader.
+
+    Starting a note doesn't allocate, lock or wait for a read: the voice plays from the
+    sound's preloaded data while the scheduler notices the new note and starts filling the
+    ring buffer, which it does by polling StreamingSamplerVoice's isReadAheadNeeded()
+    method. Set the scheduler's poll interval to a few milliseconds with
+    ReadAheadScheduler::setPollInterval().
+
+    If the scheduler falls so far behind that the voice reaches data which hasn't been
+    read yet, the missing samples are played as silence and the block is counted in
+    getNumUnderruns().
+
+    @see StreamingSamplerSound, ReadAheadScheduler, SamplerVoice
+
+    @tags{Audio}
+*/
+class DRX_API  StreamingSamplerVoice    : public SynthesiserVoice,
+                                          private ReadAheadScheduler::Client
+{
+public:
+    //==============================================================================
+    /** Creates a voice and registers it with a scheduler.
+
+        @param scheduler            the scheduler that will fill the voice's buffer. This
+                                    must outlive the voice
+        @param ringBufferSamples    the size of the voice's buffer, in samples. This is
+                                    rounded up to a power of two
+    */
+    explicit StreamingSamplerVoice (ReadAheadScheduler& scheduler, i32 ringBufferSamples = 16384);
+
+    /** Destructor. */
+    ~StreamingSamplerVoice() override;
+
+    //==============================================================================
+    /** Returns the size of the voice's ring buffer, in samples. */
+    i32 getRingBufferSize() const noexcept                  { return ringSize; }
+
+    /** Returns the number of bytes of sample memory that the voice has allocated. */
+    size_t getMemoryUsage() const noexcept;
+
+    /** Returns the number of blocks which had to be rendered with missing data since the
+        voice was created.
+    */
+    z64 getNumUnderruns() const noexcept                    { return numUnderruns; }
+
+    /** Возвращает true, если the voice doesn't need the scheduler to read anything, i.e. it's
+        either not playing, or its ring buffer holds everything up to the end of the sample,
+        or is too full for another chunk to fit.
+    */
+    b8 isBufferFull() const noexcept;
+
+    //==============================================================================
+    b8 canPlaySound (SynthesiserSound*) override;
+
+    z0 startNote (i32 midiNoteNumber, f32 velocity, SynthesiserSound*, i32 pitchWheel) override;
+    z0 stopNote (f32 velocity, b8 allowTailOff) override;
+
+    z0 pitchWheelMoved (i32 newValue) override;
+    z0 controllerMoved (i32 controllerNumber, i32 newValue) override;
+
+    z0 renderNextBlock (AudioBuffer<f32>&, i32 startSample, i32 numSamples) override;
+    using SynthesiserVoice::renderNextBlock;
+
+private:
+    //==============================================================================
+    b8 readAhead() override;
+    f64 getSecondsBuffered() const override;
+    f32 getBufferFillLevel() const override;
+    b8 isReadAheadNeeded() const override;
+
+    z64 getReadLimit() const noexcept;
+    z0 endStream() noexcept;
+    z0 retireStream (StreamingSamplerSound::Stream* previous, StreamingSamplerSound::Stream* current) noexcept;
+    z0 releaseRetiredStreams();
+
+    static constexpr i32 readChunkSize = 4096;
+    static constexpr i32 generationShift = 40;
+    static constexpr u64 positionMask = (((u64) 1) << generationShift) - 1;
+
+    ReadAheadScheduler& scheduler;
+    AudioBuffer<f32> ring;
+    i32 ringSize = 0;
+
+    // The stream is handed from the audio thread to the scheduler's thread through
+    // pendingStream, and only the scheduler's thread ever releases activeStream. A pending
+    // stream that's replaced before the scheduler picks it up is parked in retiredStreams,
+    // so that it's released on the scheduler's thread too.
+    std::atomic<StreamingSamplerSound::Stream*> pendingStream { nullptr };
+    std::atomic<StreamingSamplerSound::Stream*> retiredStreams[4] {};
+    ReferenceCountedObjectPtr<StreamingSamplerSound::Stream> activeStream;
+
+    // The note's generation in the top bits, and the end of the data that has been read
+    // into the ring buffer in the rest.
+    std::atomic<u64> streamState { 0 };
+    std::atomic<z64> readPosition { 0 }, streamEnd { 0 }, numUnderruns { 0 };
+    std::atomic<f64> sourceSamplesPerSecond { 0 };
+    u64 generation = 0;
+
+    f64 pitchRatio = 0;
+    f64 sourceSamplePosition = 0;
+    f32 lgain = 0, rgain = 0;
+
+    ADSR adsr;
+
+    DRX_LEAK_DETECTOR (StreamingSamplerVoice)
+};
+
+} // namespace drx
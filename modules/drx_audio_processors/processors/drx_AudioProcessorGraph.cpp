@@ -563,8 +563,11 @@ struct GraphRenderSequence
                                     audioPlayHead,
                                     numSamples };
 
-            for (const auto& op : renderOps)
-                op->process (context);
+            if (parallelSchedule != nullptr)
+                parallelSchedule->perform (*parallelThreads, context);
+            else
+                for (const auto& op : renderOps)
+                    op->process (context);
         }
 
         for (i32 i = 0; i < buffer.getNumChannels(); ++i)
@@ -596,7 +599,7 @@ struct GraphRenderSequence
             i32 index = 0;
         };
 
-        renderOps.push_back (std::make_unique<ClearOp> (index));
+        addOp (std::make_unique<ClearOp> (index), { audioBufferResource (index) });
     }
 
     z0 addCopyChannelOp (i32 srcIndex, i32 dstIndex)
@@ -621,7 +624,7 @@ struct GraphRenderSequence
             i32 from = 0, to = 0;
         };
 
-        renderOps.push_back (std::make_unique<CopyOp> (srcIndex, dstIndex));
+        addOp (std::make_unique<CopyOp> (srcIndex, dstIndex), { audioBufferResource (srcIndex), audioBufferResource (dstIndex) });
     }
 
     z0 addAddChannelOp (i32 srcIndex, i32 dstIndex)
@@ -646,7 +649,7 @@ struct GraphRenderSequence
             i32 from = 0, to = 0;
         };
 
-        renderOps.push_back (std::make_unique<AddOp> (srcIndex, dstIndex));
+        addOp (std::make_unique<AddOp> (srcIndex, dstIndex), { audioBufferResource (srcIndex), audioBufferResource (dstIndex) });
     }
 
     DRX_END_IGNORE_WARNINGS_MSVC
@@ -671,7 +674,7 @@ struct GraphRenderSequence
             i32 index = 0;
         };
 
-        renderOps.push_back (std::make_unique<ClearOp> (index));
+        addOp (std::make_unique<ClearOp> (index), { midiBufferResource (index) });
     }
 
     z0 addCopyMidiBufferOp (i32 srcIndex, i32 dstIndex)
@@ -696,7 +699,7 @@ struct GraphRenderSequence
             i32 from = 0, to = 0;
         };
 
-        renderOps.push_back (std::make_unique<CopyOp> (srcIndex, dstIndex));
+        addOp (std::make_unique<CopyOp> (srcIndex, dstIndex), { midiBufferResource (srcIndex), midiBufferResource (dstIndex) });
     }
 
     z0 addAddMidiBufferOp (i32 srcIndex, i32 dstIndex)
@@ -721,7 +724,7 @@ struct GraphRenderSequence
             i32 from = 0, to = 0;
         };
 
-        renderOps.push_back (std::make_unique<AddOp> (srcIndex, dstIndex));
+        addOp (std::make_unique<AddOp> (srcIndex, dstIndex), { midiBufferResource (srcIndex), midiBufferResource (dstIndex) });
     }
 
     z0 addDelayChannelOp (i32 chan, i32 delaySize)
@@ -760,7 +763,7 @@ struct GraphRenderSequence
             i32 readIndex = 0, writeIndex;
         };
 
-        renderOps.push_back (std::make_unique<DelayChannelOp> (chan, delaySize));
+        addOp (std::make_unique<DelayChannelOp> (chan, delaySize), { audioBufferResource (chan) });
     }
 
     z0 addProcessOp (const Node::Ptr& node,
@@ -768,6 +771,12 @@ struct GraphRenderSequence
                        i32 totalNumChans,
                        i32 midiBuffer)
     {
+        std::vector<i64> resources { midiBufferResource (midiBuffer) };
+
+        for (auto index : audioChannelsUsed)
+            if (index != 0) // buffer 0 is the shared read-only empty buffer
+                resources.push_back (audioBufferResource (index));
+
         auto op = [&]() -> std::unique_ptr<NodeOp>
         {
             if (auto* ioNode = dynamic_cast<const AudioProcessorGraph::AudioGraphIOProcessor*> (node->getProcessor()))
@@ -778,12 +787,14 @@ struct GraphRenderSequence
                         return std::make_unique<AudioInOp> (node, audioChannelsUsed, totalNumChans, midiBuffer);
 
                     case AudioProcessorGraph::AudioGraphIOProcessor::audioOutputNode:
+                        resources.push_back (graphAudioOutputResource());
                         return std::make_unique<AudioOutOp> (node, audioChannelsUsed, totalNumChans, midiBuffer);
 
                     case AudioProcessorGraph::AudioGraphIOProcessor::midiInputNode:
                         return std::make_unique<MidiInOp> (node, audioChannelsUsed, totalNumChans, midiBuffer);
 
                     case AudioProcessorGraph::AudioGraphIOProcessor::midiOutputNode:
+                        resources.push_back (graphMidiOutputResource());
                         return std::make_unique<MidiOutOp> (node, audioChannelsUsed, totalNumChans, midiBuffer);
                 }
             }
@@ -791,11 +802,18 @@ struct GraphRenderSequence
             return std::make_unique<ProcessOp> (node, audioChannelsUsed, totalNumChans, midiBuffer);
         }();
 
-        renderOps.push_back (std::move (op));
+        addOp (std::move (op), resources);
     }
 
-    z0 prepareBuffers (i32 blockSize)
+    /*  Pass a set of worker threads to render independent ops concurrently, or nullptr to
+        render every op in sequence on the audio thread.
+    */
+    z0 prepareBuffers (i32 blockSize, std::shared_ptr<RealtimeWorkerThreads> threads)
     {
+        parallelThreads = std::move (threads);
+        parallelSchedule = parallelThreads != nullptr ? std::make_unique<ParallelSchedule> (*this)
+                                                      : nullptr;
+
         renderingBuffer.setSize (numBuffersNeeded + 1, blockSize);
         renderingBuffer.clear();
         currentAudioOutputBuffer.setSize (numBuffersNeeded + 1, blockSize);
@@ -995,7 +1013,132 @@ private:
         }
     };
 
+    //==============================================================================
+    /*  Identifies a buffer that a RenderOp touches. When rendering in parallel, ops that share
+        a resource always run in the order in which they were added, which keeps the output
+        identical to the output of the serial renderer.
+    */
+    enum class ResourceKind : u32 { audioBuffer, midiBuffer, graphAudioOutput, graphMidiOutput };
+
+    static i64 makeResource (ResourceKind kind, i32 index)   { return (i64) (((u64) kind << 32) | (u32) index); }
+    static i64 audioBufferResource (i32 index)               { return makeResource (ResourceKind::audioBuffer, index); }
+    static i64 midiBufferResource (i32 index)                { return makeResource (ResourceKind::midiBuffer, index); }
+    static i64 graphAudioOutputResource()                    { return makeResource (ResourceKind::graphAudioOutput, 0); }
+    static i64 graphMidiOutputResource()                     { return makeResource (ResourceKind::graphMidiOutput, 0); }
+
+    z0 addOp (std::unique_ptr<RenderOp> op, const std::vector<i64>& resources)
+    {
+        const auto opIndex = (i32) renderOps.size();
+        std::set<i32> dependencies;
+
+        for (const auto resource : resources)
+        {
+            const auto previous = lastOpUsingResource.find (resource);
+
+            if (previous != lastOpUsingResource.end() && previous->second != opIndex)
+                dependencies.insert (previous->second);
+
+            lastOpUsingResource[resource] = opIndex;
+        }
+
+        for (const auto dependency : dependencies)
+            dependentOps[(size_t) dependency].push_back (opIndex);
+
+        renderOps.push_back (std::move (op));
+        dependentOps.emplace_back();
+        numDependencies.push_back ((i32) dependencies.size());
+    }
+
+    //==============================================================================
+    /*  Per-block scheduling state used when rendering on several threads.
+
+        Every op is published exactly once per block, so a flat array of slots is enough to act
+        as a lock-free ready queue: threads claim slots in order, and wait for an op to be
+        published into a claimed slot when all the ready ops have already been taken.
+    */
+    class ParallelSchedule final : public RealtimeWorkerThreads::Work
+    {
+    public:
+        explicit ParallelSchedule (const GraphRenderSequence& s)
+            : sequence (s),
+              numOps ((i32) s.renderOps.size()),
+              readySlots (new std::atomic<i32>[(size_t) numOps]),
+              pendingDependencies (new std::atomic<i32>[(size_t) numOps])
+        {
+        }
+
+        z0 perform (RealtimeWorkerThreads& threads, const Context& c)
+        {
+            context = &c;
+            numClaimed = 0;
+            numPublished = 0;
+            numCompleted = 0;
+
+            for (i32 i = 0; i < numOps; ++i)
+            {
+                readySlots[i].store (-1, std::memory_order_relaxed);
+                pendingDependencies[i].store (sequence.numDependencies[(size_t) i], std::memory_order_relaxed);
+            }
+
+            for (i32 i = 0; i < numOps; ++i)
+                if (sequence.numDependencies[(size_t) i] == 0)
+                    publish (i);
+
+            threads.run (*this);
+        }
+
+        z0 participate (i32) override
+        {
+            for (;;)
+            {
+                const auto slot = numClaimed.fetch_add (1);
+
+                if (slot >= numOps)
+                    return;
+
+                auto opIndex = readySlots[slot].load (std::memory_order_acquire);
+
+                while (opIndex < 0)
+                {
+                    Thread::yield();
+                    opIndex = readySlots[slot].load (std::memory_order_acquire);
+                }
+
+                sequence.renderOps[(size_t) opIndex]->process (*context);
+
+                for (const auto dependent : sequence.dependentOps[(size_t) opIndex])
+                    if (pendingDependencies[dependent].fetch_sub (1, std::memory_order_acq_rel) == 1)
+                        publish (dependent);
+
+                numCompleted.fetch_add (1, std::memory_order_release);
+            }
+        }
+
+        b8 isFinished() const override
+        {
+            return numCompleted.load (std::memory_order_acquire) == numOps;
+        }
+
+    private:
+        z0 publish (i32 opIndex)
+        {
+            readySlots[numPublished.fetch_add (1)].store (opIndex, std::memory_order_release);
+        }
+
+        const GraphRenderSequence& sequence;
+        const Context* context = nullptr;
+        i32k numOps;
+        std::unique_ptr<std::atomic<i32>[]> readySlots, pendingDependencies;
+        std::atomic<i32> numClaimed { 0 }, numPublished { 0 }, numCompleted { 0 };
+    };
+
     std::vector<std::unique_ptr<RenderOp>> renderOps;
+    std::vector<std::vector<i32>> dependentOps;
+    std::vector<i32> numDependencies;
+    std::unordered_map<i64, i32> lastOpUsingResource;
+
+    std::shared_ptr<RealtimeWorkerThreads> parallelThreads;
+    std::unique_ptr<ParallelSchedule> parallelSchedule;
 };
 
 //==============================================================================
@@ -1019,17 +1162,25 @@ public:
 
     static constexpr auto midiChannelIndex = AudioProcessorGraph::midiChannelIndex;
 
+    /*  Buffer reuse keeps the memory footprint low. The parallel renderer orders every op that
+        touches a buffer, so reuse would still be safe there, but a buffer that's handed on to an
+        unrelated branch would make that branch wait for the first one. Without reuse, each node
+        output channel costs one block-sized buffer, which is small next to the nodes themselves.
+    */
+    enum class BufferReuse { enabled, disabled };
+
     template <typename FloatType>
-    static SequenceAndLatency build (const Nodes& n, const Connections& c)
+    static SequenceAndLatency build (const Nodes& n, const Connections& c, BufferReuse reuse)
     {
         GraphRenderSequence<FloatType> sequence;
-        const RenderSequenceBuilder builder (n, c, sequence);
+        const RenderSequenceBuilder builder (n, c, sequence, reuse);
         return { std::move (sequence), builder.totalLatency };
     }
 
 private:
     //==============================================================================
     const Array<Node*> orderedNodes;
+    const BufferReuse bufferReuse;
 
     struct AssignedBuffer
     {
@@ -1284,7 +1435,7 @@ private:
         // No midi inputs..
         if (sources.empty())
         {
-            auto midiBufferToUse = getFreeBuffer (midiBuffers); // need to pick a buffer even if the processor doesn't use midi
+            auto midiBufferToUse = getFreeMidiBuffer(); // need to pick a buffer even if the processor doesn't use midi
 
             if (processor.acceptsMidi() || processor.producesMidi())
                 sequence.addClearMidiBufferOp (midiBufferToUse);
@@ -1304,7 +1455,7 @@ private:
                 {
                     // can't mess up this channel because it's needed later by another node, so we
                     // need to use a copy of it..
-                    auto newFreeBuffer = getFreeBuffer (midiBuffers);
+                    auto newFreeBuffer = getFreeMidiBuffer();
                     sequence.addCopyMidiBufferOp (midiBufferToUse, newFreeBuffer);
                     midiBufferToUse = newFreeBuffer;
                 }
@@ -1312,7 +1463,7 @@ private:
             else
             {
                 // probably a feedback loop, so just use an empty one..
-                midiBufferToUse = getFreeBuffer (midiBuffers); // need to pick a buffer even if the processor doesn't use midi
+                midiBufferToUse = getFreeMidiBuffer(); // need to pick a buffer even if the processor doesn't use midi
             }
 
             return midiBufferToUse;
@@ -1344,7 +1495,7 @@ private:
         if (reusableInputIndex < 0)
         {
             // can't re-use any of our input buffers, so get a new one and copy everything into it..
-            midiBufferToUse = getFreeBuffer (midiBuffers);
+            midiBufferToUse = getFreeMidiBuffer();
             jassert (midiBufferToUse >= 0);
 
             auto srcIndex = getBufferContaining (*sources.begin());
@@ -1433,6 +1584,21 @@ private:
     }
 
     //==============================================================================
+    /*  A node that doesn't produce MIDI leaves its buffer free, so without buffer reuse the
+        next node would be given the same one. That's harmless when rendering in sequence, but
+        in parallel the shared buffer would chain all such nodes together, so each one is given
+        a scratch buffer of its own instead.
+    */
+    i32 getFreeMidiBuffer()
+    {
+        const auto index = getFreeBuffer (midiBuffers);
+
+        if (bufferReuse == BufferReuse::disabled)
+            midiBuffers.getReference (index).setAssignedToNonExistentNode();
+
+        return index;
+    }
+
     static i32 getFreeBuffer (Array<AssignedBuffer>& buffers)
     {
         for (i32 i = 1; i < buffers.size(); ++i)
@@ -1489,8 +1655,9 @@ private:
     }
 
     template <typename RenderSequence>
-    RenderSequenceBuilder (const Nodes& n, const Connections& c, RenderSequence& sequence)
-        : orderedNodes (createOrderedNodeList (n, c))
+    RenderSequenceBuilder (const Nodes& n, const Connections& c, RenderSequence& sequence, BufferReuse reuse)
+        : orderedNodes (createOrderedNodeList (n, c)),
+          bufferReuse (reuse)
     {
         audioBuffers.add (AssignedBuffer::createReadOnlyEmpty()); // first buffer is read-only zeros
         midiBuffers .add (AssignedBuffer::createReadOnlyEmpty());
@@ -1500,8 +1667,12 @@ private:
         for (i32 i = 0; i < orderedNodes.size(); ++i)
         {
             createRenderingOpsForNode (c, reversed, sequence, *orderedNodes.getUnchecked (i), i);
-            markAnyUnusedBuffersAsFree (reversed, audioBuffers, i);
-            markAnyUnusedBuffersAsFree (reversed, midiBuffers, i);
+
+            if (bufferReuse == BufferReuse::enabled)
+            {
+                markAnyUnusedBuffersAsFree (reversed, audioBuffers, i);
+                markAnyUnusedBuffersAsFree (reversed, midiBuffers, i);
+            }
         }
 
         sequence.numBuffersNeeded = audioBuffers.size();
@@ -1521,10 +1692,11 @@ class RenderSequence
 public:
     using AudioGraphIOProcessor = AudioProcessorGraph::AudioGraphIOProcessor;
 
-    RenderSequence (const PrepareSettings s, const Nodes& n, const Connections& c)
-        : RenderSequence (s, s.precision == AudioProcessor::ProcessingPrecision::singlePrecision
-                                ? RenderSequenceBuilder::build<f32>  (n, c)
-                                : RenderSequenceBuilder::build<f64> (n, c))
+    RenderSequence (const PrepareSettings s,
+                    const Nodes& n,
+                    const Connections& c,
+                    const std::shared_ptr<RealtimeWorkerThreads>& threads)
+        : RenderSequence (s, build (s, n, c, threads != nullptr), threads)
     {
     }
 
@@ -1549,10 +1721,20 @@ private:
         jassertfalse;
     }
 
-    RenderSequence (const PrepareSettings s, SequenceAndLatency&& built)
+    static SequenceAndLatency build (const PrepareSettings s, const Nodes& n, const Connections& c, b8 parallel)
+    {
+        const auto reuse = parallel ? RenderSequenceBuilder::BufferReuse::disabled
+                                    : RenderSequenceBuilder::BufferReuse::enabled;
+
+        return s.precision == AudioProcessor::ProcessingPrecision::singlePrecision
+                   ? RenderSequenceBuilder::build<f32> (n, c, reuse)
+                   : RenderSequenceBuilder::build<f64> (n, c, reuse);
+    }
+
+    RenderSequence (const PrepareSettings s, SequenceAndLatency&& built, const std::shared_ptr<RealtimeWorkerThreads>& threads)
         : settings (s), sequence (std::move (built))
     {
-        visitRenderSequence (*this, [&] (auto& seq) { seq.prepareBuffers (settings.blockSize); });
+        visitRenderSequence (*this, [&] (auto& seq) { seq.prepareBuffers (settings.blockSize, threads); });
     }
 
     PrepareSettings settings;
@@ -1911,6 +2093,24 @@ public:
     /*  Call from the audio thread only. */
     auto* getAudioThreadState() const { return renderSequenceExchange.getAudioThreadState(); }
 
+    z0 setNumParallelRenderThreads (i32 numThreads)
+    {
+        jassert (numThreads >= 0);
+
+        if (numThreads == getNumParallelRenderThreads())
+            return;
+
+        // Any render sequence that's still in use keeps its own reference to the old threads
+        renderThreads = numThreads > 0 ? std::make_shared<RealtimeWorkerThreads> (numThreads, "Graph render thread") : nullptr;
+        lastBuiltSequence.reset();
+        rebuild (UpdateKind::sync);
+    }
+
+    i32 getNumParallelRenderThreads() const noexcept
+    {
+        return renderThreads != nullptr ? renderThreads->getNumThreads() : 0;
+    }
+
 private:
     z0 setParentGraph (AudioProcessor* p) const
     {
@@ -1935,7 +2135,7 @@ private:
 
             if (std::exchange (lastBuiltSequence, newSignature) != newSignature)
             {
-                auto sequence = std::make_unique<RenderSequence> (*newSettings, nodes, connections);
+                auto sequence = std::make_unique<RenderSequence> (*newSettings, nodes, connections, renderThreads);
                 owner->setLatencySamples (sequence->getLatencySamples());
                 renderSequenceExchange.set (std::move (sequence));
             }
@@ -1951,6 +2151,7 @@ private:
     Nodes nodes;
     Connections connections;
     NodeStates nodeStates;
+    std::shared_ptr<RealtimeWorkerThreads> renderThreads;
     RenderSequenceExchange renderSequenceExchange;
     NodeID lastNodeID;
     std::optional<RenderSequenceSignature> lastBuiltSequence;
@@ -1982,6 +2183,8 @@ b8 AudioProcessorGraph::disconnectNode (NodeID nodeID, UpdateKind updateKind)
 z0 AudioProcessorGraph::releaseResources()                                                                { return pimpl->releaseResources(); }
 b8 AudioProcessorGraph::removeIllegalConnections (UpdateKind updateKind)                                  { return pimpl->removeIllegalConnections (updateKind); }
 z0 AudioProcessorGraph::rebuild()                                                                         { return pimpl->rebuild (UpdateKind::sync); }
+z0 AudioProcessorGraph::setNumParallelRenderThreads (i32 numThreads)                                    { return pimpl->setNumParallelRenderThreads (numThreads); }
+i32 AudioProcessorGraph::getNumParallelRenderThreads() const noexcept                                     { return pimpl->getNumParallelRenderThreads(); }
 z0 AudioProcessorGraph::reset()                                                                           { return pimpl->reset(); }
 b8 AudioProcessorGraph::canConnect (const Connection& c) const                                            { return pimpl->canConnect (c); }
 b8 AudioProcessorGraph::isConnected (const Connection& c) const noexcept                                  { return pimpl->isConnected (c); }
@@ -2303,12 +2506,221 @@ public:
             // this graph, so we just want to make sure that we finish the test without timing out.
             logMessage ("render sequence built in " + Txt (duration) + " ms");
         }
+
+        beginTest ("parallel rendering produces the same output as serial rendering");
+        {
+            for (auto numThreads : { 1, 2, 4 })
+            {
+                AudioProcessorGraph serial, parallel;
+                parallel.setNumParallelRenderThreads (numThreads);
+                expect (parallel.getNumParallelRenderThreads() == numThreads);
+
+                buildBranchingGraph (serial, 16, 4, 1);
+                buildBranchingGraph (parallel, 16, 4, 1);
+
+                AudioBuffer<f32> serialOutput (2, blockSize), parallelOutput (2, blockSize);
+                MidiBuffer midi;
+                auto identical = true;
+
+                for (auto block = 0; block < 20; ++block)
+                {
+                    serial.processBlock (serialOutput, midi);
+                    parallel.processBlock (parallelOutput, midi);
+
+                    for (auto channel = 0; channel < 2; ++channel)
+                        identical &= std::memcmp (serialOutput.getReadPointer (channel),
+                                                  parallelOutput.getReadPointer (channel),
+                                                  sizeof (f32) * (size_t) blockSize) == 0;
+                }
+
+                expect (identical);
+                expect (serialOutput.getMagnitude (0, blockSize) > 0.0f);
+            }
+        }
+
+        beginTest ("parallel rendering scales with the number of threads");
+        {
+            const auto maxThreads = jlimit (1, 7, SystemStats::getNumCpus() - 1);
+
+            // With n workers, n + 1 independent branches should all be inside their first node
+            // at the same time. If anything chained the branches together, the first one to
+            // start would give up waiting for the others.
+            for (auto numThreads = 1; numThreads <= maxThreads; ++numThreads)
+            {
+                AudioProcessorGraph graph;
+                graph.setNumParallelRenderThreads (numThreads);
+
+                Rendezvous sources (numThreads + 1);
+                buildBranchingGraph (graph, numThreads + 1, 4, 1, &sources);
+
+                AudioBuffer<f32> output (2, blockSize);
+                MidiBuffer midi;
+                graph.processBlock (output, midi);
+
+                expect (sources.allArrived.load(), Txt (numThreads) + " worker threads didn't overlap the branches");
+            }
+
+            for (auto numThreads = 0; numThreads <= maxThreads; ++numThreads)
+            {
+                AudioProcessorGraph graph;
+                graph.setNumParallelRenderThreads (numThreads);
+                buildBranchingGraph (graph, 32, 4, 16);
+
+                AudioBuffer<f32> output (2, blockSize);
+                MidiBuffer midi;
+                constexpr auto numBlocks = 50;
+
+                const auto b = std::chrono::steady_clock::now();
+
+                for (auto block = 0; block < numBlocks; ++block)
+                    graph.processBlock (output, midi);
+
+                const auto e = std::chrono::steady_clock::now();
+                const auto duration = std::chrono::duration_cast<std::chrono::microseconds> (e - b).count();
+
+                // The overlap is checked above, this just reports how throughput changes
+                logMessage (Txt (numThreads) + " worker threads: " + Txt ((f64) duration / numBlocks, 1) + " us per block");
+            }
+        }
     }
 
 private:
     enum class MidiIn  { no, yes };
     enum class MidiOut { no, yes };
 
+    static constexpr auto blockSize = 256;
+
+    /*  Holds up the nodes that use it until a given number of them have started processing,
+        or until a time-out expires.
+    */
+    struct Rendezvous
+    {
+        explicit Rendezvous (i32 numExpectedIn)  : numExpected (numExpectedIn) {}
+
+        z0 arriveAndWait()
+        {
+            ++numArrived;
+            const auto timeOut = Time::getMillisecondCounter() + 2000;
+
+            while (numArrived.load() < numExpected)
+            {
+                if (Time::getMillisecondCounter() > timeOut)
+                {
+                    allArrived = false;
+                    return;
+                }
+
+                Thread::sleep (1);
+            }
+        }
+
+        i32k numExpected;
+        std::atomic<i32> numArrived { 0 };
+        std::atomic<b8> allArrived { true };
+    };
+
+    /*  Builds a stereo graph in which each branch is a source followed by a chain of processors.
+        Each branch also feeds into the middle of the next one, so that some inputs are mixes.
+    */
+    static z0 buildBranchingGraph (AudioProcessorGraph& graph, i32 numBranches, i32 chainLength, i32 workPerSample,
+                                     Rendezvous* sources = nullptr)
+    {
+        graph.setPlayConfigDetails (0, 2, 44100.0, blockSize);
+
+        using IOProcessor = AudioProcessorGraph::AudioGraphIOProcessor;
+        const auto output = graph.addNode (std::make_unique<IOProcessor> (IOProcessor::audioOutputNode))->nodeID;
+
+        std::vector<AudioProcessorGraph::NodeID> previousBranch;
+
+        const auto connectStereo = [&] (AudioProcessorGraph::NodeID source, AudioProcessorGraph::NodeID destination)
+        {
+            for (auto channel = 0; channel < 2; ++channel)
+                graph.addConnection ({ { source, channel }, { destination, channel } }, AudioProcessorGraph::UpdateKind::none);
+        };
+
+        for (auto branch = 0; branch < numBranches; ++branch)
+        {
+            std::vector<AudioProcessorGraph::NodeID> chain;
+
+            for (auto i = 0; i < chainLength; ++i)
+            {
+                chain.push_back (graph.addNode (std::make_unique<SignalProcessor> (i == 0, (u32) (branch * chainLength + i), workPerSample,
+                                                                                   i == 0 ? sources : nullptr),
+                                                std::nullopt,
+                                                AudioProcessorGraph::UpdateKind::none)->nodeID);
+
+                if (i > 0)
+                    connectStereo (chain[(size_t) i - 1], chain[(size_t) i]);
+            }
+
+            if (! previousBranch.empty())
+                connectStereo (previousBranch[(size_t) chainLength / 2], chain[(size_t) chainLength / 2 + 1]);
+
+            connectStereo (chain.back(), output);
+            previousBranch = chain;
+        }
+
+        graph.prepareToPlay (44100.0, blockSize);
+    }
+
+    /*  Produces a deterministic signal, with an adjustable amount of work per sample. */
+    class SignalProcessor final : public AudioProcessor
+    {
+    public:
+        SignalProcessor (b8 isSourceIn, u32 seed, i32 workPerSampleIn, Rendezvous* rendezvousIn = nullptr)
+            : AudioProcessor (BusesProperties().withInput  ("in",  AudioChannelSet::stereo())
+                                               .withOutput ("out", AudioChannelSet::stereo())),
+              isSource (isSourceIn),
+              random ((z64) seed),
+              workPerSample (workPerSampleIn),
+              rendezvous (rendezvousIn) {}
+
+        const Txt getName() const override                         { return "Signal Processor"; }
+        f64 getTailLengthSeconds() const override                  { return {}; }
+        b8 acceptsMidi() const override                             { return false; }
+        b8 producesMidi() const override                            { return false; }
+        AudioProcessorEditor* createEditor() override                 { return {}; }
+        b8 hasEditor() const override                               { return {}; }
+        i32 getNumPrograms() override                                 { return 1; }
+        i32 getCurrentProgram() override                              { return {}; }
+        z0 setCurrentProgram (i32) override                         {}
+        const Txt getProgramName (i32) override                    { return {}; }
+        z0 changeProgramName (i32, const Txt&) override          {}
+        z0 getStateInformation (drx::MemoryBlock&) override        {}
+        z0 setStateInformation (ukk, i32) override          {}
+        z0 prepareToPlay (f64, i32) override                     {}
+        z0 releaseResources() override                              {}
+
+        z0 processBlock (AudioBuffer<f32>& buffer, MidiBuffer&) override
+        {
+            if (rendezvous != nullptr)
+                rendezvous->arriveAndWait();
+
+            for (auto channel = 0; channel < buffer.getNumChannels(); ++channel)
+            {
+                auto* data = buffer.getWritePointer (channel);
+
+                for (auto i = 0; i < buffer.getNumSamples(); ++i)
+                {
+                    auto x = isSource ? random.nextFloat() * 2.0f - 1.0f : data[i];
+
+                    for (auto w = 0; w < workPerSample; ++w)
+                        x = std::tanh (x * 1.5f + 0.01f);
+
+                    data[i] = x;
+                }
+            }
+        }
+
+        using AudioProcessor::processBlock;
+
+    private:
+        const b8 isSource;
+        Random random;
+        i32k workPerSample;
+        Rendezvous* const rendezvous;
+    };
+
     class BasicProcessor final : public AudioProcessor
     {
     public:
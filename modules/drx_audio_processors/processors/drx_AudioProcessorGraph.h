@@ -332,6 +332,27 @@ public:
     */
     z0 rebuild();
 
+    //==============================================================================
+    /** Enables or disables multi-core rendering.
+
+        By default, the graph processes its nodes one after another on the thread that
+        calls processBlock(). Passing a number greater than zero here starts that many
+        realtime worker threads, and the graph will be rebuilt so that independent branches
+        can be processed concurrently. The thread calling processBlock() takes part in
+        rendering too, so one less than SystemStats::getNumCpus() is usually a good choice.
+
+        The output is bit-identical to the output of the serial renderer. Bear in mind that
+        in this mode nodes may be processed on threads other than the one that calls
+        processBlock(), and the graph's AudioPlayHead may be queried by several threads
+        at once.
+
+        Passing 0 stops the worker threads. Call this from the message thread only.
+    */
+    z0 setNumParallelRenderThreads (i32 numThreads);
+
+    /** Returns the number of worker threads set with setNumParallelRenderThreads(). */
+    i32 getNumParallelRenderThreads() const noexcept;
+
     //==============================================================================
     /** A special type of AudioProcessor that can live inside an AudioProcessorGraph
         in order to use the audio that comes into and out of the graph itself.
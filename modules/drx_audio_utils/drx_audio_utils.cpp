@@ -68,6 +68,7 @@
 #include "gui/drx_AudioDeviceSelectorComponent.cpp"
 #include "gui/drx_AudioThumbnail.cpp"
 #include "gui/drx_AudioThumbnailCache.cpp"
+#include "gui/drx_AudioThumbnailDiskCache.cpp"
 #include "gui/drx_AudioVisualiserComponent.cpp"
 #include "gui/drx_KeyboardComponentBase.cpp"
 #include "gui/drx_MidiKeyboardComponent.cpp"
@@ -88,6 +88,7 @@
 #include "gui/drx_AudioThumbnailBase.h"
 #include "gui/drx_AudioThumbnail.h"
 #include "gui/drx_AudioThumbnailCache.h"
+#include "gui/drx_AudioThumbnailDiskCache.h"
 #include "gui/drx_AudioVisualiserComponent.h"
 #include "gui/drx_KeyboardComponentBase.h"
 #include "gui/drx_MidiKeyboardComponent.h"
@@ -86,7 +86,6 @@ struct AudioThumbnail::MinMaxValue
     }
 
     inline z0 read (InputStream& input)      { input.read (values, 2); }
-    inline z0 write (OutputStream& output)   { output.write (values, 2); }
 
 private:
     i8 values[2];
@@ -267,11 +266,6 @@ public:
         return numSamplesFinished >= lengthInSamples;
     }
 
-    inline i32 sampleToThumbSample (const z64 originalSample) const noexcept
-    {
-        return (i32) (originalSample / owner.samplesPerThumbSample);
-    }
-
     z64 lengthInSamples = 0, numSamplesFinished = 0;
     f64 sampleRate = 0;
     u32 numChannels = 0;
@@ -281,6 +275,7 @@ private:
     AudioThumbnail& owner;
     std::unique_ptr<InputSource> source;
     std::unique_ptr<AudioFormatReader> reader;
+    AudioBuffer<f32> blockBuffer;
     CriticalSection readerLock;
     std::atomic<u32> lastReaderUseTime { 0 };
 
@@ -297,36 +292,29 @@ private:
 
         if (! isFullyLoaded())
         {
-            auto numToDo = (i32) jmin (256 * (z64) owner.samplesPerThumbSample, lengthInSamples - numSamplesFinished);
+            auto* pool = owner.cache.getThreadPool();
+            auto samplesPerBlock = 256 * (z64) owner.samplesPerThumbSample;
+
+            // Bigger blocks give readInParallel() enough to share out between the threads
+            if (pool != nullptr)
+                samplesPerBlock = jmax (samplesPerBlock, (z64) (pool->getNumThreads() + 1) * 65536);
+
+            auto numToDo = (i32) jmin (samplesPerBlock, lengthInSamples - numSamplesFinished);
 
             if (numToDo > 0)
             {
                 auto startSample = numSamplesFinished;
 
-                auto firstThumbIndex = sampleToThumbSample (startSample);
-                auto lastThumbIndex  = sampleToThumbSample (startSample + numToDo);
-                auto numThumbSamps = lastThumbIndex - firstThumbIndex;
-
-                HeapBlock<MinMaxValue> levelData ((u32) numThumbSamps * numChannels);
-                HeapBlock<MinMaxValue*> levels (numChannels);
-
-                for (i32 i = 0; i < (i32) numChannels; ++i)
-                    levels[i] = levelData + i * numThumbSamps;
-
-                HeapBlock<Range<f32>> levelsRead (numChannels);
+                blockBuffer.setSize ((i32) numChannels, numToDo, false, false, true);
 
-                for (i32 i = 0; i < numThumbSamps; ++i)
-                {
-                    reader->readMaxLevels ((firstThumbIndex + i) * owner.samplesPerThumbSample,
-                                           owner.samplesPerThumbSample, levelsRead, (i32) numChannels);
-
-                    for (i32 j = 0; j < (i32) numChannels; ++j)
-                        levels[j][i].setFloat (levelsRead[j]);
-                }
+                if (pool != nullptr)
+                    reader->readInParallel (blockBuffer, 0, numToDo, startSample, *pool);
+                else
+                    reader->read (&blockBuffer, 0, numToDo, startSample, true, true);
 
                 {
                     const ScopedUnlock su (readerLock);
-                    owner.setLevels (levels, firstThumbIndex, (i32) numChannels, numThumbSamps);
+                    owner.addBlock (startSample, blockBuffer, 0, numToDo);
                 }
 
                 numSamplesFinished += numToDo;
@@ -338,102 +326,6 @@ private:
     }
 };
 
-//==============================================================================
-class AudioThumbnail::ThumbData
-{
-public:
-    ThumbData (i32 numThumbSamples)
-    {
-        ensureSize (numThumbSamples);
-    }
-
-    inline MinMaxValue* getData (i32 thumbSampleIndex) noexcept
-    {
-        jassert (thumbSampleIndex < data.size());
-        return data.getRawDataPointer() + thumbSampleIndex;
-    }
-
-    i32 getSize() const noexcept
-    {
-        return data.size();
-    }
-
-    z0 getMinMax (i32 startSample, i32 endSample, MinMaxValue& result) const noexcept
-    {
-        if (startSample >= 0)
-        {
-            endSample = jmin (endSample, data.size() - 1);
-
-            i8 mx = -128;
-            i8 mn = 127;
-
-            while (startSample <= endSample)
-            {
-                auto& v = data.getReference (startSample);
-
-                if (v.getMinValue() < mn)  mn = v.getMinValue();
-                if (v.getMaxValue() > mx)  mx = v.getMaxValue();
-
-                ++startSample;
-            }
-
-            if (mn <= mx)
-            {
-                result.set (mn, mx);
-                return;
-            }
-        }
-
-        result.set (1, 0);
-    }
-
-    z0 write (const MinMaxValue* values, i32 startIndex, i32 numValues)
-    {
-        resetPeak();
-
-        if (startIndex + numValues > data.size())
-            ensureSize (startIndex + numValues);
-
-        auto* dest = getData (startIndex);
-
-        for (i32 i = 0; i < numValues; ++i)
-            dest[i] = values[i];
-    }
-
-    z0 resetPeak() noexcept
-    {
-        peakLevel = -1;
-    }
-
-    i32 getPeak() noexcept
-    {
-        if (peakLevel < 0)
-        {
-            for (auto& s : data)
-            {
-                auto peak = s.getPeak();
-
-                if (peak > peakLevel)
-                    peakLevel = peak;
-            }
-        }
-
-        return peakLevel;
-    }
-
-private:
-    Array<MinMaxValue> data;
-    i32 peakLevel = -1;
-
-    z0 ensureSize (i32 thumbSamples)
-    {
-        auto extraNeeded = thumbSamples - data.size();
-
-        if (extraNeeded > 0)
-            data.insertMultiple (-1, MinMaxValue(), extraNeeded);
-    }
-};
-
 //==============================================================================
 class AudioThumbnail::CachedWindow
 {
@@ -449,10 +341,10 @@ public:
                       const f64 startTime, const f64 endTime,
                       i32k channelNum, const f32 verticalZoomFactor,
                       const f64 rate, i32k numChans, i32k sampsPerThumbSample,
-                      LevelDataSource* levelData, const OwnedArray<ThumbData>& chans)
+                      LevelDataSource* levelData, const AudioLevelPyramid& levels)
     {
         if (refillCache (area.getWidth(), startTime, endTime, rate,
-                         numChans, sampsPerThumbSample, levelData, chans)
+                         numChans, sampsPerThumbSample, levelData, levels)
              && isPositiveAndBelow (channelNum, numChannelsCached))
         {
             auto clip = g.getClipBounds().getIntersection (area.withWidth (jmin (numSamplesCached, area.getWidth())));
@@ -492,13 +384,14 @@ public:
 
 private:
     Array<MinMaxValue> data;
+    std::vector<AudioLevelPyramid::Levels> pixelLevels;
     f64 cachedStart = 0, cachedTimePerPixel = 0;
     i32 numChannelsCached = 0, numSamplesCached = 0;
     b8 cacheNeedsRefilling = true;
 
     b8 refillCache (i32 numSamples, f64 startTime, f64 endTime,
                       f64 rate, i32 numChans, i32 sampsPerThumbSample,
-                      LevelDataSource* levelData, const OwnedArray<ThumbData>& chans)
+                      LevelDataSource* levelData, const AudioLevelPyramid& levels)
     {
         auto timePerPixel = (endTime - startTime) / numSamples;
 
@@ -561,27 +454,25 @@ private:
         }
         else
         {
-            jassert (chans.size() == numChannelsCached);
+            jassert (levels.getNumChannels() == numChannelsCached);
+
+            pixelLevels.resize ((size_t) numSamples);
 
             for (i32 channelNum = 0; channelNum < numChannelsCached; ++channelNum)
             {
-                ThumbData* channelData = chans.getUnchecked (channelNum);
-                MinMaxValue* cacheData = getData (channelNum, 0);
+                levels.getLevels (channelNum, cachedStart * rate, timePerPixel * rate,
+                                  pixelLevels.data(), numSamples);
 
-                auto timeToThumbSampleFactor = rate / (f64) sampsPerThumbSample;
-
-                startTime = cachedStart;
-                auto sample = roundToInt (startTime * timeToThumbSampleFactor);
+                MinMaxValue* cacheData = getData (channelNum, 0);
 
-                for (i32 i = numSamples; --i >= 0;)
+                for (auto& pixel : pixelLevels)
                 {
-                    auto nextSample = roundToInt ((startTime + timePerPixel) * timeToThumbSampleFactor);
-
-                    channelData->getMinMax (sample, nextSample, *cacheData);
+                    if (pixel.hasData)
+                        cacheData->setFloat ({ pixel.minimum, pixel.maximum });
+                    else
+                        *cacheData = MinMaxValue();
 
                     ++cacheData;
-                    startTime += timePerPixel;
-                    sample = nextSample;
                 }
             }
         }
@@ -613,6 +504,7 @@ AudioThumbnail::AudioThumbnail (i32k originalSamplesPerThumbnailSample,
     : formatManagerToUse (formatManager),
       cache (cacheToUse),
       window (new CachedWindow()),
+      levels (originalSamplesPerThumbnailSample),
       samplesPerThumbSample (originalSamplesPerThumbnailSample)
 {
 }
@@ -632,7 +524,7 @@ z0 AudioThumbnail::clear()
 z0 AudioThumbnail::clearChannelData()
 {
     window->invalidate();
-    channels.clear();
+    levels.reset (0, 0);
     totalSamples = numSamplesFinished = 0;
     numChannels = 0;
     sampleRate = 0;
@@ -649,13 +541,7 @@ z0 AudioThumbnail::reset (i32 newNumChannels, f64 newSampleRate, z64 totalSample
     sampleRate = newSampleRate;
     totalSamples = totalSamplesInSource;
 
-    createChannels (1 + (i32) (totalSamplesInSource / samplesPerThumbSample));
-}
-
-z0 AudioThumbnail::createChannels (i32k length)
-{
-    while (channels.size() < numChannels)
-        channels.add (new ThumbData (length));
+    levels.reset (numChannels, totalSamplesInSource);
 }
 
 //==============================================================================
@@ -663,9 +549,38 @@ b8 AudioThumbnail::loadFrom (InputStream& rawInput)
 {
     BufferedInputStream input (rawInput, 4096);
 
-    if (input.readByte() != 'j' || input.readByte() != 'a' || input.readByte() != 't' || input.readByte() != 'm')
+    char magic[4] = {};
+
+    if (input.read (magic, 4) != 4)
+        return false;
+
+    if (memcmp (magic, "jatm", 4) == 0)
+        return loadLegacyFormat (input);
+
+    if (memcmp (magic, "jatp", 4) != 0)
+        return false;
+
+    const ScopedLock sl (lock);
+    clearChannelData();
+
+    totalSamples = input.readInt64();             // Total number of source samples.
+    numSamplesFinished = input.readInt64();       // Number of valid source samples that have been read into the thumbnail.
+    sampleRate = input.readDouble();              // Source sample rate.
+
+    if (! levels.readFrom (input))
+    {
+        clearChannelData();
         return false;
+    }
+
+    samplesPerThumbSample = levels.getSamplesPerBucket();
+    numChannels = levels.getNumChannels();
+    return true;
+}
 
+b8 AudioThumbnail::loadLegacyFormat (InputStream& input)
+{
+    // The format used before the levels were kept in a pyramid, with 8-bit levels and no RMS
     const ScopedLock sl (lock);
     clearChannelData();
 
@@ -677,11 +592,35 @@ b8 AudioThumbnail::loadFrom (InputStream& rawInput)
     sampleRate = input.readInt();                 // Source sample rate.
     input.skipNextBytes (16);                     // (reserved)
 
-    createChannels (numThumbnailSamples);
+    if (samplesPerThumbSample <= 0 || numThumbnailSamples < 0 || ! isPositiveAndNotGreaterThan (numChannels, 1024))
+    {
+        clearChannelData();
+        return false;
+    }
+
+    levels = AudioLevelPyramid (samplesPerThumbSample);
+    levels.reset (numChannels, totalSamples);
+
+    std::vector<AudioLevelPyramid::Levels> values ((size_t) numThumbnailSamples * (size_t) numChannels);
 
     for (i32 i = 0; i < numThumbnailSamples; ++i)
+    {
         for (i32 chan = 0; chan < numChannels; ++chan)
-            channels.getUnchecked (chan)->getData (i)->read (input);
+        {
+            MinMaxValue value;
+            value.read (input);
+
+            auto& dest = values[(size_t) chan * (size_t) numThumbnailSamples + (size_t) i];
+            dest.minimum = value.getMinValue() / 127.0f;
+            dest.maximum = value.getMaxValue() / 127.0f;
+
+            // Everything up to numSamplesFinished was analysed, even where it was silent
+            dest.hasData = (z64) i * samplesPerThumbSample < numSamplesFinished || value.isNonZero();
+        }
+    }
+
+    for (i32 chan = 0; chan < numChannels; ++chan)
+        levels.setBucketLevels (chan, 0, values.data() + (size_t) chan * (size_t) numThumbnailSamples, numThumbnailSamples);
 
     return true;
 }
@@ -690,21 +629,11 @@ z0 AudioThumbnail::saveTo (OutputStream& output) const
 {
     const ScopedLock sl (lock);
 
-    i32k numThumbnailSamples = channels.size() == 0 ? 0 : channels.getUnchecked (0)->getSize();
-
-    output.write ("jatm", 4);
-    output.writeInt (samplesPerThumbSample);
+    output.write ("jatp", 4);
     output.writeInt64 (totalSamples);
     output.writeInt64 (numSamplesFinished);
-    output.writeInt (numThumbnailSamples);
-    output.writeInt (numChannels);
-    output.writeInt ((i32) sampleRate);
-    output.writeInt64 (0);
-    output.writeInt64 (0);
-
-    for (i32 i = 0; i < numThumbnailSamples; ++i)
-        for (i32 chan = 0; chan < numChannels; ++chan)
-            channels.getUnchecked (chan)->getData (i)->write (output);
+    output.writeDouble (sampleRate);
+    levels.writeTo (output);
 }
 
 //==============================================================================
@@ -736,7 +665,7 @@ b8 AudioThumbnail::setDataSource (LevelDataSource* newSource)
     sampleRate = source->sampleRate;
     numChannels = (i32) source->numChannels;
 
-    createChannels (1 + (i32) (totalSamples / samplesPerThumbSample));
+    levels.reset (numChannels, totalSamples);
 
     return wasSuccessful();
 }
@@ -778,45 +707,20 @@ z0 AudioThumbnail::addBlock (z64 startSample, const AudioBuffer<f32>& incoming,
               && startOffsetInBuffer >= 0
               && startOffsetInBuffer + numSamples <= incoming.getNumSamples());
 
-    auto firstThumbIndex = (i32) (startSample / samplesPerThumbSample);
-    auto lastThumbIndex  = (i32) ((startSample + numSamples + (samplesPerThumbSample - 1)) / samplesPerThumbSample);
-    auto numToDo = lastThumbIndex - firstThumbIndex;
-
-    if (numToDo > 0)
-    {
-        auto numChans = jmin (channels.size(), incoming.getNumChannels());
+    if (numSamples <= 0)
+        return;
 
-        const HeapBlock<MinMaxValue> thumbData (numToDo * numChans);
-        const HeapBlock<MinMaxValue*> thumbChannels (numChans);
+    // The block is measured before taking the lock, so that painting isn't held up by it
+    const auto blockLevels = AudioLevelPyramid::analyseBlock (samplesPerThumbSample, startSample, incoming,
+                                                              startOffsetInBuffer, numSamples);
 
-        for (i32 chan = 0; chan < numChans; ++chan)
-        {
-            auto* sourceData = incoming.getReadPointer (chan, startOffsetInBuffer);
-            auto* dest = thumbData + numToDo * chan;
-            thumbChannels [chan] = dest;
-
-            for (i32 i = 0; i < numToDo; ++i)
-            {
-                auto start = i * samplesPerThumbSample;
-                dest[i].setFloat (FloatVectorOperations::findMinAndMax (sourceData + start, jmin (samplesPerThumbSample, numSamples - start)));
-            }
-        }
-
-        setLevels (thumbChannels, firstThumbIndex, numChans, numToDo);
-    }
-}
-
-z0 AudioThumbnail::setLevels (const MinMaxValue* const* values, i32 thumbIndex, i32 numChans, i32 numValues)
-{
     const ScopedLock sl (lock);
 
-    for (i32 i = jmin (numChans, channels.size()); --i >= 0;)
-        channels.getUnchecked (i)->write (values[i], thumbIndex, numValues);
+    levels.addBlock (blockLevels);
 
-    auto start = thumbIndex * (z64) samplesPerThumbSample;
-    auto end   = (thumbIndex + numValues) * (z64) samplesPerThumbSample;
+    auto end = startSample + numSamples;
 
-    if (numSamplesFinished >= start && end > numSamplesFinished)
+    if (numSamplesFinished >= startSample && end > numSamplesFinished)
         numSamplesFinished = end;
 
     totalSamples = jmax (numSamplesFinished, totalSamples);
@@ -858,31 +762,30 @@ z64 AudioThumbnail::getNumSamplesFinished() const noexcept
 f32 AudioThumbnail::getApproximatePeak() const
 {
     const ScopedLock sl (lock);
-    i32 peak = 0;
+    f32 peak = 0;
+
+    for (i32 i = 0; i < levels.getNumChannels(); ++i)
+    {
+        auto channelLevels = levels.getLevels (i, 0, levels.getTotalSamples());
 
-    for (auto* c : channels)
-        peak = jmax (peak, c->getPeak());
+        if (channelLevels.hasData)
+            peak = jmax (peak, std::abs (channelLevels.minimum), std::abs (channelLevels.maximum));
+    }
 
-    return (f32) jlimit (0, 127, peak) / 127.0f;
+    return jlimit (0.0f, 1.0f, peak);
 }
 
 z0 AudioThumbnail::getApproximateMinMax (f64 startTime, f64 endTime, i32 channelIndex,
                                            f32& minValue, f32& maxValue) const noexcept
 {
     const ScopedLock sl (lock);
-    MinMaxValue result;
-    auto* data = channels [channelIndex];
+    AudioLevelPyramid::Levels result;
 
-    if (data != nullptr && sampleRate > 0)
-    {
-        auto firstThumbIndex = (i32) ((startTime * sampleRate) / samplesPerThumbSample);
-        auto lastThumbIndex  = (i32) (((endTime * sampleRate) + samplesPerThumbSample - 1) / samplesPerThumbSample);
-
-        data->getMinMax (jmax (0, firstThumbIndex), lastThumbIndex, result);
-    }
+    if (sampleRate > 0)
+        result = levels.getLevels (channelIndex, (z64) (startTime * sampleRate), (z64) std::ceil (endTime * sampleRate));
 
-    minValue = result.getMinValue() / 128.0f;
-    maxValue = result.getMaxValue() / 128.0f;
+    minValue = result.minimum;
+    maxValue = result.maximum;
 }
 
 z0 AudioThumbnail::drawChannel (Graphics& g, const Rectangle<i32>& area, f64 startTime,
@@ -891,7 +794,7 @@ z0 AudioThumbnail::drawChannel (Graphics& g, const Rectangle<i32>& area, f64 sta
     const ScopedLock sl (lock);
 
     window->drawChannel (g, area, startTime, endTime, channelNum, verticalZoomFactor,
-                         sampleRate, numChannels, samplesPerThumbSample, source.get(), channels);
+                         sampleRate, numChannels, samplesPerThumbSample, source.get(), levels);
 }
 
 z0 AudioThumbnail::drawChannels (Graphics& g, const Rectangle<i32>& area, f64 startTimeSeconds,
@@ -50,7 +50,9 @@ namespace drx
     listeners should repaint themselves.
 
     The thumbnail stores an internal low-res version of the wave data, and this can
-    be loaded and saved to avoid having to scan the file again.
+    be loaded and saved to avoid having to scan the file again. The low-res data is held
+    in an AudioLevelPyramid, so drawing takes the same time at any zoom level down to the
+    thumbnail's own resolution, below which the source is read directly.
 
     @see AudioThumbnailCache, AudioThumbnailBase
 
@@ -218,12 +220,11 @@ private:
 
     class LevelDataSource;
     struct MinMaxValue;
-    class ThumbData;
     class CachedWindow;
 
     std::unique_ptr<LevelDataSource> source;
     std::unique_ptr<CachedWindow> window;
-    OwnedArray<ThumbData> channels;
+    AudioLevelPyramid levels;
 
     i32 samplesPerThumbSample = 0;
     z64 totalSamples { 0 };
@@ -234,8 +235,7 @@ private:
 
     z0 clearChannelData();
     b8 setDataSource (LevelDataSource* newSource);
-    z0 setLevels (const MinMaxValue* const* values, i32 thumbIndex, i32 numChans, i32 numValues);
-    z0 createChannels (i32 length);
+    b8 loadLegacyFormat (InputStream&);
 
     DRX_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioThumbnail)
 };
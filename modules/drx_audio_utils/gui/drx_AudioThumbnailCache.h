@@ -98,6 +98,20 @@ public:
     /** Returns the thread that client thumbnails can use. */
     TimeSliceThread& getTimeSliceThread() noexcept      { return thread; }
 
+    /** Gives the thumbnails a thread pool to decode their sources with.
+
+        While a thumbnail is being generated, its reader will decode several parts of the
+        file at once on this pool, if its format supports that. The pool isn't owned by the
+        cache, and must outlive it. Pass nullptr to go back to decoding only on the cache's
+        own thread.
+
+        @see AudioFormatReader::readInParallel
+    */
+    z0 setThreadPool (ThreadPool* poolToUse) noexcept  { threadPool = poolToUse; }
+
+    /** Returns the pool set by setThreadPool(), or nullptr if there isn't one. */
+    ThreadPool* getThreadPool() const noexcept          { return threadPool; }
+
 protected:
     /** This can be overridden to provide a custom callback for saving thumbnails
         once they have finished being loaded.
@@ -112,6 +126,7 @@ protected:
 private:
     //==============================================================================
     TimeSliceThread thread;
+    std::atomic<ThreadPool*> threadPool { nullptr };
 
     class ThumbnailCacheEntry;
     OwnedArray<ThumbnailCacheEntry> thumbs;
@@ -0,0 +1,711 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace drx
+{
+
+// The index is a header followed by an open-addressed hash table of fixed-size slots, in the
+// machine's native byte order. A slot with a size of zero is empty.
+struct AudioThumbnailDiskCache::IndexHeader
+{
+    char magic[4];
+    u32 version;
+    u32 numSlots;
+    u32 numEntries;
+    z64 numBytes;
+    u64 useCounter;
+    u64 reserved[4];
+};
+
+struct AudioThumbnailDiskCache::IndexSlot
+{
+    z64 hashCode;
+    u64 lastUsed;
+    u64 checksum;
+    u32 size;
+    u32 reserved;
+};
+
+static constexpr u32 thumbnailIndexVersion = 1;
+
+// The lock for changing the index. The InterProcessLock keeps out other processes, but file
+// locks belong to a whole process, so caches in this process share a CriticalSection as well.
+class AudioThumbnailDiskCache::ScopedIndexLock
+{
+public:
+    explicit ScopedIndexLock (const AudioThumbnailDiskCache& c)
+        : cache (const_cast<AudioThumbnailDiskCache&> (c))
+    {
+        getLock().enter();
+        cache.interProcessLock.enter();
+    }
+
+    ~ScopedIndexLock()
+    {
+        cache.interProcessLock.exit();
+        getLock().exit();
+    }
+
+private:
+    static CriticalSection& getLock()
+    {
+        static CriticalSection lock;
+        return lock;
+    }
+
+    AudioThumbnailDiskCache& cache;
+
+    DRX_DECLARE_NON_COPYABLE (ScopedIndexLock)
+};
+
+//==============================================================================
+AudioThumbnailDiskCache::AudioThumbnailDiskCache (const File& cacheFolder, z64 maxBytesOnDisk,
+                                                  i32 maxNumThumbsInMemory, i32 maxNumEntries)
+    : AudioThumbnailCache (maxNumThumbsInMemory),
+      folder (cacheFolder),
+      maxBytes (maxBytesOnDisk),
+      interProcessLock ("DrxThumbnailCache_" + Txt::toHexString (cacheFolder.getFullPathName().hashCode64()))
+{
+    jassert (maxNumEntries > 0);
+
+    if (! openIndex (jmax (16, maxNumEntries)))
+        index.reset();
+}
+
+AudioThumbnailDiskCache::~AudioThumbnailDiskCache() = default;
+
+b8 AudioThumbnailDiskCache::openIndex (i32 maxNumEntries)
+{
+    static_assert (sizeof (IndexHeader) == 64 && sizeof (IndexSlot) == 32,
+                   "The index layout mustn't depend on the compiler");
+
+    if (! folder.createDirectory())
+        return false;
+
+    const auto indexFile = folder.getChildFile ("index.dat");
+
+    // Only three quarters of the slots are ever used, so that probes stay short
+    const auto numSlotsWanted = (u32) maxNumEntries + (u32) maxNumEntries / 3 + 1;
+
+    const ScopedIndexLock sl (*this);
+
+    const auto isValidIndex = [&]
+    {
+        FileInputStream in (indexFile);
+        IndexHeader header;
+
+        if (in.failedToOpen() || in.read (&header, sizeof (header)) != (i32) sizeof (header))
+            return false;
+
+        return memcmp (header.magic, "DTCI", 4) == 0
+            && header.version == thumbnailIndexVersion
+            && header.numSlots > 0
+            && indexFile.getSize() == (z64) (sizeof (IndexHeader) + header.numSlots * sizeof (IndexSlot));
+    };
+
+    if (! isValidIndex())
+    {
+        // Any thumbnail files left over can't be found any more
+        for (auto& f : folder.findChildFiles (File::findFiles, false, "*.thumb"))
+            f.deleteFile();
+
+        indexFile.deleteFile();
+
+        FileOutputStream out (indexFile);
+
+        if (out.failedToOpen())
+            return false;
+
+        IndexHeader header {};
+        memcpy (header.magic, "DTCI", 4);
+        header.version = thumbnailIndexVersion;
+        header.numSlots = numSlotsWanted;
+        out.write (&header, sizeof (header));
+        out.writeRepeatedByte (0, numSlotsWanted * sizeof (IndexSlot));
+        out.flush();
+
+        if (out.getStatus().failed())
+            return false;
+    }
+
+    index = std::make_unique<MemoryMappedFile> (indexFile, MemoryMappedFile::readWrite);
+    return index->getData() != nullptr && index->getSize() >= sizeof (IndexHeader);
+}
+
+AudioThumbnailDiskCache::IndexHeader& AudioThumbnailDiskCache::getHeader() const noexcept
+{
+    return *static_cast<IndexHeader*> (index->getData());
+}
+
+AudioThumbnailDiskCache::IndexSlot* AudioThumbnailDiskCache::getSlots() const noexcept
+{
+    return reinterpret_cast<IndexSlot*> (addBytesToPointer (index->getData(), sizeof (IndexHeader)));
+}
+
+static u32 getThumbnailIndexHomeSlot (z64 hashCode, u32 numSlots) noexcept
+{
+    // The hash codes may not be well distributed in their low bits, so mix them first
+    auto h = (u64) hashCode;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return (u32) (h % numSlots);
+}
+
+i32 AudioThumbnailDiskCache::findSlot (z64 hashCode) const noexcept
+{
+    const auto numSlots = getHeader().numSlots;
+    const auto* slots = getSlots();
+
+    for (auto i = getThumbnailIndexHomeSlot (hashCode, numSlots), n = 0u; n < numSlots; i = (i + 1) % numSlots, ++n)
+    {
+        if (slots[i].size == 0)
+            break;
+
+        if (slots[i].hashCode == hashCode)
+            return (i32) i;
+    }
+
+    return -1;
+}
+
+z0 AudioThumbnailDiskCache::removeSlot (i32 slotIndex)
+{
+    auto& header = getHeader();
+    auto* slots = getSlots();
+    const auto numSlots = header.numSlots;
+
+    getFileFor (slots[slotIndex].hashCode, slots[slotIndex].checksum).deleteFile();
+    header.numBytes -= slots[slotIndex].size;
+    --header.numEntries;
+
+    // Shifts back any later entries in the same run that would no longer be found, so
+    // that no tombstones are needed
+    auto gap = (u32) slotIndex;
+
+    for (auto i = (gap + 1) % numSlots; slots[i].size != 0; i = (i + 1) % numSlots)
+    {
+        const auto home = getThumbnailIndexHomeSlot (slots[i].hashCode, numSlots);
+        const auto distanceFromHome = (i + numSlots - home) % numSlots;
+        const auto distanceFromGap  = (i + numSlots - gap)  % numSlots;
+
+        if (distanceFromHome >= distanceFromGap)
+        {
+            slots[gap] = slots[i];
+            gap = i;
+        }
+    }
+
+    slots[gap] = {};
+}
+
+z0 AudioThumbnailDiskCache::evictUntilWithinLimits (z64 hashCodeToKeep)
+{
+    auto& header = getHeader();
+    auto* slots = getSlots();
+
+    while (header.numEntries > 0
+            && (header.numBytes > maxBytes.load() || header.numEntries > header.numSlots / 4 * 3))
+    {
+        i32 oldest = -1;
+
+        for (u32 i = 0; i < header.numSlots; ++i)
+            if (slots[i].size != 0 && slots[i].hashCode != hashCodeToKeep
+                 && (oldest < 0 || slots[i].lastUsed < slots[oldest].lastUsed))
+                oldest = (i32) i;
+
+        if (oldest < 0)
+            break;
+
+        removeSlot (oldest);
+    }
+}
+
+File AudioThumbnailDiskCache::getFileFor (z64 hashCode, u64 checksum) const
+{
+    // The checksum is part of the name, so a new version never overwrites a file that
+    // another thread or process may be reading
+    return folder.getChildFile (Txt::toHexString (hashCode).paddedLeft ('0', 16) + "_"
+                                  + Txt::toHexString ((z64) checksum).paddedLeft ('0', 16) + ".thumb");
+}
+
+u64 AudioThumbnailDiskCache::calculateChecksum (ukk data, size_t numBytes) noexcept
+{
+    // 64-bit FNV-1a
+    auto hash = (u64) 0xcbf29ce484222325ULL;
+
+    for (auto* p = static_cast<const u8*> (data), *end = p + numBytes; p != end; ++p)
+        hash = (hash ^ *p) * 0x100000001b3ULL;
+
+    return hash;
+}
+
+//==============================================================================
+b8 AudioThumbnailDiskCache::readFromDisk (z64 hashCode, MemoryBlock& destData)
+{
+    if (index == nullptr)
+        return false;
+
+    File file;
+    u64 checksum = 0;
+    u32 size = 0;
+
+    {
+        const ScopedIndexLock sl (*this);
+        const auto slotIndex = findSlot (hashCode);
+
+        if (slotIndex < 0)
+            return false;
+
+        auto& slot = getSlots()[slotIndex];
+        slot.lastUsed = ++getHeader().useCounter;
+        checksum = slot.checksum;
+        size = slot.size;
+        file = getFileFor (hashCode, checksum);
+    }
+
+    destData.reset();
+
+    if (file.loadFileAsData (destData)
+         && destData.getSize() == size
+         && calculateChecksum (destData.getData(), destData.getSize()) == checksum)
+        return true;
+
+    destData.reset();
+
+    // The file may just have been replaced or evicted by another thread or process, in which
+    // case the index will have changed and mustn't be touched
+    const ScopedIndexLock sl (*this);
+    const auto slotIndex = findSlot (hashCode);
+
+    if (slotIndex >= 0 && getSlots()[slotIndex].checksum == checksum)
+        removeSlot (slotIndex);
+
+    return false;
+}
+
+b8 AudioThumbnailDiskCache::writeToDisk (z64 hashCode, const MemoryBlock& data)
+{
+    if (index == nullptr || data.isEmpty() || (z64) data.getSize() > maxBytes.load())
+        return false;
+
+    const auto checksum = calculateChecksum (data.getData(), data.getSize());
+    const auto file = getFileFor (hashCode, checksum);
+
+    // The file is complete before the index refers to it, so readers never see a partial one
+    if (! file.replaceWithData (data.getData(), data.getSize()))
+        return false;
+
+    const ScopedIndexLock sl (*this);
+    auto& header = getHeader();
+    auto* slots = getSlots();
+
+    if (auto existing = findSlot (hashCode); existing >= 0)
+    {
+        if (slots[existing].checksum == checksum)
+        {
+            slots[existing].lastUsed = ++header.useCounter;
+            return true;
+        }
+
+        removeSlot (existing);
+    }
+
+    // There's always a free slot, because evictUntilWithinLimits() keeps a quarter of them empty
+    auto i = getThumbnailIndexHomeSlot (hashCode, header.numSlots);
+
+    while (slots[i].size != 0)
+        i = (i + 1) % header.numSlots;
+
+    slots[i].hashCode = hashCode;
+    slots[i].lastUsed = ++header.useCounter;
+    slots[i].checksum = checksum;
+    slots[i].size = (u32) data.getSize();
+    header.numBytes += (z64) data.getSize();
+    ++header.numEntries;
+
+    evictUntilWithinLimits (hashCode);
+    return true;
+}
+
+z0 AudioThumbnailDiskCache::setMaxBytesOnDisk (z64 newMaximum)
+{
+    maxBytes = newMaximum;
+
+    if (index != nullptr)
+    {
+        const ScopedIndexLock sl (*this);
+        evictUntilWithinLimits (0);
+    }
+}
+
+z64 AudioThumbnailDiskCache::getNumBytesOnDisk() const
+{
+    if (index == nullptr)
+        return 0;
+
+    const ScopedIndexLock sl (*this);
+    return getHeader().numBytes;
+}
+
+i32 AudioThumbnailDiskCache::getNumThumbsOnDisk() const
+{
+    if (index == nullptr)
+        return 0;
+
+    const ScopedIndexLock sl (*this);
+    return (i32) getHeader().numEntries;
+}
+
+b8 AudioThumbnailDiskCache::isOnDisk (z64 hashCode) const
+{
+    if (index == nullptr)
+        return false;
+
+    const ScopedIndexLock sl (*this);
+    return findSlot (hashCode) >= 0;
+}
+
+z0 AudioThumbnailDiskCache::removeFromDisk (z64 hashCode)
+{
+    if (index == nullptr)
+        return;
+
+    const ScopedIndexLock sl (*this);
+
+    if (auto slotIndex = findSlot (hashCode); slotIndex >= 0)
+        removeSlot (slotIndex);
+}
+
+z0 AudioThumbnailDiskCache::clearDisk()
+{
+    if (index == nullptr)
+        return;
+
+    const ScopedIndexLock sl (*this);
+    auto& header = getHeader();
+    auto* slots = getSlots();
+
+    for (u32 i = 0; i < header.numSlots; ++i)
+    {
+        if (slots[i].size != 0)
+            getFileFor (slots[i].hashCode, slots[i].checksum).deleteFile();
+
+        slots[i] = {};
+    }
+
+    header.numEntries = 0;
+    header.numBytes = 0;
+}
+
+//==============================================================================
+z0 AudioThumbnailDiskCache::saveNewlyFinishedThumbnail (const AudioThumbnailBase& thumb, z64 hashCode)
+{
+    MemoryOutputStream out;
+    thumb.saveTo (out);
+    writeToDisk (hashCode, out.getMemoryBlock());
+}
+
+b8 AudioThumbnailDiskCache::loadNewThumb (AudioThumbnailBase& thumb, z64 hashCode)
+{
+    MemoryBlock data;
+
+    if (! readFromDisk (hashCode, data))
+        return false;
+
+    MemoryInputStream in (data, false);
+
+    if (thumb.loadFrom (in))
+        return true;
+
+    removeFromDisk (hashCode);
+    return false;
+}
+
+//==============================================================================
+//==============================================================================
+#if DRX_UNIT_TESTS
+
+class AudioThumbnailDiskCacheTests final : public UnitTest
+{
+public:
+    AudioThumbnailDiskCacheTests()
+        : UnitTest ("AudioThumbnailDiskCache", UnitTestCategories::audio)
+    {}
+
+    z0 runTest() override
+    {
+        const TemporaryFile tempFolder;
+        const auto folder = tempFolder.getFile();
+
+        beginTest ("Data round-trips and persists");
+        {
+            {
+                AudioThumbnailDiskCache cache (folder, 1 << 20);
+                expect (cache.isUsingDisk());
+
+                for (z64 i = 1; i <= 20; ++i)
+                    expect (cache.writeToDisk (i * 12345, createData (i, 1000)));
+
+                expectEquals (cache.getNumThumbsOnDisk(), 20);
+                expectEquals (cache.getNumBytesOnDisk(), (z64) 20000);
+            }
+
+            AudioThumbnailDiskCache cache (folder, 1 << 20);
+            expectEquals (cache.getNumThumbsOnDisk(), 20);
+
+            for (z64 i = 1; i <= 20; ++i)
+            {
+                MemoryBlock data;
+                expect (cache.readFromDisk (i * 12345, data));
+                expect (data == createData (i, 1000));
+            }
+
+            MemoryBlock data;
+            expect (! cache.readFromDisk (999, data));
+
+            expect (cache.writeToDisk (12345, createData (99, 500)));
+            expect (cache.readFromDisk (12345, data));
+            expect (data == createData (99, 500));
+            expectEquals (cache.getNumBytesOnDisk(), (z64) 19500);
+            expectEquals (folder.getNumberOfChildFiles (File::findFiles, "*.thumb"), 20);
+
+            cache.removeFromDisk (12345);
+            expect (! cache.isOnDisk (12345));
+            expect (cache.isOnDisk (2 * 12345));
+
+            cache.clearDisk();
+            expectEquals (cache.getNumThumbsOnDisk(), 0);
+            expectEquals (folder.getNumberOfChildFiles (File::findFiles, "*.thumb"), 0);
+        }
+
+        beginTest ("Thumbnails are loaded from disk");
+        {
+            {
+                AudioThumbnailDiskCache cache (folder, 1 << 20);
+                TestThumbnail thumb;
+                thumb.data = createData (7, 300);
+                cache.storeThumb (thumb, 777);
+            }
+
+            AudioThumbnailDiskCache cache (folder, 1 << 20);
+            TestThumbnail thumb;
+            expect (cache.loadThumb (thumb, 777));
+            expect (thumb.data == createData (7, 300));
+            expect (! cache.loadThumb (thumb, 778));
+        }
+
+        beginTest ("The least recently used entries are evicted");
+        {
+            AudioThumbnailDiskCache cache (folder, 10000);
+            cache.clearDisk();
+
+            for (z64 i = 1; i <= 10; ++i)
+                cache.writeToDisk (i, createData (i, 1000));
+
+            MemoryBlock data;
+            expect (cache.readFromDisk (1, data));
+
+            cache.writeToDisk (11, createData (11, 1000));
+
+            expectEquals (cache.getNumThumbsOnDisk(), 10);
+            expect (cache.isOnDisk (1));
+            expect (! cache.isOnDisk (2));
+            expect (cache.isOnDisk (11));
+
+            cache.setMaxBytesOnDisk (5000);
+            expectEquals (cache.getNumBytesOnDisk(), (z64) 5000);
+            expect (cache.isOnDisk (1) && cache.isOnDisk (11));
+            expect (! cache.isOnDisk (6));
+            expectEquals (folder.getNumberOfChildFiles (File::findFiles, "*.thumb"), 5);
+        }
+
+        beginTest ("The number of entries is limited");
+        {
+            const TemporaryFile otherFolder;
+            AudioThumbnailDiskCache cache (otherFolder.getFile(), 1 << 20, 10, 32);
+
+            for (z64 i = 1; i <= 200; ++i)
+                expect (cache.writeToDisk (i * 7919, createData (i, 10)));
+
+            expect (cache.getNumThumbsOnDisk() <= 32);
+
+            for (z64 i = 190; i <= 200; ++i)
+                expect (cache.isOnDisk (i * 7919));
+        }
+
+        beginTest ("Damaged files are discarded");
+        {
+            AudioThumbnailDiskCache cache (folder, 1 << 20);
+            cache.clearDisk();
+            cache.writeToDisk (42, createData (42, 1000));
+
+            auto file = folder.findChildFiles (File::findFiles, false, "*.thumb").getFirst();
+            MemoryBlock data;
+            file.loadFileAsData (data);
+            static_cast<u8*> (data.getData())[500] ^= 1;
+            file.replaceWithData (data.getData(), data.getSize());
+
+            expect (! cache.readFromDisk (42, data));
+            expect (! cache.isOnDisk (42));
+            expect (! file.exists());
+
+            cache.writeToDisk (43, createData (43, 1000));
+            folder.findChildFiles (File::findFiles, false, "*.thumb").getFirst().deleteFile();
+            expect (! cache.readFromDisk (43, data));
+            expect (! cache.isOnDisk (43));
+        }
+
+        beginTest ("A damaged index is replaced");
+        {
+            {
+                AudioThumbnailDiskCache cache (folder, 1 << 20);
+                cache.writeToDisk (1, createData (1, 100));
+            }
+
+            folder.getChildFile ("index.dat").replaceWithText ("rubbish");
+
+            AudioThumbnailDiskCache cache (folder, 1 << 20);
+            expect (cache.isUsingDisk());
+            expectEquals (cache.getNumThumbsOnDisk(), 0);
+            expectEquals (folder.getNumberOfChildFiles (File::findFiles, "*.thumb"), 0);
+        }
+
+        beginTest ("Concurrent readers and writers");
+        {
+            AudioThumbnailDiskCache cache (folder, 1 << 20);
+            AudioThumbnailDiskCache otherCache (folder, 1 << 20);
+
+            for (z64 i = 1; i <= 16; ++i)
+                cache.writeToDisk (i, createData (i, 2000));
+
+            std::atomic<i32> numFailures { 0 };
+            ThreadPool pool (4);
+
+            for (i32 t = 0; t < 4; ++t)
+            {
+                pool.addJob ([&, t]
+                {
+                    auto& c = (t % 2) == 0 ? cache : otherCache;
+
+                    for (i32 n = 0; n < 200; ++n)
+                    {
+                        const auto i = (z64) ((n * 7 + t) % 16 + 1);
+
+                        if (t == 3 && n % 10 == 0)
+                        {
+                            c.writeToDisk (i, createData (i, 2000));
+                            continue;
+                        }
+
+                        MemoryBlock data;
+
+                        if (! c.readFromDisk (i, data) || data != createData (i, 2000))
+                            ++numFailures;
+                    }
+                });
+            }
+
+            while (pool.getNumJobs() > 0)
+                Thread::sleep (5);
+
+            expectEquals (numFailures.load(), 0);
+            expectEquals (cache.getNumThumbsOnDisk(), 16);
+        }
+
+        beginTest ("Performance");
+        {
+            AudioThumbnailDiskCache cache (folder, 64 << 20);
+            cache.clearDisk();
+
+            constexpr i32 numThumbs = 500;
+
+            for (z64 i = 0; i < numThumbs; ++i)
+                cache.writeToDisk (i + 1, createData (i, 8192));
+
+            const auto startTime = Time::getMillisecondCounterHiRes();
+            MemoryBlock data;
+
+            for (z64 i = 0; i < numThumbs; ++i)
+                expect (cache.readFromDisk (i + 1, data));
+
+            const auto elapsed = Time::getMillisecondCounterHiRes() - startTime;
+
+            logMessage ("Warm lookups of " + Txt (numThumbs) + " thumbnails: "
+                        + Txt (elapsed / numThumbs, 4) + " ms each");
+
+            cache.clearDisk();
+        }
+    }
+
+private:
+    struct TestThumbnail final : public AudioThumbnailBase
+    {
+        z0 clear() override                                           { data.reset(); }
+        b8 setSource (InputSource* s) override                        { delete s; return false; }
+        z0 setReader (AudioFormatReader* r, z64) override             { delete r; }
+        b8 loadFrom (InputStream& in) override                        { data.reset(); return in.readIntoMemoryBlock (data) > 0; }
+        z0 saveTo (OutputStream& out) const override                  { out.write (data.getData(), data.getSize()); }
+        i32 getNumChannels() const noexcept override                  { return 1; }
+        f64 getTotalLength() const noexcept override                  { return 0; }
+        z0 drawChannel (Graphics&, const Rectangle<i32>&, f64, f64, i32, f32) override {}
+        z0 drawChannels (Graphics&, const Rectangle<i32>&, f64, f64, f32) override {}
+        b8 isFullyLoaded() const noexcept override                    { return true; }
+        z64 getNumSamplesFinished() const noexcept override           { return 0; }
+        f32 getApproximatePeak() const override                       { return 0; }
+        z0 getApproximateMinMax (f64, f64, i32, f32& mn, f32& mx) const noexcept override { mn = mx = 0; }
+        z64 getHashCode() const override                              { return 0; }
+        z0 reset (i32, f64, z64) override                             {}
+        z0 addBlock (z64, const AudioBuffer<f32>&, i32, i32) override {}
+
+        MemoryBlock data;
+    };
+
+    static MemoryBlock createData (z64 seed, i32 numBytes)
+    {
+        MemoryBlock data ((size_t) numBytes);
+        Random r (seed);
+
+        for (i32 i = 0; i < numBytes; ++i)
+            data[i] = (t8) r.nextInt (256);
+
+        return data;
+    }
+};
+
+static AudioThumbnailDiskCacheTests audioThumbnailDiskCacheTests;
+
+#endif
+
+} // namespace drx
@@ -0,0 +1,156 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace drx
+{
+
+//==============================================================================
+/**
+    An AudioThumbnailCache that also keeps its thumbnails in a folder on disk.
+
+    Each finished thumbnail is written to its own file in the folder, and a single
+    memory-mapped index file maps the thumbnails' hash codes to their files. When a
+    thumbnail isn't in the in-memory cache, looking it up costs a probe of the index and
+    one file read, rather than a re-scan of the audio, so a library that has been opened
+    before is quick to display again.
+
+    The total size of the thumbnail files is kept under a budget. When a new thumbnail
+    takes it over, the ones that were used longest ago are deleted.
+
+    Each entry in the index records a checksum of its file, and any file that doesn't
+    match, e.g. because it was damaged or the app crashed while writing it, is discarded
+    and regenerated.
+
+    Several caches, in one process or in several, can share a folder. Changes to the index
+    are made under an InterProcessLock and only take a moment; the files are read and
+    checked outside the lock, so any number of readers can load thumbnails at once.
+
+    @see AudioThumbnailCache, AudioThumbnail
+
+    @tags{Audio}
+*/
+class DRX_API  AudioThumbnailDiskCache   : public AudioThumbnailCache
+{
+public:
+    //==============================================================================
+    /** Creates a cache that uses a folder on disk.
+
+        @param folder               where to keep the index and thumbnail files. It's created
+                                    if it doesn't exist
+        @param maxBytesOnDisk       the most space that the thumbnail files should take up
+        @param maxNumThumbsInMemory the number of thumbnails to keep in memory as well, as
+                                    for an AudioThumbnailCache
+        @param maxNumEntries        the number of thumbnails that the index can hold. This
+                                    only has an effect when the index is first created
+    */
+    AudioThumbnailDiskCache (const File& folder,
+                             z64 maxBytesOnDisk,
+                             i32 maxNumThumbsInMemory = 100,
+                             i32 maxNumEntries = 65536);
+
+    /** Destructor. */
+    ~AudioThumbnailDiskCache() override;
+
+    //==============================================================================
+    /** Возвращает true, если the index file was opened successfully. If it wasn't, the cache
+        just keeps thumbnails in memory.
+    */
+    b8 isUsingDisk() const noexcept                        { return index != nullptr; }
+
+    /** Returns the folder that the cache was created with. */
+    const File& getFolder() const noexcept                   { return folder; }
+
+    /** Sets the most space that the thumbnail files should take up. If they take up more
+        than this already, the least recently used ones are deleted.
+    */
+    z0 setMaxBytesOnDisk (z64 newMaximum);
+
+    /** Returns the total size of all the thumbnail files. */
+    z64 getNumBytesOnDisk() const;
+
+    /** Returns the number of thumbnails that are stored on disk. */
+    i32 getNumThumbsOnDisk() const;
+
+    /** Возвращает true, если there's a thumbnail on disk for the given hash code. */
+    b8 isOnDisk (z64 hashCode) const;
+
+    /** Deletes the thumbnail for the given hash code from the disk. */
+    z0 removeFromDisk (z64 hashCode);
+
+    /** Deletes all the thumbnails from the disk. */
+    z0 clearDisk();
+
+    //==============================================================================
+    /** Reads the data that was stored for a hash code, checking it against its checksum.
+
+        @returns false if there's no data for that hash code, or if the stored data was
+                 damaged, in which case it's deleted
+    */
+    b8 readFromDisk (z64 hashCode, MemoryBlock& destData);
+
+    /** Stores some data for a hash code, replacing anything already stored for it. */
+    b8 writeToDisk (z64 hashCode, const MemoryBlock& data);
+
+protected:
+    /** Writes newly finished thumbnails to the disk. */
+    z0 saveNewlyFinishedThumbnail (const AudioThumbnailBase&, z64 hashCode) override;
+
+    /** Loads thumbnails that aren't in memory from the disk. */
+    b8 loadNewThumb (AudioThumbnailBase&, z64 hashCode) override;
+
+private:
+    //==============================================================================
+    struct IndexHeader;
+    struct IndexSlot;
+    class ScopedIndexLock;
+
+    IndexHeader& getHeader() const noexcept;
+    IndexSlot* getSlots() const noexcept;
+    i32 findSlot (z64 hashCode) const noexcept;
+    z0 removeSlot (i32 slotIndex);
+    z0 evictUntilWithinLimits (z64 hashCodeToKeep);
+    File getFileFor (z64 hashCode, u64 checksum) const;
+    b8 openIndex (i32 maxNumEntries);
+
+    static u64 calculateChecksum (ukk data, size_t numBytes) noexcept;
+
+    const File folder;
+    std::atomic<z64> maxBytes;
+    std::unique_ptr<MemoryMappedFile> index;
+    InterProcessLock interProcessLock;
+
+    DRX_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AudioThumbnailDiskCache)
+};
+
+} // namespace drx
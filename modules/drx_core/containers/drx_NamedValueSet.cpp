@@ -70,32 +70,136 @@ b8 NamedValueSet::NamedValue::operator!= (const NamedValue& other) const noexcep
 NamedValueSet::NamedValueSet() noexcept {}
 NamedValueSet::~NamedValueSet() noexcept {}
 
-NamedValueSet::NamedValueSet (const NamedValueSet& other)  : values (other.values) {}
+NamedValueSet::NamedValueSet (const NamedValueSet& other)
+   : values (other.values), hashIndex (other.hashIndex) {}
 
 NamedValueSet::NamedValueSet (NamedValueSet&& other) noexcept
-   : values (std::move (other.values)) {}
+   : values (std::move (other.values)), hashIndex (std::move (other.hashIndex)) {}
 
 NamedValueSet::NamedValueSet (std::initializer_list<NamedValue> list)
    : values (std::move (list))
 {
+    updateHashIndex();
 }
 
 NamedValueSet& NamedValueSet::operator= (const NamedValueSet& other)
 {
     clear();
     values = other.values;
+    hashIndex = other.hashIndex;
     return *this;
 }
 
 NamedValueSet& NamedValueSet::operator= (NamedValueSet&& other) noexcept
 {
     other.values.swapWith (values);
+    other.hashIndex.swap (hashIndex);
     return *this;
 }
 
 z0 NamedValueSet::clear()
 {
     values.clear();
+    hashIndex.clear();
+}
+
+//==============================================================================
+/*  Below this many values, comparing each name's pointer in turn is quicker than hashing.
+    Above it, hashIndex is an open-addressed table of (index into values + 1), with 0 for
+    an empty slot, and is kept at no more than half full.
+*/
+static constexpr i32 minNumValuesForHashIndex = 16;
+
+i32 NamedValueSet::findIndex (const Identifier& name) const noexcept
+{
+    if (hashIndex.empty())
+    {
+        auto numValues = values.size();
+
+        for (i32 i = 0; i < numValues; ++i)
+            if (values.getReference (i).name == name)
+                return i;
+
+        return -1;
+    }
+
+    const auto mask = hashIndex.size() - 1;
+
+    for (auto slot = (size_t) name.getHash() & mask;; slot = (slot + 1) & mask)
+    {
+        const auto entry = hashIndex[slot];
+
+        if (entry == 0)
+            return -1;
+
+        if (values.getReference (entry - 1).name == name)
+            return entry - 1;
+    }
+}
+
+z0 NamedValueSet::addToHashIndex (i32 valueIndex) noexcept
+{
+    const auto mask = hashIndex.size() - 1;
+    auto slot = (size_t) values.getReference (valueIndex).name.getHash() & mask;
+
+    while (hashIndex[slot] != 0)
+        slot = (slot + 1) & mask;
+
+    hashIndex[slot] = valueIndex + 1;
+}
+
+z0 NamedValueSet::removeFromHashIndex (i32 valueIndex) noexcept
+{
+    const auto mask = hashIndex.size() - 1;
+    const auto homeSlot = [this, mask] (i32 entry) { return (size_t) values.getReference (entry - 1).name.getHash() & mask; };
+
+    auto hole = homeSlot (valueIndex + 1);
+
+    while (hashIndex[hole] != valueIndex + 1)
+        hole = (hole + 1) & mask;
+
+    // Backward-shift deletion: pull later entries of the probe run into the hole, unless
+    // their home slot lies cyclically between the hole and where they are now
+    for (auto slot = (hole + 1) & mask; hashIndex[slot] != 0; slot = (slot + 1) & mask)
+    {
+        const auto home = homeSlot (hashIndex[slot]);
+
+        if (((slot - home) & mask) >= ((slot - hole) & mask))
+        {
+            hashIndex[hole] = hashIndex[slot];
+            hole = slot;
+        }
+    }
+
+    hashIndex[hole] = 0;
+
+    // The values after the removed one are about to shift down by one
+    for (auto& entry : hashIndex)
+        if (entry > valueIndex + 1)
+            --entry;
+}
+
+z0 NamedValueSet::updateHashIndex()
+{
+    const auto numValues = values.size();
+
+    if (numValues < minNumValuesForHashIndex)
+    {
+        hashIndex.clear();
+        return;
+    }
+
+    if (! hashIndex.empty() && (size_t) numValues * 2 <= hashIndex.size())
+    {
+        // The new value is at the end, so there's no need to rebuild anything
+        addToHashIndex (numValues - 1);
+        return;
+    }
+
+    hashIndex.assign ((size_t) nextPowerOfTwo (numValues * 4), 0);
+
+    for (i32 i = 0; i < numValues; ++i)
+        addToHashIndex (i);
 }
 
 b8 NamedValueSet::operator== (const NamedValueSet& other) const noexcept
@@ -161,20 +265,12 @@ var NamedValueSet::getWithDefault (const Identifier& name, const var& defaultRet
 
 var* NamedValueSet::getVarPointer (const Identifier& name) noexcept
 {
-    for (auto& i : values)
-        if (i.name == name)
-            return &(i.value);
-
-    return {};
+    return getVarPointerAt (findIndex (name));
 }
 
 const var* NamedValueSet::getVarPointer (const Identifier& name) const noexcept
 {
-    for (auto& i : values)
-        if (i.name == name)
-            return &(i.value);
-
-    return {};
+    return getVarPointerAt (findIndex (name));
 }
 
 b8 NamedValueSet::set (const Identifier& name, var&& newValue)
@@ -189,6 +285,7 @@ b8 NamedValueSet::set (const Identifier& name, var&& newValue)
     }
 
     values.add ({ name, std::move (newValue) });
+    updateHashIndex();
     return true;
 }
 
@@ -204,6 +301,7 @@ b8 NamedValueSet::set (const Identifier& name, const var& newValue)
     }
 
     values.add ({ name, newValue });
+    updateHashIndex();
     return true;
 }
 
@@ -214,29 +312,23 @@ b8 NamedValueSet::contains (const Identifier& name) const noexcept
 
 i32 NamedValueSet::indexOf (const Identifier& name) const noexcept
 {
-    auto numValues = values.size();
-
-    for (i32 i = 0; i < numValues; ++i)
-        if (values.getReference (i).name == name)
-            return i;
-
-    return -1;
+    return findIndex (name);
 }
 
 b8 NamedValueSet::remove (const Identifier& name)
 {
-    auto numValues = values.size();
+    auto index = findIndex (name);
 
-    for (i32 i = 0; i < numValues; ++i)
-    {
-        if (values.getReference (i).name == name)
-        {
-            values.remove (i);
-            return true;
-        }
-    }
+    if (index < 0)
+        return false;
+
+    if (values.size() <= minNumValuesForHashIndex)
+        hashIndex.clear();
+    else if (! hashIndex.empty())
+        removeFromHashIndex (index);
 
-    return false;
+    values.remove (index);
+    return true;
 }
 
 Identifier NamedValueSet::getName (i32k index) const noexcept
@@ -276,6 +368,7 @@ const var* NamedValueSet::getVarPointerAt (i32 index) const noexcept
 z0 NamedValueSet::setFromXmlAttributes (const XmlElement& xml)
 {
     values.clearQuick();
+    hashIndex.clear();
 
     for (auto* att = xml.attributes.get(); att != nullptr; att = att->nextListItem)
     {
@@ -292,6 +385,8 @@ z0 NamedValueSet::setFromXmlAttributes (const XmlElement& xml)
 
         values.add ({ att->name, var (att->value) });
     }
+
+    updateHashIndex();
 }
 
 z0 NamedValueSet::copyToXmlAttributes (XmlElement& xml) const
@@ -315,4 +410,143 @@ z0 NamedValueSet::copyToXmlAttributes (XmlElement& xml) const
     }
 }
 
+//==============================================================================
+//==============================================================================
+#if DRX_UNIT_TESTS
+
+class NamedValueSetTests final : public UnitTest
+{
+public:
+    NamedValueSetTests()
+        : UnitTest ("NamedValueSet", UnitTestCategories::containers)
+    {}
+
+    static Identifier getName (i32 index)    { return Identifier ("property" + Txt (index)); }
+
+    z0 runTest() override
+    {
+        beginTest ("Lookups match a linear search");
+        {
+            auto r = getRandom();
+
+            for (auto maxSize : { 4, 20, 200 })
+            {
+                NamedValueSet set;
+                std::vector<std::pair<Identifier, i32>> reference;
+
+                for (i32 i = 0; i < 2000; ++i)
+                {
+                    const auto propertyName = getName (r.nextInt (maxSize));
+                    auto found = std::find_if (reference.begin(), reference.end(), [&] (auto& p) { return p.first == propertyName; });
+
+                    if (r.nextInt (4) == 0)
+                    {
+                        expect (set.remove (propertyName) == (found != reference.end()));
+
+                        if (found != reference.end())
+                            reference.erase (found);
+                    }
+                    else
+                    {
+                        const auto value = r.nextInt();
+                        set.set (propertyName, value);
+
+                        if (found != reference.end())
+                            found->second = value;
+                        else
+                            reference.emplace_back (propertyName, value);
+                    }
+
+                    if (! reference.empty())
+                    {
+                        const auto checkIndex = r.nextInt ((i32) reference.size());
+                        expectEquals (set.indexOf (reference[(size_t) checkIndex].first), checkIndex);
+                    }
+                }
+
+                expectEquals (set.size(), (i32) reference.size());
+
+                for (i32 i = 0; i < (i32) reference.size(); ++i)
+                {
+                    expect (set.getName (i) == reference[(size_t) i].first);
+                    expectEquals (set.indexOf (reference[(size_t) i].first), i);
+                    expect (set[reference[(size_t) i].first] == var (reference[(size_t) i].second));
+                }
+
+                for (i32 i = 0; i < maxSize; ++i)
+                {
+                    const auto propertyName = getName (i);
+                    const auto found = std::any_of (reference.begin(), reference.end(), [&] (auto& p) { return p.first == propertyName; });
+                    expect (set.contains (propertyName) == found);
+                }
+
+                NamedValueSet copy (set);
+                expect (copy == set);
+
+                NamedValueSet moved (std::move (copy));
+                expect (moved == set);
+
+                if (! reference.empty())
+                {
+                    moved.remove (reference.front().first);
+                    expect (moved != set);
+                    expect (! moved.contains (reference.front().first));
+                }
+            }
+        }
+
+        beginTest ("XML attributes");
+        {
+            XmlElement xml ("test");
+
+            for (i32 i = 0; i < 50; ++i)
+                xml.setAttribute (getName (i), i);
+
+            NamedValueSet set;
+            set.setFromXmlAttributes (xml);
+            expectEquals (set.size(), 50);
+
+            for (i32 i = 0; i < 50; ++i)
+            {
+                expectEquals (set.indexOf (getName (i)), i);
+                expect (set[getName (i)] == var (Txt (i)));
+            }
+        }
+
+        beginTest ("Performance");
+        {
+            auto r = getRandom();
+
+            for (auto numProperties : { 8, 50, 200 })
+            {
+                NamedValueSet set;
+                std::vector<Identifier> names;
+
+                for (i32 i = 0; i < numProperties; ++i)
+                {
+                    names.push_back (getName (i));
+                    set.set (names.back(), i);
+                }
+
+                constexpr i32 numLookups = 1000000;
+                i64 total = 0;
+                const auto start = Time::getMillisecondCounterHiRes();
+
+                for (i32 i = 0; i < numLookups; ++i)
+                    total += (i64) (i32) set[names[(size_t) r.nextInt (numProperties)]];
+
+                const auto elapsedMs = Time::getMillisecondCounterHiRes() - start;
+                expect (total > 0);
+
+                logMessage (Txt (numProperties) + " properties: "
+                             + Txt (elapsedMs * 1.0e6 / numLookups, 1) + " ns per lookup");
+            }
+        }
+    }
+};
+
+static NamedValueSetTests namedValueSetTests;
+
+#endif
+
 } // namespace drx
@@ -41,6 +41,11 @@ namespace drx
     This can be used as a basic structure to hold a set of var object, which can
     be retrieved by using their identifier.
 
+    Small sets are searched linearly. Once a set holds more than a few values, it also
+    keeps a hash index that uses the names' Identifier::getHash() values, so lookups stay
+    fast for objects with many properties. The values always stay in the order in which
+    they were added.
+
     @tags{Core}
 */
 class DRX_API  NamedValueSet
@@ -192,6 +197,12 @@ public:
 private:
     //==============================================================================
     Array<NamedValue> values;
+    std::vector<i32> hashIndex;
+
+    i32 findIndex (const Identifier&) const noexcept;
+    z0 addToHashIndex (i32 valueIndex) noexcept;
+    z0 removeFromHashIndex (i32 valueIndex) noexcept;
+    z0 updateHashIndex();
 };
 
 } // namespace drx
@@ -50,6 +50,7 @@
 
 #include <cctype>
 #include <cstdarg>
+#include <deque>
 #include <locale>
 #include <thread>
 
@@ -76,6 +77,7 @@
   #include <sys/errno.h>
   #include <unistd.h>
   #include <netinet/in.h>
+  #include <semaphore.h>
  #endif
 
  #if DRX_WASM
@@ -86,6 +88,7 @@
   #include <unistd.h>
   #include <netinet/in.h>
   #include <sys/stat.h>
+  #include <semaphore.h>
  #endif
 
  #if DRX_LINUX || DRX_BSD
@@ -185,6 +188,7 @@
 #include <drx_core/threads/drx_ReadWriteLock.cpp>
 #include <drx_core/threads/drx_Thread.cpp>
 #include <drx_core/threads/drx_ThreadPool.cpp>
+#include <drx_core/threads/drx_TaskGraph.cpp>
 #include <drx_core/threads/drx_TimeSliceThread.cpp>
 #include <drx_core/time/drx_PerformanceCounter.cpp>
 #include <drx_core/time/drx_RelativeTime.cpp>
@@ -192,10 +196,12 @@
 #include <drx_core/unit_tests/drx_UnitTest.cpp>
 #include <drx_core/containers/drx_Variant.cpp>
 #include <drx_core/json/drx_JSON.cpp>
+#include <drx_core/json/drx_JSONDocument.cpp>
 #include <drx_core/json/drx_JSONUtils.cpp>
 #include <drx_core/containers/drx_DynamicObject.cpp>
 #include <drx_core/xml/drx_XmlDocument.cpp>
 #include <drx_core/xml/drx_XmlElement.cpp>
+#include <drx_core/xml/drx_XmlPullParser.cpp>
 #include <drx_core/zip/drx_GZIPDecompressorInputStream.cpp>
 #include <drx_core/zip/drx_GZIPCompressorOutputStream.cpp>
 #include <drx_core/zip/drx_ZipFile.cpp>
@@ -277,6 +283,7 @@
 #include <drx_core/native/drx_AndroidDocument_android.cpp>
 #include <drx_core/threads/drx_HighResolutionTimer.cpp>
 #include <drx_core/threads/drx_WaitableEvent.cpp>
+#include <drx_core/threads/drx_Semaphore.cpp>
 #include <drx_core/network/drx_URL.cpp>
 
 #if ! DRX_WASM
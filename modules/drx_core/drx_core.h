@@ -304,6 +304,7 @@ DRX_END_IGNORE_WARNINGS_MSVC
 #include <drx_core/containers/drx_Variant.h>
 #include <drx_core/containers/drx_NamedValueSet.h>
 #include <drx_core/json/drx_JSON.h>
+#include <drx_core/json/drx_JSONDocument.h>
 #include <drx_core/containers/drx_DynamicObject.h>
 #include <drx_core/containers/drx_HashMap.h>
 #include <drx_core/containers/drx_FixedSizeFunction.h>
@@ -343,10 +344,12 @@ DRX_END_IGNORE_WARNINGS_MSVC
 #include <drx_core/threads/drx_Process.h>
 #include <drx_core/threads/drx_SpinLock.h>
 #include <drx_core/threads/drx_WaitableEvent.h>
+#include <drx_core/threads/drx_Semaphore.h>
 #include <drx_core/threads/drx_Thread.h>
 #include <drx_core/threads/drx_HighResolutionTimer.h>
 #include <drx_core/threads/drx_ThreadLocalValue.h>
 #include <drx_core/threads/drx_ThreadPool.h>
+#include <drx_core/threads/drx_TaskGraph.h>
 #include <drx_core/threads/drx_TimeSliceThread.h>
 #include <drx_core/threads/drx_ReadWriteLock.h>
 #include <drx_core/threads/drx_ScopedReadLock.h>
@@ -362,6 +365,7 @@ DRX_END_IGNORE_WARNINGS_MSVC
 #include <drx_core/unit_tests/drx_UnitTest.h>
 #include <drx_core/xml/drx_XmlDocument.h>
 #include <drx_core/xml/drx_XmlElement.h>
+#include <drx_core/xml/drx_XmlPullParser.h>
 #include <drx_core/zip/drx_GZIPCompressorOutputStream.h>
 #include <drx_core/zip/drx_GZIPDecompressorInputStream.h>
 #include <drx_core/zip/drx_ZipFile.h>
@@ -0,0 +1,1122 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+#if DRX_INTEL && (defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2))
+ #define DRX_JSON_USE_SSE2 1
+ #include <emmintrin.h>
+#else
+ #define DRX_JSON_USE_SSE2 0
+#endif
+
+namespace drx
+{
+
+struct JSONDocument::Node
+{
+    enum class Type : u8
+    {
+        null,
+        boolean,
+        int32,
+        int64,
+        number,
+        string,
+        array,
+        object
+    };
+
+    struct Member;
+    struct ObjectData;
+
+    Type type = Type::null;
+
+    // The length of a string in bytes, or the number of elements or properties
+    u32 size = 0;
+
+    union
+    {
+        i64 intValue = 0;
+        b8 boolValue;
+        f64 doubleValue;
+        const t8* stringValue;
+        const Node* elements;
+        const ObjectData* object;
+    };
+};
+
+struct JSONDocument::Node::Member
+{
+    const t8* name;
+    u32 nameLength;
+    u32 hash;
+    Node value;
+};
+
+struct JSONDocument::Node::ObjectData
+{
+    const Member* members;
+
+    // Only objects with enough properties to make it worthwhile get a hash table. Each
+    // slot holds a member index plus one, or zero if it's empty.
+    const u32* hashTable;
+    u32 hashMask;
+};
+
+//==============================================================================
+struct JSONDocument::Pimpl
+{
+    // Extra zeroed bytes after the text, so that the parser can always read a whole
+    // SIMD block at a time without checking for the end.
+    static constexpr size_t textPadding = 64;
+
+    Pimpl() = default;
+
+    Pimpl (MemoryBlock&& textToUse, size_t numBytes)
+        : text (std::move (textToUse)),
+          blockSize (jlimit ((size_t) 4096, (size_t) 1 << 20, numBytes))
+    {
+        text.ensureSize (numBytes + textPadding, false);
+        zeromem (static_cast<t8*> (text.getData()) + numBytes, text.getSize() - numBytes);
+    }
+
+    template <typename Type>
+    Type* allocate (size_t num)
+    {
+        static_assert (std::is_trivially_copyable_v<Type> && alignof (Type) <= 8);
+
+        const auto numBytes = (num * sizeof (Type) + 7) & ~(size_t) 7;
+
+        if (numBytes > spaceLeft)
+        {
+            const auto newBlockSize = jmax (blockSize, numBytes);
+            blocks.emplace_back (newBlockSize);
+            nextFree = blocks.back().get();
+            spaceLeft = newBlockSize;
+            totalBlockBytes += newBlockSize;
+        }
+
+        auto* result = reinterpret_cast<Type*> (nextFree);
+        nextFree += numBytes;
+        spaceLeft -= numBytes;
+        return result;
+    }
+
+    MemoryBlock text;
+    Node root;
+
+    std::vector<HeapBlock<t8>> blocks;
+    t8* nextFree = nullptr;
+    size_t spaceLeft = 0, blockSize = 4096, totalBlockBytes = 0;
+};
+
+//==============================================================================
+struct JSONDocument::Parser
+{
+    Parser (Pimpl& p)
+        : pimpl (p),
+          start (static_cast<t8*> (p.text.getData())),
+          pos (start)
+    {
+    }
+
+    struct ErrorException
+    {
+        Txt message;
+        i32 line = 1, column = 1;
+
+        Result getResult() const    { return Result::fail (Txt (line) + ":" + Txt (column) + ": error: " + message); }
+    };
+
+    [[noreturn]] z0 throwError (tukk message, const t8* location)
+    {
+        ErrorException e;
+        e.message = message;
+
+        // This can't stop at a null, as strings have been terminated in place
+        for (auto* p = start; p < location; ++p)
+        {
+            // Count characters rather than bytes, like JSON::parse() does
+            if ((*p & 0xc0) != 0x80)
+                ++e.column;
+
+            if (*p == '\n')  { e.column = 1; e.line++; }
+        }
+
+        throw e;
+    }
+
+    Node parseRoot()
+    {
+        // skip any UTF-8 byte order mark
+        if ((u8) pos[0] == 0xef && (u8) pos[1] == 0xbb && (u8) pos[2] == 0xbf)
+            pos += 3;
+
+        skipWhitespace();
+
+        Node result;
+
+        if (*pos == '{')       { ++pos; parseObject (result); }
+        else if (*pos == '[')  { ++pos; parseArray (result); }
+        else if (*pos != 0)    throwError ("Expected '{' or '['", pos);
+
+        return result;
+    }
+
+private:
+    Pimpl& pimpl;
+    t8* const start;
+    t8* pos;
+
+    std::vector<Node> elementStack;
+    std::vector<Node::Member> memberStack;
+
+    //==============================================================================
+    static b8 isWhitespace (t8 c) noexcept
+    {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\f' || c == '\v';
+    }
+
+    static b8 isDigit (t8 c) noexcept
+    {
+        return c >= '0' && c <= '9';
+    }
+
+   #if DRX_JSON_USE_SSE2
+    static u32 countTrailingZeros (u32 n) noexcept
+    {
+       #if DRX_MSVC
+        unsigned long index;
+        _BitScanForward (&index, n);
+        return (u32) index;
+       #else
+        return (u32) __builtin_ctz (n);
+       #endif
+    }
+   #endif
+
+    z0 skipWhitespace() noexcept
+    {
+        while (isWhitespace (*pos))
+        {
+            ++pos;
+
+           #if DRX_JSON_USE_SSE2
+            // Indented JSON has long runs of spaces, so skip them a block at a time
+            for (;;)
+            {
+                const auto block = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (pos));
+                const auto spaces = _mm_or_si128 (_mm_or_si128 (_mm_cmpeq_epi8 (block, _mm_set1_epi8 (' ')),
+                                                                _mm_cmpeq_epi8 (block, _mm_set1_epi8 ('\n'))),
+                                                  _mm_or_si128 (_mm_cmpeq_epi8 (block, _mm_set1_epi8 ('\r')),
+                                                                _mm_cmpeq_epi8 (block, _mm_set1_epi8 ('\t'))));
+                const auto mask = (u32) _mm_movemask_epi8 (spaces);
+
+                if (mask != 0xffff)
+                {
+                    pos += countTrailingZeros (~mask);
+                    break;
+                }
+
+                pos += 16;
+            }
+           #endif
+        }
+    }
+
+    // Returns the first quote, backslash or null character at or after the given position
+    static t8* findEndOfPlainText (t8* p, t8 quote) noexcept
+    {
+       #if DRX_JSON_USE_SSE2
+        const auto quotes = _mm_set1_epi8 (quote);
+        const auto backslashes = _mm_set1_epi8 ('\\');
+        const auto zeros = _mm_setzero_si128();
+
+        for (;; p += 16)
+        {
+            const auto block = _mm_loadu_si128 (reinterpret_cast<const __m128i*> (p));
+            const auto special = _mm_or_si128 (_mm_or_si128 (_mm_cmpeq_epi8 (block, quotes),
+                                                             _mm_cmpeq_epi8 (block, backslashes)),
+                                               _mm_cmpeq_epi8 (block, zeros));
+
+            if (const auto mask = (u32) _mm_movemask_epi8 (special))
+                return p + countTrailingZeros (mask);
+        }
+       #else
+        while (*p != quote && *p != '\\' && *p != 0)
+            ++p;
+
+        return p;
+       #endif
+    }
+
+    //==============================================================================
+    z0 parseValue (Node& result)
+    {
+        skipWhitespace();
+        auto* originalLocation = pos;
+
+        switch (*pos++)
+        {
+            case '{':   parseObject (result); return;
+            case '[':   parseArray (result); return;
+            case '"':   parseString ('"', result); return;
+            case '\'':  parseString ('\'', result); return;
+
+            case '-':
+                skipWhitespace();
+
+                if (isDigit (*pos))
+                {
+                    parseNumber (true, result);
+                    return;
+                }
+
+                break;
+
+            case '0': case '1': case '2': case '3': case '4':
+            case '5': case '6': case '7': case '8': case '9':
+                --pos;
+                parseNumber (false, result);
+                return;
+
+            case 't':
+                if (matchString ("rue"))
+                {
+                    result.type = Node::Type::boolean;
+                    result.boolValue = true;
+                    return;
+                }
+
+                break;
+
+            case 'f':
+                if (matchString ("alse"))
+                {
+                    result.type = Node::Type::boolean;
+                    result.boolValue = false;
+                    return;
+                }
+
+                break;
+
+            case 'n':
+                if (matchString ("ull"))
+                    return;
+
+                break;
+
+            default:
+                break;
+        }
+
+        throwError ("Syntax error", originalLocation);
+    }
+
+    b8 matchString (tukk t) noexcept
+    {
+        const auto length = strlen (t);
+
+        if (memcmp (pos, t, length) != 0)
+            return false;
+
+        pos += length;
+        return true;
+    }
+
+    z0 parseNumber (b8 isNegative, Node& result)
+    {
+        auto* numberStart = pos;
+        u64 value = 0;
+        i32 numDigits = 0;
+
+        while (isDigit (*pos))
+        {
+            value = value * 10 + (u64) (*pos++ - '0');
+            ++numDigits;
+        }
+
+        // Up to 19 digits always fit in a u64, so anything too big for an i64 is read as a f64
+        const auto tooBig = numDigits > 19 || value > (u64) std::numeric_limits<i64>::max() + (isNegative ? 1 : 0);
+
+        if (*pos == '.' || *pos == 'e' || *pos == 'E' || tooBig)
+        {
+            CharPointer_ASCII p (numberStart);
+            const auto asDouble = CharacterFunctions::readDoubleValue (p);
+            pos = p.getAddress();
+
+            result.type = Node::Type::number;
+            result.doubleValue = isNegative ? -asDouble : asDouble;
+        }
+        else
+        {
+            result.type = (value >> 31) != 0 ? Node::Type::int64 : Node::Type::int32;
+            result.intValue = isNegative ? (i64) (0 - value) : (i64) value;
+        }
+
+        if (! (isWhitespace (*pos) || *pos == ',' || *pos == '}' || *pos == ']' || *pos == 0))
+            throwError ("Syntax error in number", pos);
+    }
+
+    //==============================================================================
+    // Strings are unescaped in place, which is always possible because an escape
+    // sequence is never shorter than the UTF-8 that it turns into.
+    z0 parseString (t8 quote, Node& result)
+    {
+        auto* stringStart = pos;
+        pos = findEndOfPlainText (pos, quote);
+        auto* dest = pos;
+
+        for (;;)
+        {
+            auto c = *pos++;
+
+            if (c == quote)
+                break;
+
+            if (c == 0)
+                throwError ("Unexpected EOF in string constant", pos - 1);
+
+            if (c == '\\')
+            {
+                c = *pos++;
+
+                switch (c)
+                {
+                    case 'a': c = '\a'; break;
+                    case 'b': c = '\b'; break;
+                    case 'f': c = '\f'; break;
+                    case 'n': c = '\n'; break;
+                    case 'r': c = '\r'; break;
+                    case 't': c = '\t'; break;
+
+                    case 'u':
+                    {
+                        CharPointer_UTF8 d (dest);
+                        d.write (parseEscapeSequence());
+                        dest = d.getAddress();
+                        break;
+                    }
+
+                    case 0:
+                        throwError ("Unexpected EOF in string constant", pos - 1);
+
+                    default: break;
+                }
+
+                if (c != 'u')
+                    *dest++ = c;
+            }
+            else
+            {
+                *dest++ = c;
+            }
+
+            auto* next = findEndOfPlainText (pos, quote);
+            memmove (dest, pos, (size_t) (next - pos));
+            dest += next - pos;
+            pos = next;
+        }
+
+        *dest = 0;
+
+        result.type = Node::Type::string;
+        result.size = (u32) (dest - stringStart);
+        result.stringValue = stringStart;
+    }
+
+    i32 parseHexDigit()
+    {
+        const auto digitValue = CharacterFunctions::getHexDigitValue ((t32) (u8) *pos);
+
+        if (digitValue < 0)
+            throwError ("Invalid hex character", pos);
+
+        ++pos;
+        return digitValue;
+    }
+
+    u32 parseCodeUnit()
+    {
+        auto result = (u32) parseHexDigit() << 12;
+        result |= (u32) parseHexDigit() << 8;
+        result |= (u32) parseHexDigit() << 4;
+        return result | (u32) parseHexDigit();
+    }
+
+    t32 parseEscapeSequence()
+    {
+        const auto errorLocation = pos - 2;
+        const auto first = parseCodeUnit();
+
+        if (CharacterFunctions::isNonSurrogateCodePoint ((t32) first))
+            return (t32) first;
+
+        if (! CharacterFunctions::isHighSurrogate ((t32) first))
+            throwError ("Invalid UTF-16 escape sequence", errorLocation);
+
+        const auto lowSurrogateLocation = pos;
+
+        if (pos[0] != '\\' || pos[1] != 'u')
+            throwError ("Expected UTF-16 low surrogate", lowSurrogateLocation);
+
+        pos += 2;
+        const auto second = parseCodeUnit();
+
+        if (! CharacterFunctions::isLowSurrogate ((t32) second))
+            throwError ("Expected UTF-16 low surrogate", lowSurrogateLocation);
+
+        return (t32) (0x10000 + ((first - 0xd800) << 10) + (second - 0xdc00));
+    }
+
+    //==============================================================================
+    template <typename Type>
+    const Type* moveToArena (std::vector<Type>& stack, size_t stackStart)
+    {
+        const auto num = stack.size() - stackStart;
+        auto* result = pimpl.allocate<Type> (num);
+        std::copy (stack.begin() + (std::ptrdiff_t) stackStart, stack.end(), result);
+        stack.resize (stackStart);
+        return result;
+    }
+
+    z0 parseArray (Node& result)
+    {
+        const auto stackStart = elementStack.size();
+        auto* startOfArrayDecl = pos;
+
+        for (;;)
+        {
+            skipWhitespace();
+
+            if (*pos == ']')
+            {
+                ++pos;
+                break;
+            }
+
+            if (*pos == 0)
+                throwError ("Unexpected EOF in array declaration", startOfArrayDecl);
+
+            // Parsing the element can push more elements, so it can't be parsed in place
+            Node element;
+            parseValue (element);
+            elementStack.push_back (element);
+
+            skipWhitespace();
+
+            if (*pos == ',')  { ++pos; continue; }
+            if (*pos == ']')  { ++pos; break; }
+
+            throwError ("Expected ',' or ']'", pos);
+        }
+
+        result.type = Node::Type::array;
+        result.size = (u32) (elementStack.size() - stackStart);
+        result.elements = moveToArena (elementStack, stackStart);
+    }
+
+    z0 parseObject (Node& result)
+    {
+        const auto stackStart = memberStack.size();
+        auto* startOfObjectDecl = pos;
+
+        for (;;)
+        {
+            skipWhitespace();
+            auto* errorLocation = pos;
+            const auto c = *pos++;
+
+            if (c == '}')
+                break;
+
+            if (c == 0)
+                throwError ("Unexpected EOF in object declaration", startOfObjectDecl);
+
+            if (c != '"')
+                throwError ("Expected a property name in double-quotes", errorLocation);
+
+            Node name;
+            parseString ('"', name);
+
+            if (name.size == 0)
+                throwError ("Invalid property name", errorLocation + 1);
+
+            skipWhitespace();
+
+            if (*pos != ':')
+                throwError ("Expected ':'", pos);
+
+            ++pos;
+
+            Node::Member member;
+            member.name = name.stringValue;
+            member.nameLength = name.size;
+            member.hash = hashName (name.stringValue, name.size);
+            parseValue (member.value);
+            memberStack.push_back (member);
+
+            skipWhitespace();
+
+            if (*pos == ',')  { ++pos; continue; }
+            if (*pos == '}')  { ++pos; break; }
+
+            throwError ("Expected ',' or '}'", pos);
+        }
+
+        const auto numMembers = (u32) (memberStack.size() - stackStart);
+        auto* objectData = pimpl.allocate<Node::ObjectData> (1);
+        objectData->members = moveToArena (memberStack, stackStart);
+        objectData->hashTable = nullptr;
+        objectData->hashMask = 0;
+
+        if (numMembers >= minMembersForHashTable)
+            buildHashTable (*objectData, numMembers);
+
+        result.type = Node::Type::object;
+        result.size = numMembers;
+        result.object = objectData;
+    }
+
+    z0 buildHashTable (Node::ObjectData& objectData, u32 numMembers)
+    {
+        const auto tableSize = (u32) nextPowerOfTwo ((i32) numMembers * 2);
+        auto* table = pimpl.allocate<u32> (tableSize);
+        std::fill (table, table + tableSize, 0u);
+
+        const auto mask = tableSize - 1;
+
+        for (u32 i = 0; i < numMembers; ++i)
+        {
+            const auto& member = objectData.members[i];
+
+            for (auto slot = member.hash & mask;; slot = (slot + 1) & mask)
+            {
+                // If a name appears more than once, the last one wins, as it would with a var
+                if (table[slot] == 0 || namesMatch (objectData.members[table[slot] - 1], member.name, member.nameLength, member.hash))
+                {
+                    table[slot] = i + 1;
+                    break;
+                }
+            }
+        }
+
+        objectData.hashTable = table;
+        objectData.hashMask = mask;
+    }
+
+public:
+    static constexpr u32 minMembersForHashTable = 8;
+
+    static u32 hashName (const t8* name, size_t length) noexcept
+    {
+        // FNV-1a
+        u32 hash = 2166136261u;
+
+        for (size_t i = 0; i < length; ++i)
+            hash = (hash ^ (u8) name[i]) * 16777619u;
+
+        return hash;
+    }
+
+    static b8 namesMatch (const Node::Member& member, const t8* name, size_t length, u32 hash) noexcept
+    {
+        return member.hash == hash
+            && member.nameLength == length
+            && memcmp (member.name, name, length) == 0;
+    }
+
+    static const Node* findProperty (const Node& node, const t8* name, size_t length) noexcept
+    {
+        if (node.type != Node::Type::object)
+            return nullptr;
+
+        const auto& objectData = *node.object;
+        const auto hash = hashName (name, length);
+
+        if (objectData.hashTable != nullptr)
+        {
+            for (auto slot = hash & objectData.hashMask;; slot = (slot + 1) & objectData.hashMask)
+            {
+                const auto index = objectData.hashTable[slot];
+
+                if (index == 0)
+                    return nullptr;
+
+                if (namesMatch (objectData.members[index - 1], name, length, hash))
+                    return &objectData.members[index - 1].value;
+            }
+        }
+
+        // Search backwards, so that the last of any duplicate names wins
+        for (auto i = node.size; i > 0; --i)
+            if (namesMatch (objectData.members[i - 1], name, length, hash))
+                return &objectData.members[i - 1].value;
+
+        return nullptr;
+    }
+};
+
+//==============================================================================
+JSONDocument::JSONDocument()  : pimpl (std::make_unique<Pimpl>()) {}
+JSONDocument::~JSONDocument() = default;
+
+JSONDocument::JSONDocument (JSONDocument&&) noexcept = default;
+JSONDocument& JSONDocument::operator= (JSONDocument&&) noexcept = default;
+
+Result JSONDocument::parseText (MemoryBlock&& text, size_t numBytes, JSONDocument& result)
+{
+    auto newPimpl = std::make_unique<Pimpl> (std::move (text), numBytes);
+
+    try
+    {
+        newPimpl->root = Parser (*newPimpl).parseRoot();
+    }
+    catch (const Parser::ErrorException& error)
+    {
+        return error.getResult();
+    }
+
+    result.pimpl = std::move (newPimpl);
+    return Result::ok();
+}
+
+Result JSONDocument::parse (ukk utf8Data, size_t numBytes, JSONDocument& result)
+{
+    MemoryBlock text (numBytes + Pimpl::textPadding);
+    text.copyFrom (utf8Data, 0, numBytes);
+    return parseText (std::move (text), numBytes, result);
+}
+
+Result JSONDocument::parse (const Txt& text, JSONDocument& result)
+{
+    return parse (text.toRawUTF8(), text.getNumBytesAsUTF8(), result);
+}
+
+Result JSONDocument::parse (InputStream& input, JSONDocument& result)
+{
+    MemoryBlock text;
+    const auto numBytes = input.readIntoMemoryBlock (text);
+
+    if (numBytes >= 2)
+    {
+        const auto* bytes = static_cast<const u8*> (text.getData());
+
+        // UTF-16 needs converting first, which is what MemoryBlock::toString() does
+        if ((bytes[0] == 0xff && bytes[1] == 0xfe) || (bytes[0] == 0xfe && bytes[1] == 0xff))
+            return parse (text.toString(), result);
+    }
+
+    return parseText (std::move (text), numBytes, result);
+}
+
+Result JSONDocument::parse (const File& file, JSONDocument& result)
+{
+    FileInputStream in (file);
+
+    if (in.failedToOpen())
+        return Result::fail ("Couldn't open " + file.getFullPathName());
+
+    return parse (in, result);
+}
+
+JSONDocument::Value JSONDocument::getRoot() const noexcept
+{
+    return Value (pimpl != nullptr ? &pimpl->root : nullptr);
+}
+
+size_t JSONDocument::getMemoryUsage() const noexcept
+{
+    return pimpl != nullptr ? pimpl->text.getSize() + pimpl->totalBlockBytes : 0;
+}
+
+//==============================================================================
+b8 JSONDocument::Value::isVoid() const noexcept     { return node == nullptr || node->type == Node::Type::null; }
+b8 JSONDocument::Value::isBool() const noexcept     { return node != nullptr && node->type == Node::Type::boolean; }
+b8 JSONDocument::Value::isInt() const noexcept      { return node != nullptr && node->type == Node::Type::int32; }
+b8 JSONDocument::Value::isInt64() const noexcept    { return node != nullptr && node->type == Node::Type::int64; }
+b8 JSONDocument::Value::isDouble() const noexcept   { return node != nullptr && node->type == Node::Type::number; }
+b8 JSONDocument::Value::isString() const noexcept   { return node != nullptr && node->type == Node::Type::string; }
+b8 JSONDocument::Value::isArray() const noexcept    { return node != nullptr && node->type == Node::Type::array; }
+b8 JSONDocument::Value::isObject() const noexcept   { return node != nullptr && node->type == Node::Type::object; }
+
+b8 JSONDocument::Value::getBool() const noexcept
+{
+    return getDouble() != 0.0;
+}
+
+i32 JSONDocument::Value::getInt() const noexcept
+{
+    return (i32) getInt64();
+}
+
+i64 JSONDocument::Value::getInt64() const noexcept
+{
+    if (node != nullptr)
+    {
+        switch (node->type)
+        {
+            case Node::Type::boolean:   return node->boolValue ? 1 : 0;
+            case Node::Type::int32:
+            case Node::Type::int64:     return node->intValue;
+            case Node::Type::number:    return (i64) node->doubleValue;
+
+            case Node::Type::null:
+            case Node::Type::string:
+            case Node::Type::array:
+            case Node::Type::object:
+            default:                    break;
+        }
+    }
+
+    return 0;
+}
+
+f64 JSONDocument::Value::getDouble() const noexcept
+{
+    if (node != nullptr)
+    {
+        switch (node->type)
+        {
+            case Node::Type::boolean:   return node->boolValue ? 1.0 : 0.0;
+            case Node::Type::int32:
+            case Node::Type::int64:     return (f64) node->intValue;
+            case Node::Type::number:    return node->doubleValue;
+
+            case Node::Type::null:
+            case Node::Type::string:
+            case Node::Type::array:
+            case Node::Type::object:
+            default:                    break;
+        }
+    }
+
+    return 0.0;
+}
+
+std::string_view JSONDocument::Value::getString() const noexcept
+{
+    return isString() ? std::string_view (node->stringValue, node->size) : std::string_view();
+}
+
+Txt JSONDocument::Value::toString() const
+{
+    if (isString())
+        return Txt::fromUTF8 (node->stringValue, (i32) node->size);
+
+    if (isArray() || isObject())
+        return {};
+
+    return toVar().toString();
+}
+
+i32 JSONDocument::Value::size() const noexcept
+{
+    return isArray() || isObject() ? (i32) node->size : 0;
+}
+
+JSONDocument::Value JSONDocument::Value::operator[] (i32 arrayIndex) const noexcept
+{
+    if (isArray() && isPositiveAndBelow (arrayIndex, (i32) node->size))
+        return Value (node->elements + arrayIndex);
+
+    return {};
+}
+
+JSONDocument::Value JSONDocument::Value::operator[] (tukk propertyName) const noexcept
+{
+    return getProperty (propertyName);
+}
+
+JSONDocument::Value JSONDocument::Value::getProperty (StringRef propertyName) const noexcept
+{
+    if (node == nullptr)
+        return {};
+
+    const auto* name = propertyName.text.getAddress();
+    return Value (Parser::findProperty (*node, name, strlen (name)));
+}
+
+b8 JSONDocument::Value::hasProperty (StringRef propertyName) const noexcept
+{
+    if (node == nullptr)
+        return false;
+
+    // Unlike getProperty(), this counts a property that's explicitly null
+    const auto* name = propertyName.text.getAddress();
+    return Parser::findProperty (*node, name, strlen (name)) != nullptr;
+}
+
+std::string_view JSONDocument::Value::getPropertyName (i32 index) const noexcept
+{
+    if (isObject() && isPositiveAndBelow (index, (i32) node->size))
+        return { node->object->members[index].name, node->object->members[index].nameLength };
+
+    return {};
+}
+
+JSONDocument::Value JSONDocument::Value::getPropertyValue (i32 index) const noexcept
+{
+    if (isObject() && isPositiveAndBelow (index, (i32) node->size))
+        return Value (&node->object->members[index].value);
+
+    return {};
+}
+
+var JSONDocument::Value::toVar() const
+{
+    if (node == nullptr)
+        return {};
+
+    switch (node->type)
+    {
+        case Node::Type::boolean:   return var (node->boolValue);
+        case Node::Type::int32:     return var ((i32) node->intValue);
+        case Node::Type::int64:     return var ((z64) node->intValue);
+        case Node::Type::number:    return var (node->doubleValue);
+        case Node::Type::string:    return var (toString());
+
+        case Node::Type::array:
+        {
+            Array<var> elements;
+            elements.ensureStorageAllocated ((i32) node->size);
+
+            for (u32 i = 0; i < node->size; ++i)
+                elements.add (Value (node->elements + i).toVar());
+
+            return elements;
+        }
+
+        case Node::Type::object:
+        {
+            auto* object = new DynamicObject();
+            var result (object);
+            auto& properties = object->getProperties();
+
+            for (u32 i = 0; i < node->size; ++i)
+            {
+                const auto& member = node->object->members[i];
+                properties.set (Identifier (Txt::fromUTF8 (member.name, (i32) member.nameLength)),
+                                Value (&member.value).toVar());
+            }
+
+            return result;
+        }
+
+        case Node::Type::null:
+        default:
+            break;
+    }
+
+    return {};
+}
+
+
+//==============================================================================
+//==============================================================================
+#if DRX_UNIT_TESTS
+
+class JSONDocumentTests final : public UnitTest
+{
+public:
+    JSONDocumentTests()
+        : UnitTest ("JSONDocument", UnitTestCategories::json)
+    {}
+
+    z0 runTest() override
+    {
+        beginTest ("Values");
+        {
+            JSONDocument doc;
+            expect (JSONDocument::parse (R"({ "int": 1234, "neg": -5, "big": 12345678901234, "dbl": 1.5e3,
+                                               "t": true, "f": false, "n": null, "s": "text",
+                                               "arr": [ 1, "two", [ 3 ], { "four": 4 } ] })", doc).wasOk());
+
+            auto root = doc.getRoot();
+            expect (root.isObject());
+            expectEquals (root.size(), 9);
+
+            expect (root["int"].isInt());
+            expectEquals (root["int"].getInt(), 1234);
+            expectEquals (root["neg"].getInt(), -5);
+            expect (root["big"].isInt64());
+            expectEquals (root["big"].getInt64(), (i64) 12345678901234);
+            expect (root["dbl"].isDouble());
+            expectEquals (root["dbl"].getDouble(), 1500.0);
+            expect (root["t"].isBool() && root["t"].getBool());
+            expect (root["f"].isBool() && ! root["f"].getBool());
+            expect (root["n"].isVoid());
+            expect (root.hasProperty ("n"));
+            expect (! root.hasProperty ("missing"));
+            expect (root["missing"]["chained"][3].isVoid());
+            expectEquals (root["s"].toString(), Txt ("text"));
+            expect (root["s"].getString() == "text");
+
+            auto arr = root["arr"];
+            expectEquals (arr.size(), 4);
+            expectEquals (arr[1].toString(), Txt ("two"));
+            expectEquals (arr[2][0].getInt(), 3);
+            expectEquals (arr[3]["four"].getInt(), 4);
+            expect (arr[4].isVoid());
+            expect (arr[-1].isVoid());
+
+            expect (root.getPropertyName (0) == "int");
+            expectEquals (root.getPropertyValue (7).toString(), Txt ("text"));
+        }
+
+        beginTest ("Escapes");
+        {
+            JSONDocument doc;
+            expect (JSONDocument::parse (R"([ "a\"b\\c\/d\n\t", "\u00e9\u4e2d\ud83d\ude00", 'single "quoted"', "" ])", doc).wasOk());
+
+            auto root = doc.getRoot();
+            expectEquals (root[0].toString(), Txt ("a\"b\\c/d\n\t"));
+            expectEquals (root[1].toString(), Txt (CharPointer_UTF8 ("\xc3\xa9\xe4\xb8\xad\xf0\x9f\x98\x80")));
+            expectEquals (root[2].toString(), Txt ("single \"quoted\""));
+            expect (root[3].isString());
+            expectEquals (root[3].toString(), Txt());
+
+            expect (JSONDocument::parse (R"({ "a\u0000b": "c\u0000d" })", doc).wasOk());
+            expect (doc.getRoot()["a"].isVoid());
+            expect (doc.getRoot().getPropertyName (0) == std::string_view ("a\0b", 3));
+            expect (doc.getRoot().getPropertyValue (0).getString() == std::string_view ("c\0d", 3));
+        }
+
+        beginTest ("Errors");
+        {
+            JSONDocument doc;
+            expect (JSONDocument::parse (Txt(), doc).wasOk());
+            expect (doc.getRoot().isVoid());
+
+            expectEquals (JSONDocument::parse ("[ 1, 2", doc).getErrorMessage(), Txt ("1:7: error: Expected ',' or ']'"));
+            expectEquals (JSONDocument::parse ("{\n  \"a\" 1 }", doc).getErrorMessage(), Txt ("2:7: error: Expected ':'"));
+            expectEquals (JSONDocument::parse ("[ \"\\ud800\" ]", doc).getErrorMessage(), Txt ("1:10: error: Expected UTF-16 low surrogate"));
+            expectEquals (JSONDocument::parse ("[ 12a ]", doc).getErrorMessage(), Txt ("1:5: error: Syntax error in number"));
+            expect (JSONDocument::parse ("[ nope ]", doc).failed());
+            expect (JSONDocument::parse ("\"text\"", doc).failed());
+
+            // A failed parse leaves the document alone
+            expect (JSONDocument::parse ("[ 1 ]", doc).wasOk());
+            expect (JSONDocument::parse ("[ 1", doc).failed());
+            expectEquals (doc.getRoot()[0].getInt(), 1);
+        }
+
+        beginTest ("Property lookup");
+        {
+            for (auto numProperties : { 3, 8, 500 })
+            {
+                Txt text ("{");
+
+                for (i32 i = 0; i < numProperties; ++i)
+                    text << "\"prop" << i << "\": " << i << ",";
+
+                text << "\"prop1\": \"duplicate\" }";
+
+                JSONDocument doc;
+                expect (JSONDocument::parse (text, doc).wasOk());
+
+                auto root = doc.getRoot();
+
+                for (i32 i = 0; i < numProperties; ++i)
+                    if (i != 1)
+                        expectEquals (root.getProperty ("prop" + Txt (i)).getInt(), i);
+
+                expectEquals (root["prop1"].toString(), Txt ("duplicate"));
+                expectEquals (root.toVar()["prop1"].toString(), Txt ("duplicate"));
+                expect (! root.hasProperty ("prop" + Txt (numProperties)));
+            }
+        }
+
+        beginTest ("Matches JSON::parse");
+        {
+            auto r = getRandom();
+
+            for (i32 i = 100; --i >= 0;)
+            {
+                const auto text = JSON::toString (var (Array<var> { JSONTests::createRandomVar (r, 0) }), r.nextBool());
+
+                JSONDocument doc;
+                expect (JSONDocument::parse (text, doc).wasOk());
+                expectEquals (JSON::toString (doc.getRoot().toVar()), JSON::toString (JSON::parse (text)));
+            }
+        }
+
+        beginTest ("Benchmark");
+        {
+            const auto text = createBenchmarkDocument (getRandom(), 50000);
+
+            auto start = Time::getHighResolutionTicks();
+            const auto parsedVar = JSON::parse (text);
+            const auto varSeconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+
+            start = Time::getHighResolutionTicks();
+            JSONDocument doc;
+            expect (JSONDocument::parse (text, doc).wasOk());
+            const auto docSeconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+
+            expectEquals (doc.getRoot().size(), parsedVar.size());
+
+            const auto megabytes = (f64) text.getNumBytesAsUTF8() / (1024.0 * 1024.0);
+            logMessage ("Parsing " + Txt (megabytes, 1) + " MB: JSON::parse " + Txt (megabytes / varSeconds, 1)
+                          + " MB/s, JSONDocument " + Txt (megabytes / docSeconds, 1) + " MB/s");
+        }
+    }
+
+    static Txt createBenchmarkDocument (Random r, i32 numRecords)
+    {
+        MemoryOutputStream out;
+        out << "[\n";
+
+        for (i32 i = 0; i < numRecords; ++i)
+        {
+            out << "    {\n"
+                << "        \"id\": " << i << ",\n"
+                << "        \"timestamp\": " << (z64) 1700000000000 + i << ",\n"
+                << "        \"name\": \"event " << r.nextInt (1000) << "\",\n"
+                << "        \"level\": " << r.nextDouble() << ",\n"
+                << "        \"tags\": [ \"alpha\", \"beta\", \"gamma\" ],\n"
+                << "        \"enabled\": " << (r.nextBool() ? "true" : "false") << ",\n"
+                << "        \"position\": { \"x\": " << r.nextInt (100) << ", \"y\": " << r.nextInt (100) << " }\n"
+                << "    }" << (i < numRecords - 1 ? ",\n" : "\n");
+        }
+
+        out << "]\n";
+        return out.toString();
+    }
+};
+
+static JSONDocumentTests jsonDocumentTests;
+
+#endif
+
+} // namespace drx
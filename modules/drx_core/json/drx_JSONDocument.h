@@ -0,0 +1,200 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace drx
+{
+
+//==============================================================================
+/**
+    A read-only JSON document, for quickly parsing large amounts of JSON.
+
+    JSON::parse() builds a tree of var and DynamicObject, which means a separate
+    allocation for every object, array and string, and a trip through the global
+    StringPool for every property name. That's fine for small documents, but gets
+    slow when there's a lot of data.
+
+    A JSONDocument instead copies the text into a single block, and unescapes the
+    strings in place. The values are then stored in large blocks of memory that are
+    shared by the whole document. Property lookup uses a hash table, so finding a
+    property is O(1) however many properties an object has.
+
+    The values can't be modified, but any part of the document can be turned into a
+    var with Value::toVar() when it's needed.
+
+    @code
+    JSONDocument doc;
+
+    if (JSONDocument::parse (file, doc).wasOk())
+    {
+        auto events = doc.getRoot()["events"];
+
+        for (i32 i = 0; i < events.size(); ++i)
+            DBG (events[i]["name"].toString());
+    }
+    @endcode
+
+    @see JSON, var
+
+    @tags{Core}
+*/
+class DRX_API  JSONDocument
+{
+public:
+    //==============================================================================
+    /** Creates an empty document, whose root is a void value. */
+    JSONDocument();
+
+    /** Destructor. Any Value objects that refer to this document become invalid. */
+    ~JSONDocument();
+
+    JSONDocument (JSONDocument&&) noexcept;
+    JSONDocument& operator= (JSONDocument&&) noexcept;
+
+    //==============================================================================
+    /** Parses some UTF-8 encoded JSON, replacing this document's contents.
+
+        Like JSON::parse(), this only accepts an object or an array at the top level,
+        and will leave the document's root as a void value if the text is empty.
+
+        @returns    a Result that describes any parse error
+    */
+    static Result parse (ukk utf8Data, size_t numBytes, JSONDocument& result);
+
+    /** Parses a string of JSON, replacing this document's contents. */
+    static Result parse (const Txt& text, JSONDocument& result);
+
+    /** Parses the JSON in a stream, replacing this document's contents. */
+    static Result parse (InputStream& input, JSONDocument& result);
+
+    /** Parses the JSON in a file, replacing this document's contents. */
+    static Result parse (const File& file, JSONDocument& result);
+
+    //==============================================================================
+private:
+    struct Node;
+
+public:
+    /**
+        A lightweight reference to one of the values in a JSONDocument.
+
+        Values are cheap to copy, and only remain valid while the document that they came
+        from still exists. Looking up a property or index that doesn't exist returns a
+        void value, so lookups can be chained without checking each step.
+    */
+    class DRX_API  Value
+    {
+    public:
+        /** Creates a void value. */
+        Value() noexcept = default;
+
+        b8 isVoid() const noexcept;
+        b8 isBool() const noexcept;
+        b8 isInt() const noexcept;
+        b8 isInt64() const noexcept;
+        b8 isDouble() const noexcept;
+        b8 isString() const noexcept;
+        b8 isArray() const noexcept;
+        b8 isObject() const noexcept;
+
+        /** Returns the value as a b8. Numbers are true if they're non-zero. */
+        b8 getBool() const noexcept;
+
+        /** Returns the value as an i32, or 0 if it isn't a number or a b8. */
+        i32 getInt() const noexcept;
+
+        /** Returns the value as an i64, or 0 if it isn't a number or a b8. */
+        i64 getInt64() const noexcept;
+
+        /** Returns the value as an f64, or 0 if it isn't a number or a b8. */
+        f64 getDouble() const noexcept;
+
+        /** Returns the UTF-8 text of a string value, without copying it.
+            The view covers the whole decoded string, including any NULs that came from
+            \u0000 escapes. For any other type of value, this returns an empty view.
+        */
+        std::string_view getString() const noexcept;
+
+        /** Returns the value as a string, in the same way as var::toString(). */
+        Txt toString() const;
+
+        /** Returns the number of elements in an array, or properties in an object. */
+        i32 size() const noexcept;
+
+        /** Returns one of the elements of an array, or a void value if the index is out of range. */
+        Value operator[] (i32 arrayIndex) const noexcept;
+
+        /** Returns one of the properties of an object, or a void value if it doesn't have it. */
+        Value operator[] (tukk propertyName) const noexcept;
+
+        /** Returns one of the properties of an object, or a void value if it doesn't have it. */
+        Value getProperty (StringRef propertyName) const noexcept;
+
+        /** Возвращает true, если this is an object with the given property. */
+        b8 hasProperty (StringRef propertyName) const noexcept;
+
+        /** Returns the name of one of an object's properties, in the order they were declared. */
+        std::string_view getPropertyName (i32 index) const noexcept;
+
+        /** Returns the value of one of an object's properties, in the order they were declared. */
+        Value getPropertyValue (i32 index) const noexcept;
+
+        /** Creates a var containing a copy of this value and everything inside it. */
+        var toVar() const;
+
+    private:
+        friend class JSONDocument;
+        explicit Value (const Node* n) noexcept  : node (n) {}
+
+        const Node* node = nullptr;
+    };
+
+    //==============================================================================
+    /** Returns the document's top-level value. */
+    Value getRoot() const noexcept;
+
+    /** Returns the amount of memory used by the document, including the copy of the text. */
+    size_t getMemoryUsage() const noexcept;
+
+private:
+    //==============================================================================
+    struct Pimpl;
+    struct Parser;
+    std::unique_ptr<Pimpl> pimpl;
+
+    static Result parseText (MemoryBlock&& text, size_t numBytes, JSONDocument& result);
+
+    DRX_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JSONDocument)
+};
+
+} // namespace drx
@@ -38,41 +38,60 @@ namespace drx
 Identifier::Identifier() noexcept {}
 Identifier::~Identifier() noexcept {}
 
-Identifier::Identifier (const Identifier& other) noexcept  : name (other.name) {}
+Identifier::Identifier (const Identifier& other) noexcept  : name (other.name), hash (other.hash) {}
 
-Identifier::Identifier (Identifier&& other) noexcept : name (std::move (other.name)) {}
+Identifier::Identifier (Identifier&& other) noexcept : name (std::move (other.name)), hash (std::exchange (other.hash, 0u)) {}
 
 Identifier& Identifier::operator= (Identifier&& other) noexcept
 {
+    // Txt's move assignment swaps, so the hash is swapped too to keep the moved-from one consistent
     name = std::move (other.name);
+    std::swap (hash, other.hash);
     return *this;
 }
 
 Identifier& Identifier::operator= (const Identifier& other) noexcept
 {
     name = other.name;
+    hash = other.hash;
     return *this;
 }
 
 Identifier::Identifier (const Txt& nm)
-    : name (StringPool::getGlobalPool().getPooledString (nm))
 {
     // An Identifier cannot be created from an empty string!
     jassert (nm.isNotEmpty());
+
+    if (nm.isNotEmpty())
+    {
+        const auto numBytes = nm.getNumBytesAsUTF8();
+        hash = StringPool::getHash (nm);
+        name = StringPool::getGlobalPool().getPooledString (nm.toRawUTF8(), numBytes, hash, &nm);
+    }
 }
 
 Identifier::Identifier (tukk nm)
-    : name (StringPool::getGlobalPool().getPooledString (nm))
 {
     // An Identifier cannot be created from an empty string!
     jassert (nm != nullptr && nm[0] != 0);
+
+    if (nm != nullptr && nm[0] != 0)
+    {
+        hash = StringPool::getHash (StringRef (nm));
+        name = StringPool::getGlobalPool().getPooledString (nm, strlen (nm), hash, nullptr);
+    }
 }
 
 Identifier::Identifier (Txt::CharPointerType start, Txt::CharPointerType end)
-    : name (StringPool::getGlobalPool().getPooledString (start, end))
 {
     // An Identifier cannot be created from an empty string!
     jassert (start < end);
+
+    if (start < end && ! start.isEmpty())
+    {
+        hash = StringPool::getHash (start, end);
+        name = StringPool::getGlobalPool().getPooledString (start.getAddress(), (size_t) (end.getAddress() - start.getAddress()), hash, nullptr);
+    }
 }
 
 Identifier Identifier::null;
@@ -43,6 +43,10 @@ namespace drx
     them can be slower than just using a Txt directly, so the optimal way to use them
     is to keep some static Identifier objects for the things you use often.
 
+    Each Identifier also keeps the hash of its name that the StringPool calculated when
+    it was created, so hash-based containers can use getHash() without rescanning the
+    string.
+
     @see NamedValueSet, ValueTree
 
     @tags{Core}
@@ -128,6 +132,12 @@ public:
     /** Возвращает true, если this Identifier is null */
     b8 isNull() const noexcept                                        { return name.isEmpty(); }
 
+    /** Returns a hash of this identifier's name.
+        This is calculated once, when the name is added to the StringPool, so it's free to
+        call. It's the same value that StringPool::getHash() returns for the name's text.
+    */
+    u32 getHash() const noexcept                                      { return hash; }
+
     /** A null identifier. */
     static Identifier null;
 
@@ -139,6 +149,7 @@ public:
 
 private:
     Txt name;
+    u32 hash = 0;
 };
 
 } // namespace drx
@@ -37,76 +37,154 @@ namespace drx
 
 static i32k minNumberOfStringsForGarbageCollection = 300;
 static u32k garbageCollectionInterval = 30000;
+static constexpr u32 numShards = 32;
 
+//==============================================================================
+/*  Each shard is an open-addressed hash table, guarded by a spin-lock that's only held
+    for the time it takes to probe a few slots. The low bits of the hash pick the shard,
+    and the rest of it picks the slot, so the two don't interfere.
+*/
+struct StringPool::Shard
+{
+    struct Entry
+    {
+        Txt string;
+        u32 hash = 0, numBytes = 0;
+    };
 
-StringPool::StringPool() noexcept  : lastGarbageCollectionTime (0) {}
+    SpinLock lock;
+    std::vector<Entry> slots;
+    u32 numUsed = 0;
 
-struct StartEndString
-{
-    StartEndString (Txt::CharPointerType s, Txt::CharPointerType e) noexcept : start (s), end (e) {}
-    operator Txt() const   { return Txt (start, end); }
+    static size_t getSlotIndex (u32 hash, size_t mask) noexcept   { return (size_t) (hash / numShards) & mask; }
 
-    Txt::CharPointerType start, end;
-};
+    const Txt* find (const t8* utf8, size_t numBytes, u32 hash) const noexcept
+    {
+        if (slots.empty())
+            return nullptr;
 
-static i32 compareStrings (const Txt& s1, const Txt& s2) noexcept     { return s1.compare (s2); }
-static i32 compareStrings (CharPointer_UTF8 s1, const Txt& s2) noexcept  { return s1.compare (s2.getCharPointer()); }
+        const auto mask = slots.size() - 1;
 
-static i32 compareStrings (const StartEndString& string1, const Txt& string2) noexcept
-{
-    Txt::CharPointerType s1 (string1.start), s2 (string2.getCharPointer());
+        for (auto i = getSlotIndex (hash, mask);; i = (i + 1) & mask)
+        {
+            auto& e = slots[i];
+
+            if (e.string.isEmpty())
+                return nullptr;
+
+            if (e.hash == hash && e.numBytes == numBytes
+                 && memcmp (e.string.getCharPointer().getAddress(), utf8, numBytes) == 0)
+                return &e.string;
+        }
+    }
 
-    for (;;)
+    const Txt& insert (Txt&& string, size_t numBytes, u32 hash)
     {
-        i32k c1 = s1 < string1.end ? (i32) s1.getAndAdvance() : 0;
-        i32k c2 = (i32) s2.getAndAdvance();
-        i32k diff = c1 - c2;
+        if ((numUsed + 1) * 4 > slots.size() * 3)
+            rehash (jmax ((size_t) 16, slots.size() * 2));
 
-        if (diff != 0)  return diff < 0 ? -1 : 1;
-        if (c1 == 0)    break;
+        ++numUsed;
+        return insertWithoutGrowing ({ std::move (string), hash, (u32) numBytes });
     }
 
-    return 0;
-}
+    const Txt& insertWithoutGrowing (Entry&& entry) noexcept
+    {
+        const auto mask = slots.size() - 1;
+        auto i = getSlotIndex (entry.hash, mask);
 
-template <typename NewStringType>
-static Txt addPooledString (Array<Txt>& strings, const NewStringType& newString)
-{
-    i32 start = 0;
-    i32 end = strings.size();
+        while (slots[i].string.isNotEmpty())
+            i = (i + 1) & mask;
+
+        slots[i] = std::move (entry);
+        return slots[i].string;
+    }
 
-    while (start < end)
+    z0 rehash (size_t newSize)
     {
-        const Txt& startString = strings.getReference (start);
-        i32k startComp = compareStrings (newString, startString);
+        auto oldSlots = std::exchange (slots, std::vector<Entry> (newSize));
 
-        if (startComp == 0)
-            return startString;
+        for (auto& e : oldSlots)
+            if (e.string.isNotEmpty())
+                insertWithoutGrowing (std::move (e));
+    }
 
-        i32k halfway = (start + end) / 2;
+    // Rebuilds the table without any strings that only the pool is still holding on to
+    i32 removeUnreferencedStrings()
+    {
+        i32 numRemoved = 0;
 
-        if (halfway == start)
+        for (auto& e : slots)
         {
-            if (startComp > 0)
-                ++start;
+            if (e.string.isNotEmpty() && e.string.getReferenceCount() == 1)
+            {
+                e = {};
+                ++numRemoved;
+            }
+        }
 
-            break;
+        if (numRemoved > 0)
+        {
+            numUsed -= (u32) numRemoved;
+            rehash (slots.size());
         }
 
-        const Txt& halfwayString = strings.getReference (halfway);
-        i32k halfwayComp = compareStrings (newString, halfwayString);
+        return numRemoved;
+    }
+};
+
+//==============================================================================
+StringPool::StringPool()  : shards (new Shard[numShards]) {}
+StringPool::~StringPool() = default;
+
+static u32 hashUTF8 (const t8* utf8, size_t numBytes) noexcept
+{
+    // FNV-1a, with a final mix so that the low bits (used to pick a shard) depend on every byte
+    u32 hash = 2166136261u;
+
+    for (size_t i = 0; i < numBytes; ++i)
+        hash = (hash ^ (u8) utf8[i]) * 16777619u;
+
+    return hash ^ (hash >> 15);
+}
+
+u32 StringPool::getHash (Txt::CharPointerType start, Txt::CharPointerType end) noexcept
+{
+    return hashUTF8 (start.getAddress(), (size_t) (end.getAddress() - start.getAddress()));
+}
+
+u32 StringPool::getHash (StringRef text) noexcept
+{
+    return hashUTF8 (text.text.getAddress(), text.text.sizeInBytes() - 1);
+}
+
+Txt StringPool::getPooledString (const t8* utf8, size_t numBytes, u32 hash, const Txt* original)
+{
+    auto& shard = shards[hash % numShards];
+
+    {
+        const SpinLock::ScopedLockType sl (shard.lock);
+
+        if (auto* existing = shard.find (utf8, numBytes, hash))
+            return *existing;
+    }
+
+    // Allocating the new string is done outside the lock
+    auto newString = original != nullptr ? *original
+                                         : Txt (CharPointer_UTF8 (utf8), CharPointer_UTF8 (utf8 + numBytes));
+
+    {
+        const SpinLock::ScopedLockType sl (shard.lock);
 
-        if (halfwayComp == 0)
-            return halfwayString;
+        // Another thread might have added it in the meantime
+        if (auto* existing = shard.find (utf8, numBytes, hash))
+            return *existing;
 
-        if (halfwayComp > 0)
-            start = halfway;
-        else
-            end = halfway;
+        newString = shard.insert (std::move (newString), numBytes, hash);
     }
 
-    strings.insert (start, newString);
-    return strings.getReference (start);
+    ++numStrings;
+    garbageCollectIfNeeded();
+    return newString;
 }
 
 Txt StringPool::getPooledString (tukk const newString)
@@ -114,9 +192,8 @@ Txt StringPool::getPooledString (tukk const newString)
     if (newString == nullptr || *newString == 0)
         return {};
 
-    const ScopedLock sl (lock);
-    garbageCollectIfNeeded();
-    return addPooledString (strings, CharPointer_UTF8 (newString));
+    const auto numBytes = strlen (newString);
+    return getPooledString (newString, numBytes, hashUTF8 (newString, numBytes), nullptr);
 }
 
 Txt StringPool::getPooledString (Txt::CharPointerType start, Txt::CharPointerType end)
@@ -124,9 +201,8 @@ Txt StringPool::getPooledString (Txt::CharPointerType start, Txt::CharPointerTyp
     if (start.isEmpty() || start == end)
         return {};
 
-    const ScopedLock sl (lock);
-    garbageCollectIfNeeded();
-    return addPooledString (strings, StartEndString (start, end));
+    const auto numBytes = (size_t) (end.getAddress() - start.getAddress());
+    return getPooledString (start.getAddress(), numBytes, hashUTF8 (start.getAddress(), numBytes), nullptr);
 }
 
 Txt StringPool::getPooledString (StringRef newString)
@@ -134,9 +210,8 @@ Txt StringPool::getPooledString (StringRef newString)
     if (newString.isEmpty())
         return {};
 
-    const ScopedLock sl (lock);
-    garbageCollectIfNeeded();
-    return addPooledString (strings, newString.text);
+    const auto numBytes = newString.text.sizeInBytes() - 1;
+    return getPooledString (newString.text.getAddress(), numBytes, hashUTF8 (newString.text.getAddress(), numBytes), nullptr);
 }
 
 Txt StringPool::getPooledString (const Txt& newString)
@@ -144,25 +219,32 @@ Txt StringPool::getPooledString (const Txt& newString)
     if (newString.isEmpty())
         return {};
 
-    const ScopedLock sl (lock);
-    garbageCollectIfNeeded();
-    return addPooledString (strings, newString);
+    const auto numBytes = newString.getNumBytesAsUTF8();
+    return getPooledString (newString.toRawUTF8(), numBytes, hashUTF8 (newString.toRawUTF8(), numBytes), &newString);
 }
 
 z0 StringPool::garbageCollectIfNeeded()
 {
-    if (strings.size() > minNumberOfStringsForGarbageCollection
-         && Time::getApproximateMillisecondCounter() > lastGarbageCollectionTime + garbageCollectionInterval)
-        garbageCollect();
+    if (numStrings.load (std::memory_order_relaxed) > minNumberOfStringsForGarbageCollection)
+    {
+        auto lastTime = lastGarbageCollectionTime.load (std::memory_order_relaxed);
+        const auto now = Time::getApproximateMillisecondCounter();
+
+        // Only one of the threads that notice it's time for a collection gets to do it
+        if (now > lastTime + garbageCollectionInterval
+             && lastGarbageCollectionTime.compare_exchange_strong (lastTime, now))
+            garbageCollect();
+    }
 }
 
 z0 StringPool::garbageCollect()
 {
-    const ScopedLock sl (lock);
-
-    for (i32 i = strings.size(); --i >= 0;)
-        if (strings.getReference (i).getReferenceCount() == 1)
-            strings.remove (i);
+    for (u32 i = 0; i < numShards; ++i)
+    {
+        auto& shard = shards[i];
+        const SpinLock::ScopedLockType sl (shard.lock);
+        numStrings -= shard.removeUnreferencedStrings();
+    }
 
     lastGarbageCollectionTime = Time::getApproximateMillisecondCounter();
 }
@@ -173,4 +255,164 @@ StringPool& StringPool::getGlobalPool() noexcept
     return pool;
 }
 
+//==============================================================================
+//==============================================================================
+#if DRX_UNIT_TESTS
+
+class StringPoolTests final : public UnitTest
+{
+public:
+    StringPoolTests()
+        : UnitTest ("StringPool", UnitTestCategories::text)
+    {}
+
+    z0 runTest() override
+    {
+        beginTest ("Pooled strings are shared");
+        {
+            StringPool pool;
+            const Txt original ("hello");
+            const auto a = pool.getPooledString (original);
+            const auto b = pool.getPooledString ("hello");
+            const auto c = pool.getPooledString (StringRef ("hello"));
+
+            const Txt longer ("hello world");
+            const auto d = pool.getPooledString (longer.getCharPointer(), longer.getCharPointer() + 5);
+
+            expect (a.getCharPointer() == original.getCharPointer());
+            expect (b.getCharPointer() == a.getCharPointer());
+            expect (c.getCharPointer() == a.getCharPointer());
+            expect (d.getCharPointer() == a.getCharPointer());
+            expect (pool.getPooledString ("hellO").getCharPointer() != a.getCharPointer());
+            expect (pool.getPooledString ("").isEmpty());
+            expect (pool.getPooledString (nullptr).isEmpty());
+        }
+
+        beginTest ("Many strings");
+        {
+            StringPool pool;
+            Array<Txt> pooled;
+
+            for (i32 i = 0; i < 5000; ++i)
+                pooled.add (pool.getPooledString ("item" + Txt (i)));
+
+            for (i32 i = 0; i < 5000; ++i)
+                expect (pool.getPooledString (Txt ("item") + Txt (i)).getCharPointer() == pooled[i].getCharPointer());
+        }
+
+        beginTest ("Garbage collection");
+        {
+            StringPool pool;
+            const auto kept = pool.getPooledString ("kept");
+            const auto keptAddress = kept.getCharPointer().getAddress();
+            pool.getPooledString ("forgotten");
+
+            pool.garbageCollect();
+
+            expect (pool.getPooledString ("kept").getCharPointer().getAddress() == keptAddress);
+
+            // The original copy has gone, so the pool has to make a new one
+            const auto another = pool.getPooledString (Txt ("forgotten"));
+            expect (another == "forgotten");
+            expect (another.getReferenceCount() == 2);
+        }
+
+        beginTest ("Identifier hashes");
+        {
+            const Identifier a ("someName");
+            const Identifier b (Txt ("someName"));
+            const Txt text ("xsomeNamex");
+            const Identifier c (text.getCharPointer() + 1, text.getCharPointer() + 9);
+
+            expect (a == b && b == c);
+            expect (a.getHash() == b.getHash() && b.getHash() == c.getHash());
+            expect (a.getHash() == StringPool::getHash (StringRef ("someName")));
+            expect (a.getHash() != Identifier ("someOtherName").getHash());
+
+            auto moved = a;
+            const Identifier copied (std::move (moved));
+            expect (copied == a && copied.getHash() == a.getHash());
+        }
+
+        beginTest ("Concurrent interning");
+        {
+            StringPool pool;
+            constexpr i32 numThreads = 8, numNames = 2000;
+            std::vector<std::vector<Txt>> results (numThreads);
+            std::vector<std::thread> threads;
+
+            for (i32 t = 0; t < numThreads; ++t)
+            {
+                threads.emplace_back ([&pool, &results, t]
+                {
+                    // Each thread adds the names in a different order, to make them race
+                    for (i32 i = 0; i < numNames; ++i)
+                        results[(size_t) t].push_back (pool.getPooledString ("name" + Txt ((i * (t + 1) * 7919) % numNames)));
+                });
+            }
+
+            for (auto& thread : threads)
+                thread.join();
+
+            std::map<Txt, ukk> addresses;
+            b8 allShared = true;
+
+            for (auto& list : results)
+            {
+                for (auto& s : list)
+                {
+                    auto& address = addresses[s];
+
+                    if (address == nullptr)
+                        address = s.getCharPointer().getAddress();
+
+                    allShared = allShared && address == s.getCharPointer().getAddress();
+                }
+            }
+
+            expect (allShared);
+        }
+
+        beginTest ("Performance");
+        {
+            StringArray names;
+
+            for (i32 i = 0; i < 500; ++i)
+                names.add ("property_" + Txt (i));
+
+            for (auto numThreads : { 1, 4, 16 })
+            {
+                constexpr i32 lookupsPerThread = 200000;
+                std::vector<std::thread> threads;
+                const auto start = Time::getMillisecondCounterHiRes();
+
+                for (i32 t = 0; t < numThreads; ++t)
+                {
+                    threads.emplace_back ([&names, t]
+                    {
+                        for (i32 i = 0; i < lookupsPerThread; ++i)
+                        {
+                            const Identifier id (names[(i + t * 37) % names.size()]);
+                            ignoreUnused (id);
+                        }
+                    });
+                }
+
+                for (auto& thread : threads)
+                    thread.join();
+
+                const auto elapsedMs = Time::getMillisecondCounterHiRes() - start;
+
+                logMessage (Txt (numThreads) + " threads: "
+                             + Txt ((f64) numThreads * lookupsPerThread / jmax (0.001, elapsedMs) * 0.001, 2)
+                             + " million Identifiers/s");
+            }
+        }
+    }
+};
+
+static StringPoolTests stringPoolTests;
+
+#endif
+
 } // namespace drx
@@ -46,6 +46,9 @@ namespace drx
     compare two pooled strings for equality, as you can simply compare their pointers. It
     also cuts down on storage if you're using many copies of the same string.
 
+    The pool is split into shards by hash, each with its own small lock, so threads
+    that are interning different strings rarely have to wait for each other.
+
     @tags{Core}
 */
 class DRX_API  StringPool
@@ -53,7 +56,10 @@ class DRX_API  StringPool
 public:
     //==============================================================================
     /** Creates an empty pool. */
-    StringPool() noexcept;
+    StringPool();
+
+    /** Destructor. */
+    ~StringPool();
 
     //==============================================================================
     /** Returns a pointer to a shared copy of the string that is passed in.
@@ -86,11 +92,23 @@ public:
     /** Returns a shared global pool which is used for things like Identifiers, XML parsing. */
     static StringPool& getGlobalPool() noexcept;
 
+    /** Returns the hash that the pool uses for a string.
+        This is calculated from the string's UTF-8 bytes, and is the value that an Identifier
+        keeps alongside its pooled name.
+    */
+    static u32 getHash (Txt::CharPointerType start, Txt::CharPointerType end) noexcept;
+
+    /** Returns the hash that the pool uses for a string. */
+    static u32 getHash (StringRef text) noexcept;
+
 private:
-    Array<Txt> strings;
-    CriticalSection lock;
-    u32 lastGarbageCollectionTime;
+    struct Shard;
+    std::unique_ptr<Shard[]> shards;
+    std::atomic<i32> numStrings { 0 };
+    std::atomic<u32> lastGarbageCollectionTime { 0 };
 
+    friend class Identifier;
+    Txt getPooledString (const t8* utf8, size_t numBytes, u32 hash, const Txt* original);
     z0 garbageCollectIfNeeded();
 
     DRX_DECLARE_NON_COPYABLE (StringPool)
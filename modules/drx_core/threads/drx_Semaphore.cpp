@@ -0,0 +1,250 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace drx
+{
+
+#if DRX_WINDOWS
+class Semaphore::Pimpl
+{
+public:
+    explicit Pimpl (i32 initialCount)
+        : handle (CreateSemaphoreW (nullptr, (LONG) initialCount, std::numeric_limits<LONG>::max(), nullptr))
+    {
+        jassert (handle != nullptr);
+    }
+
+    ~Pimpl()
+    {
+        CloseHandle (handle);
+    }
+
+    b8 wait (i32 timeOutMilliseconds) noexcept
+    {
+        return WaitForSingleObject (handle, timeOutMilliseconds < 0 ? INFINITE : (DWORD) timeOutMilliseconds) == WAIT_OBJECT_0;
+    }
+
+    z0 signal (i32 count) noexcept
+    {
+        ReleaseSemaphore (handle, (LONG) count, nullptr);
+    }
+
+private:
+    HANDLE handle;
+};
+
+#elif DRX_MAC || DRX_IOS
+class Semaphore::Pimpl
+{
+public:
+    explicit Pimpl (i32 initialCount)
+    {
+        [[maybe_unused]] auto result = semaphore_create (mach_task_self(), &semaphore, SYNC_POLICY_FIFO, initialCount);
+        jassert (result == KERN_SUCCESS);
+    }
+
+    ~Pimpl()
+    {
+        semaphore_destroy (mach_task_self(), semaphore);
+    }
+
+    b8 wait (i32 timeOutMilliseconds) noexcept
+    {
+        if (timeOutMilliseconds < 0)
+        {
+            kern_return_t result;
+
+            do { result = semaphore_wait (semaphore); }
+            while (result == KERN_ABORTED);
+
+            return result == KERN_SUCCESS;
+        }
+
+        const mach_timespec_t timeout { (u32) (timeOutMilliseconds / 1000),
+                                        (clock_res_t) ((timeOutMilliseconds % 1000) * 1000000) };
+
+        return semaphore_timedwait (semaphore, timeout) == KERN_SUCCESS;
+    }
+
+    z0 signal (i32 count) noexcept
+    {
+        for (i32 i = 0; i < count; ++i)
+            semaphore_signal (semaphore);
+    }
+
+private:
+    semaphore_t semaphore;
+};
+
+#else
+class Semaphore::Pimpl
+{
+public:
+    explicit Pimpl (i32 initialCount)
+    {
+        [[maybe_unused]] auto result = sem_init (&semaphore, 0, (u32) initialCount);
+        jassert (result == 0);
+    }
+
+    ~Pimpl()
+    {
+        sem_destroy (&semaphore);
+    }
+
+    b8 wait (i32 timeOutMilliseconds) noexcept
+    {
+        if (timeOutMilliseconds < 0)
+        {
+            while (sem_wait (&semaphore) != 0)
+                if (errno != EINTR)
+                    return false;
+
+            return true;
+        }
+
+        timespec deadline;
+        clock_gettime (CLOCK_REALTIME, &deadline);
+        deadline.tv_sec  += timeOutMilliseconds / 1000;
+        deadline.tv_nsec += (timeOutMilliseconds % 1000) * 1000000;
+
+        if (deadline.tv_nsec >= 1000000000)
+        {
+            ++deadline.tv_sec;
+            deadline.tv_nsec -= 1000000000;
+        }
+
+        while (sem_timedwait (&semaphore, &deadline) != 0)
+            if (errno != EINTR)
+                return false;
+
+        return true;
+    }
+
+    z0 signal (i32 count) noexcept
+    {
+        for (i32 i = 0; i < count; ++i)
+            sem_post (&semaphore);
+    }
+
+private:
+    sem_t semaphore;
+};
+#endif
+
+//==============================================================================
+Semaphore::Semaphore (i32 initialCount)
+    : pimpl (std::make_unique<Pimpl> (initialCount))
+{
+    jassert (initialCount >= 0);
+}
+
+Semaphore::~Semaphore() = default;
+
+b8 Semaphore::wait (i32 timeOutMilliseconds) noexcept
+{
+    return pimpl->wait (timeOutMilliseconds);
+}
+
+z0 Semaphore::signal (i32 count) noexcept
+{
+    jassert (count >= 0);
+    pimpl->signal (count);
+}
+
+//==============================================================================
+#if DRX_UNIT_TESTS
+
+class SemaphoreTests final : public UnitTest
+{
+public:
+    SemaphoreTests()
+        : UnitTest ("Semaphore", UnitTestCategories::threads) {}
+
+    z0 runTest() override
+    {
+        beginTest ("The initial count can be consumed without blocking");
+        {
+            Semaphore semaphore (2);
+            expect (semaphore.wait (0));
+            expect (semaphore.wait (0));
+            expect (! semaphore.wait (0));
+        }
+
+        beginTest ("A timed wait expires when nothing signals");
+        {
+            Semaphore semaphore;
+            const auto start = Time::getMillisecondCounter();
+            expect (! semaphore.wait (20));
+            expectGreaterOrEqual ((i32) (Time::getMillisecondCounter() - start), 15);
+        }
+
+        beginTest ("Each signal releases exactly one wait");
+        {
+            Semaphore semaphore;
+            semaphore.signal (3);
+
+            for (i32 i = 0; i < 3; ++i)
+                expect (semaphore.wait (0));
+
+            expect (! semaphore.wait (0));
+        }
+
+        beginTest ("Waiting threads are woken by another thread");
+        {
+            Semaphore semaphore;
+            std::atomic<i32> numWoken { 0 };
+            std::vector<std::thread> threads;
+
+            for (i32 i = 0; i < 4; ++i)
+                threads.emplace_back ([&]
+                {
+                    if (semaphore.wait (10000))
+                        ++numWoken;
+                });
+
+            semaphore.signal (4);
+
+            for (auto& thread : threads)
+                thread.join();
+
+            expectEquals (numWoken.load(), 4);
+        }
+    }
+};
+
+static SemaphoreTests semaphoreTests;
+
+#endif
+
+} // namespace drx
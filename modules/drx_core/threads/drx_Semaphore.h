@@ -0,0 +1,82 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace drx
+{
+
+//==============================================================================
+/**
+    A counting semaphore backed by the operating system's native primitive.
+
+    Unlike WaitableEvent, calling signal() never takes a lock in user space, so it's
+    safe to use for waking worker threads from a realtime thread such as the audio
+    callback.
+
+    @see WaitableEvent
+
+    @tags{Core}
+*/
+class DRX_API  Semaphore
+{
+public:
+    //==============================================================================
+    /** Creates a semaphore with the given initial count. */
+    explicit Semaphore (i32 initialCount = 0);
+
+    /** Destructor.
+        No threads should be waiting on the semaphore when it is deleted.
+    */
+    ~Semaphore();
+
+    //==============================================================================
+    /** Decrements the count, suspending the calling thread until it is non-zero.
+
+        @param timeOutMilliseconds  the maximum time to wait, in milliseconds. A negative
+                                    value will cause it to wait forever.
+        @returns    true if the count was decremented, false if the timeout expired first.
+    */
+    b8 wait (i32 timeOutMilliseconds = -1) noexcept;
+
+    /** Increments the count, waking up to the given number of waiting threads. */
+    z0 signal (i32 count = 1) noexcept;
+
+private:
+    //==============================================================================
+    class Pimpl;
+    std::unique_ptr<Pimpl> pimpl;
+
+    DRX_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Semaphore)
+};
+
+} // namespace drx
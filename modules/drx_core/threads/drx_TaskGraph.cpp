@@ -0,0 +1,353 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace drx
+{
+
+z0 TaskHandle::State::whenFinished (std::function<z0()> callback)
+{
+    {
+        const ScopedLock sl (lock);
+
+        if (! finished)
+        {
+            continuations.push_back (std::move (callback));
+            return;
+        }
+    }
+
+    callback();
+}
+
+z0 TaskHandle::State::markFinished()
+{
+    std::vector<std::function<z0()>> toCall;
+
+    {
+        const ScopedLock sl (lock);
+        finished = true;
+        toCall.swap (continuations);
+    }
+
+    finishedEvent.signal();
+
+    for (auto& callback : toCall)
+        callback();
+}
+
+b8 TaskHandle::isFinished() const noexcept
+{
+    return state == nullptr || state->finished.load();
+}
+
+b8 TaskHandle::wait (i32 timeOutMilliseconds) const
+{
+    if (state == nullptr)
+        return true;
+
+    auto* s = state.get();
+    return s->pool.waitWhileRunningJobs (s->group, [s] { return s->finished.load(); }, s->finishedEvent, timeOutMilliseconds);
+}
+
+//==============================================================================
+TaskGraph::TaskGraph (ThreadPool& poolToUse)
+    : pool (poolToUse), group (poolToUse)
+{
+    allFinishedEvent.signal();
+}
+
+TaskGraph::~TaskGraph()
+{
+    // If this gets stuck, one of the tasks is probably waiting for a dependency that
+    // will never finish.
+    waitForAll();
+}
+
+b8 TaskGraph::waitForAll (i32 timeOutMilliseconds)
+{
+    return pool.waitWhileRunningJobs (group, [this]
+                                      {
+                                          const ScopedLock sl (countLock);
+                                          return numUnfinishedTasks == 0;
+                                      },
+                                      allFinishedEvent, timeOutMilliseconds);
+}
+
+//==============================================================================
+/*  The shared state for a task while it's waiting for its dependencies, and while its
+    chunks are being run. The pool's threads each take chunks in turn until they run
+    out, and whichever thread finishes last completes the task.
+*/
+struct TaskGraph::PendingTask
+{
+    PendingTask (TaskGraph& g, std::shared_ptr<TaskHandle::State> s, i32 chunks, std::unique_ptr<Work> w)
+        : graph (g), state (std::move (s)), numChunks (chunks), functions (std::move (w))
+    {
+    }
+
+    TaskGraph& graph;
+    std::shared_ptr<TaskHandle::State> state;
+    const i32 numChunks;
+    std::unique_ptr<Work> functions;
+
+    std::atomic<i32> numDependenciesLeft { 0 }, nextChunk { 0 }, numWorkersLeft { 0 };
+
+    z0 dependencyFinished (const std::shared_ptr<PendingTask>& self)
+    {
+        if (--numDependenciesLeft == 0)
+            launch (self);
+    }
+
+    z0 launch (const std::shared_ptr<PendingTask>& self)
+    {
+        if (numChunks <= 0)
+        {
+            complete();
+            return;
+        }
+
+        const auto numWorkers = jmin (numChunks, graph.pool.getNumThreads());
+        numWorkersLeft = numWorkers;
+
+        for (i32 i = 0; i < numWorkers; ++i)
+            graph.group.addJob ([self] { self->work(); });
+    }
+
+    z0 work()
+    {
+        for (auto chunk = nextChunk++; chunk < numChunks; chunk = nextChunk++)
+        {
+            try
+            {
+                functions->runChunk (chunk);
+            }
+            catch (...)
+            {
+                jassertfalse; // Your tasks mustn't throw any exceptions!
+            }
+        }
+
+        if (--numWorkersLeft == 0)
+            complete();
+    }
+
+    z0 complete()
+    {
+        functions->finish();
+
+        state->markFinished();
+        graph.taskFinished();
+    }
+};
+
+z0 TaskGraph::start (std::shared_ptr<TaskHandle::State> state, const Array<TaskHandle>& dependencies,
+                     i32 numChunks, std::unique_ptr<Work> work)
+{
+    {
+        const ScopedLock sl (countLock);
+
+        if (numUnfinishedTasks++ == 0)
+            allFinishedEvent.reset();
+    }
+
+    auto task = std::make_shared<PendingTask> (*this, std::move (state), numChunks, std::move (work));
+
+    // The extra count stops the task being launched before all its dependencies have been looked at
+    task->numDependenciesLeft = dependencies.size() + 1;
+
+    for (auto& dependency : dependencies)
+    {
+        if (dependency.state != nullptr)
+            dependency.state->whenFinished ([task] { task->dependencyFinished (task); });
+        else
+            task->dependencyFinished (task);
+    }
+
+    task->dependencyFinished (task);
+}
+
+z0 TaskGraph::taskFinished()
+{
+    const ScopedLock sl (countLock);
+
+    if (--numUnfinishedTasks == 0)
+        allFinishedEvent.signal();
+}
+
+i32 TaskGraph::getChunkSize (i32 numItems, i32 grainSize) const noexcept
+{
+    if (grainSize > 0)
+        return grainSize;
+
+    // Enough chunks to keep all the threads busy when some chunks take longer than others
+    return jmax (1, numItems / (pool.getNumThreads() * 8));
+}
+
+i32 TaskGraph::getNumChunks (i32 numItems, i32 chunkSize) noexcept
+{
+    return numItems > 0 ? (numItems + chunkSize - 1) / chunkSize : 0;
+}
+
+//==============================================================================
+//==============================================================================
+#if DRX_UNIT_TESTS
+
+class TaskGraphTests final : public UnitTest
+{
+public:
+    TaskGraphTests()
+        : UnitTest ("TaskGraph", UnitTestCategories::threads)
+    {}
+
+    z0 runTest() override
+    {
+        for (auto numThreads : { 1, 4 })
+        {
+            ThreadPool pool (ThreadPoolOptions{}.withNumberOfThreads (numThreads));
+            const auto suffix = " (" + Txt (numThreads) + " threads)";
+
+            beginTest ("parallelFor visits every index once" + suffix);
+            {
+                TaskGraph graph (pool);
+
+                for (auto grainSize : { 0, 1, 7, 1000 })
+                {
+                    std::vector<std::atomic<i32>> counts (1000);
+
+                    auto handle = graph.parallelFor (0, 1000, [&] (i32 i) { ++counts[(size_t) i]; }, grainSize);
+                    expect (handle.wait (10000));
+                    expect (handle.isFinished());
+
+                    expect (std::all_of (counts.begin(), counts.end(), [] (auto& c) { return c.load() == 1; }));
+                }
+
+                expect (graph.parallelFor (5, 5, [this] (i32) { expect (false); }).wait (10000));
+            }
+
+            beginTest ("parallelReduce" + suffix);
+            {
+                TaskGraph graph (pool);
+
+                auto sum = graph.parallelReduce (0, 100000, (i64) 0,
+                                                 [] (i32 i) { return (i64) i; },
+                                                 [] (i64 a, i64 b) { return a + b; });
+
+                expectEquals (sum.get(), (i64) 100000 * 99999 / 2);
+
+                // The chunks have to be combined in order for this to work
+                auto text = graph.parallelReduce (0, 200, Txt(),
+                                                  [] (i32 i) { return Txt::charToString ((t32) ('a' + i % 26)); },
+                                                  [] (const Txt& a, const Txt& b) { return a + b; },
+                                                  3);
+
+                Txt expected;
+
+                for (i32 i = 0; i < 200; ++i)
+                    expected << Txt::charToString ((t32) ('a' + i % 26));
+
+                expectEquals (text.get(), expected);
+
+                auto empty = graph.parallelReduce (0, 0, 42, [] (i32) { return 1; }, [] (i32 a, i32 b) { return a + b; });
+                expectEquals (empty.get(), 42);
+            }
+
+            beginTest ("Dependencies" + suffix);
+            {
+                TaskGraph graph (pool);
+                WaitableEvent release;
+                std::atomic<i32> stage { 0 };
+
+                auto first = graph.addTask ([&] { release.wait (-1); stage = 1; });
+                auto second = graph.addTask ([&] { return stage.load(); }, { first });
+                auto loop = graph.parallelFor (0, 100, [&] (i32) { expect (stage.load() >= 1); }, 0, { first, second });
+                auto last = graph.addTask ([&] { stage = 2; }, { loop });
+
+                expect (! last.wait (50));
+                expect (! second.isFinished());
+
+                release.signal();
+                expect (graph.waitForAll (10000));
+                expectEquals (second.get(), 1);
+                expectEquals (stage.load(), 2);
+            }
+
+            beginTest ("Tasks can wait for other tasks" + suffix);
+            {
+                TaskGraph graph (pool);
+
+                // Every thread ends up waiting inside a task here, so this only finishes
+                // if the waiting threads carry on running the inner tasks.
+                auto outer = graph.parallelFor (0, 8, [&] (i32)
+                {
+                    auto inner = graph.parallelReduce (0, 1000, 0,
+                                                       [] (i32) { return 1; },
+                                                       [] (i32 a, i32 b) { return a + b; });
+
+                    expectEquals (inner.get(), 1000);
+                });
+
+                expect (outer.wait (10000));
+            }
+
+            beginTest ("Empty handles count as finished" + suffix);
+            {
+                TaskGraph graph (pool);
+                TaskHandle empty;
+
+                expect (empty.isFinished());
+                expect (empty.wait (0));
+                expectEquals (graph.addTask ([] { return 3; }, { empty }).get(), 3);
+            }
+
+            beginTest ("Move-only functions can be used" + suffix);
+            {
+                TaskGraph graph (pool);
+                std::atomic<i32> total { 0 };
+
+                auto value = graph.addTask ([p = std::make_unique<i32> (7)] { return *p; });
+                auto loop = graph.parallelFor (0, 10, [&total, p = std::make_unique<i32> (2)] (i32) { total += *p; });
+
+                expectEquals (value.get(), 7);
+                expect (loop.wait (10000));
+                expectEquals (total.load(), 20);
+            }
+        }
+    }
+};
+
+static TaskGraphTests taskGraphTests;
+
+#endif
+
+} // namespace drx
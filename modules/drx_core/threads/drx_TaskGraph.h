@@ -0,0 +1,358 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace drx
+{
+
+class TaskGraph;
+
+//==============================================================================
+/**
+    A handle that can be used to wait for a task that was started by a TaskGraph.
+
+    Handles are cheap to copy, and all the copies refer to the same task. A
+    default-constructed handle doesn't refer to any task, and counts as finished.
+
+    @see TaskGraph, TaskFuture
+
+    @tags{Core}
+*/
+class DRX_API  TaskHandle
+{
+public:
+    /** Creates a handle that doesn't refer to any task. */
+    TaskHandle() = default;
+
+    /** Возвращает true, если the task has finished running, or if this handle is empty. */
+    b8 isFinished() const noexcept;
+
+    /** Waits for the task to finish.
+
+        If this is called on one of the threads of the pool that's running the task, the
+        thread will carry on running the graph's queued jobs while it waits, so it's safe for
+        a task to wait for other tasks.
+
+        @param timeOutMilliseconds  the maximum time to wait, or -1 to wait forever
+        @returns    true if the task finished, or false if the time-out expired first
+    */
+    b8 wait (i32 timeOutMilliseconds = -1) const;
+
+protected:
+    /** @internal */
+    struct State
+    {
+        State (ThreadPool& p, const ThreadPool::JobGroup& g)  : pool (p), group (g) {}
+        virtual ~State() = default;
+
+        z0 whenFinished (std::function<z0()> callback);
+        z0 markFinished();
+
+        ThreadPool& pool;
+        const ThreadPool::JobGroup& group;
+        std::atomic<b8> finished { false };
+        WaitableEvent finishedEvent { true };
+        CriticalSection lock;
+        std::vector<std::function<z0()>> continuations;
+    };
+
+    /** @internal */
+    template <typename ResultType>
+    struct ResultState final : public State
+    {
+        using State::State;
+        std::optional<ResultType> result;
+    };
+
+    explicit TaskHandle (std::shared_ptr<State> s) noexcept  : state (std::move (s)) {}
+
+    std::shared_ptr<State> state;
+
+private:
+    friend class TaskGraph;
+};
+
+//==============================================================================
+/**
+    A TaskHandle for a task that produces a value.
+
+    @see TaskGraph, TaskHandle
+
+    @tags{Core}
+*/
+template <typename ResultType>
+class TaskFuture  : public TaskHandle
+{
+public:
+    /** Creates a future that doesn't refer to any task. */
+    TaskFuture() = default;
+
+    /** Waits for the task to finish, and returns the value that it produced.
+
+        It's a mistake to call this on an empty future.
+    */
+    const ResultType& get() const
+    {
+        jassert (state != nullptr);
+        wait();
+        return *static_cast<const ResultState<ResultType>&> (*state).result;
+    }
+
+private:
+    friend class TaskGraph;
+
+    explicit TaskFuture (std::shared_ptr<ResultState<ResultType>> s) noexcept  : TaskHandle (std::move (s)) {}
+};
+
+//==============================================================================
+/**
+    Runs tasks, parallel loops and reductions on a ThreadPool, with dependencies
+    between them.
+
+    Each of the methods that starts some work returns a handle that can be waited on,
+    and can be passed as a dependency to later tasks, which won't start until all of
+    their dependencies have finished. The work is run on the pool's threads using a
+    ThreadPool::JobGroup, so tasks that wait for other tasks won't tie up a thread.
+
+    @code
+    TaskGraph graph (pool);
+
+    auto load    = graph.addTask ([&] { loadData(); });
+    auto process = graph.parallelFor (0, numBlocks, [&] (i32 i) { processBlock (i); }, 0, { load });
+    auto total   = graph.parallelReduce (0, numBlocks, 0.0,
+                                         [&] (i32 i) { return getBlockLevel (i); },
+                                         [] (f64 a, f64 b) { return a + b; },
+                                         0, { process });
+
+    DBG (total.get());
+    @endcode
+
+    The graph's destructor waits for all of its tasks to finish, so anything that the
+    tasks refer to must outlive it.
+
+    @see ThreadPool, TaskHandle, TaskFuture
+
+    @tags{Core}
+*/
+class DRX_API  TaskGraph
+{
+public:
+    //==============================================================================
+    /** Creates a graph that will run its tasks on the given pool. */
+    explicit TaskGraph (ThreadPool& poolToUse);
+
+    /** Destructor. This waits for all the graph's tasks to finish. */
+    ~TaskGraph();
+
+    //==============================================================================
+    /** Starts a task once all the given dependencies have finished.
+
+        If the function returns a value, this returns a TaskFuture that can be used to
+        get it, otherwise it returns a TaskHandle. The function is moved into the graph,
+        so it can hold move-only objects.
+    */
+    template <typename Function>
+    auto addTask (Function&& task, const Array<TaskHandle>& dependencies = {})
+    {
+        using ResultType = std::invoke_result_t<Function>;
+
+        if constexpr (std::is_void_v<ResultType>)
+        {
+            auto s = std::make_shared<TaskHandle::State> (pool, group);
+            start (s, dependencies, 1, makeWork ([fn = std::forward<Function> (task)] (i32) mutable { fn(); }));
+            return TaskHandle (s);
+        }
+        else
+        {
+            auto s = std::make_shared<TaskHandle::ResultState<ResultType>> (pool, group);
+            auto* rawState = s.get();
+            start (s, dependencies, 1, makeWork ([fn = std::forward<Function> (task), rawState] (i32) mutable { rawState->result = fn(); }));
+            return TaskFuture<ResultType> (s);
+        }
+    }
+
+    /** Calls a function for each index in the range [begin, end), spread across the
+        pool's threads.
+
+        The range is split into chunks of grainSize indices, which the threads take in
+        turn. A grainSize of 0 will pick a size that gives each thread several chunks.
+        The calls can happen in any order, and on any thread, and several of them can
+        happen at the same time.
+    */
+    template <typename Function>
+    TaskHandle parallelFor (i32 begin, i32 end,
+                            Function body,
+                            i32 grainSize = 0,
+                            const Array<TaskHandle>& dependencies = {})
+    {
+        auto s = std::make_shared<TaskHandle::State> (pool, group);
+
+        const auto chunkSize = getChunkSize (end - begin, grainSize);
+        const auto numChunks = getNumChunks (end - begin, chunkSize);
+
+        start (s, dependencies, numChunks, makeWork ([begin, end, chunkSize, fn = std::move (body)] (i32 chunk)
+        {
+            const auto chunkStart = begin + chunk * chunkSize;
+            const auto chunkEnd = jmin (end, chunkStart + chunkSize);
+
+            for (auto i = chunkStart; i < chunkEnd; ++i)
+                fn (i);
+        }));
+
+        return TaskHandle (s);
+    }
+
+    /** Combines the values produced for each index in the range [begin, end), using the
+        pool's threads.
+
+        Each chunk of indices is folded into its own total, starting from the identity
+        value, and then the totals for the chunks are combined in order. That means that
+        the combine function must be associative, but it doesn't need to be commutative,
+        and the result doesn't depend on how the work was shared between the threads.
+
+        @param begin        the first index
+        @param end          one past the last index
+        @param identity     a value which has no effect when combined with another value,
+                            e.g. 0 for a sum
+        @param map          a function taking an i32 index and returning a ResultType
+        @param combine      a function taking two ResultTypes and returning their combination
+        @param grainSize    the number of indices in each chunk, or 0 to pick one automatically
+        @param dependencies tasks that must finish before this one starts
+    */
+    template <typename ResultType, typename MapFunction, typename CombineFunction>
+    TaskFuture<ResultType> parallelReduce (i32 begin, i32 end,
+                                           ResultType identity,
+                                           MapFunction map,
+                                           CombineFunction combine,
+                                           i32 grainSize = 0,
+                                           const Array<TaskHandle>& dependencies = {})
+    {
+        auto s = std::make_shared<TaskHandle::ResultState<ResultType>> (pool, group);
+        auto* rawState = s.get();
+
+        const auto chunkSize = getChunkSize (end - begin, grainSize);
+        const auto numChunks = getNumChunks (end - begin, chunkSize);
+        auto partials = std::make_shared<std::vector<ResultType>> ((size_t) numChunks, identity);
+
+        auto runChunk = [=] (i32 chunk)
+        {
+            const auto chunkStart = begin + chunk * chunkSize;
+            const auto chunkEnd = jmin (end, chunkStart + chunkSize);
+            auto total = identity;
+
+            for (auto i = chunkStart; i < chunkEnd; ++i)
+                total = combine (total, map (i));
+
+            (*partials)[(size_t) chunk] = std::move (total);
+        };
+
+        auto finish = [=]
+        {
+            auto total = identity;
+
+            for (auto& partial : *partials)
+                total = combine (total, partial);
+
+            rawState->result = std::move (total);
+        };
+
+        start (s, dependencies, numChunks, makeWork (std::move (runChunk), std::move (finish)));
+        return TaskFuture<ResultType> (s);
+    }
+
+    //==============================================================================
+    /** Waits for all the tasks that have been added to this graph to finish.
+
+        @param timeOutMilliseconds  the maximum time to wait, or -1 to wait forever
+        @returns    true if the tasks finished, or false if the time-out expired first
+    */
+    b8 waitForAll (i32 timeOutMilliseconds = -1);
+
+    /** Returns the pool that this graph is using. */
+    ThreadPool& getThreadPool() const noexcept      { return pool; }
+
+private:
+    //==============================================================================
+    ThreadPool& pool;
+    ThreadPool::JobGroup group;
+
+    struct PendingTask;
+
+    // The functions for a task are held in one of these rather than a std::function, so
+    // that they only need to be movable.
+    struct Work
+    {
+        virtual ~Work() = default;
+        virtual z0 runChunk (i32 chunk) = 0;
+        virtual z0 finish() = 0;
+    };
+
+    template <typename RunChunk, typename Finish>
+    struct WorkFunctions final : public Work
+    {
+        WorkFunctions (RunChunk r, Finish f)  : run (std::move (r)), fin (std::move (f)) {}
+
+        z0 runChunk (i32 chunk) override   { run (chunk); }
+        z0 finish() override               { fin(); }
+
+        RunChunk run;
+        Finish fin;
+    };
+
+    template <typename RunChunk, typename Finish>
+    static std::unique_ptr<Work> makeWork (RunChunk runChunk, Finish finish)
+    {
+        return std::make_unique<WorkFunctions<RunChunk, Finish>> (std::move (runChunk), std::move (finish));
+    }
+
+    template <typename RunChunk>
+    static std::unique_ptr<Work> makeWork (RunChunk runChunk)
+    {
+        return makeWork (std::move (runChunk), [] {});
+    }
+
+    CriticalSection countLock;
+    i32 numUnfinishedTasks = 0;
+    WaitableEvent allFinishedEvent { true };
+
+    z0 start (std::shared_ptr<TaskHandle::State>, const Array<TaskHandle>& dependencies,
+              i32 numChunks, std::unique_ptr<Work> work);
+
+    z0 taskFinished();
+    i32 getChunkSize (i32 numItems, i32 grainSize) const noexcept;
+    static i32 getNumChunks (i32 numItems, i32 chunkSize) noexcept;
+
+    DRX_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TaskGraph)
+};
+
+} // namespace drx
@@ -35,26 +35,347 @@
 namespace drx
 {
 
+/*  An entry in one of the pool's queues.
+
+    The queues never hold jobs directly, because a job that hasn't started yet can be
+    removed and deleted at any time. Instead, whichever thread claims the job from its
+    entry first gets to decide what happens to it, and the entry itself is freed when
+    neither the queue nor the pool's list of jobs refers to it any more.
+*/
+struct ThreadPool::QueueEntry
+{
+    QueueEntry (ThreadPoolJob* j, JobGroup* g, i32 numRefs) noexcept
+        : job (j), group (g), refCount (numRefs)
+    {
+    }
+
+    // Returns nullptr if someone else has already claimed it
+    ThreadPoolJob* claim() noexcept     { return job.exchange (nullptr); }
+
+    z0 release() noexcept
+    {
+        if (--refCount == 0)
+            delete this;
+    }
+
+    std::atomic<ThreadPoolJob*> job;
+    JobGroup* const group;
+    std::atomic<i32> refCount;
+};
+
+//==============================================================================
+/*  A Chase-Lev work-stealing deque. The thread that owns it pushes and pops at the
+    bottom, and any other thread can steal from the top.
+*/
+struct ThreadPool::LocalQueue
+{
+    LocalQueue()
+    {
+        buffers.push_back (std::make_unique<Buffer> (64));
+        buffer = buffers.back().get();
+    }
+
+    // Must only be called by the owning thread
+    z0 push (QueueEntry* entry)
+    {
+        const auto b = bottom.load (std::memory_order_relaxed);
+        const auto t = top.load (std::memory_order_acquire);
+        auto* buf = buffer.load (std::memory_order_relaxed);
+
+        if (b - t > buf->mask)
+            buf = grow (*buf, t, b);
+
+        buf->set (b, entry, entry->group);
+        std::atomic_thread_fence (std::memory_order_release);
+        bottom.store (b + 1, std::memory_order_relaxed);
+    }
+
+    // Must only be called by the owning thread
+    QueueEntry* pop() noexcept
+    {
+        const auto b = bottom.load (std::memory_order_relaxed) - 1;
+        auto* buf = buffer.load (std::memory_order_relaxed);
+        bottom.store (b, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+        auto t = top.load (std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            bottom.store (b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+
+        auto* entry = buf->get (b);
+
+        if (t == b)
+        {
+            // This is the last entry, so we need to race any thieves for it
+            if (! top.compare_exchange_strong (t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                entry = nullptr;
+
+            bottom.store (b + 1, std::memory_order_relaxed);
+        }
+
+        return entry;
+    }
+
+    // Must only be called by the owning thread. Only pops the newest entry if it belongs to the given group.
+    QueueEntry* popFromGroup (const JobGroup& group) noexcept
+    {
+        const auto b = bottom.load (std::memory_order_relaxed) - 1;
+
+        if (b < top.load (std::memory_order_acquire)
+             || buffer.load (std::memory_order_relaxed)->getGroup (b) != &group)
+            return nullptr;
+
+        // Only thieves can have changed anything since, and they take from the other end,
+        // so this either gets the same entry or nothing.
+        return pop();
+    }
+
+    // Can be called from any thread. This may fail if it loses a race with another thread.
+    QueueEntry* steal() noexcept
+    {
+        return stealIf ([] (const JobGroup*) { return true; });
+    }
+
+    // Like steal(), but only takes the oldest entry if it belongs to the given group
+    QueueEntry* stealFromGroup (const JobGroup& group) noexcept
+    {
+        return stealIf ([&group] (const JobGroup* g) { return g == &group; });
+    }
+
+    i64 size() const noexcept
+    {
+        return jmax ((i64) 0, bottom.load (std::memory_order_relaxed) - top.load (std::memory_order_relaxed));
+    }
+
+private:
+    /*  Each slot keeps a copy of its entry's group, because a thief mustn't look inside an
+        entry until it has claimed it - the owner may already have run and deleted it.
+    */
+    struct Buffer
+    {
+        explicit Buffer (i64 size)
+            : mask (size - 1), items (new Slot[(size_t) size])
+        {
+        }
+
+        QueueEntry* get (i64 index) const noexcept          { return items[(size_t) (index & mask)].entry.load (std::memory_order_relaxed); }
+        const JobGroup* getGroup (i64 index) const noexcept { return items[(size_t) (index & mask)].group.load (std::memory_order_relaxed); }
+
+        z0 set (i64 index, QueueEntry* entry, const JobGroup* group) noexcept
+        {
+            auto& slot = items[(size_t) (index & mask)];
+            slot.group.store (group, std::memory_order_relaxed);
+            slot.entry.store (entry, std::memory_order_relaxed);
+        }
+
+        struct Slot
+        {
+            std::atomic<QueueEntry*> entry { nullptr };
+            std::atomic<const JobGroup*> group { nullptr };
+        };
+
+        const i64 mask;
+        std::unique_ptr<Slot[]> items;
+    };
+
+    template <typename Predicate>
+    QueueEntry* stealIf (Predicate&& isWanted) noexcept
+    {
+        auto t = top.load (std::memory_order_acquire);
+        std::atomic_thread_fence (std::memory_order_seq_cst);
+        const auto b = bottom.load (std::memory_order_acquire);
+
+        if (t >= b)
+            return nullptr;
+
+        auto* buf = buffer.load (std::memory_order_acquire);
+
+        // If the slot has been reused since, the exchange below fails, so what's read here
+        // is only acted on if it was still valid
+        auto* entry = buf->get (t);
+
+        if (! isWanted (buf->getGroup (t)))
+            return nullptr;
+
+        if (! top.compare_exchange_strong (t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+
+        return entry;
+    }
+
+    Buffer* grow (const Buffer& old, i64 t, i64 b)
+    {
+        auto bigger = std::make_unique<Buffer> ((old.mask + 1) * 2);
+
+        for (auto i = t; i < b; ++i)
+            bigger->set (i, old.get (i), old.getGroup (i));
+
+        // The old buffers are kept until the queue is deleted, as a thief might still be reading one
+        buffers.push_back (std::move (bigger));
+        buffer.store (buffers.back().get(), std::memory_order_release);
+        return buffers.back().get();
+    }
+
+    std::atomic<i64> top { 0 }, bottom { 0 };
+    std::atomic<Buffer*> buffer { nullptr };
+    std::vector<std::unique_ptr<Buffer>> buffers;
+};
+
+//==============================================================================
+struct ThreadPool::SharedQueue
+{
+    z0 push (QueueEntry* entry, b8 atFront)
+    {
+        const ScopedLock sl (lock);
+
+        if (atFront)
+        {
+            // Jobs moved to the front are kept apart, so that they can jump ahead of
+            // anything already sitting in the threads' local queues too.
+            urgentEntries.push_front (entry);
+            ++numUrgentEntries;
+        }
+        else
+        {
+            entries.push_back (entry);
+        }
+    }
+
+    QueueEntry* popUrgent()
+    {
+        if (numUrgentEntries.load() == 0)
+            return nullptr;
+
+        const ScopedLock sl (lock);
+
+        if (urgentEntries.empty())
+            return nullptr;
+
+        auto* entry = urgentEntries.front();
+        urgentEntries.pop_front();
+        --numUrgentEntries;
+        return entry;
+    }
+
+    /*  Takes the entry at the front, and moves a share of any backlog onto the given local
+        queue, where other threads can steal it. That saves a trip through this lock for
+        each job when lots of small jobs are being added from outside the pool.
+    */
+    QueueEntry* pop (LocalQueue& localQueue, i32 numThreads)
+    {
+        const ScopedLock sl (lock);
+
+        if (entries.empty())
+            return nullptr;
+
+        auto* entry = entries.front();
+        entries.pop_front();
+
+        const auto numToMove = jmin ((size_t) 32, entries.size() / (size_t) jmax (1, numThreads));
+
+        // Pushed in reverse, so that the owning thread still pops the oldest one first
+        for (auto i = numToMove; i > 0; --i)
+            localQueue.push (entries[i - 1]);
+
+        entries.erase (entries.begin(), entries.begin() + (std::ptrdiff_t) numToMove);
+        return entry;
+    }
+
+    QueueEntry* pop()
+    {
+        if (auto* entry = popUrgent())
+            return entry;
+
+        const ScopedLock sl (lock);
+
+        if (entries.empty())
+            return nullptr;
+
+        auto* entry = entries.front();
+        entries.pop_front();
+        return entry;
+    }
+
+    // Takes the oldest entry that belongs to the given group, wherever it is in the queue
+    QueueEntry* popFromGroup (const JobGroup& group)
+    {
+        const ScopedLock sl (lock);
+
+        const auto iter = std::find_if (entries.begin(), entries.end(), [&group] (QueueEntry* e) { return e->group == &group; });
+
+        if (iter == entries.end())
+            return nullptr;
+
+        auto* entry = *iter;
+        entries.erase (iter);
+        return entry;
+    }
+
+    CriticalSection lock;
+    std::deque<QueueEntry*> entries, urgentEntries;
+    std::atomic<i32> numUrgentEntries { 0 };
+};
+
+//==============================================================================
 struct ThreadPool::ThreadPoolThread final : public Thread
 {
-    ThreadPoolThread (ThreadPool& p, const Options& options)
+    ThreadPoolThread (ThreadPool& p, const Options& options, i32 threadIndex)
        : Thread { options.threadName, options.threadStackSizeBytes },
-         pool { p }
+         pool { p },
+         index { threadIndex }
     {
     }
 
     z0 run() override
     {
+        current = this;
+
         while (! threadShouldExit())
         {
-            if (! pool.runNextJob (*this))
-                wait (500);
+            if (pool.runNextJob (*this))
+                continue;
+
+            // The queues are checked again after marking this thread as idle, so that
+            // a job added in between can't be missed. Anything that queues a job after
+            // that will see the flag and wake this thread up.
+            isIdle = true;
+            ++pool.numIdleThreads;
+
+            if (pool.runNextJob (*this))
+            {
+                setNotIdle();
+                continue;
+            }
+
+            wait (-1);
+            setNotIdle();
         }
+
+        current = nullptr;
+    }
+
+    z0 setNotIdle() noexcept
+    {
+        if (isIdle.exchange (false))
+            --pool.numIdleThreads;
+    }
+
+    static ThreadPoolThread* getCurrentThreadForPool (const ThreadPool& p) noexcept
+    {
+        return current != nullptr && &current->pool == &p ? current : nullptr;
     }
 
     std::atomic<ThreadPoolJob*> currentJob { nullptr };
+    std::atomic<b8> isIdle { false };
+    LocalQueue queue;
 
     ThreadPool& pool;
+    const i32 index;
+
+    static inline thread_local ThreadPoolThread* current = nullptr;
 
     DRX_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ThreadPoolThread)
 };
@@ -107,12 +428,13 @@ ThreadPoolJob* ThreadPoolJob::getCurrentThreadPoolJob()
 
 //==============================================================================
 ThreadPool::ThreadPool (const Options& options)
+    : sharedQueue (std::make_unique<SharedQueue>())
 {
     // not much point having a pool without any threads!
     jassert (options.numberOfThreads > 0);
 
-    for (i32 i = jmax (1, options.numberOfThreads); --i >= 0;)
-        threads.add (new ThreadPoolThread (*this, options));
+    for (i32 i = 0; i < jmax (1, options.numberOfThreads); ++i)
+        threads.add (new ThreadPoolThread (*this, options, i));
 
     for (auto* t : threads)
         t->startThread (options.desiredThreadPriority);
@@ -131,6 +453,33 @@ ThreadPool::~ThreadPool()
 {
     removeAllJobs (true, 5000);
     stopThreads();
+
+    // Anything left in the queues now is either a job that was removed before it started,
+    // or one that timed out above and is still in the list of jobs.
+    const auto discard = [] (QueueEntry* entry)
+    {
+        if (auto* job = entry->claim())
+        {
+            if (auto* group = entry->group)
+            {
+                delete job;
+                group->jobFinished();
+            }
+        }
+
+        entry->release();
+    };
+
+    for (auto* t : threads)
+        while (auto* entry = t->queue.pop())
+            discard (entry);
+
+    while (auto* entry = sharedQueue->pop())
+        discard (entry);
+
+    for (auto& registered : jobs)
+        if (registered.entry != nullptr)
+            registered.entry->release();
 }
 
 z0 ThreadPool::stopThreads()
@@ -154,13 +503,16 @@ z0 ThreadPool::addJob (ThreadPoolJob* job, b8 deleteJobWhenFinished)
         job->isActive = false;
         job->shouldBeDeleted = deleteJobWhenFinished;
 
+        // One reference for the queue, and one for the list of jobs
+        auto* entry = new QueueEntry (job, nullptr, 2);
+
         {
             const ScopedLock sl (lock);
-            jobs.add (job);
+            job->indexInPool = (i32) jobs.size();
+            jobs.push_back ({ job, entry });
         }
 
-        for (auto* t : threads)
-            t->notify();
+        enqueue (entry, false);
     }
 }
 
@@ -193,7 +545,7 @@ z0 ThreadPool::addJob (std::function<z0()> jobToRun)
 i32 ThreadPool::getNumJobs() const noexcept
 {
     const ScopedLock sl (lock);
-    return jobs.size();
+    return (i32) jobs.size();
 }
 
 i32 ThreadPool::getNumThreads() const noexcept
@@ -204,29 +556,37 @@ i32 ThreadPool::getNumThreads() const noexcept
 ThreadPoolJob* ThreadPool::getJob (i32 index) const noexcept
 {
     const ScopedLock sl (lock);
-    return jobs [index];
+    return isPositiveAndBelow (index, (i32) jobs.size()) ? jobs[(size_t) index].job : nullptr;
 }
 
 b8 ThreadPool::contains (const ThreadPoolJob* job) const noexcept
 {
     const ScopedLock sl (lock);
-    return jobs.contains (const_cast<ThreadPoolJob*> (job));
+    return indexOfJob (job) >= 0;
 }
 
 b8 ThreadPool::isJobRunning (const ThreadPoolJob* job) const noexcept
 {
     const ScopedLock sl (lock);
-    return jobs.contains (const_cast<ThreadPoolJob*> (job)) && job->isActive;
+    return indexOfJob (job) >= 0 && job->isActive;
 }
 
 z0 ThreadPool::moveJobToFront (const ThreadPoolJob* job) noexcept
 {
     const ScopedLock sl (lock);
 
-    auto index = jobs.indexOf (const_cast<ThreadPoolJob*> (job));
+    auto index = indexOfJob (job);
 
-    if (index > 0 && ! job->isActive)
-        jobs.move (index, 0);
+    if (index >= 0 && ! job->isActive)
+    {
+        auto& registered = jobs[(size_t) index];
+
+        if (cancelIfNotStarted (registered))
+        {
+            registered.entry = new QueueEntry (registered.job, nullptr, 2);
+            enqueue (registered.entry, true);
+        }
+    }
 }
 
 b8 ThreadPool::waitForJobToFinish (const ThreadPoolJob* job, i32 timeOutMs) const
@@ -256,20 +616,22 @@ b8 ThreadPool::removeJob (ThreadPoolJob* job, b8 interruptIfRunning, i32 timeOut
     {
         const ScopedLock sl (lock);
 
-        if (jobs.contains (job))
+        auto index = indexOfJob (job);
+
+        if (index >= 0)
         {
-            if (job->isActive)
+            if (cancelIfNotStarted (jobs[(size_t) index]))
+            {
+                removeFromRegistry (job);
+                addToDeleteList (deletionList, job);
+            }
+            else
             {
                 if (interruptIfRunning)
                     job->signalJobShouldExit();
 
                 dontWait = false;
             }
-            else
-            {
-                jobs.removeFirstMatchingValue (job);
-                addToDeleteList (deletionList, job);
-            }
         }
     }
 
@@ -287,24 +649,27 @@ b8 ThreadPool::removeAllJobs (b8 interruptRunningJobs, i32 timeOutMs,
         {
             const ScopedLock sl (lock);
 
-            for (i32 i = jobs.size(); --i >= 0;)
+            // Removing a job moves the last one into its place, so this goes backwards
+            // to make sure that every job gets looked at exactly once.
+            for (auto i = (i32) jobs.size(); --i >= 0;)
             {
-                auto* job = jobs.getUnchecked (i);
+                auto& registered = jobs[(size_t) i];
+                auto* job = registered.job;
 
                 if (selectedJobsToRemove == nullptr || selectedJobsToRemove->isJobSuitable (job))
                 {
-                    if (job->isActive)
+                    if (cancelIfNotStarted (registered))
+                    {
+                        removeFromRegistry (job);
+                        addToDeleteList (deletionList, job);
+                    }
+                    else
                     {
                         jobsToWaitFor.add (job);
 
                         if (interruptRunningJobs)
                             job->signalJobShouldExit();
                     }
-                    else
-                    {
-                        jobs.remove (i);
-                        addToDeleteList (deletionList, job);
-                    }
                 }
             }
         }
@@ -318,7 +683,7 @@ b8 ThreadPool::removeAllJobs (b8 interruptRunningJobs, i32 timeOutMs,
         {
             auto* job = jobsToWaitFor.getUnchecked (i);
 
-            if (! isJobRunning (job))
+            if (! contains (job))
                 jobsToWaitFor.remove (i);
         }
 
@@ -339,90 +704,256 @@ StringArray ThreadPool::getNamesOfAllJobs (b8 onlyReturnActiveJobs) const
     StringArray s;
     const ScopedLock sl (lock);
 
-    for (auto* job : jobs)
-        if (job->isActive || ! onlyReturnActiveJobs)
-            s.add (job->getJobName());
+    for (auto& registered : jobs)
+        if (registered.job->isActive || ! onlyReturnActiveJobs)
+            s.add (registered.job->getJobName());
 
     return s;
 }
 
-ThreadPoolJob* ThreadPool::pickNextJobToRun()
+//==============================================================================
+z0 ThreadPool::enqueue (QueueEntry* entry, b8 atFront)
 {
-    OwnedArray<ThreadPoolJob> deletionList;
+    // JobGroup jobs added by one of this pool's own threads go onto its local queue, so that
+    // child jobs are usually run by the same thread, while idle threads steal the rest.
+    // Jobs added with addJob() always go onto the shared queue, to keep them in order.
+    if (auto* thread = ThreadPoolThread::getCurrentThreadForPool (*this); thread != nullptr && entry->group != nullptr && ! atFront)
+        thread->queue.push (entry);
+    else
+        sharedQueue->push (entry, atFront);
+
+    wakeIdleThread();
+}
 
-    {
-        const ScopedLock sl (lock);
+b8 ThreadPool::wakeIdleThread()
+{
+    std::atomic_thread_fence (std::memory_order_seq_cst);
 
-        for (i32 i = 0; i < jobs.size(); ++i)
+    if (numIdleThreads.load() > 0)
+    {
+        for (auto* t : threads)
         {
-            if (auto* job = jobs[i])
+            if (t->isIdle.load() && t->isIdle.exchange (false))
             {
-                if (! job->isActive)
-                {
-                    if (job->shouldStop)
-                    {
-                        jobs.remove (i);
-                        addToDeleteList (deletionList, job);
-                        --i;
-                        continue;
-                    }
-
-                    job->isActive = true;
-                    return job;
-                }
+                --numIdleThreads;
+                t->notify();
+                return true;
             }
         }
     }
 
+    return false;
+}
+
+ThreadPool::QueueEntry* ThreadPool::pickNextEntry (ThreadPoolThread& thread)
+{
+    if (auto* entry = sharedQueue->popUrgent())
+        return entry;
+
+    if (auto* entry = thread.queue.pop())
+        return entry;
+
+    if (auto* entry = sharedQueue->pop (thread.queue, threads.size()))
+    {
+        // Any jobs that were moved onto this thread's queue can be stolen now
+        for (auto numMoved = thread.queue.size(); numMoved > 0 && wakeIdleThread(); --numMoved)
+        {}
+
+        return entry;
+    }
+
+    const auto numThreads = threads.size();
+
+    for (i32 i = 1; i < numThreads; ++i)
+        if (auto* entry = threads.getUnchecked ((thread.index + i) % numThreads)->queue.steal())
+            return entry;
+
     return nullptr;
 }
 
+ThreadPool::QueueEntry* ThreadPool::pickEntryFromGroup (ThreadPoolThread& thread, const JobGroup& group)
+{
+    // The group's jobs that this thread added are the newest ones in its own queue
+    if (auto* entry = thread.queue.popFromGroup (group))
+        return entry;
+
+    const auto numThreads = threads.size();
+
+    for (i32 i = 1; i < numThreads; ++i)
+        if (auto* entry = threads.getUnchecked ((thread.index + i) % numThreads)->queue.stealFromGroup (group))
+            return entry;
+
+    return sharedQueue->popFromGroup (group);
+}
+
 b8 ThreadPool::runNextJob (ThreadPoolThread& thread)
 {
-    if (auto* job = pickNextJobToRun())
+    if (auto* entry = pickNextEntry (thread))
     {
-        auto result = ThreadPoolJob::jobHasFinished;
-        thread.currentJob = job;
+        runEntry (thread, entry);
+        return true;
+    }
+
+    return false;
+}
+
+z0 ThreadPool::runEntry (ThreadPoolThread& thread, QueueEntry* entry)
+{
+    auto* job = entry->claim();
+    auto* group = entry->group;
+    entry->release();
+
+    // The job was removed before it got a chance to start
+    if (job == nullptr)
+        return;
+
+    if (group != nullptr)
+    {
+        runJob (thread, job);
+        delete job;
+        group->jobFinished();
+        return;
+    }
+
+    auto result = ThreadPoolJob::jobHasFinished;
 
-        try
+    if (! job->shouldStop)
+    {
+        job->isActive = true;
+        result = runJob (thread, job);
+    }
+
+    OwnedArray<ThreadPoolJob> deletionList;
+
+    {
+        const ScopedLock sl (lock);
+
+        job->isActive = false;
+
+        auto& registered = jobs[(size_t) job->indexInPool];
+        jassert (registered.job == job);
+
+        registered.entry->release();
+        registered.entry = nullptr;
+
+        if (result != ThreadPoolJob::jobNeedsRunningAgain || job->shouldStop)
         {
-            result = job->runJob();
+            removeFromRegistry (job);
+            addToDeleteList (deletionList, job);
+
+            jobFinishedSignal.signal();
         }
-        catch (...)
+        else
         {
-            jassertfalse; // Your runJob() method mustn't throw any exceptions!
+            // put the job on the end of the shared queue if it wants another go
+            registered.entry = new QueueEntry (job, nullptr, 2);
+            sharedQueue->push (registered.entry, false);
+            wakeIdleThread();
         }
+    }
+}
 
-        thread.currentJob = nullptr;
+ThreadPoolJob::JobStatus ThreadPool::runJob (ThreadPoolThread& thread, ThreadPoolJob* job)
+{
+    auto result = ThreadPoolJob::jobHasFinished;
 
-        OwnedArray<ThreadPoolJob> deletionList;
+    // Jobs can be nested when a thread runs other jobs while waiting for a JobGroup
+    auto* previousJob = thread.currentJob.exchange (job);
 
-        {
-            const ScopedLock sl (lock);
+    try
+    {
+        result = job->runJob();
+    }
+    catch (...)
+    {
+        jassertfalse; // Your runJob() method mustn't throw any exceptions!
+    }
 
-            if (jobs.contains (job))
-            {
-                job->isActive = false;
+    thread.currentJob = previousJob;
+    return result;
+}
 
-                if (result != ThreadPoolJob::jobNeedsRunningAgain || job->shouldStop)
-                {
-                    jobs.removeFirstMatchingValue (job);
-                    addToDeleteList (deletionList, job);
+b8 ThreadPool::cancelIfNotStarted (RegisteredJob& registered)
+{
+    if (registered.entry != nullptr && registered.entry->claim() == registered.job)
+    {
+        registered.entry->release();
+        registered.entry = nullptr;
+        return true;
+    }
 
-                    jobFinishedSignal.signal();
-                }
-                else
-                {
-                    // move the job to the end of the queue if it wants another go
-                    jobs.move (jobs.indexOf (job), -1);
-                }
+    return false;
+}
+
+i32 ThreadPool::indexOfJob (const ThreadPoolJob* job) const noexcept
+{
+    for (size_t i = 0; i < jobs.size(); ++i)
+        if (jobs[i].job == job)
+            return (i32) i;
+
+    return -1;
+}
+
+z0 ThreadPool::removeFromRegistry (ThreadPoolJob* job)
+{
+    const auto index = (size_t) job->indexInPool;
+    jassert (jobs[index].job == job);
+
+    jobs[index] = jobs.back();
+    jobs[index].job->indexInPool = (i32) index;
+    jobs.pop_back();
+
+    job->indexInPool = -1;
+}
+
+b8 ThreadPool::waitWhileRunningJobs (const JobGroup& groupToHelp, const std::function<b8()>& isDone,
+                                      WaitableEvent& doneEvent, i32 timeOutMs)
+{
+    const auto start = Time::getMillisecondCounter();
+
+    const auto getTimeRemaining = [&]
+    {
+        return timeOutMs < 0 ? -1 : jmax (0, timeOutMs - (i32) (Time::getMillisecondCounter() - start));
+    };
+
+    // If this is one of our own threads, blocking it could stop the jobs we're waiting
+    // for from ever running, so it runs any of them that haven't started yet. It mustn't
+    // pick up anything else, as an unrelated job could keep it busy long after the group
+    // has finished, or end up waiting for something further up this thread's stack.
+    if (auto* thread = ThreadPoolThread::getCurrentThreadForPool (*this))
+    {
+        while (! isDone())
+        {
+            const auto remaining = getTimeRemaining();
+
+            if (remaining == 0)
+                return false;
+
+            if (auto* entry = pickEntryFromGroup (*thread, groupToHelp))
+            {
+                runEntry (*thread, entry);
+                continue;
             }
+
+            // Everything left is running on other threads, but one of those might still add
+            // more jobs to the group, so this checks again every so often
+            doneEvent.wait (remaining < 0 ? 1 : jmin (1, remaining));
         }
 
         return true;
     }
 
-    return false;
+    while (! isDone())
+    {
+        const auto remaining = getTimeRemaining();
+
+        if (remaining == 0)
+            return false;
+
+        doneEvent.wait (remaining);
+    }
+
+    return true;
 }
 
 z0 ThreadPool::addToDeleteList (OwnedArray<ThreadPoolJob>& deletionList, ThreadPoolJob* job) const
@@ -434,4 +965,338 @@ z0 ThreadPool::addToDeleteList (OwnedArray<ThreadPoolJob>& deletionList, ThreadP
         deletionList.add (job);
 }
 
+//==============================================================================
+ThreadPool::JobGroup::JobGroup (ThreadPool& poolToUse)
+    : pool (poolToUse)
+{
+}
+
+ThreadPool::JobGroup::~JobGroup()
+{
+    wait();
+}
+
+z0 ThreadPool::JobGroup::addJob (std::function<z0()> jobToRun)
+{
+    struct LambdaJobWrapper final : public ThreadPoolJob
+    {
+        LambdaJobWrapper (std::function<z0()> j) : ThreadPoolJob ("group"), job (std::move (j)) {}
+        JobStatus runJob() override      { job(); return ThreadPoolJob::jobHasFinished; }
+
+        std::function<z0()> job;
+    };
+
+    ++numPending;
+    pool.enqueue (new QueueEntry (new LambdaJobWrapper (std::move (jobToRun)), this, 1), false);
+}
+
+z0 ThreadPool::JobGroup::wait()
+{
+    pool.waitWhileRunningJobs (*this, [this] { return numPending.load() == 0; }, finishedEvent, -1);
+
+    // Makes sure that the last job to finish has stopped touching this object
+    const ScopedLock sl (finishedLock);
+}
+
+z0 ThreadPool::JobGroup::jobFinished()
+{
+    const ScopedLock sl (finishedLock);
+
+    if (--numPending == 0)
+        finishedEvent.signal();
+}
+
+//==============================================================================
+//==============================================================================
+#if DRX_UNIT_TESTS
+
+class ThreadPoolTests final : public UnitTest
+{
+public:
+    ThreadPoolTests()
+        : UnitTest ("ThreadPool", UnitTestCategories::threads)
+    {}
+
+    z0 runTest() override
+    {
+        beginTest ("Jobs run and get deleted");
+        {
+            std::atomic<i32> numRun { 0 }, numDeleted { 0 };
+
+            {
+                ThreadPool pool (ThreadPoolOptions{}.withNumberOfThreads (3));
+
+                for (i32 i = 0; i < 200; ++i)
+                    pool.addJob (new CountingJob (numRun, numDeleted), true);
+
+                expect (waitUntil ([&] { return pool.getNumJobs() == 0; }));
+            }
+
+            expectEquals (numRun.load(), 200);
+            expectEquals (numDeleted.load(), 200);
+        }
+
+        beginTest ("Jobs that haven't started can be removed");
+        {
+            std::atomic<i32> numRun { 0 }, numDeleted { 0 };
+            WaitableEvent release;
+
+            ThreadPool pool (ThreadPoolOptions{}.withNumberOfThreads (1));
+            pool.addJob ([&] { release.wait (-1); });
+
+            CountingJob waiting (numRun, numDeleted);
+            pool.addJob (&waiting, false);
+
+            expect (pool.contains (&waiting));
+            expect (! pool.isJobRunning (&waiting));
+            expect (pool.removeJob (&waiting, false, 0));
+            expect (! pool.contains (&waiting));
+
+            release.signal();
+            expect (pool.removeAllJobs (false, 5000));
+            expectEquals (numRun.load(), 0);
+        }
+
+        beginTest ("Jobs can ask to be run again");
+        {
+            std::atomic<i32> count { 0 };
+
+            ThreadPool pool (ThreadPoolOptions{}.withNumberOfThreads (2));
+            pool.addJob (std::function<ThreadPoolJob::JobStatus()> ([&]
+            {
+                return ++count < 50 ? ThreadPoolJob::jobNeedsRunningAgain
+                                    : ThreadPoolJob::jobHasFinished;
+            }));
+
+            expect (waitUntil ([&] { return pool.getNumJobs() == 0; }));
+            expectEquals (count.load(), 50);
+        }
+
+        beginTest ("Jobs can be moved to the front");
+        {
+            WaitableEvent release;
+            Array<i32> order;
+            CriticalSection orderLock;
+
+            ThreadPool pool (ThreadPoolOptions{}.withNumberOfThreads (1));
+            pool.addJob ([&] { release.wait (-1); });
+
+            OwnedArray<OrderedJob> ordered;
+
+            for (i32 i = 0; i < 4; ++i)
+                pool.addJob (ordered.add (new OrderedJob (i, order, orderLock)), false);
+
+            pool.moveJobToFront (ordered[3]);
+            release.signal();
+
+            expect (waitUntil ([&] { return pool.getNumJobs() == 0; }));
+            expect (order == Array<i32> { 3, 0, 1, 2 });
+        }
+
+        beginTest ("Selected jobs can be removed");
+        {
+            std::atomic<i32> numRun { 0 }, numDeleted { 0 };
+            WaitableEvent release;
+
+            ThreadPool pool (ThreadPoolOptions{}.withNumberOfThreads (1));
+            pool.addJob ([&] { release.wait (-1); });
+
+            for (i32 i = 0; i < 10; ++i)
+                pool.addJob (new CountingJob (numRun, numDeleted), true);
+
+            struct CountingJobSelector final : public ThreadPool::JobSelector
+            {
+                b8 isJobSuitable (ThreadPoolJob* job) override   { return dynamic_cast<CountingJob*> (job) != nullptr; }
+            };
+
+            CountingJobSelector selector;
+            expect (pool.removeAllJobs (false, 0, &selector));
+            expectEquals (pool.getNumJobs(), 1);
+            expectEquals (numDeleted.load(), 10);
+
+            release.signal();
+            expect (pool.removeAllJobs (false, 5000));
+            expectEquals (numRun.load(), 0);
+        }
+
+        beginTest ("Fork/join");
+        {
+            for (auto numThreads : { 1, 4 })
+            {
+                ThreadPool pool (ThreadPoolOptions{}.withNumberOfThreads (numThreads));
+
+                // Each level waits for its children from inside a job, so this will only
+                // finish if waiting threads carry on running other jobs.
+                expectEquals (parallelSum (pool, 0, 100000), (i64) 100000 * 99999 / 2);
+
+                {
+                    std::atomic<i32> count { 0 };
+                    ThreadPool::JobGroup group (pool);
+
+                    for (i32 i = 0; i < 1000; ++i)
+                        group.addJob ([&] { ++count; });
+
+                    group.wait();
+                    expectEquals (count.load(), 1000);
+                }
+            }
+        }
+
+        beginTest ("Jobs added from inside the pool keep their order");
+        {
+            Array<i32> order;
+            CriticalSection orderLock;
+            OwnedArray<OrderedJob> ordered;
+
+            for (i32 i = 0; i < 4; ++i)
+                ordered.add (new OrderedJob (i, order, orderLock));
+
+            ThreadPool pool (ThreadPoolOptions{}.withNumberOfThreads (1));
+
+            pool.addJob ([&]
+            {
+                for (auto* job : ordered)
+                    pool.addJob (job, false);
+            });
+
+            expect (waitUntil ([&] { return pool.getNumJobs() == 0; }));
+            expect (order == Array<i32> { 0, 1, 2, 3 });
+        }
+
+        beginTest ("Waiting for a group only runs that group's jobs");
+        {
+            ThreadPool pool (ThreadPoolOptions{}.withNumberOfThreads (1));
+            std::atomic<b8> otherJobRan { false }, otherJobRanDuringWait { true };
+            std::atomic<i32> count { 0 };
+
+            pool.addJob ([&]
+            {
+                ThreadPool::JobGroup group (pool);
+                group.addJob ([&] { ++count; });
+                pool.addJob ([&] { otherJobRan = true; });
+                group.addJob ([&] { ++count; });
+
+                group.wait();
+                otherJobRanDuringWait = otherJobRan.load();
+            });
+
+            expect (waitUntil ([&] { return pool.getNumJobs() == 0 && otherJobRan.load(); }));
+            expectEquals (count.load(), 2);
+            expect (! otherJobRanDuringWait.load());
+        }
+
+        beginTest ("Idle threads are woken when jobs are added");
+        {
+            ThreadPool pool (ThreadPoolOptions{}.withNumberOfThreads (2));
+            Thread::sleep (50);
+
+            for (i32 i = 0; i < 20; ++i)
+            {
+                WaitableEvent done;
+                const auto start = Time::getMillisecondCounter();
+                pool.addJob ([&] { done.signal(); });
+
+                expect (done.wait (5000));
+                expect (Time::getMillisecondCounter() - start < 250);
+                Thread::sleep (5);
+            }
+        }
+
+        beginTest ("Throughput");
+        {
+            for (auto numThreads : { 1, 4, 16 })
+            {
+                constexpr i32 numJobs = 100000;
+                std::atomic<i32> count { 0 };
+
+                ThreadPool pool (ThreadPoolOptions{}.withNumberOfThreads (numThreads));
+                const auto start = Time::getHighResolutionTicks();
+
+                for (i32 i = 0; i < numJobs; ++i)
+                    pool.addJob ([&] { ++count; });
+
+                expect (waitUntil ([&] { return count.load() == numJobs; }));
+
+                const auto seconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+                logMessage (Txt (numThreads) + " threads: " + Txt (roundToInt (numJobs / seconds)) + " jobs/sec");
+            }
+        }
+    }
+
+private:
+    struct CountingJob final : public ThreadPoolJob
+    {
+        CountingJob (std::atomic<i32>& r, std::atomic<i32>& d)  : ThreadPoolJob ("counting"), numRun (r), numDeleted (d) {}
+        ~CountingJob() override     { ++numDeleted; }
+
+        JobStatus runJob() override
+        {
+            ++numRun;
+            return jobHasFinished;
+        }
+
+        std::atomic<i32>& numRun;
+        std::atomic<i32>& numDeleted;
+    };
+
+    struct OrderedJob final : public ThreadPoolJob
+    {
+        OrderedJob (i32 i, Array<i32>& o, CriticalSection& l)  : ThreadPoolJob ("ordered"), index (i), order (o), lock (l) {}
+
+        JobStatus runJob() override
+        {
+            const ScopedLock sl (lock);
+            order.add (index);
+            return jobHasFinished;
+        }
+
+        i32 index;
+        Array<i32>& order;
+        CriticalSection& lock;
+    };
+
+    static i64 parallelSum (ThreadPool& pool, i64 begin, i64 end)
+    {
+        if (end - begin <= 1000)
+        {
+            i64 total = 0;
+
+            for (auto i = begin; i < end; ++i)
+                total += i;
+
+            return total;
+        }
+
+        const auto mid = begin + (end - begin) / 2;
+        i64 left = 0, right = 0;
+
+        ThreadPool::JobGroup group (pool);
+        group.addJob ([&] { left = parallelSum (pool, begin, mid); });
+        group.addJob ([&] { right = parallelSum (pool, mid, end); });
+        group.wait();
+
+        return left + right;
+    }
+
+    template <typename Predicate>
+    static b8 waitUntil (Predicate&& predicate)
+    {
+        const auto timeout = Time::getMillisecondCounter() + 10000;
+
+        while (! predicate())
+        {
+            if (Time::getMillisecondCounter() > timeout)
+                return false;
+
+            Thread::sleep (1);
+        }
+
+        return true;
+    }
+};
+
+static ThreadPoolTests threadPoolTests;
+
+#endif
+
 } // namespace drx
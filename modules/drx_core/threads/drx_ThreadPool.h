@@ -146,6 +146,7 @@ private:
     friend class ThreadPool;
     Txt jobName;
     ThreadPool* pool = nullptr;
+    i32 indexInPool = -1;
     std::atomic<b8> shouldStop { false }, isActive { false }, shouldBeDeleted { false };
     ThreadSafeListenerList<Thread::Listener> listeners;
 
@@ -379,19 +380,99 @@ public:
     */
     StringArray getNamesOfAllJobs (b8 onlyReturnActiveJobs) const;
 
+    //==============================================================================
+    /** A set of jobs that can be waited on together, for fork/join style parallelism.
+
+        Jobs added to a group are run by the pool's threads like any other job. If they're
+        added from inside a job that the pool is running, they go onto that thread's own
+        queue, and idle threads will steal them from there.
+
+        When wait() is called on one of the pool's threads, it doesn't block: the thread
+        carries on running queued jobs until every job in the group has finished. That means
+        a job can split its work into child jobs and wait for them without tying up a thread.
+
+        Jobs in a group aren't visible through getJob(), contains() or getNumJobs(), and
+        can't be removed once they've been added.
+
+        @code
+        ThreadPool::JobGroup group (pool);
+        group.addJob ([&] { left  = sumOf (data, half); });
+        group.addJob ([&] { right = sumOf (data + half, num - half); });
+        group.wait();
+        @endcode
+    */
+    class DRX_API  JobGroup
+    {
+    public:
+        /** Creates an empty group that will run its jobs on the given pool. */
+        explicit JobGroup (ThreadPool& poolToUse);
+
+        /** Destructor. This will wait for any jobs that haven't finished yet. */
+        ~JobGroup();
+
+        /** Adds a job to the group. It'll be started as soon as a thread is free. */
+        z0 addJob (std::function<z0()> job);
+
+        /** Waits until all the jobs that have been added to this group have finished.
+
+            If this is called on one of the pool's threads, the thread will run any of
+            this group's jobs that haven't started yet while it waits, rather than
+            blocking. It won't run jobs that don't belong to the group.
+        */
+        z0 wait();
+
+    private:
+        friend class ThreadPool;
+        ThreadPool& pool;
+        std::atomic<i32> numPending { 0 };
+        CriticalSection finishedLock;
+        WaitableEvent finishedEvent;
+
+        z0 jobFinished();
+
+        DRX_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JobGroup)
+    };
+
 private:
     //==============================================================================
-    Array<ThreadPoolJob*> jobs;
+    struct QueueEntry;
+    struct LocalQueue;
+    struct SharedQueue;
+
+    struct RegisteredJob
+    {
+        ThreadPoolJob* job;
+        QueueEntry* entry;
+    };
+
+    // Every job added with addJob(), in no particular order
+    std::vector<RegisteredJob> jobs;
 
     struct ThreadPoolThread;
     friend class ThreadPoolJob;
+    friend class TaskGraph;
+    friend class TaskHandle;
     OwnedArray<ThreadPoolThread> threads;
 
+    // Jobs added from outside the pool's threads, or that want running again
+    std::unique_ptr<SharedQueue> sharedQueue;
+    std::atomic<i32> numIdleThreads { 0 };
+
     CriticalSection lock;
     WaitableEvent jobFinishedSignal;
 
     b8 runNextJob (ThreadPoolThread&);
-    ThreadPoolJob* pickNextJobToRun();
+    QueueEntry* pickNextEntry (ThreadPoolThread&);
+    QueueEntry* pickEntryFromGroup (ThreadPoolThread&, const JobGroup&);
+    z0 runEntry (ThreadPoolThread&, QueueEntry*);
+    ThreadPoolJob::JobStatus runJob (ThreadPoolThread&, ThreadPoolJob*);
+    z0 enqueue (QueueEntry*, b8 atFront);
+    b8 cancelIfNotStarted (RegisteredJob&);
+    i32 indexOfJob (const ThreadPoolJob*) const noexcept;
+    z0 removeFromRegistry (ThreadPoolJob*);
+    b8 wakeIdleThread();
+    b8 waitWhileRunningJobs (const JobGroup& groupToHelp, const std::function<b8()>& isDone,
+                             WaitableEvent& doneEvent, i32 timeOutMs);
     z0 addToDeleteList (OwnedArray<ThreadPoolJob>&, ThreadPoolJob*) const;
     z0 stopThreads();
 
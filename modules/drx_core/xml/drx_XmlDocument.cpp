@@ -50,6 +50,16 @@ std::unique_ptr<XmlElement> XmlDocument::parse (const Txt& textToParse)
     return XmlDocument (textToParse).getDocumentElement();
 }
 
+std::unique_ptr<XmlElement> XmlDocument::parse (InputStream& input)
+{
+    XmlPullParser parser (input);
+
+    if (parser.next() == XmlPullParser::startElement)
+        return parser.readElement();
+
+    return {};
+}
+
 std::unique_ptr<XmlElement> parseXML (const Txt& textToParse)
 {
     return XmlDocument (textToParse).getDocumentElement();
@@ -156,6 +156,14 @@ public:
     */
     static std::unique_ptr<XmlElement> parse (const Txt& xmlData);
 
+    /** A handy static method that parses XML from a stream.
+        This reads the stream in chunks with an XmlPullParser, so the whole of the source
+        text never has to be held in memory. Entities declared in a DTD aren't expanded.
+        @returns    a new XmlElement, or nullptr if there was an error.
+        @see XmlPullParser
+    */
+    static std::unique_ptr<XmlElement> parse (InputStream& input);
+
 
     //==============================================================================
 private:
@@ -0,0 +1,1039 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace drx
+{
+
+XmlPullParser::XmlPullParser (InputStream& s)
+    : source (&s),
+      inputBufferSize (65536)
+{
+    inputBuffer.malloc (inputBufferSize + 1);
+    inputPos = inputEnd = inputBuffer.get();
+    *inputEnd = 0;
+}
+
+XmlPullParser::XmlPullParser (std::unique_ptr<InputStream> s)
+    : XmlPullParser (*s)
+{
+    ownedStream = std::move (s);
+}
+
+XmlPullParser::~XmlPullParser() = default;
+
+//==============================================================================
+b8 XmlPullParser::fill (size_t numBytesNeeded)
+{
+    auto available = (size_t) (inputEnd - inputPos);
+
+    if (available >= numBytesNeeded)
+        return true;
+
+    if (streamFinished)
+        return false;
+
+    if (inputPos != inputBuffer.get())
+    {
+        memmove (inputBuffer.get(), inputPos, available);
+        inputPos = inputBuffer.get();
+        inputEnd = inputPos + available;
+    }
+
+    if (numBytesNeeded > inputBufferSize)
+    {
+        inputBufferSize = numBytesNeeded * 2;
+        inputBuffer.realloc (inputBufferSize + 1);
+        inputPos = inputBuffer.get();
+        inputEnd = inputPos + available;
+    }
+
+    while (available < numBytesNeeded)
+    {
+        const auto numRead = source->read (inputEnd, (i32) (inputBufferSize - available));
+
+        if (numRead <= 0)
+        {
+            streamFinished = true;
+            break;
+        }
+
+        inputEnd += numRead;
+        available += (size_t) numRead;
+    }
+
+    // Keeping a null after the data means that scanning loops stop at the end by themselves
+    *inputEnd = 0;
+    return available >= numBytesNeeded;
+}
+
+t8 XmlPullParser::peek (size_t offset)
+{
+    if (inputPos + offset >= inputEnd && ! fill (offset + 1))
+        return 0;
+
+    return inputPos[offset];
+}
+
+b8 XmlPullParser::matches (tukk textToMatch)
+{
+    const auto length = strlen (textToMatch);
+    return fill (length) && memcmp (inputPos, textToMatch, length) == 0;
+}
+
+static b8 isXmlWhitespace (t8 c) noexcept
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+static b8 isXmlNameChar (t8 c) noexcept
+{
+    // Anything outside ASCII is part of a multi-byte UTF-8 character, which we'll allow in names
+    return (u8) c >= 0x80 || XmlIdentifierChars::isIdentifierChar ((t32) c);
+}
+
+z0 XmlPullParser::skipWhitespace()
+{
+    for (;;)
+    {
+        while (isXmlWhitespace (*inputPos))
+            ++inputPos;
+
+        if (inputPos < inputEnd || ! fill (1))
+            return;
+    }
+}
+
+b8 XmlPullParser::skipPast (tukk terminator, b8 keepSkippedText)
+{
+    const auto length = strlen (terminator);
+
+    for (;;)
+    {
+        if (! fill (length))
+        {
+            if (keepSkippedText)
+                appendToEvent (inputPos, (size_t) (inputEnd - inputPos));
+
+            inputPos = inputEnd;
+            return false;
+        }
+
+        const auto* lastStart = inputEnd - length;
+
+        for (auto* p = inputPos; p <= lastStart; ++p)
+        {
+            p = static_cast<t8*> (memchr (p, terminator[0], (size_t) (lastStart - p) + 1));
+
+            if (p == nullptr)
+                break;
+
+            if (memcmp (p, terminator, length) == 0)
+            {
+                if (keepSkippedText)
+                    appendToEvent (inputPos, (size_t) (p - inputPos));
+
+                inputPos = p + length;
+                return true;
+            }
+        }
+
+        // Keep the last few bytes, which might be the start of the terminator
+        const auto newPos = inputEnd - (length - 1);
+
+        if (keepSkippedText)
+            appendToEvent (inputPos, (size_t) (newPos - inputPos));
+
+        inputPos = newPos;
+
+        if (! fill (length))
+        {
+            if (keepSkippedText)
+                appendToEvent (inputPos, (size_t) (inputEnd - inputPos));
+
+            inputPos = inputEnd;
+            return false;
+        }
+    }
+}
+
+b8 XmlPullParser::skipDocType()
+{
+    inputPos += 2;
+
+    for (i32 depth = 1; depth > 0; ++inputPos)
+    {
+        const auto c = peek();
+
+        if (c == 0)
+            return false;
+
+        if (c == '<')
+            ++depth;
+        else if (c == '>')
+            --depth;
+    }
+
+    return true;
+}
+
+z0 XmlPullParser::checkForUnicodeInput()
+{
+    if (! fill (3))
+        fill (2);
+
+    const auto* bytes = reinterpret_cast<const u8*> (inputPos);
+    const auto available = (size_t) (inputEnd - inputPos);
+
+    if (available >= 3 && CharPointer_UTF8::isByteOrderMark (inputPos))
+    {
+        inputPos += 3;
+    }
+    else if (available >= 2 && ((bytes[0] == 0xff && bytes[1] == 0xfe) || (bytes[0] == 0xfe && bytes[1] == 0xff)))
+    {
+        // UTF-16 has to be converted first, which means reading the whole stream
+        MemoryOutputStream data;
+        data.write (inputPos, available);
+        data.writeFromInputStream (*source, -1);
+
+        const auto utf8 = data.toString().toStdString();
+
+        ownedStream = std::make_unique<MemoryInputStream> (utf8.data(), utf8.size(), true);
+        source = ownedStream.get();
+        inputPos = inputEnd = inputBuffer.get();
+        *inputEnd = 0;
+        streamFinished = false;
+    }
+}
+
+//==============================================================================
+z0 XmlPullParser::startEvent() noexcept
+{
+    eventData.clear();
+    attributes.clear();
+    nameOffset = textOffset = 0;
+}
+
+z0 XmlPullParser::appendToEvent (const t8* data, size_t numBytes)
+{
+    eventData.insert (eventData.end(), data, data + numBytes);
+}
+
+StringRef XmlPullParser::getEventString (size_t offset) const noexcept
+{
+    return offset < eventData.size() ? StringRef (eventData.data() + offset) : StringRef();
+}
+
+StringRef XmlPullParser::getName() const noexcept
+{
+    return currentEvent == startElement || currentEvent == endElement ? getEventString (nameOffset) : StringRef();
+}
+
+StringRef XmlPullParser::getText() const noexcept
+{
+    return currentEvent == text ? getEventString (textOffset) : StringRef();
+}
+
+StringRef XmlPullParser::getAttributeName (i32 index) const noexcept
+{
+    return isPositiveAndBelow (index, getNumAttributes()) ? getEventString (attributes[(size_t) index].first) : StringRef();
+}
+
+StringRef XmlPullParser::getAttributeValue (i32 index) const noexcept
+{
+    return isPositiveAndBelow (index, getNumAttributes()) ? getEventString (attributes[(size_t) index].second) : StringRef();
+}
+
+StringRef XmlPullParser::getAttributeValue (StringRef attributeName) const noexcept
+{
+    for (i32 i = 0; i < getNumAttributes(); ++i)
+        if (getAttributeName (i) == attributeName)
+            return getAttributeValue (i);
+
+    return {};
+}
+
+XmlPullParser::EventType XmlPullParser::setError (const Txt& message)
+{
+    lastError = message;
+    startEvent();
+    return currentEvent = error;
+}
+
+z0 XmlPullParser::popElement()
+{
+    elementNames.resize (elementNameOffsets.back());
+    elementNameOffsets.pop_back();
+}
+
+//==============================================================================
+XmlPullParser::EventType XmlPullParser::next()
+{
+    if (currentEvent == error || (started && currentEvent == endOfDocument))
+        return currentEvent;
+
+    if (! started)
+    {
+        started = true;
+        checkForUnicodeInput();
+    }
+
+    if (pendingEndOfEmptyElement)
+    {
+        // The start element's name is still in the event buffer
+        pendingEndOfEmptyElement = false;
+        attributes.clear();
+        popElement();
+        return currentEvent = endElement;
+    }
+
+    if (currentEvent == endElement && getDepth() == 0)
+        return currentEvent = endOfDocument;
+
+    for (;;)
+    {
+        if (getDepth() == 0)
+        {
+            // Before the outer element, so skip anything that isn't a start tag
+            skipWhitespace();
+
+            if (peek() == 0)
+            {
+                startEvent();
+                return currentEvent = endOfDocument;
+            }
+
+            if (peek() != '<')
+                return setError ("expected '<'");
+
+            if (matches ("<?"))
+            {
+                if (! skipPast ("?>"))
+                    return setError ("malformed header");
+
+                continue;
+            }
+
+            if (matches ("<!--"))
+            {
+                if (! skipPast ("-->"))
+                    return setError ("unterminated comment");
+
+                continue;
+            }
+
+            if (peek (1) == '!')
+            {
+                if (! skipDocType())
+                    return setError ("malformed DTD");
+
+                continue;
+            }
+
+            return readStartElement();
+        }
+
+        const auto c = peek();
+
+        if (c == 0)
+            return setError ("unmatched tags");
+
+        if (c == '<')
+        {
+            const auto c1 = peek (1);
+
+            if (c1 == '/')
+                return readEndElement();
+
+            if (c1 == '!')
+            {
+                if (matches ("<![CDATA["))
+                    return readCData();
+
+                if (matches ("<!--"))
+                {
+                    if (! skipPast ("-->"))
+                        return setError ("unterminated comment");
+
+                    continue;
+                }
+            }
+
+            if (c1 == '?')
+            {
+                if (! skipPast ("?>"))
+                    return setError ("unterminated processing instruction");
+
+                continue;
+            }
+
+            return readStartElement();
+        }
+
+        if (readText() || currentEvent == error)
+            return currentEvent;
+    }
+}
+
+b8 XmlPullParser::readName()
+{
+    const auto start = eventData.size();
+
+    for (;;)
+    {
+        auto* p = inputPos;
+
+        while (isXmlNameChar (*p))
+            ++p;
+
+        appendToEvent (inputPos, (size_t) (p - inputPos));
+        inputPos = p;
+
+        if (inputPos < inputEnd || ! fill (1))
+            break;
+    }
+
+    return eventData.size() > start;
+}
+
+XmlPullParser::EventType XmlPullParser::readStartElement()
+{
+    startEvent();
+    ++inputPos;
+
+    // allow for a gap after the '<'
+    skipWhitespace();
+
+    if (! readName())
+        return setError ("tag name missing");
+
+    eventData.push_back (0);
+
+    for (;;)
+    {
+        skipWhitespace();
+        const auto c = peek();
+
+        if (c == '/' && peek (1) == '>')
+        {
+            inputPos += 2;
+            pendingEndOfEmptyElement = true;
+            break;
+        }
+
+        if (c == '>')
+        {
+            ++inputPos;
+            break;
+        }
+
+        if (c == 0)
+            return setError ("unmatched tags");
+
+        if (! isXmlNameChar (c))
+            return setError ("illegal character found in " + Txt (getEventString (nameOffset)) + ": '" + Txt::charToString ((t32) (u8) c) + "'");
+
+        const auto attributeNameOffset = eventData.size();
+        readName();
+        eventData.push_back (0);
+
+        skipWhitespace();
+
+        if (peek() != '=')
+            return setError ("expected '=' after attribute '" + Txt (getEventString (attributeNameOffset)) + "'");
+
+        ++inputPos;
+        skipWhitespace();
+
+        const auto quote = peek();
+
+        if (quote != '"' && quote != '\'')
+            return setError ("expected a quoted value for attribute '" + Txt (getEventString (attributeNameOffset)) + "'");
+
+        const auto valueOffset = eventData.size();
+
+        if (! readAttributeValue())
+            return setError ("unmatched quotes");
+
+        attributes.push_back ({ attributeNameOffset, valueOffset });
+    }
+
+    const auto* name = eventData.data() + nameOffset;
+    elementNameOffsets.push_back (elementNames.size());
+    elementNames.insert (elementNames.end(), name, name + strlen (name) + 1);
+
+    return currentEvent = startElement;
+}
+
+b8 XmlPullParser::readAttributeValue()
+{
+    const auto quote = *inputPos++;
+
+    for (;;)
+    {
+        auto* p = inputPos;
+
+        while (*p != quote && *p != '&' && *p != 0)
+            ++p;
+
+        appendToEvent (inputPos, (size_t) (p - inputPos));
+        inputPos = p;
+
+        if (*p == quote)
+        {
+            ++inputPos;
+            eventData.push_back (0);
+            return true;
+        }
+
+        if (*p == '&')
+            readEntity();
+        else if (! fill (1))
+            return false;
+    }
+}
+
+XmlPullParser::EventType XmlPullParser::readEndElement()
+{
+    if (! skipPast (">"))
+        return setError ("unmatched tags");
+
+    startEvent();
+
+    const auto* name = elementNames.data() + elementNameOffsets.back();
+    appendToEvent (name, strlen (name) + 1);
+    popElement();
+
+    return currentEvent = endElement;
+}
+
+XmlPullParser::EventType XmlPullParser::readCData()
+{
+    startEvent();
+    inputPos += 9;
+
+    if (! skipPast ("]]>", true))
+        return setError ("unterminated CDATA section");
+
+    eventData.push_back (0);
+    return currentEvent = text;
+}
+
+b8 XmlPullParser::readText()
+{
+    startEvent();
+    b8 contentShouldBeUsed = ! ignoreEmptyText;
+
+    for (;;)
+    {
+        auto* p = inputPos;
+
+        if (contentShouldBeUsed)
+        {
+            while (*p != '<' && *p != '&' && *p != '\r' && *p != 0)
+                ++p;
+        }
+        else
+        {
+            while (isXmlWhitespace (*p) && *p != '\r')
+                ++p;
+
+            while (*p != '<' && *p != '&' && *p != '\r' && *p != 0)
+            {
+                contentShouldBeUsed = true;
+                ++p;
+            }
+        }
+
+        appendToEvent (inputPos, (size_t) (p - inputPos));
+        inputPos = p;
+
+        const auto c = *p;
+
+        if (c == 0)
+        {
+            if (! fill (1))
+            {
+                setError ("unmatched tags");
+                return false;
+            }
+
+            continue;
+        }
+
+        if (c == '\r')
+        {
+            // Line endings are normalised to a single newline, as XmlDocument does
+            ++inputPos;
+
+            if (peek() != '\n')
+                eventData.push_back ('\n');
+
+            continue;
+        }
+
+        if (c == '&')
+        {
+            const auto entityStart = eventData.size();
+            readEntity();
+
+            for (auto i = entityStart; i < eventData.size(); ++i)
+                contentShouldBeUsed = contentShouldBeUsed || ! isXmlWhitespace (eventData[i]);
+
+            continue;
+        }
+
+        // Comments are dropped from the middle of a block of text
+        if (matches ("<!--"))
+        {
+            if (! skipPast ("-->"))
+            {
+                setError ("unterminated comment");
+                return false;
+            }
+
+            continue;
+        }
+
+        break;
+    }
+
+    if (! contentShouldBeUsed)
+        return false;
+
+    eventData.push_back (0);
+    currentEvent = text;
+    return true;
+}
+
+z0 XmlPullParser::readEntity()
+{
+    // skip over the ampersand
+    ++inputPos;
+
+    t8 name[36];
+    size_t length = 0;
+
+    for (;;)
+    {
+        const auto c = peek();
+
+        if (c == ';')
+        {
+            ++inputPos;
+            break;
+        }
+
+        if (c == 0 || c == '&' || c == '<' || isXmlWhitespace (c) || length >= sizeof (name) - 1)
+        {
+            // Not a proper entity, so just treat it as text
+            eventData.push_back ('&');
+            appendToEvent (name, length);
+            return;
+        }
+
+        name[length++] = c;
+        ++inputPos;
+    }
+
+    name[length] = 0;
+
+    const auto appendChar = [this] (t32 character)
+    {
+        t8 utf8[8];
+        CharPointer_UTF8 dest (utf8);
+        dest.write (character);
+        appendToEvent (utf8, (size_t) (dest.getAddress() - utf8));
+    };
+
+    const auto nameMatches = [&] (tukk entity)
+    {
+        return CharacterFunctions::compareIgnoreCase (CharPointer_ASCII (name), CharPointer_ASCII (entity)) == 0;
+    };
+
+    if (nameMatches ("amp"))        eventData.push_back ('&');
+    else if (nameMatches ("quot"))  eventData.push_back ('"');
+    else if (nameMatches ("apos"))  eventData.push_back ('\'');
+    else if (nameMatches ("lt"))    eventData.push_back ('<');
+    else if (nameMatches ("gt"))    eventData.push_back ('>');
+    else if (name[0] == '#')
+    {
+        const auto isHex = name[1] == 'x' || name[1] == 'X';
+        const auto* digits = name + (isHex ? 2 : 1);
+        z64 charCode = 0;
+        b8 isValid = *digits != 0;
+
+        for (auto* d = digits; *d != 0 && isValid; ++d)
+        {
+            const auto digit = isHex ? CharacterFunctions::getHexDigitValue ((t32) *d)
+                                     : (*d >= '0' && *d <= '9' ? *d - '0' : -1);
+
+            isValid = digit >= 0 && charCode <= 0x10ffff;
+            charCode = charCode * (isHex ? 16 : 10) + digit;
+        }
+
+        if (isValid && charCode > 0 && charCode <= 0x10ffff)
+        {
+            appendChar ((t32) charCode);
+        }
+        else
+        {
+            eventData.push_back ('&');
+            appendToEvent (name, length);
+            eventData.push_back (';');
+        }
+    }
+    else
+    {
+        const auto replacement = entityResolver != nullptr ? entityResolver (StringRef (name))
+                                                           : Txt (CharPointer_UTF8 (name));
+        appendToEvent (replacement.toRawUTF8(), replacement.getNumBytesAsUTF8());
+    }
+}
+
+//==============================================================================
+XmlElement* XmlPullParser::createElementFromCurrentEvent() const
+{
+    const auto name = getName().text;
+    auto* element = new XmlElement (name, name.findTerminatingNull());
+    LinkedListPointer<XmlElement::XmlAttributeNode>::Appender attributeAppender (element->attributes);
+
+    for (i32 i = 0; i < getNumAttributes(); ++i)
+    {
+        const auto attributeName = getAttributeName (i).text;
+        auto* attribute = new XmlElement::XmlAttributeNode (attributeName, attributeName.findTerminatingNull());
+        attribute->value = Txt (getAttributeValue (i).text);
+        attributeAppender.append (attribute);
+    }
+
+    return element;
+}
+
+std::unique_ptr<XmlElement> XmlPullParser::readElement()
+{
+    // This must be called when the parser has just read a start tag!
+    jassert (currentEvent == startElement);
+
+    if (currentEvent != startElement)
+        return {};
+
+    const auto outerDepth = getDepth();
+    std::unique_ptr<XmlElement> result (createElementFromCurrentEvent());
+
+    using Appender = LinkedListPointer<XmlElement>::Appender;
+    std::vector<std::unique_ptr<Appender>> childAppenders;
+    childAppenders.push_back (std::make_unique<Appender> (result->firstChildElement));
+
+    for (;;)
+    {
+        switch (next())
+        {
+            case startElement:
+            {
+                auto* element = createElementFromCurrentEvent();
+                childAppenders.back()->append (element);
+                childAppenders.push_back (std::make_unique<Appender> (element->firstChildElement));
+                break;
+            }
+
+            case endElement:
+                if (getDepth() < outerDepth)
+                    return result;
+
+                childAppenders.pop_back();
+                break;
+
+            case text:
+                childAppenders.back()->append (XmlElement::createTextElement (Txt (getText().text)));
+                break;
+
+            case endOfDocument:
+            case error:
+            default:
+                return {};
+        }
+    }
+}
+
+//==============================================================================
+//==============================================================================
+#if DRX_UNIT_TESTS
+
+class XmlPullParserTests final : public UnitTest
+{
+public:
+    XmlPullParserTests()
+        : UnitTest ("XmlPullParser", UnitTestCategories::xml)
+    {}
+
+    // Hands out the data a few bytes at a time, to exercise the parser's buffer refilling
+    struct TrickleStream final : public InputStream
+    {
+        TrickleStream (const Txt& text, i32 maxBytesPerRead)
+            : data (text.toRawUTF8(), text.getNumBytesAsUTF8(), true), chunkSize (maxBytesPerRead) {}
+
+        z64 getTotalLength() override               { return data.getTotalLength(); }
+        b8 isExhausted() override                   { return data.isExhausted(); }
+        i32 read (uk dest, i32 maxBytes) override   { return data.read (dest, jmin (maxBytes, chunkSize)); }
+        z64 getPosition() override                  { return data.getPosition(); }
+        b8 setPosition (z64 pos) override           { return data.setPosition (pos); }
+
+        MemoryInputStream data;
+        i32 chunkSize;
+    };
+
+    static Txt describeEvents (const Txt& xml, i32 chunkSize = 65536)
+    {
+        TrickleStream stream (xml, chunkSize);
+        XmlPullParser parser (stream);
+        Txt result;
+
+        for (;;)
+        {
+            switch (parser.next())
+            {
+                case XmlPullParser::startElement:
+                    result << "<" << parser.getName();
+
+                    for (i32 i = 0; i < parser.getNumAttributes(); ++i)
+                        result << " " << parser.getAttributeName (i) << "=" << parser.getAttributeValue (i);
+
+                    result << ">";
+                    break;
+
+                case XmlPullParser::endElement:  result << "</" << parser.getName() << ">"; break;
+                case XmlPullParser::text:        result << "[" << parser.getText() << "]"; break;
+                case XmlPullParser::error:       return result + "!" + parser.getLastError();
+                case XmlPullParser::endOfDocument:
+                default:                         return result;
+            }
+        }
+    }
+
+    z0 expectEvents (const Txt& xml, const Txt& expectedEvents)
+    {
+        expectEquals (describeEvents (xml), expectedEvents);
+    }
+
+    static Txt createRandomXml (Random& r, i32 depth)
+    {
+        XmlElement root ("ROOT");
+        addRandomChildren (r, root, depth);
+        return root.toString();
+    }
+
+    static z0 addRandomChildren (Random& r, XmlElement& parent, i32 depth)
+    {
+        for (i32 i = r.nextInt (6); --i >= 0;)
+        {
+            if (r.nextInt (4) == 0)
+            {
+                parent.addTextElement (Txt ("text & <stuff> ") + Txt (r.nextInt()) + " \xe2\x82\xac");
+                continue;
+            }
+
+            auto* child = parent.createNewChildElement ("E" + Txt (r.nextInt (20)));
+
+            for (i32 j = r.nextInt (4); --j >= 0;)
+                child->setAttribute ("a" + Txt (j), Txt ("\"value\" ") + Txt (r.nextInt64()));
+
+            if (depth > 0)
+                addRandomChildren (r, *child, depth - 1);
+        }
+    }
+
+    z0 runTest() override
+    {
+        beginTest ("Events");
+        {
+            expectEvents ("<?xml version=\"1.0\"?>\n<!-- hello -->\n<!DOCTYPE a [ <!ENTITY x \"y\"> ]>\n"
+                          "<a x='1' y = \"two\"><b/>  <c>text</c><?pi?><!-- c --><d z=\"\"></d></a>",
+                          "<a x=1 y=two><b></b><c>[text]</c><d z=></d></a>");
+
+            expectEvents ("<a>one<!-- x -->two</a>", "<a>[onetwo]</a>");
+            expectEvents ("<a>x\r\ny\rz</a>", "<a>[x\ny\nz]</a>");
+            expectEvents ("<a><![CDATA[<not> &amp; a tag]]></a>", "<a>[<not> &amp; a tag]</a>");
+            expectEvents ("< a\n></a >", "<a></a>");
+            expectEvents ("", "");
+            expectEvents ("<a/><b/>", "<a></a>");
+        }
+
+        beginTest ("Entities");
+        {
+            expectEvents ("<a v=\"&lt;&amp;&gt;\">&quot;&apos;&#65;&#x42;&#x20ac; &AMP;</a>",
+                          Txt (CharPointer_UTF8 ("<a v=<&>>[\"'AB\xe2\x82\xac &]</a>")));
+            expectEvents ("<a>&unknown; & &#xzz;</a>", "<a>[unknown & &#xzz;]</a>");
+
+            MemoryInputStream stream ("<a>&name;</a>", 13, false);
+            XmlPullParser parser (stream);
+            parser.setEntityResolver ([] (StringRef entityName) { return Txt (entityName).toUpperCase(); });
+            parser.next();
+            parser.next();
+            expectEquals (Txt (parser.getText()), Txt ("NAME"));
+        }
+
+        beginTest ("Whitespace");
+        {
+            MemoryInputStream stream ("<a> <b/>\n</a>", 13, false);
+            XmlPullParser parser (stream);
+            parser.setEmptyTextElementsIgnored (false);
+            Txt types;
+
+            while (parser.next() != XmlPullParser::endOfDocument)
+                types << (i32) parser.getEventType();
+
+            expectEquals (types, Txt ("020121"));
+        }
+
+        beginTest ("Errors");
+        {
+            expectEvents ("<a><b></a>", "<a><b></b>!unmatched tags");
+            expectEvents ("<a>text", "<a>!unmatched tags");
+            expectEvents ("<a x></a>", "!expected '=' after attribute 'x'");
+            expectEvents ("<a x=\"1></a>", "!unmatched quotes");
+            expectEvents ("<a $></a>", "!illegal character found in a: '$'");
+            expectEvents ("<></>", "!tag name missing");
+            expectEvents ("<a><!-- x</a>", "<a>!unterminated comment");
+            expectEvents ("<a><![CDATA[ x</a>", "<a>!unterminated CDATA section");
+            expectEvents ("hello", "!expected '<'");
+        }
+
+        beginTest ("readElement matches XmlDocument");
+        {
+            auto r = getRandom();
+
+            for (i32 i = 0; i < 30; ++i)
+            {
+                const auto xml = createRandomXml (r, 4);
+                const auto expected = XmlDocument::parse (xml);
+                expect (expected != nullptr);
+
+                for (auto chunkSize : { 1, 3, 17, 65536 })
+                {
+                    TrickleStream stream (xml, chunkSize);
+                    const auto parsed = XmlDocument::parse (stream);
+                    expect (parsed != nullptr);
+
+                    if (parsed != nullptr && expected != nullptr)
+                        expect (parsed->isEquivalentTo (expected.get(), false));
+
+                    expectEquals (describeEvents (xml, chunkSize), describeEvents (xml));
+                }
+            }
+        }
+
+        beginTest ("readElement on a sub-element");
+        {
+            MemoryInputStream stream ("<list><item id=\"1\"><x/></item><item id=\"2\">hi</item></list>", 60, false);
+            XmlPullParser parser (stream);
+            Txt ids;
+
+            while (parser.next() != XmlPullParser::endOfDocument)
+            {
+                if (parser.getEventType() == XmlPullParser::startElement && parser.getName() == StringRef ("item"))
+                {
+                    auto item = parser.readElement();
+                    ids << item->getStringAttribute ("id") << item->getNumChildElements();
+                    expectEquals (parser.getDepth(), 1);
+                }
+            }
+
+            expectEquals (ids, Txt ("1121"));
+        }
+
+        beginTest ("UTF-16 input");
+        {
+            MemoryOutputStream data;
+            data.writeText (Txt (CharPointer_UTF8 ("<a b=\"\xe2\x82\xac\">x</a>")), true, true, nullptr);
+            MemoryInputStream stream (data.getData(), data.getDataSize(), false);
+            auto element = XmlDocument::parse (stream);
+            expect (element != nullptr && element->getStringAttribute ("b") == Txt (CharPointer_UTF8 ("\xe2\x82\xac")));
+        }
+
+        beginTest ("Performance");
+        {
+            auto r = getRandom();
+            XmlElement root ("ROOT");
+
+            for (i32 i = 0; i < 20000; ++i)
+            {
+                auto* child = root.createNewChildElement ("ITEM");
+                child->setAttribute ("index", i);
+                child->setAttribute ("value", r.nextDouble());
+                child->addTextElement ("some text for item " + Txt (i));
+            }
+
+            const auto xml = root.toString();
+            const auto numBytes = (f64) xml.getNumBytesAsUTF8();
+
+            const auto timeIt = [&] (std::function<z0()> fn)
+            {
+                const auto start = Time::getMillisecondCounterHiRes();
+                fn();
+                return numBytes / (1000.0 * jmax (0.001, Time::getMillisecondCounterHiRes() - start));
+            };
+
+            const auto domRate = timeIt ([&] { expect (XmlDocument::parse (xml) != nullptr); });
+
+            const auto streamRate = timeIt ([&]
+            {
+                MemoryInputStream stream (xml.toRawUTF8(), xml.getNumBytesAsUTF8(), false);
+                expect (XmlDocument::parse (stream) != nullptr);
+            });
+
+            i32 numItems = 0;
+
+            const auto pullRate = timeIt ([&]
+            {
+                MemoryInputStream stream (xml.toRawUTF8(), xml.getNumBytesAsUTF8(), false);
+                XmlPullParser parser (stream);
+
+                while (parser.next() != XmlPullParser::endOfDocument)
+                    if (parser.getEventType() == XmlPullParser::startElement)
+                        ++numItems;
+            });
+
+            expectEquals (numItems, 20001);
+
+            logMessage ("XmlDocument::parse (Txt): " + Txt (domRate, 1) + " MB/s, "
+                        "XmlDocument::parse (InputStream): " + Txt (streamRate, 1) + " MB/s, "
+                        "XmlPullParser events: " + Txt (pullRate, 1) + " MB/s");
+        }
+    }
+};
+
+static XmlPullParserTests xmlPullParserTests;
+
+#endif
+
+} // namespace drx
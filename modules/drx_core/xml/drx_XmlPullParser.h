@@ -0,0 +1,209 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace drx
+{
+
+//==============================================================================
+/**
+    Reads XML from a stream one item at a time, without building a tree of
+    XmlElement objects.
+
+    Each call to next() moves on to the next start tag, end tag or block of text, and
+    the names, attributes and text of the current item can then be read as StringRefs.
+    Those refer to a buffer that gets reused, so they're only valid until next() is
+    called again. The stream is read in chunks, so the amount of memory needed
+    depends on the size of the largest single item rather than the size of the whole
+    document.
+
+    @code
+    FileInputStream in (presetLibrary);
+    XmlPullParser parser (in);
+
+    while (parser.next() == XmlPullParser::startElement)
+    {
+        if (parser.getDepth() == 2 && parser.getName() == StringRef ("PRESET"))
+        {
+            if (auto preset = parser.readElement())   // just this element and its children
+                loadPreset (*preset);
+        }
+    }
+    @endcode
+
+    The parser skips the XML header, comments, processing instructions and any DTD.
+    CDATA sections are returned as text. Standard and numeric character entities are
+    expanded, but entities declared in a DTD aren't: if you need those, use
+    setEntityResolver() or an XmlDocument instead.
+
+    @see XmlDocument, XmlElement
+
+    @tags{Core}
+*/
+class DRX_API  XmlPullParser
+{
+public:
+    //==============================================================================
+    /** Creates a parser that reads from a stream.
+        The stream must stay valid for the lifetime of the parser.
+    */
+    explicit XmlPullParser (InputStream& source);
+
+    /** Creates a parser that reads from a stream, and takes ownership of it. */
+    explicit XmlPullParser (std::unique_ptr<InputStream> source);
+
+    /** Destructor. */
+    ~XmlPullParser();
+
+    //==============================================================================
+    /** The kinds of item that the parser can find. */
+    enum EventType
+    {
+        startElement,   ///< An opening tag. Its name and attributes are available.
+        endElement,     ///< A closing tag, or the end of an empty element like <foo/>.
+        text,           ///< A block of text or a CDATA section.
+        endOfDocument,  ///< The outer element has been closed, or the input has run out.
+        error           ///< The XML is malformed, see getLastError().
+    };
+
+    /** Moves on to the next item in the document, and returns its type.
+
+        Once this has returned endOfDocument or error, it'll carry on doing so.
+    */
+    EventType next();
+
+    /** Returns the type of the current item. */
+    EventType getEventType() const noexcept                 { return currentEvent; }
+
+    /** Returns the tag name of the current start or end element. */
+    StringRef getName() const noexcept;
+
+    /** Returns the content of the current text item, with any entities expanded. */
+    StringRef getText() const noexcept;
+
+    /** Returns the number of attributes of the current start element. */
+    i32 getNumAttributes() const noexcept                   { return (i32) attributes.size(); }
+
+    /** Returns the name of one of the current start element's attributes. */
+    StringRef getAttributeName (i32 index) const noexcept;
+
+    /** Returns the value of one of the current start element's attributes. */
+    StringRef getAttributeValue (i32 index) const noexcept;
+
+    /** Returns the value of the current start element's attribute with the given name,
+        or an empty string if there isn't one.
+    */
+    StringRef getAttributeValue (StringRef attributeName) const noexcept;
+
+    /** Returns the number of elements that are currently open.
+        After the outer element's start tag, this will be 1.
+    */
+    i32 getDepth() const noexcept                           { return (i32) elementNameOffsets.size(); }
+
+    /** Returns a description of the problem if next() returned error. */
+    const Txt& getLastError() const noexcept                { return lastError; }
+
+    //==============================================================================
+    /** Reads the current start element and everything inside it into an XmlElement.
+
+        This must be called when the current event is startElement. When it returns,
+        the current event will be the matching endElement, so you can carry on calling
+        next() to read the rest of the document.
+
+        @returns    the new element, or nullptr if there was a parse error
+    */
+    std::unique_ptr<XmlElement> readElement();
+
+    //==============================================================================
+    /** Sets a flag to change the treatment of empty text elements.
+
+        If this is true (the default state), then any text elements that contain only
+        whitespace characters will be skipped, as they are by XmlDocument.
+    */
+    z0 setEmptyTextElementsIgnored (b8 shouldBeIgnored) noexcept    { ignoreEmptyText = shouldBeIgnored; }
+
+    /** Sets a function to provide the replacement text for any entities other than the
+        standard XML ones. It's given the entity's name without the '&' and ';'.
+
+        By default, an unknown entity is replaced by its name, as XmlDocument does.
+    */
+    z0 setEntityResolver (std::function<Txt (StringRef)> resolver)  { entityResolver = std::move (resolver); }
+
+private:
+    //==============================================================================
+    std::unique_ptr<InputStream> ownedStream;
+    InputStream* source;
+
+    HeapBlock<t8> inputBuffer;
+    size_t inputBufferSize = 0;
+    t8* inputPos = nullptr;
+    t8* inputEnd = nullptr;
+    b8 streamFinished = false, started = false, pendingEndOfEmptyElement = false;
+
+    EventType currentEvent = endOfDocument;
+    std::vector<t8> eventData;
+    size_t nameOffset = 0, textOffset = 0;
+    std::vector<std::pair<size_t, size_t>> attributes;
+
+    std::vector<t8> elementNames;
+    std::vector<size_t> elementNameOffsets;
+
+    b8 ignoreEmptyText = true;
+    std::function<Txt (StringRef)> entityResolver;
+    Txt lastError;
+
+    b8 fill (size_t numBytesNeeded);
+    t8 peek (size_t offset = 0);
+    b8 matches (tukk text);
+    z0 skipWhitespace();
+    b8 skipPast (tukk terminator, b8 keepSkippedText = false);
+    b8 skipDocType();
+    EventType setError (const Txt&);
+    EventType readStartElement();
+    EventType readEndElement();
+    b8 readText();
+    EventType readCData();
+    b8 readName();
+    b8 readAttributeValue();
+    z0 checkForUnicodeInput();
+    XmlElement* createElementFromCurrentEvent() const;
+    z0 readEntity();
+    z0 appendToEvent (const t8* data, size_t numBytes);
+    z0 startEvent() noexcept;
+    z0 popElement();
+    StringRef getEventString (size_t offset) const noexcept;
+
+    DRX_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (XmlPullParser)
+};
+
+} // namespace drx
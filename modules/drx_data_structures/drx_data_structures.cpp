@@ -46,6 +46,7 @@
 #include "values/drx_Value.cpp"
 #include "values/drx_ValueTree.cpp"
 #include "values/drx_ValueTreeSynchroniser.cpp"
+#include "values/drx_ValueTreeSnapshot.cpp"
 #include "values/drx_CachedValue.cpp"
 #include "undomanager/drx_UndoManager.cpp"
 #include "undomanager/drx_UndoableAction.cpp"
@@ -69,6 +69,7 @@
 #include "values/drx_Value.h"
 #include "values/drx_ValueTree.h"
 #include "values/drx_ValueTreeSynchroniser.h"
+#include "values/drx_ValueTreeSnapshot.h"
 #include "values/drx_CachedValue.h"
 #include "values/drx_ValueTreePropertyWithDefault.h"
 #include "app_properties/drx_PropertiesFile.h"
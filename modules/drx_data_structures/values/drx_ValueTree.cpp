@@ -1252,6 +1252,42 @@ public:
                 expectEquals (lines[numLines - 1], "<Test number=\"" + test.second + "\"/>");
             }
         }
+
+        {
+            beginTest ("Property lookup performance");
+
+            auto r = getRandom();
+
+            for (auto numProperties : { 10, 50, 200 })
+            {
+                ValueTree tree ("Node");
+                Array<Identifier> names;
+
+                for (i32 i = 0; i < numProperties; ++i)
+                {
+                    names.add (createRandomIdentifier (r) + Txt (i));
+                    tree.setProperty (names.getLast(), i, nullptr);
+                }
+
+                constexpr i32 numLookups = 1000000;
+                i64 total = 0;
+                const auto start = Time::getMillisecondCounterHiRes();
+
+                for (i32 i = 0; i < numLookups; ++i)
+                {
+                    const auto& propertyName = names.getReference (i % numProperties);
+
+                    if (tree.hasProperty (propertyName))
+                        total += (i64) (i32) tree[propertyName];
+                }
+
+                const auto elapsedMs = Time::getMillisecondCounterHiRes() - start;
+                expectEquals (total, (i64) numLookups / numProperties * (numProperties - 1) * numProperties / 2);
+
+                logMessage (Txt (numProperties) + " properties: "
+                             + Txt (elapsedMs * 1.0e6 / numLookups, 1) + " ns per hasProperty + getProperty");
+            }
+        }
     }
 };
 
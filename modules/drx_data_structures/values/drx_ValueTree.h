@@ -626,6 +626,7 @@ public:
 private:
     //==============================================================================
     friend class SharedObject;
+    friend class ValueTreeSnapshot;
 
     ReferenceCountedObjectPtr<SharedObject> object;
     ListenerList<Listener> listeners;
@@ -0,0 +1,703 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace drx
+{
+
+/*  The layout of a snapshot, with all numbers as little-endian u32s:
+
+    header:     magic, version, numIdentifiers, identifierTableOffset, rootNodeOffset, totalSize
+    nodes:      type, numProperties, numChildren, childOffsets[numChildren],
+                { name, valueOffset }[numProperties]
+    values:     a tag byte followed by the value, see writeValue()
+    identifier table: { numBytes, UTF-8 bytes }[numIdentifiers]
+
+    Identifiers are stored as indexes into the table. Each node is written after all of its
+    children and property values, so every offset a node refers to is smaller than its own,
+    which means a corrupt file can't make the reader loop.
+*/
+namespace ValueTreeSnapshotFormat
+{
+    static constexpr u32 magic = 0x31535456; // "VTS1"
+    static constexpr u32 version = 1;
+    static constexpr u32 headerSize = 24;
+    static constexpr u32 nodeHeaderSize = 12;
+
+    enum ValueTag : u8
+    {
+        voidValue, intValue, int64Value, doubleValue, trueValue, falseValue, stringValue, streamedValue
+    };
+}
+
+//==============================================================================
+struct ValueTreeSnapshotWriter
+{
+    MemoryOutputStream out;
+    std::unordered_map<ukk, u32> identifierIndexes;
+    Array<Identifier> identifierList;
+
+    z0 writeU32 (u32 value)
+    {
+        out.writeInt ((i32) value);
+    }
+
+    u32 getPosition() noexcept
+    {
+        return (u32) out.getPosition();
+    }
+
+    u32 getIdentifierIndex (const Identifier& id)
+    {
+        auto result = identifierIndexes.emplace (id.getCharPointer().getAddress(), (u32) identifierList.size());
+
+        if (result.second)
+            identifierList.add (id);
+
+        return result.first->second;
+    }
+
+    z0 writeValue (const var& v)
+    {
+        using namespace ValueTreeSnapshotFormat;
+
+        if (v.isVoid())
+        {
+            out.writeByte ((t8) voidValue);
+        }
+        else if (v.isBool())
+        {
+            out.writeByte ((t8) ((b8) v ? trueValue : falseValue));
+        }
+        else if (v.isInt())
+        {
+            out.writeByte ((t8) intValue);
+            out.writeInt ((i32) v);
+        }
+        else if (v.isInt64())
+        {
+            out.writeByte ((t8) int64Value);
+            out.writeInt64 ((z64) v);
+        }
+        else if (v.isDouble())
+        {
+            out.writeByte ((t8) doubleValue);
+            out.writeDouble ((f64) v);
+        }
+        else if (v.isString())
+        {
+            const auto s = v.toString();
+            const auto numBytes = s.getNumBytesAsUTF8();
+
+            out.writeByte ((t8) stringValue);
+            writeU32 ((u32) numBytes);
+            out.write (s.toRawUTF8(), numBytes);
+        }
+        else
+        {
+            // Arrays, binary data and anything else use var's own format
+            MemoryOutputStream streamed;
+            v.writeToStream (streamed);
+
+            out.writeByte ((t8) streamedValue);
+            writeU32 ((u32) streamed.getDataSize());
+            out << streamed;
+        }
+    }
+
+    u32 writeNode (const ValueTree& tree)
+    {
+        const auto numChildren = tree.getNumChildren();
+        const auto numProperties = tree.getNumProperties();
+
+        std::vector<u32> childOffsets;
+        childOffsets.reserve ((size_t) numChildren);
+
+        for (auto child : tree)
+            childOffsets.push_back (writeNode (child));
+
+        std::vector<u32> valueOffsets;
+        valueOffsets.reserve ((size_t) numProperties);
+
+        for (i32 i = 0; i < numProperties; ++i)
+        {
+            valueOffsets.push_back (getPosition());
+            writeValue (tree.getProperty (tree.getPropertyName (i)));
+        }
+
+        const auto nodeOffset = getPosition();
+        writeU32 (getIdentifierIndex (tree.getType()));
+        writeU32 ((u32) numProperties);
+        writeU32 ((u32) numChildren);
+
+        for (auto offset : childOffsets)
+            writeU32 (offset);
+
+        for (i32 i = 0; i < numProperties; ++i)
+        {
+            writeU32 (getIdentifierIndex (tree.getPropertyName (i)));
+            writeU32 (valueOffsets[(size_t) i]);
+        }
+
+        return nodeOffset;
+    }
+};
+
+b8 ValueTreeSnapshot::write (const ValueTree& tree, OutputStream& output)
+{
+    using namespace ValueTreeSnapshotFormat;
+
+    if (! tree.isValid())
+        return false;
+
+    ValueTreeSnapshotWriter writer;
+
+    // The header gets filled in once the offsets are known
+    for (u32 i = 0; i < headerSize / 4; ++i)
+        writer.writeU32 (0);
+
+    const auto rootOffset = writer.writeNode (tree);
+    const auto identifierTableOffset = writer.getPosition();
+
+    for (auto& id : writer.identifierList)
+    {
+        const auto numBytes = id.toString().getNumBytesAsUTF8();
+        writer.writeU32 ((u32) numBytes);
+        writer.out.write (id.toString().toRawUTF8(), numBytes);
+    }
+
+    const auto totalSize = writer.out.getPosition();
+
+    if (totalSize > (z64) std::numeric_limits<u32>::max())
+        return false;
+
+    writer.out.setPosition (0);
+
+    for (auto field : { magic, version, (u32) writer.identifierList.size(), identifierTableOffset, rootOffset, (u32) totalSize })
+        writer.writeU32 (field);
+
+    return output.write (writer.out.getData(), (size_t) totalSize);
+}
+
+//==============================================================================
+ValueTreeSnapshot::ValueTreeSnapshot() = default;
+ValueTreeSnapshot::~ValueTreeSnapshot() = default;
+
+ValueTreeSnapshot::ValueTreeSnapshot (const File& file)
+    : mappedFile (std::make_unique<MemoryMappedFile> (file, MemoryMappedFile::readOnly))
+{
+    if (mappedFile->getData() != nullptr)
+        open (mappedFile->getData(), mappedFile->getSize());
+}
+
+ValueTreeSnapshot::ValueTreeSnapshot (MemoryBlock block)
+    : ownedData (std::move (block))
+{
+    open (ownedData.getData(), ownedData.getSize());
+}
+
+u32 ValueTreeSnapshot::readU32 (size_t offset) const noexcept
+{
+    // Callers have already checked that the whole field is inside the data
+    jassert (offset + 4 <= dataSize);
+    return ByteOrder::littleEndianInt (data + offset);
+}
+
+z0 ValueTreeSnapshot::open (ukk newData, size_t newSize)
+{
+    using namespace ValueTreeSnapshotFormat;
+
+    data = static_cast<const u8*> (newData);
+    dataSize = newSize;
+
+    const auto fail = [this]
+    {
+        data = nullptr;
+        dataSize = 0;
+        identifiers.clear();
+    };
+
+    if (dataSize < headerSize || readU32 (0) != magic || readU32 (4) != version || readU32 (20) != dataSize)
+        return fail();
+
+    const auto numIdentifiers = readU32 (8);
+    auto pos = (size_t) readU32 (12);
+    rootOffset = readU32 (16);
+
+    if (pos > dataSize || numIdentifiers > (dataSize - pos) / 4)
+        return fail();
+
+    identifiers.ensureStorageAllocated ((i32) numIdentifiers);
+
+    for (u32 i = 0; i < numIdentifiers; ++i)
+    {
+        if (pos + 4 > dataSize)
+            return fail();
+
+        const auto numBytes = (size_t) readU32 (pos);
+        pos += 4;
+
+        if (numBytes == 0 || numBytes > dataSize - pos)
+            return fail();
+
+        const auto* name = reinterpret_cast<const t8*> (data + pos);
+        identifiers.add (Identifier (CharPointer_UTF8 (name), CharPointer_UTF8 (name + numBytes)));
+        pos += numBytes;
+    }
+
+    if (rootOffset < headerSize || ! isNodeInRange (rootOffset))
+        return fail();
+}
+
+b8 ValueTreeSnapshot::isNodeInRange (u32 offset) const noexcept
+{
+    using namespace ValueTreeSnapshotFormat;
+
+    if ((size_t) offset + nodeHeaderSize > dataSize)
+        return false;
+
+    const auto numProperties = (size_t) readU32 (offset + 4);
+    const auto numChildren = (size_t) readU32 (offset + 8);
+
+    return (numChildren + numProperties * 2) * 4 <= dataSize - offset - nodeHeaderSize;
+}
+
+var ValueTreeSnapshot::readValue (u32 offset) const
+{
+    using namespace ValueTreeSnapshotFormat;
+
+    if (offset >= dataSize)
+        return {};
+
+    const auto* p = data + offset + 1;
+    const auto available = dataSize - offset - 1;
+
+    switch (data[offset])
+    {
+        case trueValue:     return true;
+        case falseValue:    return false;
+        case intValue:      return available >= 4 ? var ((i32) ByteOrder::littleEndianInt (p)) : var();
+        case int64Value:    return available >= 8 ? var ((z64) ByteOrder::littleEndianInt64 (p)) : var();
+
+        case doubleValue:
+        {
+            if (available < 8)
+                return {};
+
+            const auto bits = ByteOrder::littleEndianInt64 (p);
+            f64 value;
+            memcpy (&value, &bits, sizeof (value));
+            return value;
+        }
+
+        case stringValue:
+        case streamedValue:
+        {
+            if (available < 4)
+                return {};
+
+            const auto numBytes = (size_t) ByteOrder::littleEndianInt (p);
+
+            if (numBytes > available - 4)
+                return {};
+
+            if (data[offset] == stringValue)
+                return Txt::fromUTF8 (reinterpret_cast<const t8*> (p + 4), (i32) numBytes);
+
+            MemoryInputStream in (p + 4, numBytes, false);
+            return var::readFromStream (in);
+        }
+
+        case voidValue:
+        default:
+            return {};
+    }
+}
+
+ValueTreeSnapshot::Node ValueTreeSnapshot::getRoot() const noexcept
+{
+    return isValid() ? Node (*this, rootOffset) : Node();
+}
+
+ValueTree ValueTreeSnapshot::createValueTree() const
+{
+    return getRoot().createValueTree();
+}
+
+ValueTree ValueTreeSnapshot::createValueTree (u32 nodeOffset) const
+{
+    const Node node (*this, nodeOffset);
+    const auto type = node.getType();
+
+    if (type.isNull())
+        return {};
+
+    ValueTree v (type);
+    auto& properties = v.object->properties;
+    const auto numProperties = node.getNumProperties();
+
+    for (i32 i = 0; i < numProperties; ++i)
+    {
+        const auto name = node.getPropertyName (i);
+
+        if (name.isValid())
+            properties.set (name, node.getProperty (i));
+    }
+
+    const auto numChildren = node.getNumChildren();
+    v.object->children.ensureStorageAllocated (numChildren);
+
+    for (i32 i = 0; i < numChildren; ++i)
+    {
+        const auto childOffset = node.read (ValueTreeSnapshotFormat::nodeHeaderSize + (u32) i * 4);
+
+        if (childOffset >= nodeOffset || ! isNodeInRange (childOffset))
+            continue;
+
+        auto child = createValueTree (childOffset);
+
+        if (child.isValid())
+        {
+            v.object->children.add (child.object);
+            child.object->parent = v.object.get();
+        }
+    }
+
+    return v;
+}
+
+//==============================================================================
+u32 ValueTreeSnapshot::Node::read (u32 fieldOffset) const noexcept
+{
+    return owner->readU32 ((size_t) offset + fieldOffset);
+}
+
+Identifier ValueTreeSnapshot::Node::getType() const
+{
+    return owner != nullptr ? owner->identifiers[(i32) read (0)] : Identifier();
+}
+
+b8 ValueTreeSnapshot::Node::hasType (const Identifier& typeName) const
+{
+    return getType() == typeName;
+}
+
+i32 ValueTreeSnapshot::Node::getNumProperties() const noexcept
+{
+    return owner != nullptr ? (i32) read (4) : 0;
+}
+
+i32 ValueTreeSnapshot::Node::getNumChildren() const noexcept
+{
+    return owner != nullptr ? (i32) read (8) : 0;
+}
+
+Identifier ValueTreeSnapshot::Node::getPropertyName (i32 index) const
+{
+    if (! isPositiveAndBelow (index, getNumProperties()))
+        return {};
+
+    return owner->identifiers[(i32) read (ValueTreeSnapshotFormat::nodeHeaderSize + (read (8) + (u32) index * 2) * 4)];
+}
+
+var ValueTreeSnapshot::Node::getProperty (i32 index) const
+{
+    if (! isPositiveAndBelow (index, getNumProperties()))
+        return {};
+
+    const auto valueOffset = read (ValueTreeSnapshotFormat::nodeHeaderSize + (read (8) + (u32) index * 2 + 1) * 4);
+    return valueOffset < offset ? owner->readValue (valueOffset) : var();
+}
+
+i32 ValueTreeSnapshot::Node::findProperty (const Identifier& name) const noexcept
+{
+    const auto numProperties = getNumProperties();
+
+    for (i32 i = 0; i < numProperties; ++i)
+    {
+        const auto nameIndex = (i32) read (ValueTreeSnapshotFormat::nodeHeaderSize + (read (8) + (u32) i * 2) * 4);
+
+        if (isPositiveAndBelow (nameIndex, owner->identifiers.size()) && owner->identifiers.getReference (nameIndex) == name)
+            return i;
+    }
+
+    return -1;
+}
+
+var ValueTreeSnapshot::Node::getProperty (const Identifier& name) const
+{
+    return getProperty (findProperty (name));
+}
+
+var ValueTreeSnapshot::Node::getProperty (const Identifier& name, const var& defaultReturnValue) const
+{
+    const auto index = findProperty (name);
+    return index >= 0 ? getProperty (index) : defaultReturnValue;
+}
+
+b8 ValueTreeSnapshot::Node::hasProperty (const Identifier& name) const noexcept
+{
+    return findProperty (name) >= 0;
+}
+
+ValueTreeSnapshot::Node ValueTreeSnapshot::Node::getChild (i32 index) const noexcept
+{
+    if (! isPositiveAndBelow (index, getNumChildren()))
+        return {};
+
+    const auto childOffset = read (ValueTreeSnapshotFormat::nodeHeaderSize + (u32) index * 4);
+
+    if (childOffset >= offset || ! owner->isNodeInRange (childOffset))
+        return {};
+
+    return Node (*owner, childOffset);
+}
+
+ValueTreeSnapshot::Node ValueTreeSnapshot::Node::getChildWithName (const Identifier& type) const
+{
+    for (auto child : *this)
+        if (child.hasType (type))
+            return child;
+
+    return {};
+}
+
+ValueTree ValueTreeSnapshot::Node::createValueTree() const
+{
+    return owner != nullptr ? owner->createValueTree (offset) : ValueTree();
+}
+
+ValueTreeSnapshot::Node ValueTreeSnapshot::Node::Iterator::operator*() const noexcept
+{
+    return owner != nullptr ? Node (*owner, offset).getChild (index) : Node();
+}
+
+//==============================================================================
+//==============================================================================
+#if DRX_UNIT_TESTS
+
+class ValueTreeSnapshotTests final : public UnitTest
+{
+public:
+    ValueTreeSnapshotTests()
+        : UnitTest ("ValueTreeSnapshot", UnitTestCategories::values)
+    {}
+
+    static MemoryBlock createSnapshotData (const ValueTree& tree)
+    {
+        MemoryOutputStream out;
+        ValueTreeSnapshot::write (tree, out);
+        return out.getMemoryBlock();
+    }
+
+    z0 expectNodeMatches (const ValueTreeSnapshot::Node& node, const ValueTree& tree)
+    {
+        expect (node.getType() == tree.getType());
+        expectEquals (node.getNumProperties(), tree.getNumProperties());
+        expectEquals (node.getNumChildren(), tree.getNumChildren());
+
+        for (i32 i = 0; i < tree.getNumProperties(); ++i)
+        {
+            const auto propertyName = tree.getPropertyName (i);
+            expect (node.getPropertyName (i) == propertyName);
+            expect (node.hasProperty (propertyName));
+            expect (node.getProperty (propertyName).equalsWithSameType (tree[propertyName]));
+        }
+
+        for (i32 i = 0; i < tree.getNumChildren(); ++i)
+            expectNodeMatches (node.getChild (i), tree.getChild (i));
+    }
+
+    static ValueTree createSessionTree (i32 numNodes)
+    {
+        ValueTree root ("SESSION");
+        root.setProperty ("name", "Benchmark session", nullptr);
+        ValueTree tracks ("TRACKS");
+        root.appendChild (tracks, nullptr);
+
+        for (i32 i = 0; i < numNodes / 10; ++i)
+        {
+            ValueTree track ("TRACK");
+            track.setProperty ("name", "Track " + Txt (i), nullptr);
+            track.setProperty ("colour", "ff" + Txt::toHexString (i * 12345), nullptr);
+            track.setProperty ("volume", i * 0.01, nullptr);
+            track.setProperty ("mute", (i % 3) == 0, nullptr);
+
+            for (i32 j = 0; j < 9; ++j)
+            {
+                ValueTree clip ("CLIP");
+                clip.setProperty ("id", i * 10 + j, nullptr);
+                clip.setProperty ("start", (f64) j * 4.0, nullptr);
+                clip.setProperty ("length", 4.0, nullptr);
+                clip.setProperty ("source", "audio/take_" + Txt (j) + ".wav", nullptr);
+                track.appendChild (clip, nullptr);
+            }
+
+            tracks.appendChild (track, nullptr);
+        }
+
+        return root;
+    }
+
+    z0 runTest() override
+    {
+        beginTest ("Round trip");
+        {
+            auto r = getRandom();
+
+            for (i32 i = 0; i < 20; ++i)
+            {
+                auto tree = ValueTreeTests::createRandomTree (nullptr, 0, r);
+                tree.setProperty ("int64", (z64) 0x123456789abcLL, nullptr);
+                tree.setProperty ("array", Array<var> { 1, "two", 3.0 }, nullptr);
+                tree.setProperty ("binary", var (MemoryBlock ("abc", 3)), nullptr);
+                tree.setProperty ("void", var(), nullptr);
+
+                ValueTreeSnapshot snapshot (createSnapshotData (tree));
+                expect (snapshot.isValid());
+
+                const auto restored = snapshot.createValueTree();
+                expect (restored.isEquivalentTo (tree));
+                expectNodeMatches (snapshot.getRoot(), tree);
+            }
+        }
+
+        beginTest ("Lazy access");
+        {
+            const auto tree = createSessionTree (200);
+            ValueTreeSnapshot snapshot (createSnapshotData (tree));
+            const auto tracks = snapshot.getRoot().getChildWithName ("TRACKS");
+
+            expect (tracks.isValid());
+            expect (! snapshot.getRoot().getChildWithName ("MISSING").isValid());
+            expect (! tracks.getChild (1000).isValid());
+            expectEquals ((i32) tracks.getChild (3).getChild (2).getProperty ("id"), 32);
+            expect (tracks.getChild (3).getProperty ("missing", 99) == var (99));
+
+            i32 numTracks = 0;
+
+            for (auto track : tracks)
+            {
+                expect (track.hasType ("TRACK"));
+                ++numTracks;
+            }
+
+            expectEquals (numTracks, 20);
+
+            const auto subtree = tracks.getChild (5).createValueTree();
+            expect (subtree.isEquivalentTo (tree.getChildWithName ("TRACKS").getChild (5)));
+            expect (! subtree.getParent().isValid());
+        }
+
+        beginTest ("Memory-mapped file");
+        {
+            const auto tree = createSessionTree (100);
+            TemporaryFile temp;
+
+            {
+                FileOutputStream out (temp.getFile());
+                expect (ValueTreeSnapshot::write (tree, out));
+            }
+
+            ValueTreeSnapshot snapshot (temp.getFile());
+            expect (snapshot.isValid());
+            expect (snapshot.createValueTree().isEquivalentTo (tree));
+
+            expect (! ValueTreeSnapshot (File()).isValid());
+        }
+
+        beginTest ("Corrupt data");
+        {
+            auto r = getRandom();
+            const auto data = createSnapshotData (createSessionTree (50));
+
+            expect (! ValueTreeSnapshot (MemoryBlock (data.getData(), data.getSize() - 1)).isValid());
+            expect (! ValueTreeSnapshot (MemoryBlock ("not a snapshot at all, honest", 29)).isValid());
+
+            for (i32 i = 0; i < 200; ++i)
+            {
+                auto damaged = data;
+                const auto position = (size_t) r.nextInt ((i32) damaged.getSize() - 24) + 24;
+                damaged[position] = (t8) r.nextInt (256);
+
+                // It doesn't matter what comes out, as long as it doesn't crash
+                ValueTreeSnapshot snapshot (std::move (damaged));
+                snapshot.createValueTree();
+            }
+        }
+
+        beginTest ("Performance");
+        {
+            const auto tree = createSessionTree (40000);
+
+            const auto xml = tree.toXmlString();
+
+            MemoryOutputStream binary;
+            tree.writeToStream (binary);
+
+            MemoryOutputStream snapshotData;
+            ValueTreeSnapshot::write (tree, snapshotData);
+
+            const auto timeIt = [] (std::function<z0()> fn)
+            {
+                const auto start = Time::getMillisecondCounterHiRes();
+                fn();
+                return Time::getMillisecondCounterHiRes() - start;
+            };
+
+            const auto xmlTime = timeIt ([&] { expect (ValueTree::fromXml (xml).isValid()); });
+            const auto binaryTime = timeIt ([&] { expect (ValueTree::readFromData (binary.getData(), binary.getDataSize()).isValid()); });
+
+            std::unique_ptr<ValueTreeSnapshot> snapshot;
+            const auto openTime = timeIt ([&] { snapshot = std::make_unique<ValueTreeSnapshot> (snapshotData.getMemoryBlock()); });
+            const auto fullTime = timeIt ([&] { expect (snapshot->createValueTree().isValid()); });
+            const auto lazyTime = timeIt ([&]
+            {
+                const auto track = snapshot->getRoot().getChildWithName ("TRACKS").getChild (2000);
+                expect (track.getChild (4).createValueTree().isValid());
+            });
+
+            logMessage ("40k nodes - XML: " + Txt (xmlTime, 1) + " ms (" + Txt (xml.getNumBytesAsUTF8() / 1024) + " KB), "
+                        "binary: " + Txt (binaryTime, 1) + " ms (" + Txt ((i32) binary.getDataSize() / 1024) + " KB), "
+                        "snapshot: open " + Txt (openTime, 2) + " ms + full tree " + Txt (fullTime, 1)
+                        + " ms (" + Txt ((i32) snapshotData.getDataSize() / 1024) + " KB), one subtree "
+                        + Txt (lazyTime, 3) + " ms");
+        }
+    }
+};
+
+static ValueTreeSnapshotTests valueTreeSnapshotTests;
+
+#endif
+
+} // namespace drx
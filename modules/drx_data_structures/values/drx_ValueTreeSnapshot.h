@@ -0,0 +1,197 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace drx
+{
+
+//==============================================================================
+/**
+    A compact binary snapshot of a ValueTree, which can be read without parsing it.
+
+    ValueTree::writeToStream() stores every property name as a string, and reading it
+    back has to rebuild the whole tree at once. A snapshot instead keeps a single table
+    of the identifiers that are used, and stores each node as a fixed-size record with
+    the offsets of its children and property values, so any node can be found directly.
+
+    When a snapshot is opened from a file, the file is memory-mapped and nothing is read
+    until it's needed. You can look around the tree through Node objects, which read
+    straight from the mapped data, and then turn just the parts you want into ValueTrees
+    with Node::createValueTree().
+
+    @code
+    ValueTreeSnapshot::write (sessionState, *sessionFile.createOutputStream());
+    ...
+    ValueTreeSnapshot snapshot (sessionFile);
+
+    for (auto track : snapshot.getRoot().getChildWithName ("TRACKS"))
+        if (track.getProperty ("selected"))
+            loadTrack (track.createValueTree());
+    @endcode
+
+    @see ValueTree
+    @tags{DataStructures}
+*/
+class DRX_API  ValueTreeSnapshot
+{
+public:
+    //==============================================================================
+    /** Creates an empty snapshot. */
+    ValueTreeSnapshot();
+
+    /** Memory-maps a file that was written with write().
+        If the file can't be opened or isn't a valid snapshot, isValid() will return false.
+    */
+    explicit ValueTreeSnapshot (const File& file);
+
+    /** Creates a snapshot from a block of data that was written with write().
+        The block is kept by the snapshot, so none of the tree data gets copied.
+    */
+    explicit ValueTreeSnapshot (MemoryBlock data);
+
+    /** Destructor. */
+    ~ValueTreeSnapshot();
+
+    //==============================================================================
+    /** Writes a tree to a stream in the snapshot format.
+        @returns false if the stream couldn't be written, or the tree is too large for
+                 the format's 32-bit offsets.
+    */
+    static b8 write (const ValueTree& tree, OutputStream& output);
+
+    /** Возвращает true, если the snapshot holds a valid tree. */
+    b8 isValid() const noexcept                     { return data != nullptr; }
+
+    //==============================================================================
+    /**
+        A read-only view of one node in a snapshot.
+
+        This reads directly from the snapshot's data, so it's cheap to create and copy,
+        but it must not be used after the ValueTreeSnapshot has been deleted.
+    */
+    class DRX_API  Node
+    {
+    public:
+        /** Creates an invalid node. */
+        Node() noexcept = default;
+
+        /** Возвращает true, если this refers to a node in a snapshot. */
+        b8 isValid() const noexcept                 { return owner != nullptr; }
+
+        /** Returns the node's type. */
+        Identifier getType() const;
+
+        /** Возвращает true, если the node has the given type. */
+        b8 hasType (const Identifier& typeName) const;
+
+        /** Returns the number of properties the node has. */
+        i32 getNumProperties() const noexcept;
+
+        /** Returns the name of one of the node's properties. */
+        Identifier getPropertyName (i32 index) const;
+
+        /** Returns the value of one of the node's properties. */
+        var getProperty (i32 index) const;
+
+        /** Returns the value of a named property, or a void var if it isn't there. */
+        var getProperty (const Identifier& name) const;
+
+        /** Returns the value of a named property, or a default value if it isn't there. */
+        var getProperty (const Identifier& name, const var& defaultReturnValue) const;
+
+        /** Возвращает true, если the node has a property with this name. */
+        b8 hasProperty (const Identifier& name) const noexcept;
+
+        /** Returns the number of child nodes. */
+        i32 getNumChildren() const noexcept;
+
+        /** Returns one of the child nodes, or an invalid node if the index is out of range. */
+        Node getChild (i32 index) const noexcept;
+
+        /** Returns the first child with the given type, or an invalid node if there isn't one. */
+        Node getChildWithName (const Identifier& type) const;
+
+        /** Builds a ValueTree containing this node and all of its children. */
+        ValueTree createValueTree() const;
+
+        /** Iterates the node's children. */
+        struct Iterator
+        {
+            Node operator*() const noexcept;
+            Iterator& operator++() noexcept                         { ++index; return *this; }
+            b8 operator!= (const Iterator& other) const noexcept    { return index != other.index; }
+
+            const ValueTreeSnapshot* owner;
+            u32 offset;
+            i32 index;
+        };
+
+        Iterator begin() const noexcept             { return { owner, offset, 0 }; }
+        Iterator end() const noexcept               { return { owner, offset, getNumChildren() }; }
+
+    private:
+        friend class ValueTreeSnapshot;
+        Node (const ValueTreeSnapshot& s, u32 nodeOffset) noexcept  : owner (&s), offset (nodeOffset) {}
+
+        u32 read (u32 fieldOffset) const noexcept;
+        i32 findProperty (const Identifier&) const noexcept;
+
+        const ValueTreeSnapshot* owner = nullptr;
+        u32 offset = 0;
+    };
+
+    /** Returns the root node, or an invalid node if the snapshot isn't valid. */
+    Node getRoot() const noexcept;
+
+    /** Builds the whole tree as a ValueTree. */
+    ValueTree createValueTree() const;
+
+private:
+    //==============================================================================
+    std::unique_ptr<MemoryMappedFile> mappedFile;
+    MemoryBlock ownedData;
+    const u8* data = nullptr;
+    size_t dataSize = 0;
+    u32 rootOffset = 0;
+    Array<Identifier> identifiers;
+
+    z0 open (ukk, size_t);
+    u32 readU32 (size_t offset) const noexcept;
+    b8 isNodeInRange (u32 offset) const noexcept;
+    var readValue (u32 offset) const;
+    ValueTree createValueTree (u32 nodeOffset) const;
+
+    DRX_DECLARE_NON_COPYABLE (ValueTreeSnapshot)
+};
+
+} // namespace drx
@@ -66,6 +66,7 @@
 #endif
 
 #include "processors/drx_FIRFilter.cpp"
+#include "processors/drx_FIRBlockFilter.cpp"
 #include "processors/drx_IIRFilter.cpp"
 #include "processors/drx_FirstOrderTPTFilter.cpp"
 #include "processors/drx_Panner.cpp"
@@ -109,11 +110,14 @@
 
  #if DRX_USE_SIMD
   #include "containers/drx_SIMDRegister_test.cpp"
+  #include "processors/drx_VoiceBankSynthesiser_test.cpp"
+  #include "processors/drx_IIRFilterBank_test.cpp"
  #endif
 
  #include "containers/drx_AudioBlock_test.cpp"
  #include "frequency/drx_Convolution_test.cpp"
  #include "frequency/drx_FFT_test.cpp"
  #include "processors/drx_FIRFilter_test.cpp"
+ #include "processors/drx_FIRBlockFilter_test.cpp"
  #include "processors/drx_ProcessorChain_test.cpp"
 #endif
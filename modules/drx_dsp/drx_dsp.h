@@ -266,6 +266,7 @@ namespace util
 #include "processors/drx_IIRFilter.h"
 #include "processors/drx_IIRFilter_Impl.h"
 #include "processors/drx_FIRFilter.h"
+#include "processors/drx_FIRBlockFilter.h"
 #include "processors/drx_StateVariableFilter.h"
 #include "processors/drx_FirstOrderTPTFilter.h"
 #include "processors/drx_Panner.h"
@@ -275,6 +276,12 @@ namespace util
 #include "processors/drx_LinkwitzRileyFilter.h"
 #include "processors/drx_DryWetMixer.h"
 #include "processors/drx_StateVariableTPTFilter.h"
+
+#if DRX_USE_SIMD
+ #include "processors/drx_VoiceBankSynthesiser.h"
+ #include "processors/drx_IIRFilterBank.h"
+#endif
+
 #include "frequency/drx_FFT.h"
 #include "frequency/drx_Convolution.h"
 #include "frequency/drx_Windowing.h"
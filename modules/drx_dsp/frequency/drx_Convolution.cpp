@@ -446,6 +446,324 @@ struct ConvolutionEngine
     std::vector<AudioBuffer<f32>> buffersInputSegments, buffersImpulseSegments;
 };
 
+//==============================================================================
+class ConvolutionLevel;
+
+// A few threads shared by all the Convolution instances in the process, which convolve the
+// blocks of the later levels of the non-uniform partitioning. When several blocks are
+// waiting, the one with the earliest deadline is done first.
+//
+// The threads are only started once a level needs them. Every Convolution holds a reference
+// to this object, so the last one is released (and the threads joined) on whichever thread
+// deletes the Convolution, never on the audio thread.
+class ConvolutionWorkers
+{
+public:
+    ConvolutionWorkers() = default;
+
+    ~ConvolutionWorkers()
+    {
+        for (auto& worker : workers)
+            worker->signalThreadShouldExit();
+
+        wakeUpSignal.signal ((i32) workers.size());
+
+        for (auto& worker : workers)
+            worker->stopThread (-1);
+    }
+
+    z0 addLevel (ConvolutionLevel& level)
+    {
+        const ScopedLock sl (lock);
+        levels.add (&level);
+
+        if (workers.empty())
+        {
+            const auto numThreads = jlimit (1, 4, SystemStats::getNumCpus() - 1);
+
+            for (i32 i = 0; i < numThreads; ++i)
+                workers.push_back (std::make_unique<Worker> (*this, i));
+
+            for (auto& worker : workers)
+                worker->startThread (Thread::Priority::highest);
+        }
+    }
+
+    z0 removeLevel (ConvolutionLevel& level)
+    {
+        const ScopedLock sl (lock);
+        levels.removeFirstMatchingValue (&level);
+    }
+
+    // Called on the audio thread after a block has been handed over. This doesn't take
+    // any locks: posting to the semaphore only enters the kernel if a worker is asleep.
+    z0 wakeUp() noexcept
+    {
+        if (claimSleepingWorker())
+            wakeUpSignal.signal();
+    }
+
+private:
+    class Worker final : public Thread
+    {
+    public:
+        Worker (ConvolutionWorkers& o, i32 index)
+            : Thread ("Convolution thread " + Txt (index + 1)), owner (o) {}
+
+        z0 run() override;
+
+    private:
+        ConvolutionWorkers& owner;
+    };
+
+    b8 runMostUrgentJob();
+
+    b8 claimSleepingWorker() noexcept
+    {
+        for (auto n = numSleeping.load(); n > 0;)
+            if (numSleeping.compare_exchange_weak (n, n - 1))
+                return true;
+
+        return false;
+    }
+
+    CriticalSection lock;
+    Array<ConvolutionLevel*> levels;
+    std::vector<std::unique_ptr<Worker>> workers;
+    Semaphore wakeUpSignal;
+    std::atomic<i32> numSleeping { 0 };
+
+    DRX_DECLARE_NON_COPYABLE (ConvolutionWorkers)
+};
+
+// One of the later levels of the non-uniform partitioning: a uniformly partitioned engine
+// with a bigger block size, for a later section of the impulse response.
+//
+// The input is collected one block at a time. When a block is complete it's convolved,
+// either straight away or on one of the worker threads, while the next block is being
+// collected, and the result is played back during the block after that. That adds two blocks
+// of delay, which are taken off the zeros in front of this section of the impulse response,
+// so a level can only start at least two of its blocks into the response.
+class ConvolutionLevel
+{
+public:
+    ConvolutionLevel (const AudioBuffer<f32>& ir, i32 numChannelsIn, i32 offset, i32 length,
+                      i32 blockSizeIn, i32 latency, f64 sampleRate, ConvolutionWorkers* workersToUse)
+        : numChannels (numChannelsIn),
+          blockSize (blockSizeIn),
+          blockDurationMs (1000.0 * blockSize / sampleRate),
+          workers (workersToUse)
+    {
+        const auto numZeros = offset + latency - 2 * blockSize;
+        jassert (numZeros >= 0);
+
+        AudioBuffer<f32> section (numChannels, numZeros + length);
+        section.clear();
+
+        for (i32 channel = 0; channel < numChannels; ++channel)
+        {
+            section.copyFrom (channel, numZeros, ir, jmin (ir.getNumChannels() - 1, channel), offset, length);
+
+            engines.push_back (std::make_unique<ConvolutionEngine> (section.getReadPointer (channel),
+                                                                    (size_t) section.getNumSamples(),
+                                                                    (size_t) blockSize));
+        }
+
+        for (auto* buffers : { &inputs, &outputs })
+            for (auto& buffer : *buffers)
+                buffer.setSize (numChannels, blockSize);
+
+        clearBuffers();
+
+        if (workers != nullptr)
+            workers->addLevel (*this);
+    }
+
+    ~ConvolutionLevel()
+    {
+        if (workers != nullptr)
+            workers->removeLevel (*this);
+
+        waitForJob();
+    }
+
+    z0 reset()
+    {
+        waitForJob();
+
+        for (auto& engine : engines)
+            engine->reset();
+
+        clearBuffers();
+    }
+
+    // Collects the input, and adds this level's output to the output buffers
+    z0 processSamples (const f32* const* input, f32* const* output, size_t numChannelsToProcess, size_t numSamples)
+    {
+        size_t numSamplesProcessed = 0;
+
+        while (numSamplesProcessed < numSamples)
+        {
+            const auto numThisTime = jmin (numSamples - numSamplesProcessed, (size_t) (blockSize - position));
+
+            for (size_t channel = 0; channel < numChannelsToProcess; ++channel)
+            {
+                FloatVectorOperations::copy (inputs[current].getWritePointer ((i32) channel, position),
+                                             input[channel] + numSamplesProcessed,
+                                             (i32) numThisTime);
+
+                FloatVectorOperations::add (output[channel] + numSamplesProcessed,
+                                            outputs[current].getReadPointer ((i32) channel, position),
+                                            (i32) numThisTime);
+            }
+
+            position += (i32) numThisTime;
+            numSamplesProcessed += numThisTime;
+
+            if (position == blockSize)
+            {
+                // The previous block's result is needed from now on. If no worker has
+                // started on it yet, this thread does it instead.
+                waitForJob();
+
+                jobSlot = current;
+                jobNumChannels = numChannelsToProcess;
+                current = 1 - current;
+                position = 0;
+
+                if (workers == nullptr)
+                {
+                    runJob();
+                }
+                else
+                {
+                    deadline = Time::getMillisecondCounterHiRes() + blockDurationMs;
+                    state = pending;
+                    workers->wakeUp();
+                }
+            }
+        }
+    }
+
+    // Called by a worker thread while it holds the workers' lock
+    b8 isPending() const noexcept          { return state.load() == pending; }
+    f64 getDeadline() const noexcept       { return deadline.load(); }
+
+    b8 tryToStartJob() noexcept
+    {
+        auto expected = pending;
+        return state.compare_exchange_strong (expected, running);
+    }
+
+    z0 runStartedJob() noexcept
+    {
+        runJob();
+        state = idle;
+
+        if (waitingForJob.exchange (false))
+            jobFinished.signal();
+    }
+
+private:
+    enum State { idle, pending, running };
+
+    z0 runJob() noexcept
+    {
+        // The input of the block that was handed over goes in, and the output that will be
+        // played back once the next block is complete comes out in the same slot.
+        for (size_t channel = 0; channel < jobNumChannels; ++channel)
+            engines[channel]->processSamples (inputs[jobSlot].getReadPointer ((i32) channel),
+                                              outputs[jobSlot].getWritePointer ((i32) channel),
+                                              (size_t) blockSize);
+    }
+
+    z0 waitForJob() noexcept
+    {
+        if (tryToStartJob())
+        {
+            runStartedJob();
+            return;
+        }
+
+        if (state.load() == idle)
+            return;
+
+        // A worker is still busy with the previous block, so its deadline has been missed and
+        // there's nothing to do but sleep until it's finished. Whichever side clears the flag
+        // first decides whether the worker will post to the semaphore.
+        waitingForJob = true;
+
+        if (state.load() != idle || ! waitingForJob.exchange (false))
+            jobFinished.wait (-1);
+    }
+
+    z0 clearBuffers()
+    {
+        for (auto* buffers : { &inputs, &outputs })
+            for (auto& buffer : *buffers)
+                buffer.clear();
+
+        current = 0;
+        position = 0;
+    }
+
+    const i32 numChannels, blockSize;
+    const f64 blockDurationMs;
+    ConvolutionWorkers* const workers;
+    std::vector<std::unique_ptr<ConvolutionEngine>> engines;
+
+    std::array<AudioBuffer<f32>, 2> inputs, outputs;
+    size_t current = 0, jobSlot = 0, jobNumChannels = 0;
+    i32 position = 0;
+
+    std::atomic<State> state { idle };
+    std::atomic<f64> deadline { 0.0 };
+    std::atomic<b8> waitingForJob { false };
+    Semaphore jobFinished;
+
+    DRX_DECLARE_NON_COPYABLE (ConvolutionLevel)
+};
+
+z0 ConvolutionWorkers::Worker::run()
+{
+    const ScopedNoDenormals noDenormals;
+
+    while (! threadShouldExit())
+    {
+        if (owner.runMostUrgentJob())
+            continue;
+
+        ++owner.numSleeping;
+
+        // The audio thread only wakes a worker if it sees one sleeping, so check again after
+        // being counted to avoid missing a block that was handed over in the meantime. If the
+        // audio thread has already claimed this worker, the semaphore will have been posted.
+        if (owner.runMostUrgentJob() && owner.claimSleepingWorker())
+            continue;
+
+        owner.wakeUpSignal.wait (-1);
+    }
+}
+
+b8 ConvolutionWorkers::runMostUrgentJob()
+{
+    ConvolutionLevel* job = nullptr;
+
+    {
+        const ScopedLock sl (lock);
+
+        for (auto* level : levels)
+            if (level->isPending() && (job == nullptr || level->getDeadline() < job->getDeadline()))
+                job = level;
+
+        if (job == nullptr || ! job->tryToStartJob())
+            return false;
+    }
+
+    job->runStartedJob();
+    return true;
+}
+
 //==============================================================================
 class MultichannelEngine
 {
@@ -454,15 +772,14 @@ public:
                         i32 maxBlockSize,
                         i32 maxBufferSize,
                         Convolution::NonUniform headSizeIn,
-                        b8 isZeroDelayIn)
-        : tailBuffer (1, maxBlockSize),
+                        b8 isZeroDelayIn,
+                        f64 sampleRate)
+        : levelBuffer (numChannels, maxBlockSize),
           latency (isZeroDelayIn ? 0 : maxBufferSize),
           irSize (buf.getNumSamples()),
           blockSize (maxBlockSize),
           isZeroDelay (isZeroDelayIn)
     {
-        constexpr auto numChannels = 2;
-
         const auto makeEngine = [&] (i32 channel, i32 offset, i32 length, u32 thisBlockSize)
         {
             return std::make_unique<ConvolutionEngine> (buf.getReadPointer (jmin (buf.getNumChannels() - 1, channel), offset),
@@ -474,64 +791,100 @@ public:
         {
             for (i32 i = 0; i < numChannels; ++i)
                 head.emplace_back (makeEngine (i, 0, buf.getNumSamples(), static_cast<u32> (maxBufferSize)));
+
+            return;
         }
-        else
+
+        const auto size = jmin (buf.getNumSamples(), jmax (minimumHeadSize, headSizeIn.headSizeInSamples));
+
+        for (i32 i = 0; i < numChannels; ++i)
+            head.emplace_back (makeEngine (i, 0, size, static_cast<u32> (maxBufferSize)));
+
+        // The rest of the impulse response is split into levels whose block sizes grow by a
+        // factor of four each time. Each level adds two of its blocks of delay, so it has to
+        // start at least that far into the response (once the head's latency is included),
+        // and it extends until the next level is allowed to start.
+        auto levelBlockSize = 1;
+
+        while (levelBlockSize * 4 <= size + latency)
+            levelBlockSize *= 2;
+
+        for (auto offset = size; offset < buf.getNumSamples();)
         {
-            const auto size = jmin (buf.getNumSamples(), headSizeIn.headSizeInSamples);
+            const auto nextBlockSize = jmin (levelBlockSize * 4, maximumLevelBlockSize);
+            const auto end = jmin (buf.getNumSamples(),
+                                   nextBlockSize == levelBlockSize ? buf.getNumSamples()
+                                                                   : jmax (offset + levelBlockSize, 2 * nextBlockSize - latency));
 
-            for (i32 i = 0; i < numChannels; ++i)
-                head.emplace_back (makeEngine (i, 0, size, static_cast<u32> (maxBufferSize)));
+            // Only the levels with blocks much longer than the audio callbacks are worth
+            // handing over to another thread, the others are convolved on the audio thread.
+            const auto useWorkers = levelBlockSize >= 4 * maxBlockSize;
 
-            const auto tailBufferSize = static_cast<u32> (headSizeIn.headSizeInSamples + (isZeroDelay ? 0 : maxBufferSize));
+            if (useWorkers && ! workers.has_value())
+                workers.emplace();
 
-            if (size != buf.getNumSamples())
-                for (i32 i = 0; i < numChannels; ++i)
-                    tail.emplace_back (makeEngine (i, size, buf.getNumSamples() - size, tailBufferSize));
+            levels.push_back (std::make_unique<ConvolutionLevel> (buf, numChannels, offset, end - offset,
+                                                                  levelBlockSize, latency, sampleRate,
+                                                                  useWorkers ? &workers->get() : nullptr));
+
+            offset = end;
+            levelBlockSize = nextBlockSize;
         }
     }
 
+    ~MultichannelEngine()
+    {
+        // The levels must unregister themselves before the workers can be released
+        levels.clear();
+    }
+
     z0 reset()
     {
         for (const auto& e : head)
             e->reset();
 
-        for (const auto& e : tail)
-            e->reset();
+        for (auto& level : levels)
+            level->reset();
     }
 
     z0 processSamples (const AudioBlock<const f32>& input, AudioBlock<f32>& output)
     {
-        const auto numChannels = jmin (head.size(), input.getNumChannels(), output.getNumChannels());
+        const auto numChannelsToProcess = jmin ((size_t) numChannels, input.getNumChannels(), output.getNumChannels());
         const auto numSamples  = jmin (input.getNumSamples(), output.getNumSamples());
 
-        const AudioBlock<f32> fullTailBlock (tailBuffer);
-        const auto tailBlock = fullTailBlock.getSubBlock (0, (size_t) numSamples);
+        std::array<const f32*, numChannels> inputChannels;
+        std::array<f32*, numChannels> outputChannels, levelChannels;
 
-        const auto isUniform = tail.empty();
+        for (size_t channel = 0; channel < numChannelsToProcess; ++channel)
+        {
+            inputChannels[channel]  = input.getChannelPointer (channel);
+            outputChannels[channel] = output.getChannelPointer (channel);
+            levelChannels[channel]  = levelBuffer.getWritePointer ((i32) channel);
+        }
 
-        for (size_t channel = 0; channel < numChannels; ++channel)
+        // The levels are processed first, as the input and output may be the same buffers
+        if (! levels.empty())
         {
-            if (! isUniform)
-                tail[channel]->processSamplesWithAddedLatency (input.getChannelPointer (channel),
-                                                               tailBlock.getChannelPointer (0),
-                                                               numSamples);
+            levelBuffer.clear();
+
+            for (auto& level : levels)
+                level->processSamples (inputChannels.data(), levelChannels.data(), numChannelsToProcess, numSamples);
+        }
 
+        for (size_t channel = 0; channel < numChannelsToProcess; ++channel)
+        {
             if (isZeroDelay)
-                head[channel]->processSamples (input.getChannelPointer (channel),
-                                               output.getChannelPointer (channel),
-                                               numSamples);
+                head[channel]->processSamples (inputChannels[channel], outputChannels[channel], numSamples);
             else
-                head[channel]->processSamplesWithAddedLatency (input.getChannelPointer (channel),
-                                                               output.getChannelPointer (channel),
-                                                               numSamples);
+                head[channel]->processSamplesWithAddedLatency (inputChannels[channel], outputChannels[channel], numSamples);
 
-            if (! isUniform)
-                output.getSingleChannelBlock (channel) += tailBlock;
+            if (! levels.empty())
+                FloatVectorOperations::add (outputChannels[channel], levelChannels[channel], (i32) numSamples);
         }
 
         const auto numOutputChannels = output.getNumChannels();
 
-        for (auto i = numChannels; i < numOutputChannels; ++i)
+        for (auto i = numChannelsToProcess; i < numOutputChannels; ++i)
             output.getSingleChannelBlock (i).copyFrom (output.getSingleChannelBlock (0));
     }
 
@@ -540,8 +893,14 @@ public:
     i32 getBlockSize() const noexcept  { return blockSize; }
 
 private:
-    std::vector<std::unique_ptr<ConvolutionEngine>> head, tail;
-    AudioBuffer<f32> tailBuffer;
+    static constexpr i32 numChannels = 2;
+    static constexpr i32 minimumHeadSize = 64;
+    static constexpr i32 maximumLevelBlockSize = 16384;
+
+    std::vector<std::unique_ptr<ConvolutionEngine>> head;
+    std::optional<SharedResourcePointer<ConvolutionWorkers>> workers;
+    std::vector<std::unique_ptr<ConvolutionLevel>> levels;
+    AudioBuffer<f32> levelBuffer;
 
     i32k latency;
     i32k irSize;
@@ -799,7 +1158,8 @@ private:
                                                      processSpec.maximumBlockSize,
                                                      maxBufferSize,
                                                      headSize,
-                                                     shouldBeZeroLatency);
+                                                     shouldBeZeroLatency,
+                                                     processSpec.sampleRate);
     }
 
     static AudioBuffer<f32> makeImpulseBuffer()
@@ -1055,8 +1415,9 @@ public:
     z0 processSamples (const AudioBlock<const f32>& input, AudioBlock<f32>& output)
     {
         engineQueue->postPendingCommand();
+        postPendingRelease();
 
-        if (previousEngine == nullptr)
+        if (previousEngine == nullptr && pendingRelease == nullptr)
             installPendingEngine();
 
         mixer.processSamples (input,
@@ -1110,9 +1471,25 @@ public:
 private:
     z0 destroyPreviousEngine()
     {
-        // If the queue is full, we'll destroy this straight away
-        BackgroundMessageQueue::IncomingCommand command = [p = std::move (previousEngine)]() mutable { p = nullptr; };
-        messageQueue->pimpl->push (command);
+        if (previousEngine == nullptr)
+            return;
+
+        // No new engine is installed while a release is pending, so there's only ever one
+        jassert (pendingRelease == nullptr);
+
+        pendingRelease = [p = std::move (previousEngine)]() mutable { p = nullptr; };
+        postPendingRelease();
+    }
+
+    // If the queue is full, the engine is held on to and posted again on the next block,
+    // rather than being destroyed on the audio thread.
+    z0 postPendingRelease()
+    {
+        if (pendingRelease == nullptr)
+            return;
+
+        if (messageQueue->pimpl->push (pendingRelease))
+            pendingRelease = nullptr;
     }
 
     z0 installNewEngine (std::unique_ptr<MultichannelEngine> newEngine)
@@ -1129,9 +1506,12 @@ private:
             installNewEngine (std::move (newEngine));
     }
 
+    // Declared first so that it's released last, after this object's engines
+    SharedResourcePointer<ConvolutionWorkers> workers;
     OptionalQueue messageQueue;
     std::shared_ptr<ConvolutionEngineQueue> engineQueue;
     std::unique_ptr<MultichannelEngine> previousEngine, currentEngine;
+    BackgroundMessageQueue::IncomingCommand pendingRelease;
     CrossoverMixer mixer;
 };
 
@@ -94,8 +94,9 @@ private:
     Note: The default operation of this class uses zero latency and a uniform
     partitioned algorithm. If the impulse response size is large, or if the
     algorithm is too CPU intensive, it is possible to use either a fixed
-    latency version of the algorithm, or a simple non-uniform partitioned
-    convolution algorithm.
+    latency version of the algorithm, or a non-uniform partitioned
+    convolution algorithm which moves most of the work for long impulse
+    responses off the audio thread.
 
     Threading: It is not safe to interleave calls to the methods of this
     class. If you need to load new impulse responses during processing the
@@ -147,8 +148,18 @@ public:
         efficiency of the processing for IR sizes of 4096 samples or greater
         (recommended for reverberation IRs).
 
-        @param requiredHeadSize       the head IR size for two stage non-uniform
-                                      partitioned convolution
+        The head of the IR is convolved with zero latency using the processing
+        block size. The rest of the IR is split into several levels whose block
+        sizes grow by a factor of four each time, up to 16384 samples. The
+        levels with blocks much longer than the processing block size are
+        convolved on a small pool of background threads shared by all the
+        Convolution objects, so that the audio thread only has to copy their
+        input and output. If a background thread falls behind, the audio
+        thread does the work itself, so the output is always correct.
+
+        @param requiredHeadSize       the size of the zero latency head of the
+                                      non-uniform partitioned convolution
+                                      (at least 64 samples are used)
      */
     explicit Convolution (const NonUniform& requiredHeadSize);
 
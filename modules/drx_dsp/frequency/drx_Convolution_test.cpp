@@ -555,6 +555,80 @@ public:
             }
         }
 
+        beginTest ("Long non-uniform convolutions work");
+        {
+            // Long enough to need several levels, including ones run on the worker threads
+            const auto ramp = makeRamp (static_cast<i32> (spec.maximumBlockSize) * 64);
+
+            for (const auto blockSize : { spec.maximumBlockSize, spec.maximumBlockSize / 4 })
+            {
+                for (const auto headSize : { 64, 300, 2048 })
+                {
+                    testConvolution ({ spec.sampleRate, blockSize, spec.numChannels },
+                                     Convolution::NonUniform { headSize },
+                                     ramp,
+                                     spec.sampleRate,
+                                     Convolution::Stereo::yes,
+                                     Convolution::Trim::no,
+                                     Convolution::Normalise::no,
+                                     ramp);
+                }
+            }
+        }
+
+        beginTest ("Non-uniform convolutions with long impulse responses are cheaper than uniform ones");
+        {
+            // Not a pass/fail test: this paces the processing in real time so that the worker
+            // threads get their chance, and logs the share of each block's duration spent on
+            // the audio thread.
+            constexpr auto sampleRate = 48000.0;
+            constexpr auto blockSize = 512;
+            constexpr auto numBlocks = 192;
+
+            AudioBuffer<f32> audio (2, blockSize);
+            AudioBlock<f32> audioBlock { audio };
+            Random random;
+
+            const auto measureLoad = [&] (const AudioBuffer<f32>& ir, i32 headSize)
+            {
+                MultichannelEngine engine (ir, blockSize, blockSize, Convolution::NonUniform { headSize }, true, sampleRate);
+
+                const auto blockDurationMs = 1000.0 * blockSize / sampleRate;
+                const auto start = Time::getMillisecondCounterHiRes();
+                auto timeProcessing = 0.0;
+
+                for (auto i = 0; i < numBlocks; ++i)
+                {
+                    for (auto channel = 0; channel < audio.getNumChannels(); ++channel)
+                        for (auto sample = 0; sample < blockSize; ++sample)
+                            audio.setSample (channel, sample, random.nextFloat() * 2.0f - 1.0f);
+
+                    const auto blockStart = Time::getMillisecondCounterHiRes();
+                    engine.processSamples (audioBlock, audioBlock);
+                    timeProcessing += Time::getMillisecondCounterHiRes() - blockStart;
+
+                    const auto due = start + (i + 1) * blockDurationMs;
+                    Thread::sleep (jmax (0, (i32) (due - Time::getMillisecondCounterHiRes())));
+                }
+
+                return 100.0 * timeProcessing / (numBlocks * blockDurationMs);
+            };
+
+            for (const auto seconds : { 1, 5, 10, 20 })
+            {
+                AudioBuffer<f32> ir (2, roundToInt (seconds * sampleRate));
+
+                for (auto channel = 0; channel < ir.getNumChannels(); ++channel)
+                    for (auto sample = 0; sample < ir.getNumSamples(); ++sample)
+                        ir.setSample (channel, sample, (random.nextFloat() * 2.0f - 1.0f)
+                                                          * std::exp (-5.0f * (f32) sample / (f32) ir.getNumSamples()));
+
+                logMessage (Txt (seconds) + " s impulse response, audio thread load: uniform "
+                            + Txt (measureLoad (ir, 0), 1) + "%, non-uniform "
+                            + Txt (measureLoad (ir, blockSize), 1) + "%");
+            }
+        }
+
         beginTest ("Convolutions with latency work");
         {
             const auto ramp = makeRamp (static_cast<i32> (spec.maximumBlockSize) * 8);
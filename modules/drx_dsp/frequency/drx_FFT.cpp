@@ -41,6 +41,12 @@ struct FFT::Instance
     virtual z0 perform (const Complex<f32>* input, Complex<f32>* output, b8 inverse) const noexcept = 0;
     virtual z0 performRealOnlyForwardTransform (f32*, b8) const noexcept = 0;
     virtual z0 performRealOnlyInverseTransform (f32*) const noexcept = 0;
+
+    // Engines that can do several transforms at once more quickly than one at a time
+    // override these and return true. Otherwise, FFT does the transforms one by one.
+    virtual b8 performBatch (const Complex<f32>*, Complex<f32>*, i32, i32, i32, b8) const noexcept  { return false; }
+    virtual b8 performRealOnlyForwardTransforms (f32* const*, i32, b8) const noexcept               { return false; }
+    virtual b8 performRealOnlyInverseTransforms (f32* const*, i32) const noexcept                     { return false; }
 };
 
 struct FFT::Engine
@@ -438,6 +444,678 @@ struct FFTFallback final : public FFT::Instance
 
 FFT::EngineImpl<FFTFallback> fftFallback;
 
+//==============================================================================
+//==============================================================================
+/*  A radix-4 Stockham autosort FFT, with a radix-2 stage at the end for odd orders.
+
+    The data is deinterleaved into separate real and imaginary arrays before it's
+    transformed, so that each butterfly can work on a whole SIMDRegister of neighbouring
+    values. The Stockham ordering swaps between two buffers on each stage, so there's
+    no bit-reversal pass.
+*/
+template <typename FloatType>
+struct StockhamTransform
+{
+    explicit StockhamTransform (i32 order)
+        : size (1 << order), paddedSize (getPaddedLength (size))
+    {
+        size_t numTwiddles = 0;
+
+        for (i32 n = size, stride = 1; n >= 4; n /= 4, stride *= 4)
+        {
+            stages.push_back ({ n / 4, stride, numTwiddles });
+            numTwiddles += 6 * getPaddedLength (n / 4);
+        }
+
+        hasRadix2Stage = (order & 1) != 0;
+
+        twiddleStorage.calloc (numTwiddles + alignmentPadding);
+        twiddles = getAligned (twiddleStorage.getData());
+
+        for (const auto& stage : stages)
+        {
+            auto* w = twiddles + stage.twiddleOffset;
+            const auto tableSize = getPaddedLength (stage.quarter);
+            const auto n = 4 * stage.quarter;
+
+            for (i32 p = 0; p < stage.quarter; ++p)
+            {
+                for (i32 k = 1; k <= 3; ++k)
+                {
+                    auto phase = -MathConstants<f64>::twoPi * (f64) (k * p) / (f64) n;
+
+                    w[(size_t) (2 * k - 2) * tableSize + (size_t) p] = (FloatType) std::cos (phase);
+                    w[(size_t) (2 * k - 1) * tableSize + (size_t) p] = (FloatType) std::sin (phase);
+                }
+            }
+        }
+    }
+
+    // The input and output may point to the same array.
+    z0 perform (const Complex<FloatType>* input, Complex<FloatType>* output, b8 inverse, FloatType scale) const noexcept
+    {
+        perform (input, output, 1, inverse, scale);
+    }
+
+    // Element i is read from input[i * stride], and written to output[i * stride].
+    z0 perform (const Complex<FloatType>* input, Complex<FloatType>* output, i32 stride, b8 inverse, FloatType scale) const noexcept
+    {
+        if (size == 1)
+        {
+            *output = *input * scale;
+            return;
+        }
+
+        withScratchSpace (4 * paddedSize, [&] (FloatType* scratch)
+        {
+            auto* xr = scratch;
+            auto* xi = xr + paddedSize;
+            auto* yr = xi + paddedSize;
+            auto* yi = yr + paddedSize;
+
+            for (i32 i = 0; i < size; ++i)
+            {
+                xr[i] = input[i * stride].real();
+                xi[i] = input[i * stride].imag();
+            }
+
+            for (const auto& stage : stages)
+            {
+                if (inverse)
+                    radix4Stage<true>  (stage, xr, xi, yr, yi);
+                else
+                    radix4Stage<false> (stage, xr, xi, yr, yi);
+
+                std::swap (xr, yr);
+                std::swap (xi, yi);
+            }
+
+            if (hasRadix2Stage)
+            {
+                radix2Stage (xr, xi, yr, yi);
+                std::swap (xr, yr);
+                std::swap (xi, yi);
+            }
+
+            for (i32 i = 0; i < size; ++i)
+                output[i * stride] = { xr[i] * scale, xi[i] * scale };
+        });
+    }
+
+    /*  Performs several transforms of the same size.
+
+        getInput (t) and getOutput (t) return the first element of transform t, and its other
+        elements are stride apart. Each input may be the same array as its output.
+
+        Groups of SIMDRegister::size() transforms are done together, with each lane of a
+        register holding a different transform, so every twiddle factor is loaded once per
+        group and every butterfly is vectorised. Any transforms left over, and transforms
+        too big for the scratch space on the stack, are done one at a time.
+    */
+    template <typename GetInput, typename GetOutput>
+    z0 performBatch (i32 numTransforms, GetInput&& getInput, GetOutput&& getOutput,
+                     i32 stride, b8 inverse, FloatType scale) const noexcept
+    {
+        i32 t = 0;
+
+       #if DRX_USE_SIMD
+        constexpr auto numLanes = (i32) Vec::SIMDNumElements;
+        const auto numScratchValues = 4 * (size_t) size * (size_t) numLanes;
+
+        if (size > 1
+             && numTransforms >= numLanes
+             && (numScratchValues + alignmentPadding) * sizeof (FloatType) < maxScratchSpaceToAlloca)
+        {
+            withScratchSpace (numScratchValues, [&] (FloatType* scratch)
+            {
+                for (; t + numLanes <= numTransforms; t += numLanes)
+                {
+                    const Complex<FloatType>* inputs[numLanes];
+                    Complex<FloatType>* outputs[numLanes];
+
+                    for (i32 lane = 0; lane < numLanes; ++lane)
+                    {
+                        inputs[lane] = getInput (t + lane);
+                        outputs[lane] = getOutput (t + lane);
+                    }
+
+                    performGroup (inputs, outputs, stride, inverse, scale, reinterpret_cast<Vec*> (scratch));
+                }
+            });
+        }
+       #endif
+
+        for (; t < numTransforms; ++t)
+            perform (getInput (t), getOutput (t), stride, inverse, scale);
+    }
+
+    i32 getSize() const noexcept      { return size; }
+
+private:
+    //==============================================================================
+    struct Stage
+    {
+        i32 quarter, stride;
+        size_t twiddleOffset;
+    };
+
+   #if DRX_USE_SIMD
+    using Vec = SIMDRegister<FloatType>;
+    static constexpr size_t alignment = Vec::SIMDRegisterSize;
+   #else
+    static constexpr size_t alignment = 16;
+   #endif
+
+    static constexpr size_t alignmentPadding = alignment / sizeof (FloatType);
+    static constexpr size_t maxScratchSpaceToAlloca = 256 * 1024;
+
+    static size_t getPaddedLength (i32 n) noexcept
+    {
+        return ((size_t) n + alignmentPadding - 1) & ~(alignmentPadding - 1);
+    }
+
+    static FloatType* getAligned (FloatType* p) noexcept
+    {
+        return snapPointerToAlignment (p, alignment);
+    }
+
+    template <typename Callback>
+    static z0 withScratchSpace (size_t numValues, Callback&& callback) noexcept
+    {
+        const auto numBytes = (numValues + alignmentPadding) * sizeof (FloatType);
+
+        if (numBytes < maxScratchSpaceToAlloca)
+        {
+            DRX_BEGIN_IGNORE_WARNINGS_MSVC (6255)
+            callback (getAligned (static_cast<FloatType*> (alloca (numBytes))));
+            DRX_END_IGNORE_WARNINGS_MSVC
+        }
+        else
+        {
+            HeapBlock<FloatType> heapSpace (numValues + alignmentPadding);
+            callback (getAligned (heapSpace.getData()));
+        }
+    }
+
+    //==============================================================================
+    // These work on scalars and on SIMDRegisters alike. The inverse transform uses the
+    // conjugate twiddles, and swaps the first and third outputs.
+    template <b8 conjugate, typename Value>
+    static forcedinline z0 multiply (Value xr, Value xi, Value wr, Value wi, Value& outR, Value& outI) noexcept
+    {
+        if constexpr (conjugate)
+        {
+            outR = xr * wr + xi * wi;
+            outI = xi * wr - xr * wi;
+        }
+        else
+        {
+            outR = xr * wr - xi * wi;
+            outI = xr * wi + xi * wr;
+        }
+    }
+
+    template <b8 inverse, typename Value>
+    static forcedinline z0 butterfly (const Value* in, const Value* w, Value* out) noexcept
+    {
+        const auto apcR = in[0] + in[4], apcI = in[1] + in[5];
+        const auto amcR = in[0] - in[4], amcI = in[1] - in[5];
+        const auto bpdR = in[2] + in[6], bpdI = in[3] + in[7];
+        const auto bmdR = in[2] - in[6], bmdI = in[3] - in[7];
+
+        // (a - c) - j (b - d) and (a - c) + j (b - d)
+        const auto minusR = amcR + bmdI, minusI = amcI - bmdR;
+        const auto plusR  = amcR - bmdI, plusI  = amcI + bmdR;
+
+        out[0] = apcR + bpdR;
+        out[1] = apcI + bpdI;
+
+        multiply<inverse> (inverse ? plusR : minusR, inverse ? plusI : minusI, w[0], w[1], out[2], out[3]);
+        multiply<inverse> (apcR - bpdR, apcI - bpdI, w[2], w[3], out[4], out[5]);
+        multiply<inverse> (inverse ? minusR : plusR, inverse ? minusI : plusI, w[4], w[5], out[6], out[7]);
+    }
+
+    template <b8 inverse>
+    z0 radix4Stage (const Stage& stage, const FloatType* xr, const FloatType* xi,
+                    FloatType* yr, FloatType* yi) const noexcept
+    {
+       #if DRX_USE_SIMD
+        const auto quarter = stage.quarter, stride = stage.stride;
+        const auto* tw = twiddles + stage.twiddleOffset;
+        const auto tableSize = getPaddedLength (quarter);
+        constexpr auto numLanes = (i32) Vec::SIMDNumElements;
+
+        // On the first stage each group of inputs is contiguous, but the outputs are four
+        // apart, so the results are transposed through a small buffer.
+        if (stride == 1 && quarter >= numLanes)
+        {
+            alignas (alignment) FloatType results[8 * numLanes];
+
+            for (i32 p = 0; p < quarter; p += numLanes)
+            {
+                Vec in[8], w[6], out[8];
+
+                for (i32 k = 0; k < 4; ++k)
+                {
+                    in[2 * k]     = Vec::fromRawArray (xr + p + k * quarter);
+                    in[2 * k + 1] = Vec::fromRawArray (xi + p + k * quarter);
+                }
+
+                for (size_t k = 0; k < 6; ++k)
+                    w[k] = Vec::fromRawArray (tw + k * tableSize + (size_t) p);
+
+                butterfly<inverse> (in, w, out);
+
+                for (i32 k = 0; k < 8; ++k)
+                    out[k].copyToRawArray (results + k * numLanes);
+
+                for (i32 lane = 0; lane < numLanes; ++lane)
+                {
+                    for (i32 k = 0; k < 4; ++k)
+                    {
+                        yr[4 * (p + lane) + k] = results[(2 * k) * numLanes + lane];
+                        yi[4 * (p + lane) + k] = results[(2 * k + 1) * numLanes + lane];
+                    }
+                }
+            }
+
+            return;
+        }
+       #endif
+
+       #if DRX_USE_SIMD
+        if (stride >= numLanes)
+        {
+            for (i32 p = 0; p < quarter; ++p)
+            {
+                Vec w[6];
+
+                for (size_t k = 0; k < 6; ++k)
+                    w[k] = Vec::expand (tw[k * tableSize + (size_t) p]);
+
+                const auto* inR = xr + stride * p;
+                const auto* inI = xi + stride * p;
+                auto* outR = yr + stride * 4 * p;
+                auto* outI = yi + stride * 4 * p;
+                const auto inStep = stride * quarter;
+
+                for (i32 q = 0; q < stride; q += numLanes)
+                {
+                    Vec in[8], out[8];
+
+                    for (i32 k = 0; k < 4; ++k)
+                    {
+                        in[2 * k]     = Vec::fromRawArray (inR + q + k * inStep);
+                        in[2 * k + 1] = Vec::fromRawArray (inI + q + k * inStep);
+                    }
+
+                    butterfly<inverse> (in, w, out);
+
+                    for (i32 k = 0; k < 4; ++k)
+                    {
+                        out[2 * k]    .copyToRawArray (outR + q + k * stride);
+                        out[2 * k + 1].copyToRawArray (outI + q + k * stride);
+                    }
+                }
+            }
+
+            return;
+        }
+       #endif
+
+        radix4Butterflies<inverse> (stage, xr, xi, yr, yi);
+    }
+
+    // A radix-4 stage where each Value holds one element of the signal, which is either a
+    // scalar, or a SIMDRegister holding the same element of several different signals.
+    template <b8 inverse, typename Value>
+    z0 radix4Butterflies (const Stage& stage, const Value* xr, const Value* xi, Value* yr, Value* yi) const noexcept
+    {
+        const auto quarter = stage.quarter, stride = stage.stride;
+        const auto* tw = twiddles + stage.twiddleOffset;
+        const auto tableSize = getPaddedLength (quarter);
+
+        for (i32 p = 0; p < quarter; ++p)
+        {
+            Value w[6];
+
+            for (size_t k = 0; k < 6; ++k)
+                w[k] = broadcast<Value> (tw[k * tableSize + (size_t) p]);
+
+            const auto* inR = xr + stride * p;
+            const auto* inI = xi + stride * p;
+            auto* outR = yr + stride * 4 * p;
+            auto* outI = yi + stride * 4 * p;
+            const auto inStep = stride * quarter;
+
+            for (i32 q = 0; q < stride; ++q)
+            {
+                Value in[8], out[8];
+
+                for (i32 k = 0; k < 4; ++k)
+                {
+                    in[2 * k]     = inR[q + k * inStep];
+                    in[2 * k + 1] = inI[q + k * inStep];
+                }
+
+                butterfly<inverse> (in, w, out);
+
+                for (i32 k = 0; k < 4; ++k)
+                {
+                    outR[q + k * stride] = out[2 * k];
+                    outI[q + k * stride] = out[2 * k + 1];
+                }
+            }
+        }
+    }
+
+    template <typename Value>
+    static Value broadcast (FloatType value) noexcept
+    {
+        if constexpr (std::is_same_v<Value, FloatType>)
+            return value;
+        else
+            return Value::expand (value);
+    }
+
+    z0 radix2Stage (const FloatType* xr, const FloatType* xi, FloatType* yr, FloatType* yi) const noexcept
+    {
+       #if DRX_USE_SIMD
+        const auto half = size / 2;
+        constexpr auto numLanes = (i32) Vec::SIMDNumElements;
+
+        if (half >= numLanes)
+        {
+            for (i32 i = 0; i < half; i += numLanes)
+            {
+                const auto ar = Vec::fromRawArray (xr + i), br = Vec::fromRawArray (xr + i + half);
+                const auto ai = Vec::fromRawArray (xi + i), bi = Vec::fromRawArray (xi + i + half);
+
+                (ar + br).copyToRawArray (yr + i);
+                (ai + bi).copyToRawArray (yi + i);
+                (ar - br).copyToRawArray (yr + i + half);
+                (ai - bi).copyToRawArray (yi + i + half);
+            }
+
+            return;
+        }
+       #endif
+
+        radix2Butterflies (xr, xi, yr, yi);
+    }
+
+    template <typename Value>
+    z0 radix2Butterflies (const Value* xr, const Value* xi, Value* yr, Value* yi) const noexcept
+    {
+        const auto half = size / 2;
+
+        for (i32 i = 0; i < half; ++i)
+        {
+            yr[i] = xr[i] + xr[i + half];
+            yi[i] = xi[i] + xi[i + half];
+            yr[i + half] = xr[i] - xr[i + half];
+            yi[i + half] = xi[i] - xi[i + half];
+        }
+    }
+
+   #if DRX_USE_SIMD
+    z0 performGroup (const Complex<FloatType>* const* inputs, Complex<FloatType>* const* outputs,
+                     i32 stride, b8 inverse, FloatType scale, Vec* scratch) const noexcept
+    {
+        constexpr auto numLanes = (i32) Vec::SIMDNumElements;
+
+        auto* xr = scratch;
+        auto* xi = xr + size;
+        auto* yr = xi + size;
+        auto* yi = yr + size;
+
+        alignas (alignment) FloatType re[numLanes], im[numLanes];
+
+        for (i32 i = 0; i < size; ++i)
+        {
+            for (i32 lane = 0; lane < numLanes; ++lane)
+            {
+                const auto c = inputs[lane][i * stride];
+                re[lane] = c.real();
+                im[lane] = c.imag();
+            }
+
+            xr[i] = Vec::fromRawArray (re);
+            xi[i] = Vec::fromRawArray (im);
+        }
+
+        for (const auto& stage : stages)
+        {
+            if (inverse)
+                radix4Butterflies<true>  (stage, xr, xi, yr, yi);
+            else
+                radix4Butterflies<false> (stage, xr, xi, yr, yi);
+
+            std::swap (xr, yr);
+            std::swap (xi, yi);
+        }
+
+        if (hasRadix2Stage)
+        {
+            radix2Butterflies (xr, xi, yr, yi);
+            std::swap (xr, yr);
+            std::swap (xi, yi);
+        }
+
+        const auto scaleFactor = Vec::expand (scale);
+
+        for (i32 i = 0; i < size; ++i)
+        {
+            (xr[i] * scaleFactor).copyToRawArray (re);
+            (xi[i] * scaleFactor).copyToRawArray (im);
+
+            for (i32 lane = 0; lane < numLanes; ++lane)
+                outputs[lane][i * stride] = { re[lane], im[lane] };
+        }
+    }
+   #endif
+
+    //==============================================================================
+    i32 size;
+    size_t paddedSize;
+    std::vector<Stage> stages;
+    b8 hasRadix2Stage = false;
+    HeapBlock<FloatType> twiddleStorage;
+    FloatType* twiddles = nullptr;
+
+    DRX_DECLARE_NON_COPYABLE (StockhamTransform)
+};
+
+//==============================================================================
+/*  Complex and real-only transforms of one size, built on StockhamTransform.
+
+    A real transform of size N is done as a complex transform of size N / 2 on the
+    even and odd samples packed together, followed by a pass that separates the two
+    spectra again.
+*/
+template <typename FloatType>
+struct StockhamEngine
+{
+    explicit StockhamEngine (i32 order)
+        : size (1 << order),
+          complexTransform (order),
+          halfSizeTransform (jmax (0, order - 1)),
+          realTwiddles ((size_t) (size / 4 + 1))
+    {
+        for (i32 k = 0; k <= size / 4; ++k)
+        {
+            auto phase = -MathConstants<f64>::twoPi * (f64) k / (f64) size;
+            realTwiddles[k] = { (FloatType) std::cos (phase), (FloatType) std::sin (phase) };
+        }
+    }
+
+    z0 perform (const Complex<FloatType>* input, Complex<FloatType>* output, b8 inverse) const noexcept
+    {
+        complexTransform.perform (input, output, inverse, inverse ? (FloatType) 1 / (FloatType) size : (FloatType) 1);
+    }
+
+    z0 performBatch (const Complex<FloatType>* input, Complex<FloatType>* output, i32 numTransforms,
+                     i32 stride, i32 distance, b8 inverse) const noexcept
+    {
+        complexTransform.performBatch (numTransforms,
+                                       [&] (i32 t) { return input + (std::ptrdiff_t) t * distance; },
+                                       [&] (i32 t) { return output + (std::ptrdiff_t) t * distance; },
+                                       stride, inverse, inverse ? (FloatType) 1 / (FloatType) size : (FloatType) 1);
+    }
+
+    z0 performRealOnlyForwardTransform (FloatType* d, b8 onlyCalculateNonNegativeFrequencies) const noexcept
+    {
+        performRealOnlyForwardTransforms (&d, 1, onlyCalculateNonNegativeFrequencies);
+    }
+
+    z0 performRealOnlyInverseTransform (FloatType* d) const noexcept
+    {
+        performRealOnlyInverseTransforms (&d, 1);
+    }
+
+    z0 performRealOnlyForwardTransforms (FloatType* const* data, i32 numTransforms,
+                                         b8 onlyCalculateNonNegativeFrequencies) const noexcept
+    {
+        if (size == 1)
+            return;
+
+        const auto getData = [data] (i32 t) { return reinterpret_cast<Complex<FloatType>*> (data[t]); };
+        halfSizeTransform.performBatch (numTransforms, getData, getData, 1, false, (FloatType) 1);
+
+        for (i32 t = 0; t < numTransforms; ++t)
+            separateRealSpectra (getData (t), onlyCalculateNonNegativeFrequencies);
+    }
+
+    z0 performRealOnlyInverseTransforms (FloatType* const* data, i32 numTransforms) const noexcept
+    {
+        if (size == 1)
+            return;
+
+        const auto getData = [data] (i32 t) { return reinterpret_cast<Complex<FloatType>*> (data[t]); };
+
+        for (i32 t = 0; t < numTransforms; ++t)
+            combineRealSpectra (getData (t));
+
+        halfSizeTransform.performBatch (numTransforms, getData, getData, 1, true, (FloatType) 2 / (FloatType) size);
+
+        for (i32 t = 0; t < numTransforms; ++t)
+            std::fill (data[t] + size, data[t] + 2 * size, (FloatType) 0);
+    }
+
+private:
+    // Turns the half-size transform of the packed even and odd samples into the first
+    // half of the real signal's spectrum.
+    z0 separateRealSpectra (Complex<FloatType>* x, b8 onlyCalculateNonNegativeFrequencies) const noexcept
+    {
+        using C = Complex<FloatType>;
+        const auto half = size / 2;
+        const FloatType oneHalf = (FloatType) 0.5;
+
+        const auto first = x[0];
+        x[0]    = { first.real() + first.imag(), 0 };
+        x[half] = { first.real() - first.imag(), 0 };
+
+        for (i32 k = 1; k <= half / 2; ++k)
+        {
+            const auto zk = x[k], zmk = std::conj (x[half - k]);
+            const auto even = (zk + zmk) * oneHalf;
+            const auto diff = (zk - zmk) * oneHalf;
+            const auto odd = realTwiddles[k] * C (diff.imag(), -diff.real());
+
+            x[k] = even + odd;
+            x[half - k] = std::conj (even - odd);
+        }
+
+        if (! onlyCalculateNonNegativeFrequencies)
+            for (i32 k = half + 1; k < size; ++k)
+                x[k] = std::conj (x[size - k]);
+    }
+
+    // The reverse of separateRealSpectra()
+    z0 combineRealSpectra (Complex<FloatType>* x) const noexcept
+    {
+        using C = Complex<FloatType>;
+        const auto half = size / 2;
+        const FloatType oneHalf = (FloatType) 0.5;
+
+        {
+            const auto x0 = x[0], xm = std::conj (x[half]);
+            const auto even = (x0 + xm) * oneHalf;
+            const auto odd = (x0 - xm) * oneHalf;
+            x[0] = { even.real() - odd.imag(), even.imag() + odd.real() };
+        }
+
+        for (i32 k = 1; k <= half / 2; ++k)
+        {
+            const auto xk = x[k], xmk = std::conj (x[half - k]);
+            const auto even = (xk + xmk) * oneHalf;
+            const auto odd = (xk - xmk) * std::conj (realTwiddles[k]) * oneHalf;
+            const auto jOdd = C (-odd.imag(), odd.real());
+
+            x[k] = even + jOdd;
+            x[half - k] = std::conj (even - jOdd);
+        }
+    }
+
+    i32 size;
+    StockhamTransform<FloatType> complexTransform, halfSizeTransform;
+    HeapBlock<Complex<FloatType>> realTwiddles;
+
+    DRX_DECLARE_NON_COPYABLE (StockhamEngine)
+};
+
+struct StockhamFFT final : public FFT::Instance
+{
+    // this is used when there's no platform FFT library, in preference to FFTFallback
+    static constexpr i32 priority = 0;
+
+    static StockhamFFT* create (i32 order)
+    {
+        return new StockhamFFT (order);
+    }
+
+    explicit StockhamFFT (i32 order) : engine (order) {}
+
+    z0 perform (const Complex<f32>* input, Complex<f32>* output, b8 inverse) const noexcept override
+    {
+        engine.perform (input, output, inverse);
+    }
+
+    z0 performRealOnlyForwardTransform (f32* d, b8 onlyCalculateNonNegativeFrequencies) const noexcept override
+    {
+        engine.performRealOnlyForwardTransform (d, onlyCalculateNonNegativeFrequencies);
+    }
+
+    z0 performRealOnlyInverseTransform (f32* d) const noexcept override
+    {
+        engine.performRealOnlyInverseTransform (d);
+    }
+
+    b8 performBatch (const Complex<f32>* input, Complex<f32>* output, i32 numTransforms,
+                       i32 stride, i32 distance, b8 inverse) const noexcept override
+    {
+        engine.performBatch (input, output, numTransforms, stride, distance, inverse);
+        return true;
+    }
+
+    b8 performRealOnlyForwardTransforms (f32* const* data, i32 numTransforms,
+                                           b8 onlyCalculateNonNegativeFrequencies) const noexcept override
+    {
+        engine.performRealOnlyForwardTransforms (data, numTransforms, onlyCalculateNonNegativeFrequencies);
+        return true;
+    }
+
+    b8 performRealOnlyInverseTransforms (f32* const* data, i32 numTransforms) const noexcept override
+    {
+        engine.performRealOnlyInverseTransforms (data, numTransforms);
+        return true;
+    }
+
+    StockhamEngine<f32> engine;
+};
+
+FFT::EngineImpl<StockhamFFT> stockhamFFT;
+
 //==============================================================================
 //==============================================================================
 #if (DRX_MAC || DRX_IOS) && DRX_USE_VDSP_FRAMEWORK
@@ -957,9 +1635,16 @@ FFT::EngineImpl<IntelPerformancePrimitivesFFT> intelPerformancePrimitivesFFT;
 #endif
 
 //==============================================================================
+// The tables are built in the FFT's constructor, so the f64 methods never allocate
+struct FFT::DoublePrecisionEngine final : public StockhamEngine<f64>
+{
+    using StockhamEngine<f64>::StockhamEngine;
+};
+
 //==============================================================================
-FFT::FFT (i32 order)
+FFT::FFT (i32 order, b8 withDoublePrecision)
     : engine (FFT::Engine::createBestEngineForPlatform (order)),
+      doubleEngine (withDoublePrecision ? std::make_unique<DoublePrecisionEngine> (order) : nullptr),
       size (1 << order)
 {
 }
@@ -988,20 +1673,117 @@ z0 FFT::performRealOnlyInverseTransform (f32* inputOutputData) const noexcept
         engine->performRealOnlyInverseTransform (inputOutputData);
 }
 
+z0 FFT::perform (const Complex<f64>* input, Complex<f64>* output, b8 inverse) const noexcept
+{
+    jassert (doubleEngine != nullptr); // create the FFT with withDoublePrecision set to use this
+
+    if (doubleEngine != nullptr)
+        doubleEngine->perform (input, output, inverse);
+}
+
+z0 FFT::performRealOnlyForwardTransform (f64* inputOutputData, b8 ignoreNegativeFreqs) const noexcept
+{
+    jassert (doubleEngine != nullptr);
+
+    if (doubleEngine != nullptr)
+        doubleEngine->performRealOnlyForwardTransform (inputOutputData, ignoreNegativeFreqs);
+}
+
+z0 FFT::performRealOnlyInverseTransform (f64* inputOutputData) const noexcept
+{
+    jassert (doubleEngine != nullptr);
+
+    if (doubleEngine != nullptr)
+        doubleEngine->performRealOnlyInverseTransform (inputOutputData);
+}
+
 z0 FFT::performFrequencyOnlyForwardTransform (f32* inputOutputData, b8 ignoreNegativeFreqs) const noexcept
+{
+    performFrequencyOnlyForwardTransforms (&inputOutputData, 1, ignoreNegativeFreqs);
+}
+
+//==============================================================================
+z0 FFT::performBatch (const Complex<f32>* input, Complex<f32>* output, i32 numTransforms,
+                        i32 stride, i32 distance, b8 inverse) const noexcept
+{
+    if (engine == nullptr || engine->performBatch (input, output, numTransforms, stride, distance, inverse))
+        return;
+
+    // The engine may not be able to work in place, so each transform is copied into
+    // some scratch space first
+    const auto doTransforms = [&] (Complex<f32>* scratch)
+    {
+        auto* transformed = scratch + size;
+
+        for (i32 t = 0; t < numTransforms; ++t)
+        {
+            const auto* in = input + (std::ptrdiff_t) t * distance;
+            auto* out = output + (std::ptrdiff_t) t * distance;
+
+            for (i32 i = 0; i < size; ++i)
+                scratch[i] = in[i * stride];
+
+            engine->perform (scratch, transformed, inverse);
+
+            for (i32 i = 0; i < size; ++i)
+                out[i * stride] = transformed[i];
+        }
+    };
+
+    const auto scratchSize = 2 * (size_t) size * sizeof (Complex<f32>);
+
+    if (scratchSize < 256 * 1024)
+    {
+        DRX_BEGIN_IGNORE_WARNINGS_MSVC (6255)
+        doTransforms (static_cast<Complex<f32>*> (alloca (scratchSize)));
+        DRX_END_IGNORE_WARNINGS_MSVC
+    }
+    else
+    {
+        HeapBlock<Complex<f32>> heapSpace (2 * (size_t) size);
+        doTransforms (heapSpace.getData());
+    }
+}
+
+z0 FFT::performRealOnlyForwardTransforms (f32* const* inputOutputData, i32 numTransforms,
+                                            b8 ignoreNegativeFreqs) const noexcept
+{
+    if (engine == nullptr || engine->performRealOnlyForwardTransforms (inputOutputData, numTransforms, ignoreNegativeFreqs))
+        return;
+
+    for (i32 t = 0; t < numTransforms; ++t)
+        engine->performRealOnlyForwardTransform (inputOutputData[t], ignoreNegativeFreqs);
+}
+
+z0 FFT::performRealOnlyInverseTransforms (f32* const* inputOutputData, i32 numTransforms) const noexcept
+{
+    if (engine == nullptr || engine->performRealOnlyInverseTransforms (inputOutputData, numTransforms))
+        return;
+
+    for (i32 t = 0; t < numTransforms; ++t)
+        engine->performRealOnlyInverseTransform (inputOutputData[t]);
+}
+
+z0 FFT::performFrequencyOnlyForwardTransforms (f32* const* inputOutputData, i32 numTransforms,
+                                                 b8 ignoreNegativeFreqs) const noexcept
 {
     if (size == 1)
         return;
 
-    performRealOnlyForwardTransform (inputOutputData, ignoreNegativeFreqs);
-    auto* out = reinterpret_cast<Complex<f32>*> (inputOutputData);
+    performRealOnlyForwardTransforms (inputOutputData, numTransforms, ignoreNegativeFreqs);
 
     const auto limit = ignoreNegativeFreqs ? (size / 2) + 1 : size;
 
-    for (i32 i = 0; i < limit; ++i)
-        inputOutputData[i] = std::abs (out[i]);
+    for (i32 t = 0; t < numTransforms; ++t)
+    {
+        auto* data = inputOutputData[t];
+        auto* out = reinterpret_cast<Complex<f32>*> (data);
 
-    zeromem (inputOutputData + limit, static_cast<size_t> (size * 2 - limit) * sizeof (f32));
+        for (i32 i = 0; i < limit; ++i)
+            data[i] = std::abs (out[i]);
+
+        zeromem (data + limit, static_cast<size_t> (size * 2 - limit) * sizeof (f32));
+    }
 }
 
 } // namespace drx::dsp
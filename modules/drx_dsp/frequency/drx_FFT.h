@@ -38,9 +38,9 @@ namespace drx::dsp
 /**
     Performs a fast fourier transform.
 
-    This is only a simple low-footprint implementation and isn't tuned for speed - it may
-    be useful for simple applications where one of the more complex FFT libraries would be
-    overkill. (But in the future it may end up becoming optimised of course...)
+    The transforms are done by the fastest engine available on the platform: Apple's vDSP,
+    Intel IPP or MKL, or FFTW, if they've been enabled. Otherwise DRX uses its own radix-4
+    Stockham engine, which is vectorised with SIMDRegister on SSE, AVX and NEON.
 
     The FFT class itself contains lookup tables, so there's some overhead in creating
     one, you should create and cache an FFT object for each size/direction of transform
@@ -54,8 +54,11 @@ public:
     //==============================================================================
     /** Initialises an object for performing forward and inverse FFT with the given size.
         The number of points the FFT will operate on will be 2 ^ order.
+
+        The double precision methods need their own set of tables, so they're only available
+        if withDoublePrecision is true.
     */
-    FFT (i32 order);
+    FFT (i32 order, b8 withDoublePrecision = false);
 
     /** Move constructor. */
     FFT (FFT&&) noexcept;
@@ -103,6 +106,29 @@ public:
     */
     z0 performRealOnlyInverseTransform (f32* inputOutputData) const noexcept;
 
+    //==============================================================================
+    /** Performs an out-of-place FFT on double precision data, either forward or inverse.
+        The arrays must contain at least getSize() elements.
+
+        The double precision methods always use DRX's built-in engine, whose tables are
+        allocated when the FFT is constructed. They do nothing unless the FFT was created
+        with withDoublePrecision set to true.
+    */
+    z0 perform (const Complex<f64>* input, Complex<f64>* output, b8 inverse) const noexcept;
+
+    /** Performs an in-place forward transform on a block of double precision real data.
+        This works in the same way as the single precision version.
+    */
+    z0 performRealOnlyForwardTransform (f64* inputOutputData,
+                                          b8 onlyCalculateNonNegativeFrequencies = false) const noexcept;
+
+    /** Performs a reverse operation to data created in performRealOnlyForwardTransform().
+        This works in the same way as the single precision version.
+    */
+    z0 performRealOnlyInverseTransform (f64* inputOutputData) const noexcept;
+
+    //==============================================================================
+
     /** Takes an array and simply transforms it to the magnitude frequency response
         spectrum. This may be handy for things like frequency displays or analysis.
         The size of the array passed in must be 2 * getSize().
@@ -114,6 +140,45 @@ public:
     z0 performFrequencyOnlyForwardTransform (f32* inputOutputData,
                                                b8 onlyCalculateNonNegativeFrequencies = false) const noexcept;
 
+    //==============================================================================
+    /** Performs several out-of-place FFTs of the same size at once, either forward or inverse.
+
+        Element i of transform t is read from input[t * distance + i * stride], and written to
+        the same place in the output array. So for a block of interleaved channels, the stride
+        is the number of channels and the distance is 1, and for transforms that follow each
+        other in memory, the stride is 1 and the distance is at least getSize().
+
+        The input and output may be the same array. DRX's built-in engine transforms a group
+        of channels with each SIMD lane holding a different channel, which is quicker than
+        transforming them one by one. Only whole groups are done that way, as a partly empty
+        group is slower than the single transforms, so a batch needs at least as many
+        transforms as there are values in a SIMDRegister to gain anything - a stereo pair
+        won't. Other engines just do one transform after another.
+    */
+    z0 performBatch (const Complex<f32>* input, Complex<f32>* output, i32 numTransforms,
+                     i32 stride, i32 distance, b8 inverse) const noexcept;
+
+    /** Performs performRealOnlyForwardTransform() on several arrays at once.
+        Each of the arrays must be 2 * getSize() long.
+        @see performBatch
+    */
+    z0 performRealOnlyForwardTransforms (f32* const* inputOutputData, i32 numTransforms,
+                                           b8 onlyCalculateNonNegativeFrequencies = false) const noexcept;
+
+    /** Performs performRealOnlyInverseTransform() on several arrays at once.
+        Each of the arrays must be 2 * getSize() long.
+        @see performBatch
+    */
+    z0 performRealOnlyInverseTransforms (f32* const* inputOutputData, i32 numTransforms) const noexcept;
+
+    /** Performs performFrequencyOnlyForwardTransform() on several arrays at once, which
+        is handy for analysing many channels.
+        Each of the arrays must be 2 * getSize() long.
+        @see performBatch
+    */
+    z0 performFrequencyOnlyForwardTransforms (f32* const* inputOutputData, i32 numTransforms,
+                                                b8 onlyCalculateNonNegativeFrequencies = false) const noexcept;
+
     /** Returns the number of data points that this FFT was created to work with. */
     i32 getSize() const noexcept            { return size; }
 
@@ -127,8 +192,10 @@ public:
 private:
     //==============================================================================
     struct Engine;
+    struct DoublePrecisionEngine;
 
     std::unique_ptr<Instance> engine;
+    std::unique_ptr<DoublePrecisionEngine> doubleEngine;
     i32 size;
 
     //==============================================================================
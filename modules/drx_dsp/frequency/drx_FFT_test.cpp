@@ -203,6 +203,324 @@ struct FFTUnitTest final : public UnitTest
         }
     };
 
+    struct DoublePrecisionTest
+    {
+        static z0 performReferenceFourier (const Complex<f64>* in, Complex<f64>* out, size_t n, b8 reverse)
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                Complex<f64> sum;
+
+                for (size_t j = 0; j < n; ++j)
+                    sum += in[j] * std::polar (1.0, (reverse ? 1.0 : -1.0) * MathConstants<f64>::twoPi
+                                                      * (f64) ((i * j) % n) / (f64) n);
+
+                out[i] = reverse ? sum / (f64) n : sum;
+            }
+        }
+
+        template <typename Type>
+        static f64 getMaxError (const Type* a, const Type* b, size_t n)
+        {
+            f64 maxError = 0;
+
+            for (size_t i = 0; i < n; ++i)
+                maxError = jmax (maxError, (f64) std::abs (a[i] - b[i]));
+
+            return maxError;
+        }
+
+        static z0 run (FFTUnitTest& u)
+        {
+            Random random (378272);
+
+            for (size_t order = 0; order <= 10; ++order)
+            {
+                auto n = (1u << order);
+                FFT fft ((i32) order, true);
+
+                std::vector<Complex<f64>> input (n), output (n), reference (n), inverse (n);
+
+                for (auto& c : input)
+                    c = { 2.0 * random.nextDouble() - 1.0, 2.0 * random.nextDouble() - 1.0 };
+
+                performReferenceFourier (input.data(), reference.data(), n, false);
+                fft.perform (input.data(), output.data(), false);
+                u.expectLessThan (getMaxError (output.data(), reference.data(), n), 1.0e-9);
+
+                fft.perform (output.data(), inverse.data(), true);
+                u.expectLessThan (getMaxError (inverse.data(), input.data(), n), 1.0e-12);
+
+                // real-only transforms, using the real parts of the same input
+                std::vector<f64> samples (n);
+                std::vector<Complex<f64>> realInput (n), realOutput (n);
+
+                for (size_t i = 0; i < n; ++i)
+                {
+                    samples[i] = input[i].real();
+                    realInput[i] = samples[i];
+                }
+
+                performReferenceFourier (realInput.data(), reference.data(), n, false);
+
+                std::copy (samples.begin(), samples.end(), reinterpret_cast<f64*> (realOutput.data()));
+                fft.performRealOnlyForwardTransform (reinterpret_cast<f64*> (realOutput.data()));
+                u.expectLessThan (getMaxError (realOutput.data(), reference.data(), n), 1.0e-9);
+
+                std::copy (samples.begin(), samples.end(), reinterpret_cast<f64*> (realOutput.data()));
+                fft.performRealOnlyForwardTransform (reinterpret_cast<f64*> (realOutput.data()), true);
+                u.expectLessThan (getMaxError (realOutput.data(), reference.data(), n / 2 + 1), 1.0e-9);
+
+                fft.performRealOnlyInverseTransform (reinterpret_cast<f64*> (realOutput.data()));
+                u.expectLessThan (getMaxError (reinterpret_cast<f64*> (realOutput.data()), samples.data(), n), 1.0e-12);
+            }
+        }
+    };
+
+    // Compares the built-in engine with the old fallback one, at sizes that are too big
+    // for the reference transform
+    struct StockhamEngineTest
+    {
+        static z0 run (FFTUnitTest& u)
+        {
+            Random random (378272);
+
+            for (i32 order = 0; order <= 16; ++order)
+            {
+                auto n = (size_t) 1 << order;
+
+                std::unique_ptr<FFT::Instance> stockham (StockhamFFT::create (order)),
+                                               fallback (FFTFallback::create (order));
+
+                HeapBlock<Complex<f32>> input (n), expected (n), output (n);
+                fillRandom (random, input.getData(), n);
+
+                // the errors grow with the size of the transform
+                auto tolerance = 1.0e-5 * std::sqrt ((f64) n) * (order + 1);
+
+                for (auto inverse : { false, true })
+                {
+                    fallback->perform (input, expected, inverse);
+                    stockham->perform (input, output, inverse);
+                    u.expectLessThan (DoublePrecisionTest::getMaxError (output.getData(), expected.getData(), n),
+                                      inverse ? tolerance / (f64) n : tolerance);
+                }
+
+                // the output may also be the input
+                memcpy (output.getData(), input.getData(), n * sizeof (Complex<f32>));
+                stockham->perform (output, output, false);
+                fallback->perform (input, expected, false);
+                u.expectLessThan (DoublePrecisionTest::getMaxError (output.getData(), expected.getData(), n), tolerance);
+
+                HeapBlock<f32> samples (n), realExpected (2 * n), realOutput (2 * n);
+                fillRandom (random, samples.getData(), n);
+
+                for (auto onlyNonNegative : { false, true })
+                {
+                    memcpy (realExpected.getData(), samples.getData(), n * sizeof (f32));
+                    memcpy (realOutput.getData(), samples.getData(), n * sizeof (f32));
+                    fallback->performRealOnlyForwardTransform (realExpected, onlyNonNegative);
+                    stockham->performRealOnlyForwardTransform (realOutput, onlyNonNegative);
+
+                    auto numValues = onlyNonNegative ? n + 2 : 2 * n;
+                    u.expectLessThan (DoublePrecisionTest::getMaxError (realOutput.getData(), realExpected.getData(),
+                                                                        jmin (numValues, 2 * n)), tolerance);
+                }
+
+                stockham->performRealOnlyInverseTransform (realOutput);
+                u.expectLessThan (DoublePrecisionTest::getMaxError (realOutput.getData(), samples.getData(), n), 1.0e-4);
+            }
+        }
+    };
+
+    struct BatchTest
+    {
+        static z0 run (FFTUnitTest& u)
+        {
+            Random random (378272);
+
+            for (i32 order = 0; order <= 10; ++order)
+            {
+                FFT fft (order);
+                const auto n = (size_t) fft.getSize();
+
+                for (auto numChannels : { 1, 3, 8, 13 })
+                {
+                    const auto numValues = n * (size_t) numChannels;
+
+                    // interleaved, then one channel after another with some padding between
+                    for (auto interleaved : { true, false })
+                    {
+                        const auto stride   = interleaved ? numChannels : 1;
+                        const auto distance = interleaved ? 1 : (i32) n + 3;
+                        const auto length   = interleaved ? numValues : (size_t) distance * (size_t) numChannels;
+
+                        for (auto inverse : { false, true })
+                        {
+                            HeapBlock<Complex<f32>> input (length), output (length), single (n), expected (n);
+                            fillRandom (random, input.getData(), length);
+
+                            fft.performBatch (input, output, numChannels, stride, distance, inverse);
+
+                            b8 allMatch = true;
+
+                            for (i32 t = 0; t < numChannels; ++t)
+                            {
+                                for (size_t i = 0; i < n; ++i)
+                                    single[i] = input[(size_t) (t * distance) + i * (size_t) stride];
+
+                                fft.perform (single, expected, inverse);
+
+                                for (size_t i = 0; i < n; ++i)
+                                    single[i] = output[(size_t) (t * distance) + i * (size_t) stride];
+
+                                allMatch = allMatch && checkArrayIsSimilar (single.getData(), expected.getData(), n);
+                            }
+
+                            u.expect (allMatch);
+
+                            // in place
+                            fft.performBatch (input, input, numChannels, stride, distance, inverse);
+
+                            for (i32 t = 0; t < numChannels; ++t)
+                                for (size_t i = 0; i < n; ++i)
+                                    allMatch = allMatch && input[(size_t) (t * distance) + i * (size_t) stride]
+                                                             == output[(size_t) (t * distance) + i * (size_t) stride];
+
+                            u.expect (allMatch);
+                        }
+                    }
+
+                    AudioBuffer<f32> batch (numChannels, 2 * (i32) n), expected (numChannels, 2 * (i32) n);
+
+                    for (i32 t = 0; t < numChannels; ++t)
+                    {
+                        fillRandom (random, batch.getWritePointer (t), n);
+                        FloatVectorOperations::fill (batch.getWritePointer (t, (i32) n), 0.0f, (i32) n);
+                    }
+
+                    expected.makeCopyOf (batch);
+
+                    fft.performRealOnlyForwardTransforms (batch.getArrayOfWritePointers(), numChannels);
+
+                    for (i32 t = 0; t < numChannels; ++t)
+                        fft.performRealOnlyForwardTransform (expected.getWritePointer (t));
+
+                    for (i32 t = 0; t < numChannels; ++t)
+                        u.expect (checkArrayIsSimilar (batch.getReadPointer (t), expected.getReadPointer (t), 2 * n));
+
+                    fft.performRealOnlyInverseTransforms (batch.getArrayOfWritePointers(), numChannels);
+
+                    for (i32 t = 0; t < numChannels; ++t)
+                        fft.performRealOnlyInverseTransform (expected.getWritePointer (t));
+
+                    for (i32 t = 0; t < numChannels; ++t)
+                        u.expect (checkArrayIsSimilar (batch.getReadPointer (t), expected.getReadPointer (t), n));
+                }
+            }
+        }
+    };
+
+    // Logs the speed of the built-in engine against the old fallback one
+    struct PerformanceTest
+    {
+        template <typename Callback>
+        static f64 getNanosecondsPerPoint (size_t n, Callback&& callback)
+        {
+            const auto numRuns = jmax ((size_t) 4, ((size_t) 1 << 21) / n);
+
+            callback();
+            const auto start = Time::getHighResolutionTicks();
+
+            for (size_t i = 0; i < numRuns; ++i)
+                callback();
+
+            return Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start)
+                     * 1.0e9 / (f64) (numRuns * n);
+        }
+
+        static z0 run (FFTUnitTest& u)
+        {
+            Random random (378272);
+
+            for (i32 order = 5; order <= 20; ++order)
+            {
+                auto n = (size_t) 1 << order;
+
+                std::unique_ptr<FFT::Instance> stockham (StockhamFFT::create (order)),
+                                               fallback (FFTFallback::create (order));
+                FFT fft (order);
+
+                HeapBlock<Complex<f32>> input (n), output (n);
+                HeapBlock<f32> real (2 * n);
+                fillRandom (random, input.getData(), n);
+                fillRandom (random, real.getData(), 2 * n);
+
+                auto complexTime = [&] (FFT::Instance& e) { return getNanosecondsPerPoint (n, [&] { e.perform (input, output, false); }); };
+                auto realTime    = [&] (FFT::Instance& e) { return getNanosecondsPerPoint (n, [&] { e.performRealOnlyForwardTransform (real, true); }); };
+
+                u.logMessage ("2^" + Txt (order) + " complex: stockham " + Txt (complexTime (*stockham), 2)
+                                + " ns/pt, fallback " + Txt (complexTime (*fallback), 2)
+                                + " ns/pt, default " + Txt (getNanosecondsPerPoint (n, [&] { fft.perform (input, output, false); }), 2)
+                                + " ns/pt; real: stockham " + Txt (realTime (*stockham), 2)
+                                + " ns/pt, fallback " + Txt (realTime (*fallback), 2) + " ns/pt");
+            }
+
+            // Batched transforms against one transform per channel
+            for (auto order : { 7, 9, 11 })
+            {
+                FFT fft (order);
+                const auto n = (size_t) fft.getSize();
+
+                for (auto numChannels : { 8, 32, 64 })
+                {
+                    const auto numValues = n * (size_t) numChannels;
+
+                    HeapBlock<Complex<f32>> input (numValues), output (numValues);
+                    fillRandom (random, input.getData(), numValues);
+
+                    AudioBuffer<f32> real (numChannels, 2 * (i32) n);
+
+                    for (i32 t = 0; t < numChannels; ++t)
+                        fillRandom (random, real.getWritePointer (t), 2 * n);
+
+                    const auto interleavedTime = getNanosecondsPerPoint (numValues, [&]
+                    {
+                        fft.performBatch (input, output, numChannels, numChannels, 1, false);
+                    });
+
+                    const auto batchTime = getNanosecondsPerPoint (numValues, [&]
+                    {
+                        fft.performBatch (input, output, numChannels, 1, (i32) n, false);
+                    });
+
+                    const auto separateTime = getNanosecondsPerPoint (numValues, [&]
+                    {
+                        for (i32 t = 0; t < numChannels; ++t)
+                            fft.perform (input + (size_t) t * n, output + (size_t) t * n, false);
+                    });
+
+                    const auto realBatchTime = getNanosecondsPerPoint (numValues, [&]
+                    {
+                        fft.performRealOnlyForwardTransforms (real.getArrayOfWritePointers(), numChannels, true);
+                    });
+
+                    const auto realSeparateTime = getNanosecondsPerPoint (numValues, [&]
+                    {
+                        for (i32 t = 0; t < numChannels; ++t)
+                            fft.performRealOnlyForwardTransform (real.getWritePointer (t), true);
+                    });
+
+                    u.logMessage ("2^" + Txt (order) + " x " + Txt (numChannels) + " channels: complex batch "
+                                    + Txt (batchTime, 2) + " ns/pt, interleaved " + Txt (interleavedTime, 2)
+                                    + " ns/pt, one at a time " + Txt (separateTime, 2)
+                                    + " ns/pt; real batch " + Txt (realBatchTime, 2)
+                                    + " ns/pt, one at a time " + Txt (realSeparateTime, 2) + " ns/pt");
+                }
+            }
+        }
+    };
+
     template <class TheTest>
     z0 runTestForAllTypes (tukk unitTestName)
     {
@@ -216,6 +534,10 @@ struct FFTUnitTest final : public UnitTest
         runTestForAllTypes<RealTest> ("Real input numbers Test");
         runTestForAllTypes<FrequencyOnlyTest> ("Frequency only Test");
         runTestForAllTypes<ComplexTest> ("Complex input numbers Test");
+        runTestForAllTypes<DoublePrecisionTest> ("Double precision Test");
+        runTestForAllTypes<StockhamEngineTest> ("Stockham engine Test");
+        runTestForAllTypes<BatchTest> ("Batched transforms Test");
+        runTestForAllTypes<PerformanceTest> ("Performance");
     }
 };
 
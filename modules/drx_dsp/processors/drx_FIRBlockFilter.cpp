@@ -0,0 +1,545 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace drx::dsp
+{
+
+//==============================================================================
+template <typename SampleType>
+struct FIR::BlockFilter<SampleType>::Engine
+{
+    virtual ~Engine() = default;
+
+    virtual z0 reset() noexcept = 0;
+
+    // Replaces the coefficients without touching the history. The number of coefficients
+    // must be the same as the ones the engine was created with.
+    virtual z0 setCoefficients (const Coefficients<SampleType>&) noexcept = 0;
+
+    // The number of input samples must be no more than the maximum block size. Returns
+    // the number of output samples written.
+    virtual size_t process (size_t channel, const SampleType* input, SampleType* output, size_t numInputSamples) noexcept = 0;
+};
+
+//==============================================================================
+template <typename SampleType>
+struct FIR::BlockFilter<SampleType>::DirectEngine final : public Engine
+{
+   #if DRX_USE_SIMD
+    using Vec = SIMDRegister<SampleType>;
+    static constexpr size_t numLanes = Vec::SIMDNumElements;
+   #else
+    static constexpr size_t numLanes = 1;
+   #endif
+
+    DirectEngine (const Coefficients<SampleType>& c, const ProcessSpec& spec)
+        : numTaps ((size_t) c.coefficients.size()),
+          paddedLength (roundUp (numTaps + numLanes - 1)),
+          historyLength (roundUp (numTaps - 1)),
+          channelLength (historyLength + roundUp ((size_t) spec.maximumBlockSize) + paddedLength),
+          numChannels (spec.numChannels)
+    {
+        // There's a reversed copy of the coefficients for each possible misalignment of the
+        // first input sample used by an output, so that both can be loaded from aligned
+        // addresses
+        kernelStorage.calloc (numLanes * paddedLength + numLanes);
+        kernels = getAligned (kernelStorage.get());
+        setCoefficients (c);
+
+        historyStorage.calloc (numChannels * channelLength + numLanes);
+        history = getAligned (historyStorage.get());
+    }
+
+    z0 reset() noexcept override
+    {
+        zeromem (history, sizeof (SampleType) * numChannels * channelLength);
+    }
+
+    z0 setCoefficients (const Coefficients<SampleType>& c) noexcept override
+    {
+        jassert ((size_t) c.coefficients.size() == numTaps);
+
+        for (size_t shift = 0; shift < numLanes; ++shift)
+            for (size_t j = 0; j < numTaps; ++j)
+                kernels[shift * paddedLength + shift + j] = c.coefficients[(i32) (numTaps - 1 - j)];
+    }
+
+    size_t process (size_t channel, const SampleType* input, SampleType* output, size_t numSamples) noexcept override
+    {
+        // Each channel's buffer holds the last numTaps - 1 input samples, followed by this
+        // block, which starts at an aligned address
+        auto* buffer = history + channel * channelLength;
+        FloatVectorOperations::copy (buffer + historyLength, input, numSamples);
+
+        for (size_t i = 0; i < numSamples; ++i)
+        {
+            const auto first = historyLength + i + 1 - numTaps;
+            const auto shift = first % numLanes;
+            const auto* samples = buffer + first - shift;
+            const auto* kernel = kernels + shift * paddedLength;
+
+           #if DRX_USE_SIMD
+            auto sum = Vec::expand (0);
+
+            for (size_t j = 0; j < paddedLength; j += numLanes)
+                sum = Vec::multiplyAdd (sum, Vec::fromRawArray (kernel + j), Vec::fromRawArray (samples + j));
+
+            output[i] = sum.sum();
+           #else
+            SampleType sum = 0;
+
+            for (size_t j = 0; j < paddedLength; ++j)
+                sum += kernel[j] * samples[j];
+
+            output[i] = sum;
+           #endif
+        }
+
+        std::copy (buffer + historyLength + numSamples + 1 - numTaps,
+                   buffer + historyLength + numSamples,
+                   buffer + historyLength + 1 - numTaps);
+
+        return numSamples;
+    }
+
+    static size_t roundUp (size_t n) noexcept         { return (n + numLanes - 1) / numLanes * numLanes; }
+
+    static SampleType* getAligned (SampleType* p) noexcept
+    {
+       #if DRX_USE_SIMD
+        return Vec::getNextSIMDAlignedPtr (p);
+       #else
+        return p;
+       #endif
+    }
+
+    const size_t numTaps, paddedLength, historyLength, channelLength, numChannels;
+    HeapBlock<SampleType> kernelStorage, historyStorage;
+    SampleType* kernels = nullptr;
+    SampleType* history = nullptr;
+};
+
+//==============================================================================
+template <typename SampleType>
+struct FIR::BlockFilter<SampleType>::PolyphaseEngine final : public Engine
+{
+    PolyphaseEngine (const Coefficients<SampleType>& c, const ProcessSpec& spec, i32 interpolationFactor, i32 decimationFactor)
+        : interpolation ((size_t) interpolationFactor),
+          decimation ((size_t) decimationFactor),
+          branchLength (((size_t) c.coefficients.size() + interpolation - 1) / interpolation),
+          history ((i32) spec.numChannels, (i32) (branchLength - 1 + spec.maximumBlockSize)),
+          phases (spec.numChannels)
+    {
+        branches.resize ((i32) (interpolation * branchLength));
+        setCoefficients (c);
+        reset();
+    }
+
+    z0 reset() noexcept override
+    {
+        history.clear();
+        std::fill (phases.begin(), phases.end(), (size_t) 0);
+    }
+
+    z0 setCoefficients (const Coefficients<SampleType>& c) noexcept override
+    {
+        jassert (((size_t) c.coefficients.size() + interpolation - 1) / interpolation == branchLength);
+
+        // Branch p holds the coefficients p, p + L, p + 2L... in reverse order, so that it
+        // lines up with the input samples in the history
+        branches.fill (0);
+
+        for (i32 k = 0; k < c.coefficients.size(); ++k)
+        {
+            const auto branch = (size_t) k % interpolation;
+            const auto tap = (size_t) k / interpolation;
+            branches.set ((i32) (branch * branchLength + branchLength - 1 - tap), c.coefficients[k]);
+        }
+    }
+
+    size_t process (size_t channel, const SampleType* input, SampleType* output, size_t numInputSamples) noexcept override
+    {
+        auto* buffer = history.getWritePointer ((i32) channel);
+        FloatVectorOperations::copy (buffer + branchLength - 1, input, numInputSamples);
+
+        // The position of the next output on the upsampled time axis, relative to the
+        // first input sample of this block
+        auto& t = phases[channel];
+        const auto* outputStart = output;
+
+        for (const auto end = numInputSamples * interpolation; t < end; t += decimation)
+        {
+            const auto* branch = branches.begin() + (t % interpolation) * branchLength;
+            const auto* samples = buffer + t / interpolation;
+
+            SampleType sum = 0;
+
+            for (size_t j = 0; j < branchLength; ++j)
+                sum += branch[j] * samples[j];
+
+            *output++ = sum;
+        }
+
+        t -= numInputSamples * interpolation;
+
+        std::copy (buffer + numInputSamples, buffer + numInputSamples + branchLength - 1, buffer);
+        return (size_t) (output - outputStart);
+    }
+
+    const size_t interpolation, decimation, branchLength;
+    Array<SampleType> branches;
+    AudioBuffer<SampleType> history;
+    std::vector<size_t> phases;
+};
+
+//==============================================================================
+template <typename SampleType>
+struct FIR::BlockFilter<SampleType>::OverlapSaveEngine final : public Engine
+{
+    OverlapSaveEngine (const Coefficients<SampleType>& c, const ProcessSpec& spec)
+        : partitionSize ((size_t) nextPowerOfTwo (jmax (32, (i32) spec.maximumBlockSize))),
+          fftSize (2 * partitionSize),
+          spectrumSize (fftSize + 2),
+          fft (roundToInt (std::log2 ((f64) fftSize)), std::is_same_v<SampleType, f64>),
+          numPartitions (((size_t) c.coefficients.size() + partitionSize - 1) / partitionSize),
+          kernelSpectra (numPartitions * spectrumSize),
+          kernelWork (2 * fftSize)
+    {
+        setCoefficients (c);
+
+        channels.resize (spec.numChannels);
+
+        for (auto& ch : channels)
+        {
+            ch.window.resize (fftSize);
+            ch.spectrum.resize (2 * fftSize);
+            ch.output.resize (2 * fftSize);
+            ch.accumulator.resize (spectrumSize);
+            ch.delayLine.resize (numPartitions * spectrumSize);
+        }
+
+        reset();
+    }
+
+    z0 reset() noexcept override
+    {
+        for (auto& ch : channels)
+        {
+            for (auto* v : { &ch.window, &ch.spectrum, &ch.output, &ch.accumulator, &ch.delayLine })
+                std::fill (v->begin(), v->end(), (SampleType) 0);
+
+            ch.position = 0;
+            ch.newest = 0;
+        }
+    }
+
+    z0 setCoefficients (const Coefficients<SampleType>& c) noexcept override
+    {
+        jassert (((size_t) c.coefficients.size() + partitionSize - 1) / partitionSize == numPartitions);
+
+        for (size_t p = 0; p < numPartitions; ++p)
+        {
+            std::fill (kernelWork.begin(), kernelWork.end(), (SampleType) 0);
+
+            const auto start = p * partitionSize;
+            const auto num = jmin (partitionSize, (size_t) c.coefficients.size() - start);
+            FloatVectorOperations::copy (kernelWork.data(), c.coefficients.begin() + start, num);
+
+            fft.performRealOnlyForwardTransform (kernelWork.data(), true);
+            FloatVectorOperations::copy (kernelSpectra.data() + p * spectrumSize, kernelWork.data(), spectrumSize);
+        }
+
+        // The older partitions' contributions to the current one were made with the old kernel
+        for (auto& ch : channels)
+            accumulateOlderPartitions (ch);
+    }
+
+    size_t process (size_t channel, const SampleType* input, SampleType* output, size_t numSamples) noexcept override
+    {
+        auto& ch = channels[channel];
+        const auto numInputSamples = numSamples;
+
+        while (numSamples > 0)
+        {
+            const auto numThisTime = jmin (numSamples, partitionSize - ch.position);
+            const auto outputStart = partitionSize + ch.position;
+
+            // The second half of the window holds the current partition, with zeros after
+            // the samples received so far
+            FloatVectorOperations::copy (ch.window.data() + outputStart, input, numThisTime);
+
+            FloatVectorOperations::copy (ch.spectrum.data(), ch.window.data(), fftSize);
+            fft.performRealOnlyForwardTransform (ch.spectrum.data(), true);
+
+            // The older partitions were dealt with when the previous partition was completed
+            FloatVectorOperations::copy (ch.output.data(), ch.accumulator.data(), spectrumSize);
+            multiplyAdd (ch.output.data(), kernelSpectra.data(), ch.spectrum.data());
+            fft.performRealOnlyInverseTransform (ch.output.data());
+
+            FloatVectorOperations::copy (output, ch.output.data() + outputStart, numThisTime);
+
+            ch.position += numThisTime;
+            input += numThisTime;
+            output += numThisTime;
+            numSamples -= numThisTime;
+
+            if (ch.position == partitionSize)
+                finishPartition (ch);
+        }
+
+        return numInputSamples;
+    }
+
+private:
+    struct Channel
+    {
+        std::vector<SampleType> window, spectrum, output, accumulator, delayLine;
+        size_t position = 0, newest = 0;
+    };
+
+    z0 finishPartition (Channel& ch) noexcept
+    {
+        // The spectrum of the complete window goes into the delay line, and the
+        // contributions of all the partitions except the first are summed for the
+        // outputs of the next partition
+        ch.newest = (ch.newest + 1) % numPartitions;
+        FloatVectorOperations::copy (ch.delayLine.data() + ch.newest * spectrumSize, ch.spectrum.data(), spectrumSize);
+
+        accumulateOlderPartitions (ch);
+
+        std::copy (ch.window.begin() + (std::ptrdiff_t) partitionSize, ch.window.end(), ch.window.begin());
+        std::fill (ch.window.begin() + (std::ptrdiff_t) partitionSize, ch.window.end(), (SampleType) 0);
+        ch.position = 0;
+    }
+
+    z0 accumulateOlderPartitions (Channel& ch) noexcept
+    {
+        std::fill (ch.accumulator.begin(), ch.accumulator.end(), (SampleType) 0);
+
+        for (size_t p = 1; p < numPartitions; ++p)
+        {
+            const auto slot = (ch.newest + numPartitions + 1 - p) % numPartitions;
+            multiplyAdd (ch.accumulator.data(), kernelSpectra.data() + p * spectrumSize, ch.delayLine.data() + slot * spectrumSize);
+        }
+    }
+
+    // Adds the product of two spectra of interleaved complex numbers to another
+    z0 multiplyAdd (SampleType* dest, const SampleType* a, const SampleType* b) const noexcept
+    {
+        for (size_t i = 0; i < spectrumSize; i += 2)
+        {
+            dest[i]     += a[i] * b[i]     - a[i + 1] * b[i + 1];
+            dest[i + 1] += a[i] * b[i + 1] + a[i + 1] * b[i];
+        }
+    }
+
+    const size_t partitionSize, fftSize, spectrumSize;
+    FFT fft;
+    const size_t numPartitions;
+    std::vector<SampleType> kernelSpectra, kernelWork;
+    std::vector<Channel> channels;
+};
+
+//==============================================================================
+template <typename SampleType>
+FIR::BlockFilter<SampleType>::BlockFilter()
+    : coefficients (new Coefficients<SampleType> (1))
+{
+    coefficients->coefficients.set (0, 1);
+}
+
+template <typename SampleType>
+FIR::BlockFilter<SampleType>::~BlockFilter() = default;
+
+template <typename SampleType>
+z0 FIR::BlockFilter<SampleType>::setCoefficients (CoefficientsPtr newCoefficients, Method methodToUse)
+{
+    // Use the other overload to make a filter that changes the sample rate
+    jassert (methodToUse != Method::polyphase);
+
+    if (interpolation == 1 && decimation == 1 && requestedMethod == methodToUse && canUpdateInPlace (*newCoefficients))
+    {
+        coefficients = std::move (newCoefficients);
+        engine->setCoefficients (*coefficients);
+        return;
+    }
+
+    coefficients = std::move (newCoefficients);
+    requestedMethod = methodToUse;
+    interpolation = decimation = 1;
+    createEngine();
+}
+
+template <typename SampleType>
+z0 FIR::BlockFilter<SampleType>::setCoefficients (CoefficientsPtr newCoefficients, i32 interpolationFactor, i32 decimationFactor)
+{
+    jassert (interpolationFactor > 0 && decimationFactor > 0);
+
+    if (requestedMethod == Method::polyphase && interpolation == interpolationFactor && decimation == decimationFactor
+         && canUpdateInPlace (*newCoefficients))
+    {
+        coefficients = std::move (newCoefficients);
+        engine->setCoefficients (*coefficients);
+        return;
+    }
+
+    coefficients = std::move (newCoefficients);
+    requestedMethod = Method::polyphase;
+    interpolation = jmax (1, interpolationFactor);
+    decimation = jmax (1, decimationFactor);
+    createEngine();
+}
+
+template <typename SampleType>
+typename FIR::BlockFilter<SampleType>::Method FIR::BlockFilter<SampleType>::chooseMethod (size_t numCoefficients,
+                                                                                          size_t maximumBlockSize) noexcept
+{
+    // The shortest number of coefficients for which overlap-save was quicker than the
+    // direct method, for each maximum block size, found with the benchmark in the unit
+    // tests on an x64 machine with SSE. Overlap-save has a fixed cost for each block, so
+    // it only pays off for longer filters when the blocks are small.
+    struct Crossover { size_t maximumBlockSize, numCoefficients; };
+
+    static constexpr Crossover crossovers[] { { 16,   512 },
+                                              { 32,   512 },
+                                              { 64,   256 },
+                                              { 128,  256 },
+                                              { 256,  256 },
+                                              { 512,  256 },
+                                              { 1024, 256 } };
+
+    auto threshold = std::end (crossovers)[-1].numCoefficients;
+
+    for (const auto& crossover : crossovers)
+    {
+        if (maximumBlockSize <= crossover.maximumBlockSize)
+        {
+            threshold = crossover.numCoefficients;
+            break;
+        }
+    }
+
+    return numCoefficients >= threshold ? Method::overlapSave : Method::direct;
+}
+
+template <typename SampleType>
+b8 FIR::BlockFilter<SampleType>::canUpdateInPlace (const Coefficients<SampleType>& newCoefficients) const noexcept
+{
+    // The engines are sized for a number of coefficients, and Method::automatic picks its
+    // method from the same number, so the current engine can take any set of the same length
+    return engine != nullptr && coefficients != nullptr
+            && newCoefficients.coefficients.size() == coefficients->coefficients.size();
+}
+
+template <typename SampleType>
+z0 FIR::BlockFilter<SampleType>::prepare (const ProcessSpec& newSpec)
+{
+    spec = newSpec;
+    createEngine();
+}
+
+template <typename SampleType>
+z0 FIR::BlockFilter<SampleType>::reset() noexcept
+{
+    if (engine != nullptr)
+        engine->reset();
+}
+
+template <typename SampleType>
+z0 FIR::BlockFilter<SampleType>::createEngine()
+{
+    engine.reset();
+
+    if (spec.numChannels == 0 || spec.maximumBlockSize == 0 || coefficients == nullptr || coefficients->coefficients.isEmpty())
+        return;
+
+    currentMethod = requestedMethod == Method::automatic
+                        ? chooseMethod ((size_t) coefficients->coefficients.size(), spec.maximumBlockSize)
+                        : requestedMethod;
+
+    switch (currentMethod)
+    {
+        case Method::polyphase:    engine = std::make_unique<PolyphaseEngine> (*coefficients, spec, interpolation, decimation); break;
+        case Method::overlapSave:  engine = std::make_unique<OverlapSaveEngine> (*coefficients, spec); break;
+        case Method::direct:
+        case Method::automatic:    engine = std::make_unique<DirectEngine> (*coefficients, spec); break;
+    }
+}
+
+template <typename SampleType>
+z0 FIR::BlockFilter<SampleType>::processBlock (const AudioBlock<const SampleType>& input,
+                                                 const AudioBlock<SampleType>& output,
+                                                 b8 isBypassed) noexcept
+{
+    // You need to call prepare() and setCoefficients() before processing
+    jassert (engine != nullptr);
+
+    const auto numChannels = jmin (input.getNumChannels(), output.getNumChannels(), (size_t) spec.numChannels);
+    const auto numInputSamples = input.getNumSamples();
+
+    jassert (numInputSamples % (size_t) decimation == 0);
+    jassert (output.getNumSamples() == getNumOutputSamples (numInputSamples));
+
+    if (engine == nullptr)
+        return;
+
+    if (isBypassed)
+    {
+        if (input.getChannelPointer (0) != output.getChannelPointer (0) && interpolation == decimation)
+            output.copyFrom (input);
+
+        engine->reset();
+        return;
+    }
+
+    const auto blockSize = (size_t) spec.maximumBlockSize;
+
+    for (size_t channel = 0; channel < numChannels; ++channel)
+    {
+        const auto* src = input.getChannelPointer (channel);
+        auto* dst = output.getChannelPointer (channel);
+
+        for (size_t start = 0; start < numInputSamples; start += blockSize)
+        {
+            const auto numThisTime = jmin (blockSize, numInputSamples - start);
+            dst += engine->process (channel, src + start, dst, numThisTime);
+        }
+    }
+}
+
+//==============================================================================
+template class FIR::BlockFilter<f32>;
+template class FIR::BlockFilter<f64>;
+
+} // namespace drx::dsp
@@ -0,0 +1,175 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace drx::dsp::FIR
+{
+
+/**
+    A multichannel FIR filter which picks the quickest way of applying its coefficients.
+
+    Filter does a direct convolution for each sample, which gets expensive for long sets
+    of coefficients, and Convolution needs a background thread and a message queue to
+    load its impulse responses. This class sits in between, and uses one of these methods:
+
+    - Method::direct convolves a whole block at a time, adding each coefficient times the
+      block of input to the output, using FloatVectorOperations.
+    - Method::overlapSave uses a uniformly partitioned overlap-save algorithm with an FFT
+      whose size is twice the next power of two above the maximum block size. Like the
+      other methods it has no latency, and it runs entirely on the calling thread.
+    - Method::polyphase is used when the filter changes the sample rate, by inserting
+      interpolationFactor - 1 zeros between the input samples, filtering the result and
+      then keeping one sample in decimationFactor. Only the outputs that are kept are
+      computed, and the zeros are never multiplied. Note that the inserted zeros reduce
+      the level by the interpolation factor, so you may want to scale the coefficients
+      to make up for it.
+
+    With Method::automatic, the choice between direct and overlap-save is made by
+    chooseMethod(), from the number of coefficients and the maximum block size.
+
+    The engine is rebuilt whenever prepare() is called, or setCoefficients() changes the
+    number of coefficients or the method, so these allocate memory. When only the values
+    of the coefficients change, the engine is updated in place and keeps the filter's
+    history, so that a parameter can be swept without clicks. Neither of these may be
+    called at the same time as process().
+
+    @see Filter, Convolution, FFT
+
+    @tags{DSP}
+*/
+template <typename SampleType>
+class BlockFilter
+{
+public:
+    //==============================================================================
+    /** A typedef for a ref-counted pointer to the coefficients object */
+    using CoefficientsPtr = typename Coefficients<SampleType>::Ptr;
+
+    /** The ways in which the filter can be applied. */
+    enum class Method
+    {
+        automatic,
+        direct,
+        polyphase,
+        overlapSave
+    };
+
+    //==============================================================================
+    /** Creates a filter which passes its input through unchanged. */
+    BlockFilter();
+
+    /** Destructor. */
+    ~BlockFilter();
+
+    //==============================================================================
+    /** Sets the coefficients to use, and the method to apply them with.
+
+        Method::polyphase can't be chosen here, use the other overload to make a
+        filter which changes the sample rate.
+    */
+    z0 setCoefficients (CoefficientsPtr newCoefficients, Method methodToUse = Method::automatic);
+
+    /** Sets the coefficients to use for a filter which changes the sample rate by a ratio
+        of interpolationFactor / decimationFactor, using the polyphase method.
+
+        When processing, the number of input samples in each block must be a multiple of
+        the decimation factor, and the output block must have the number of samples
+        returned by getNumOutputSamples().
+    */
+    z0 setCoefficients (CoefficientsPtr newCoefficients, i32 interpolationFactor, i32 decimationFactor);
+
+    /** Returns the method which is being used. This is only known once both prepare() and
+        setCoefficients() have been called.
+    */
+    Method getMethod() const noexcept                                  { return currentMethod; }
+
+    /** Returns the number of output samples produced from a number of input samples. */
+    size_t getNumOutputSamples (size_t numInputSamples) const noexcept
+    {
+        return numInputSamples * (size_t) interpolation / (size_t) decimation;
+    }
+
+    /** Returns the method used by Method::automatic for a number of coefficients and a
+        maximum block size.
+
+        The crossover points come from timing both methods on the same machine, so they
+        are only a guide to what's quickest on yours.
+    */
+    static Method chooseMethod (size_t numCoefficients, size_t maximumBlockSize) noexcept;
+
+    //==============================================================================
+    /** Prepares the filter for processing. */
+    z0 prepare (const ProcessSpec& spec);
+
+    /** Resets the filter's processing pipeline, ready to start a new stream of data. */
+    z0 reset() noexcept;
+
+    /** Processes a block of samples.
+
+        Unless the filter changes the sample rate, the input and output blocks must have
+        the same size. Blocks longer than the maximum block size are split up.
+
+        When the context is bypassed, the input is passed through and the filter's state
+        is cleared.
+    */
+    template <typename ProcessContext>
+    z0 process (const ProcessContext& context) noexcept
+    {
+        static_assert (std::is_same_v<typename ProcessContext::SampleType, SampleType>,
+                       "The sample-type of the FIR filter must match the sample-type supplied to this process callback");
+
+        processBlock (context.getInputBlock(), context.getOutputBlock(), context.isBypassed);
+    }
+
+private:
+    //==============================================================================
+    struct Engine;
+    struct DirectEngine;
+    struct PolyphaseEngine;
+    struct OverlapSaveEngine;
+
+    z0 processBlock (const AudioBlock<const SampleType>& input, const AudioBlock<SampleType>& output, b8 isBypassed) noexcept;
+    z0 createEngine();
+    b8 canUpdateInPlace (const Coefficients<SampleType>&) const noexcept;
+
+    CoefficientsPtr coefficients;
+    Method requestedMethod = Method::automatic, currentMethod = Method::automatic;
+    i32 interpolation = 1, decimation = 1;
+    ProcessSpec spec { 0.0, 0, 0 };
+
+    std::unique_ptr<Engine> engine;
+
+    DRX_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BlockFilter)
+};
+
+} // namespace drx::dsp::FIR
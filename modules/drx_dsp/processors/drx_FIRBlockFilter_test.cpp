@@ -0,0 +1,330 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace drx::dsp
+{
+
+class FIRBlockFilterTests final : public UnitTest
+{
+public:
+    FIRBlockFilterTests()
+        : UnitTest ("FIR::BlockFilter", UnitTestCategories::dsp)
+    {}
+
+    template <typename SampleType>
+    static typename FIR::Coefficients<SampleType>::Ptr makeRandomCoefficients (Random& random, i32 numCoefficients)
+    {
+        auto coefficients = new FIR::Coefficients<SampleType> ((size_t) numCoefficients);
+
+        for (auto& c : coefficients->coefficients)
+            c = (SampleType) (random.nextDouble() * 2.0 - 1.0);
+
+        return coefficients;
+    }
+
+    template <typename SampleType>
+    static AudioBuffer<SampleType> makeRandomSignal (Random& random, i32 numChannels, i32 numSamples)
+    {
+        AudioBuffer<SampleType> result (numChannels, numSamples);
+
+        for (auto channel = 0; channel < numChannels; ++channel)
+            for (auto i = 0; i < numSamples; ++i)
+                result.setSample (channel, i, (SampleType) (random.nextDouble() * 2.0 - 1.0));
+
+        return result;
+    }
+
+    // Filters the input after inserting interpolation - 1 zeros between each sample, and
+    // keeps one output in every decimation
+    template <typename SampleType>
+    static AudioBuffer<SampleType> reference (const FIR::Coefficients<SampleType>& coefficients,
+                                              const AudioBuffer<SampleType>& input,
+                                              i32 interpolation = 1, i32 decimation = 1)
+    {
+        const auto& fir = coefficients.coefficients;
+        AudioBuffer<SampleType> result (input.getNumChannels(), input.getNumSamples() * interpolation / decimation);
+
+        for (auto channel = 0; channel < input.getNumChannels(); ++channel)
+        {
+            for (auto m = 0; m < result.getNumSamples(); ++m)
+            {
+                const auto t = m * decimation;
+                f64 sum = 0;
+
+                for (auto k = t % interpolation; k < fir.size() && k <= t; k += interpolation)
+                    sum += (f64) fir[k] * (f64) input.getSample (channel, (t - k) / interpolation);
+
+                result.setSample (channel, m, (SampleType) sum);
+            }
+        }
+
+        return result;
+    }
+
+    template <typename SampleType>
+    f64 getMaxError (const AudioBuffer<SampleType>& a, const AudioBuffer<SampleType>& b)
+    {
+        expectEquals (a.getNumSamples(), b.getNumSamples());
+
+        auto maxError = 0.0;
+
+        for (auto channel = 0; channel < a.getNumChannels(); ++channel)
+            for (auto i = 0; i < jmin (a.getNumSamples(), b.getNumSamples()); ++i)
+                maxError = jmax (maxError, std::abs ((f64) a.getSample (channel, i) - (f64) b.getSample (channel, i)));
+
+        return maxError;
+    }
+
+    template <typename SampleType>
+    z0 testMethods()
+    {
+        using Filter = FIR::BlockFilter<SampleType>;
+
+        Random random (8392829);
+        constexpr auto numSamples = 3000;
+        constexpr u32 maximumBlockSize = 128;
+        const auto tolerance = std::is_same_v<SampleType, f32> ? 1.0e-3 : 1.0e-9;
+
+        const auto input = makeRandomSignal<SampleType> (random, 2, numSamples);
+
+        for (const auto numCoefficients : { 1, 7, 64, 300, 1500 })
+        {
+            const auto coefficients = makeRandomCoefficients<SampleType> (random, numCoefficients);
+            const auto expected = reference (*coefficients, input);
+
+            for (const auto method : { Filter::Method::direct, Filter::Method::overlapSave, Filter::Method::automatic })
+            {
+                Filter filter;
+                filter.setCoefficients (coefficients, method);
+                filter.prepare ({ 44100.0, maximumBlockSize, 2 });
+
+                if (method != Filter::Method::automatic)
+                    expect (filter.getMethod() == method);
+
+                // Uneven block sizes, both in place and not, including one longer than
+                // the maximum block size
+                auto buffer = input;
+                AudioBuffer<SampleType> output (2, numSamples);
+                AudioBlock<SampleType> block (buffer), outputBlock (output);
+
+                for (i32 start = 0, size = 1, i = 0; start < numSamples; start += size, size = (size * 5 + 3) % 300, ++i)
+                {
+                    size = jmin (size, numSamples - start);
+                    auto subBlock = block.getSubBlock ((size_t) start, (size_t) size);
+                    auto outputSubBlock = outputBlock.getSubBlock ((size_t) start, (size_t) size);
+
+                    if (i % 2 == 0)
+                    {
+                        filter.process (ProcessContextReplacing<SampleType> (subBlock));
+                        outputSubBlock.copyFrom (subBlock);
+                    }
+                    else
+                    {
+                        filter.process (ProcessContextNonReplacing<SampleType> (subBlock, outputSubBlock));
+                    }
+                }
+
+                expectLessThan (getMaxError (output, expected), tolerance);
+            }
+        }
+    }
+
+    template <typename SampleType>
+    z0 testPolyphase()
+    {
+        using Filter = FIR::BlockFilter<SampleType>;
+
+        Random random (12345);
+        constexpr auto numInputSamples = 1200;
+        const auto input = makeRandomSignal<SampleType> (random, 2, numInputSamples);
+
+        for (const auto& [interpolation, decimation] : { std::pair { 2, 1 }, std::pair { 1, 3 }, std::pair { 3, 2 }, std::pair { 4, 4 } })
+        {
+            for (const auto numCoefficients : { 1, 10, 63 })
+            {
+                const auto coefficients = makeRandomCoefficients<SampleType> (random, numCoefficients);
+                const auto expected = reference (*coefficients, input, interpolation, decimation);
+
+                Filter filter;
+                filter.setCoefficients (coefficients, interpolation, decimation);
+                filter.prepare ({ 44100.0, 100, 2 });
+                expect (filter.getMethod() == Filter::Method::polyphase);
+
+                AudioBuffer<SampleType> output (2, (i32) filter.getNumOutputSamples (numInputSamples));
+                AudioBlock<const SampleType> inputBlock (input);
+                AudioBlock<SampleType> outputBlock (output);
+
+                // Blocks which are multiples of the decimation factor, some of them longer
+                // than the maximum block size
+                for (size_t start = 0, size = (size_t) decimation; start < numInputSamples; start += size, size = (size * 7) % 240)
+                {
+                    size = jmin (size - size % (size_t) decimation, numInputSamples - start);
+
+                    if (size == 0)
+                        size = (size_t) decimation;
+
+                    auto outputSubBlock = outputBlock.getSubBlock (filter.getNumOutputSamples (start),
+                                                                   filter.getNumOutputSamples (size));
+
+                    filter.process (ProcessContextNonReplacing<SampleType> (inputBlock.getSubBlock (start, size), outputSubBlock));
+                }
+
+                expectLessThan (getMaxError (output, expected), 1.0e-4);
+            }
+        }
+    }
+
+    template <typename SampleType>
+    z0 testCoefficientChanges()
+    {
+        using Filter = FIR::BlockFilter<SampleType>;
+
+        Random random (5551212);
+        constexpr auto numSamples = 2000, switchPoint = 1100;
+        const auto tolerance = std::is_same_v<SampleType, f32> ? 1.0e-3 : 1.0e-9;
+
+        const auto input = makeRandomSignal<SampleType> (random, 2, numSamples);
+
+        for (const auto method : { Filter::Method::direct, Filter::Method::overlapSave })
+        {
+            const auto first = makeRandomCoefficients<SampleType> (random, 300);
+            const auto second = makeRandomCoefficients<SampleType> (random, 300);
+
+            // Once the coefficients change, the output is the new filter applied to the
+            // whole input, as the history is kept
+            auto expected = reference (*first, input);
+            const auto expectedAfterChange = reference (*second, input);
+
+            for (auto channel = 0; channel < 2; ++channel)
+                expected.copyFrom (channel, switchPoint, expectedAfterChange, channel, switchPoint, numSamples - switchPoint);
+
+            Filter filter;
+            filter.setCoefficients (first, method);
+            filter.prepare ({ 44100.0, 128, 2 });
+
+            auto buffer = input;
+            AudioBlock<SampleType> block (buffer);
+            auto beforeChange = block.getSubBlock (0, switchPoint), afterChange = block.getSubBlock (switchPoint);
+            filter.process (ProcessContextReplacing<SampleType> (beforeChange));
+
+            filter.setCoefficients (second, method);
+            expect (filter.getMethod() == method);
+
+            filter.process (ProcessContextReplacing<SampleType> (afterChange));
+
+            expectLessThan (getMaxError (buffer, expected), tolerance);
+        }
+    }
+
+    z0 runTest() override
+    {
+        beginTest ("Direct and overlap-save methods match a direct convolution");
+        testMethods<f32>();
+        testMethods<f64>();
+
+        beginTest ("Polyphase resampling matches filtering a zero stuffed signal");
+        testPolyphase<f32>();
+        testPolyphase<f64>();
+
+        beginTest ("Changing coefficients of the same length keeps the history");
+        testCoefficientChanges<f32>();
+        testCoefficientChanges<f64>();
+
+        beginTest ("Automatic method selection");
+        {
+            using Filter = FIR::BlockFilter<f32>;
+
+            expect (Filter::chooseMethod (16, 512) == Filter::Method::direct);
+            expect (Filter::chooseMethod (16384, 512) == Filter::Method::overlapSave);
+            expect (Filter::chooseMethod (16384, 32) == Filter::Method::overlapSave);
+            expect (Filter::chooseMethod (16384, 8192) == Filter::Method::overlapSave);
+        }
+
+        beginTest ("Performance");
+        {
+            // The crossover table used by chooseMethod() comes from this benchmark. It logs
+            // the time taken by both methods for one second of mono audio, and the shortest
+            // filter for which overlap-save was quicker.
+            using Filter = FIR::BlockFilter<f32>;
+            constexpr f64 sampleRate = 48000.0;
+
+            Random random;
+            auto input = makeRandomSignal<f32> (random, 1, (i32) sampleRate);
+
+            const auto time = [&] (const Filter::CoefficientsPtr& coefficients, Filter::Method method, i32 blockSize)
+            {
+                Filter filter;
+                filter.setCoefficients (coefficients, method);
+                filter.prepare ({ sampleRate, (u32) blockSize, 1 });
+
+                auto buffer = input;
+                AudioBlock<f32> block (buffer);
+
+                const auto start = Time::getMillisecondCounterHiRes();
+
+                for (size_t i = 0; i + (size_t) blockSize <= block.getNumSamples(); i += (size_t) blockSize)
+                {
+                    auto subBlock = block.getSubBlock (i, (size_t) blockSize);
+                    filter.process (ProcessContextReplacing<f32> (subBlock));
+                }
+
+                return Time::getMillisecondCounterHiRes() - start;
+            };
+
+            for (const auto blockSize : { 16, 32, 64, 128, 256, 512, 1024 })
+            {
+                Txt line = "  block size " + Txt (blockSize) + ":";
+                auto crossover = 0;
+
+                for (auto numCoefficients = 16; numCoefficients <= 4096; numCoefficients *= 2)
+                {
+                    const auto coefficients = makeRandomCoefficients<f32> (random, numCoefficients);
+                    const auto directMs = time (coefficients, Filter::Method::direct, blockSize);
+                    const auto overlapSaveMs = time (coefficients, Filter::Method::overlapSave, blockSize);
+
+                    if (crossover == 0 && overlapSaveMs < directMs)
+                        crossover = numCoefficients;
+
+                    line << " " << numCoefficients << " taps " << Txt (directMs, 1) << "/" << Txt (overlapSaveMs, 1) << " ms";
+                }
+
+                logMessage (line + ", overlap-save quicker from " + Txt (crossover) + " taps");
+            }
+        }
+    }
+};
+
+static FIRBlockFilterTests firBlockFilterTests;
+
+} // namespace drx::dsp
@@ -47,10 +47,10 @@ namespace drx::dsp::FIR
 
         Using FIRFilter is fast enough for FIRCoefficients with a size lower than 128
         samples. For longer filters, it might be more efficient to use the class
-        Convolution instead, which does the same processing in the frequency domain
-        thanks to FFT.
+        BlockFilter, which switches to processing in the frequency domain thanks to FFT
+        when that's quicker, or the class Convolution for very long impulse responses.
 
-        @see FIRFilter::Coefficients, Convolution, FFT
+        @see FIRFilter::Coefficients, BlockFilter, Convolution, FFT
 
         @tags{DSP}
     */
@@ -0,0 +1,354 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace drx::dsp::IIR
+{
+
+/**
+    Filters a number of channels at once, with one channel in each element of a
+    SIMDRegister.
+
+    Using a ProcessorDuplicator of Filter objects runs a separate scalar recursion for
+    each channel. This class copies the samples of a group of numLanes channels into a
+    buffer where they are interleaved, runs each second order section of the cascade on the
+    whole group using the transposed direct form II, and then copies the result back.
+
+    Each channel has its own coefficients for each section, so a bank can just as well
+    hold a multichannel EQ or a set of bands: to split a signal into bands, copy it into
+    each channel of the block before processing it. The cascades returned by the
+    FilterDesign methods can be passed straight to setCoefficients(). First order
+    coefficients are also accepted, but higher orders are not.
+
+    Coefficient changes are smoothed by ramping the coefficients of the whole group
+    linearly towards their new values, over the time given to setRampDurationSeconds().
+    The coefficients must be changed on the same thread that calls process().
+
+    @see Filter, ProcessorDuplicator, FilterDesign, SIMDRegister
+
+    @tags{DSP}
+*/
+template <typename SampleType>
+class FilterBank
+{
+public:
+    //==============================================================================
+    using Vec = SIMDRegister<SampleType>;
+
+    /** The number of channels which are processed together. */
+    static constexpr i32 numLanes = (i32) Vec::SIMDNumElements;
+
+    //==============================================================================
+    /** Creates a bank for a number of channels, each with a cascade of a number of
+        second order sections. Initially every section passes its input through unchanged.
+    */
+    FilterBank (i32 numChannelsToUse, i32 numSectionsToUse)
+        : numChannels (jmax (1, numChannelsToUse)),
+          numSections (jmax (1, numSectionsToUse)),
+          numGroups ((numChannels + numLanes - 1) / numLanes),
+          sections ((size_t) (numGroups * numSections)),
+          rampSamplesRemaining ((size_t) numGroups, 0)
+    {
+        for (auto& section : sections)
+        {
+            for (size_t i = 0; i < 5; ++i)
+                section.current[i] = section.target[i] = Vec::expand (getPassThrough()[i]);
+        }
+    }
+
+    //==============================================================================
+    /** Returns the number of channels. */
+    i32 getNumChannels() const noexcept                      { return numChannels; }
+
+    /** Returns the number of sections in the cascade of each channel. */
+    i32 getNumSections() const noexcept                      { return numSections; }
+
+    //==============================================================================
+    /** Sets the coefficients of one section for one channel. */
+    z0 setCoefficients (i32 channel, i32 sectionIndex, const Coefficients<SampleType>& newCoefficients) noexcept
+    {
+        jassert (isPositiveAndBelow (channel, numChannels) && isPositiveAndBelow (sectionIndex, numSections));
+
+        setTarget (channel, sectionIndex, toSecondOrder (newCoefficients));
+        startRamp (channel / numLanes);
+    }
+
+    /** Sets the coefficients of the whole cascade for one channel, for example from one
+        of the FilterDesign methods. Any sections after the end of the array are set to
+        pass their input through unchanged.
+    */
+    z0 setCoefficients (i32 channel, const ReferenceCountedArray<Coefficients<SampleType>>& cascade) noexcept
+    {
+        jassert (isPositiveAndBelow (channel, numChannels) && cascade.size() <= numSections);
+
+        for (i32 i = 0; i < numSections; ++i)
+            setTarget (channel, i, i < cascade.size() ? toSecondOrder (*cascade.getUnchecked (i))
+                                                    : getPassThrough());
+
+        startRamp (channel / numLanes);
+    }
+
+    /** Sets the length of the ramp used for smoothing coefficient changes. */
+    z0 setRampDurationSeconds (f64 newDurationSeconds) noexcept
+    {
+        rampDurationSeconds = newDurationSeconds;
+        rampLength = roundToInt (rampDurationSeconds * sampleRate);
+    }
+
+    //==============================================================================
+    /** Called before processing starts. */
+    z0 prepare (const ProcessSpec& spec)
+    {
+        jassert (spec.numChannels <= (u32) numChannels);
+
+        sampleRate = spec.sampleRate;
+        maximumBlockSize = jmax (1, (i32) spec.maximumBlockSize);
+        setRampDurationSeconds (rampDurationSeconds);
+
+        scratchStorage.allocate ((size_t) ((maximumBlockSize + 1) * numLanes), true);
+        scratch = Vec::getNextSIMDAlignedPtr (scratchStorage.get());
+
+        reset();
+    }
+
+    /** Resets the state of every channel, and jumps to the latest coefficients. */
+    z0 reset() noexcept
+    {
+        for (auto& section : sections)
+        {
+            section.current = section.target;
+            section.s1 = section.s2 = Vec::expand (0);
+        }
+
+        std::fill (rampSamplesRemaining.begin(), rampSamplesRemaining.end(), 0);
+    }
+
+    /** Processes a block of samples. */
+    template <typename ProcessContext>
+    z0 process (const ProcessContext& context) noexcept
+    {
+        auto&& inputBlock  = context.getInputBlock();
+        auto&& outputBlock = context.getOutputBlock();
+
+        jassert (inputBlock.getNumChannels() == outputBlock.getNumChannels());
+        jassert (inputBlock.getNumSamples()  == outputBlock.getNumSamples());
+        jassert (scratch != nullptr);
+
+        if (context.isBypassed)
+        {
+            if (context.usesSeparateInputAndOutputBlocks())
+                outputBlock.copyFrom (inputBlock);
+
+            return;
+        }
+
+        const auto numChannelsToProcess = jmin ((size_t) numChannels, outputBlock.getNumChannels());
+        const auto numSamples = outputBlock.getNumSamples();
+
+        for (size_t start = 0; start < numSamples; start += (size_t) maximumBlockSize)
+        {
+            const auto numThisTime = jmin (numSamples - start, (size_t) maximumBlockSize);
+
+            for (i32 group = 0; group < numGroups; ++group)
+            {
+                const auto firstChannel = (size_t) (group * numLanes);
+
+                for (size_t lane = 0; lane < (size_t) numLanes; ++lane)
+                {
+                    const auto channel = firstChannel + lane;
+
+                    if (channel < numChannelsToProcess)
+                    {
+                        const auto* src = inputBlock.getChannelPointer (channel) + start;
+
+                        for (size_t i = 0; i < numThisTime; ++i)
+                            scratch[i * (size_t) numLanes + lane] = src[i];
+                    }
+                    else
+                    {
+                        for (size_t i = 0; i < numThisTime; ++i)
+                            scratch[i * (size_t) numLanes + lane] = 0;
+                    }
+                }
+
+                processGroup (group, numThisTime);
+
+                for (size_t lane = 0; lane < (size_t) numLanes && firstChannel + lane < numChannelsToProcess; ++lane)
+                {
+                    auto* dst = outputBlock.getChannelPointer (firstChannel + lane) + start;
+
+                    for (size_t i = 0; i < numThisTime; ++i)
+                        dst[i] = scratch[i * (size_t) numLanes + lane];
+                }
+            }
+        }
+    }
+
+private:
+    //==============================================================================
+    // The coefficients of a section, in the order b0, b1, b2, a1, a2
+    using SectionCoefficients = std::array<Vec, 5>;
+
+    struct Section
+    {
+        SectionCoefficients current, target, step;
+        Vec s1, s2;
+    };
+
+    static std::array<SampleType, 5> getPassThrough() noexcept
+    {
+        return { 1, 0, 0, 0, 0 };
+    }
+
+    static std::array<SampleType, 5> toSecondOrder (const Coefficients<SampleType>& c) noexcept
+    {
+        const auto* raw = c.getRawCoefficients();
+
+        switch (c.getFilterOrder())
+        {
+            case 1:  return { raw[0], raw[1], 0, raw[2], 0 };
+            case 2:  return { raw[0], raw[1], raw[2], raw[3], raw[4] };
+            default: break;
+        }
+
+        // The bank can only be used with first and second order sections
+        jassertfalse;
+        return getPassThrough();
+    }
+
+    z0 setTarget (i32 channel, i32 sectionIndex, const std::array<SampleType, 5>& values) noexcept
+    {
+        auto& section = sections[(size_t) ((channel / numLanes) * numSections + sectionIndex)];
+
+        for (size_t i = 0; i < values.size(); ++i)
+            section.target[i].set ((size_t) (channel % numLanes), values[i]);
+    }
+
+    z0 startRamp (i32 group) noexcept
+    {
+        auto* groupSections = sections.data() + group * numSections;
+
+        if (rampLength <= 0 || scratch == nullptr)
+        {
+            for (i32 i = 0; i < numSections; ++i)
+                groupSections[i].current = groupSections[i].target;
+
+            rampSamplesRemaining[(size_t) group] = 0;
+            return;
+        }
+
+        const auto scale = (SampleType) 1 / (SampleType) rampLength;
+
+        for (i32 i = 0; i < numSections; ++i)
+            for (size_t c = 0; c < 5; ++c)
+                groupSections[i].step[c] = (groupSections[i].target[c] - groupSections[i].current[c]) * scale;
+
+        rampSamplesRemaining[(size_t) group] = rampLength;
+    }
+
+    z0 processGroup (i32 group, size_t numSamples) noexcept
+    {
+        auto& remaining = rampSamplesRemaining[(size_t) group];
+        const auto numRampSamples = (size_t) jmin ((size_t) remaining, numSamples);
+        const auto rampEnds = numRampSamples > 0 && numRampSamples == (size_t) remaining;
+        auto* groupSections = sections.data() + group * numSections;
+
+        for (i32 i = 0; i < numSections; ++i)
+        {
+            auto& section = groupSections[i];
+
+            auto b0 = section.current[0], b1 = section.current[1], b2 = section.current[2];
+            auto a1 = section.current[3], a2 = section.current[4];
+            auto lv1 = section.s1, lv2 = section.s2;
+
+            const auto processSample = [&] (size_t index)
+            {
+                auto* data = scratch + index * (size_t) numLanes;
+
+                const auto input = Vec::fromRawArray (data);
+                const auto output = (input * b0) + lv1;
+                output.copyToRawArray (data);
+
+                lv1 = (input * b1) - (output * a1) + lv2;
+                lv2 = (input * b2) - (output * a2);
+            };
+
+            size_t index = 0;
+
+            for (; index < numRampSamples; ++index)
+            {
+                processSample (index);
+
+                b0 += section.step[0];
+                b1 += section.step[1];
+                b2 += section.step[2];
+                a1 += section.step[3];
+                a2 += section.step[4];
+            }
+
+            // Avoid leaving any rounding errors from the ramp behind
+            if (rampEnds)
+            {
+                b0 = section.target[0];
+                b1 = section.target[1];
+                b2 = section.target[2];
+                a1 = section.target[3];
+                a2 = section.target[4];
+            }
+
+            for (; index < numSamples; ++index)
+                processSample (index);
+
+            section.current = { b0, b1, b2, a1, a2 };
+            section.s1 = lv1;
+            section.s2 = lv2;
+        }
+
+        remaining -= (i32) numRampSamples;
+    }
+
+    //==============================================================================
+    i32k numChannels, numSections, numGroups;
+    std::vector<Section> sections;
+    std::vector<i32> rampSamplesRemaining;
+
+    HeapBlock<SampleType> scratchStorage;
+    SampleType* scratch = nullptr;
+
+    f64 sampleRate = 44100.0, rampDurationSeconds = 0.0;
+    i32 rampLength = 0, maximumBlockSize = 0;
+
+    DRX_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FilterBank)
+};
+
+} // namespace drx::dsp::IIR
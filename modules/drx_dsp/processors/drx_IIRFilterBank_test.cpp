@@ -0,0 +1,231 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace drx::dsp
+{
+
+class IIRFilterBankTests final : public UnitTest
+{
+public:
+    IIRFilterBankTests()
+        : UnitTest ("IIR::FilterBank", UnitTestCategories::dsp)
+    {}
+
+    template <typename SampleType>
+    z0 testMatchesFilters()
+    {
+        using Bank = IIR::FilterBank<SampleType>;
+        using Coeffs = IIR::Coefficients<SampleType>;
+
+        constexpr f64 sampleRate = 48000.0;
+        constexpr i32 numSamples = 1000;
+
+        // Enough channels for a group that is only partly used
+        const auto numChannels = 2 * Bank::numLanes + 1;
+        constexpr i32 numSections = 3;
+
+        Bank bank (numChannels, numSections);
+        std::vector<std::vector<IIR::Filter<SampleType>>> filters ((size_t) numChannels);
+
+        for (auto channel = 0; channel < numChannels; ++channel)
+        {
+            auto& cascade = filters[(size_t) channel];
+            const auto frequency = (SampleType) (200.0 + 300.0 * channel);
+
+            if (channel % 2 == 0)
+            {
+                // A whole cascade from FilterDesign
+                const auto design = FilterDesign<SampleType>::designIIRLowpassHighOrderButterworthMethod (frequency, sampleRate, 6);
+                bank.setCoefficients (channel, design);
+
+                for (auto* section : design)
+                    cascade.emplace_back (section);
+            }
+            else
+            {
+                // Sections set one at a time, including a first order one, with the last
+                // section left alone
+                const std::array<typename Coeffs::Ptr, 2> sections { Coeffs::makePeakFilter (sampleRate, frequency, (SampleType) 2, (SampleType) 3),
+                                                                     Coeffs::makeFirstOrderHighPass (sampleRate, frequency / 4) };
+
+                for (size_t i = 0; i < sections.size(); ++i)
+                {
+                    bank.setCoefficients (channel, (i32) i, *sections[i]);
+                    cascade.emplace_back (sections[i]);
+                }
+            }
+
+            for (auto& filter : cascade)
+                filter.reset();
+        }
+
+        bank.prepare ({ sampleRate, 128, (u32) numChannels });
+
+        AudioBuffer<SampleType> buffer (numChannels, numSamples);
+        Random random;
+
+        for (auto channel = 0; channel < numChannels; ++channel)
+            for (auto i = 0; i < numSamples; ++i)
+                buffer.setSample (channel, i, (SampleType) (random.nextDouble() * 2.0 - 1.0));
+
+        auto expected = buffer;
+
+        for (auto channel = 0; channel < numChannels; ++channel)
+            for (auto i = 0; i < numSamples; ++i)
+                for (auto& filter : filters[(size_t) channel])
+                    expected.setSample (channel, i, filter.processSample (expected.getSample (channel, i)));
+
+        // Uneven block sizes, including ones longer than the maximum
+        AudioBlock<SampleType> block (buffer);
+
+        for (i32 start = 0, size = 1; start < numSamples; start += size, size = size * 3 + 1)
+        {
+            auto subBlock = block.getSubBlock ((size_t) start, (size_t) jmin (size, numSamples - start));
+            bank.process (ProcessContextReplacing<SampleType> (subBlock));
+        }
+
+        auto maxError = 0.0;
+
+        for (auto channel = 0; channel < numChannels; ++channel)
+            for (auto i = 0; i < numSamples; ++i)
+                maxError = jmax (maxError, (f64) std::abs (buffer.getSample (channel, i) - expected.getSample (channel, i)));
+
+        expectLessThan (maxError, 1.0e-4);
+    }
+
+    template <typename SampleType>
+    z0 testSmoothing()
+    {
+        IIR::FilterBank<SampleType> bank (1, 1);
+        bank.setRampDurationSeconds (0.01);
+        bank.prepare ({ 1000.0, 32, 1 });
+
+        AudioBuffer<SampleType> buffer (1, 32);
+        AudioBlock<SampleType> block (buffer);
+
+        // A section which just multiplies by two
+        bank.setCoefficients (0, 0, IIR::Coefficients<SampleType> (2, 0, 1, 0));
+
+        block.fill ((SampleType) 1);
+        bank.process (ProcessContextReplacing<SampleType> (block));
+
+        for (auto i = 0; i < 10; ++i)
+            expectWithinAbsoluteError (buffer.getSample (0, i), (SampleType) (1.0 + i / 10.0), (SampleType) 1.0e-5);
+
+        for (auto i = 10; i < 32; ++i)
+            expectEquals (buffer.getSample (0, i), (SampleType) 2);
+
+        // Without a ramp the change is immediate
+        bank.setRampDurationSeconds (0.0);
+        bank.setCoefficients (0, 0, IIR::Coefficients<SampleType> (3, 0, 1, 0));
+
+        block.fill ((SampleType) 1);
+        bank.process (ProcessContextReplacing<SampleType> (block));
+
+        for (auto i = 0; i < 32; ++i)
+            expectEquals (buffer.getSample (0, i), (SampleType) 3);
+    }
+
+    z0 runTest() override
+    {
+        beginTest ("Output matches a cascade of Filter objects for each channel");
+        testMatchesFilters<f32>();
+        testMatchesFilters<f64>();
+
+        beginTest ("Coefficient changes are ramped");
+        testSmoothing<f32>();
+        testSmoothing<f64>();
+
+        beginTest ("Performance");
+        {
+            // A 32 channel, 4 band EQ, as a ProcessorDuplicator of Filter objects for each
+            // band and as a single bank
+            constexpr f64 sampleRate = 48000.0;
+            constexpr i32 numChannels = 32, numBands = 4, blockSize = 512;
+            const ProcessSpec spec { sampleRate, (u32) blockSize, (u32) numChannels };
+
+            using Duplicator = ProcessorDuplicator<IIR::Filter<f32>, IIR::Coefficients<f32>>;
+            std::array<Duplicator, numBands> duplicators;
+            IIR::FilterBank<f32> bank (numChannels, numBands);
+
+            for (auto band = 0; band < numBands; ++band)
+            {
+                const auto coefficients = IIR::Coefficients<f32>::makePeakFilter (sampleRate, 100.0f * std::pow (4.0f, (f32) band), 1.0f, 2.0f);
+                *duplicators[(size_t) band].state = *coefficients;
+                duplicators[(size_t) band].prepare (spec);
+
+                for (auto channel = 0; channel < numChannels; ++channel)
+                    bank.setCoefficients (channel, band, *coefficients);
+            }
+
+            bank.prepare (spec);
+
+            AudioBuffer<f32> buffer (numChannels, blockSize);
+            AudioBlock<f32> block (buffer);
+            Random random;
+
+            for (auto channel = 0; channel < numChannels; ++channel)
+                for (auto i = 0; i < blockSize; ++i)
+                    buffer.setSample (channel, i, random.nextFloat() * 2.0f - 1.0f);
+
+            const auto numBlocks = roundToInt (10.0 * sampleRate / blockSize);
+
+            const auto time = [&] (auto&& processBlock)
+            {
+                const auto start = Time::getMillisecondCounterHiRes();
+
+                for (auto i = 0; i < numBlocks; ++i)
+                    processBlock();
+
+                return Time::getMillisecondCounterHiRes() - start;
+            };
+
+            const auto duplicatorMs = time ([&]
+            {
+                for (auto& duplicator : duplicators)
+                    duplicator.process (ProcessContextReplacing<f32> (block));
+            });
+
+            const auto bankMs = time ([&] { bank.process (ProcessContextReplacing<f32> (block)); });
+
+            logMessage ("  " + Txt (numChannels) + " channels, " + Txt (numBands) + " bands, 10 seconds: ProcessorDuplicator "
+                        + Txt (duplicatorMs, 1) + " ms, filter bank with " + Txt (IIR::FilterBank<f32>::numLanes)
+                        + " lanes " + Txt (bankMs, 1) + " ms");
+        }
+    }
+};
+
+static IIRFilterBankTests iirFilterBankTests;
+
+} // namespace drx::dsp
@@ -0,0 +1,441 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace drx::dsp
+{
+
+/**
+    A Synthesiser whose voices are stored as a structure of arrays, and rendered a whole
+    SIMDRegister of voices at a time.
+
+    A normal Synthesiser calls the virtual SynthesiserVoice::renderNextBlock() method for
+    each of its voices, and each voice runs its own scalar loop. When a synth has a lot of
+    voices that all do the same thing, it's much quicker to keep each voice parameter in an
+    array with one element per voice, and to render SIMDRegister::size() voices at once.
+
+    To use it, create a subclass which keeps its voice state in LaneArray members,
+    registers them with addLaneArray(), and implements voiceStarted(), voiceReleased() and
+    renderGroup(). When a voice has finished its release, the subclass calls finishVoice().
+
+    The active voices are always packed into the lowest voice indices, so starting a voice
+    takes the next free index, and a finished voice is replaced by the last active one.
+    Voices are found by a table indexed by MIDI channel and note, so starting, releasing
+    and finishing a voice are all O(1). Only stealing a voice when they're all in use has to
+    search for the oldest one.
+
+    MIDI is handled sample-accurately by renderNextBlock(), as with any other Synthesiser.
+    Each voice is mono, and the sum of the voices is added to every channel of the output.
+    This class doesn't use SynthesiserSound or SynthesiserVoice objects, so don't add any.
+
+    @see Synthesiser, SIMDRegister
+
+    @tags{DSP}
+*/
+template <typename SampleType>
+class VoiceBankSynthesiser  : public Synthesiser
+{
+public:
+    //==============================================================================
+    using Vec = SIMDRegister<SampleType>;
+
+    /** The number of voices which are rendered together. */
+    static constexpr i32 numLanes = (i32) Vec::SIMDNumElements;
+
+    //==============================================================================
+    /** One value for each voice, laid out so that a group of numLanes voices can be
+        loaded straight into a SIMDRegister.
+    */
+    class LaneArray
+    {
+    public:
+        LaneArray() = default;
+
+        /** Returns the value for one voice. */
+        SampleType& operator[] (i32 voiceIndex) noexcept          { return data[voiceIndex]; }
+
+        /** Returns the value for one voice. */
+        SampleType operator[] (i32 voiceIndex) const noexcept     { return data[voiceIndex]; }
+
+        /** Loads the values for a group of voices. */
+        Vec load (i32 group) const noexcept                       { return Vec::fromRawArray (data + group * numLanes); }
+
+        /** Stores the values for a group of voices. */
+        z0 store (i32 group, Vec values) noexcept               { values.copyToRawArray (data + group * numLanes); }
+
+    private:
+        friend class VoiceBankSynthesiser;
+
+        z0 allocate (i32 numVoices)
+        {
+            storage.allocate ((size_t) (numVoices + numLanes), true);
+            data = Vec::getNextSIMDAlignedPtr (storage.get());
+        }
+
+        HeapBlock<SampleType> storage;
+        SampleType* data = nullptr;
+
+        DRX_DECLARE_NON_COPYABLE (LaneArray)
+    };
+
+    //==============================================================================
+    /** Creates a synthesiser with room for a given number of voices.
+        The number is rounded up to a multiple of numLanes.
+    */
+    explicit VoiceBankSynthesiser (i32 maxNumVoices)
+        : capacity (jmax (1, (maxNumVoices + numLanes - 1) / numLanes) * numLanes),
+          voiceInfo ((size_t) capacity)
+    {
+        std::fill (std::begin (voiceTable), std::end (voiceTable), -1);
+    }
+
+    //==============================================================================
+    /** Returns the number of voices that the synth can play at once. */
+    i32 getMaxNumVoices() const noexcept                          { return capacity; }
+
+    /** Returns the number of voices that are currently playing, including those that are
+        in their release phase. These are always the voices from 0 to getNumActiveVoices() - 1.
+    */
+    i32 getNumActiveVoices() const noexcept                       { return numActive; }
+
+    /** Returns the index of the voice playing a note whose key hasn't been released, or -1. */
+    i32 findVoice (i32 midiChannel, i32 midiNoteNumber) const noexcept
+    {
+        return isPositiveAndBelow (midiChannel - 1, 16) && isPositiveAndBelow (midiNoteNumber, 128)
+                 ? voiceTable[(midiChannel - 1) * 128 + midiNoteNumber] : -1;
+    }
+
+    /** Returns the MIDI note that a voice is playing. */
+    i32 getVoiceNote (i32 voiceIndex) const noexcept              { return voiceInfo[(size_t) voiceIndex].note; }
+
+    /** Возвращает true, если a voice is in its release phase. */
+    b8 isVoiceReleased (i32 voiceIndex) const noexcept          { return voiceInfo[(size_t) voiceIndex].released; }
+
+    //==============================================================================
+    z0 noteOn (i32 midiChannel, i32 midiNoteNumber, f32 velocity) override
+    {
+        const ScopedLock sl (lock);
+
+        // If hitting a note that's still ringing, release it first, as Synthesiser does
+        if (auto existing = findVoice (midiChannel, midiNoteNumber); existing >= 0)
+            releaseVoice (existing, 1.0f, true);
+
+        if (numActive == capacity)
+        {
+            if (! isNoteStealingEnabled())
+                return;
+
+            removeVoice (findOldestVoice());
+        }
+
+        const auto index = numActive++;
+        auto& info = voiceInfo[(size_t) index];
+        info.channel = midiChannel;
+        info.note = midiNoteNumber;
+        info.noteOnTime = ++lastNoteOnCounter;
+        info.keyDown = true;
+        info.released = info.finished = false;
+
+        if (auto* slot = getTableSlot (midiChannel, midiNoteNumber))
+            *slot = index;
+
+        voiceStarted (index, midiNoteNumber, velocity);
+        removeFinishedVoices();
+    }
+
+    z0 noteOff (i32 midiChannel, i32 midiNoteNumber, f32 velocity, b8 allowTailOff) override
+    {
+        const ScopedLock sl (lock);
+
+        const auto index = findVoice (midiChannel, midiNoteNumber);
+
+        if (index < 0)
+            return;
+
+        voiceInfo[(size_t) index].keyDown = false;
+
+        if (! sustainedChannels[midiChannel])
+            releaseVoice (index, velocity, allowTailOff);
+
+        removeFinishedVoices();
+    }
+
+    z0 allNotesOff (i32 midiChannel, b8 allowTailOff) override
+    {
+        const ScopedLock sl (lock);
+
+        for (auto i = numActive; --i >= 0;)
+            if (midiChannel <= 0 || voiceInfo[(size_t) i].channel == midiChannel)
+                releaseVoice (i, 1.0f, allowTailOff);
+
+        removeFinishedVoices();
+    }
+
+    z0 handleSustainPedal (i32 midiChannel, b8 isDown) override
+    {
+        jassert (midiChannel > 0 && midiChannel <= 16);
+        const ScopedLock sl (lock);
+
+        sustainedChannels.setBit (midiChannel, isDown);
+
+        if (! isDown)
+        {
+            for (auto i = numActive; --i >= 0;)
+            {
+                const auto& info = voiceInfo[(size_t) i];
+
+                if (info.channel == midiChannel && ! info.keyDown && ! info.released)
+                    releaseVoice (i, 1.0f, true);
+            }
+
+            removeFinishedVoices();
+        }
+    }
+
+protected:
+    //==============================================================================
+    /** Called when a voice starts a note. The subclass should set up the voice's values
+        in its LaneArrays.
+    */
+    virtual z0 voiceStarted (i32 voiceIndex, i32 midiNoteNumber, f32 velocity) = 0;
+
+    /** Called when a voice's key is released, so that it can start its release phase.
+        It must call finishVoice() when the release is over, either now or from
+        renderGroup().
+    */
+    virtual z0 voiceReleased (i32 voiceIndex, f32 velocity) = 0;
+
+    /** Renders a group of numLanes voices, starting with voice group * numLanes.
+
+        Each element of the output is one sample, with one lane for each voice. Lanes that
+        belong to voices which aren't active are ignored, so there's no need to treat them
+        specially.
+    */
+    virtual z0 renderGroup (i32 group, Vec* output, i32 numSamples) = 0;
+
+    /** Registers one of the subclass's arrays of voice values, and allocates it.
+        Call this from the subclass's constructor for each LaneArray. When voices are moved
+        around, the values in the registered arrays are moved with them.
+    */
+    z0 addLaneArray (LaneArray& array)
+    {
+        array.allocate (capacity);
+        laneArrays.push_back (&array);
+    }
+
+    /** Tells the synth that a voice has finished its release.
+        It's safe to call this from renderGroup(); the voice is removed once the group has
+        been rendered.
+    */
+    z0 finishVoice (i32 voiceIndex) noexcept
+    {
+        jassert (isPositiveAndBelow (voiceIndex, numActive));
+        voiceInfo[(size_t) voiceIndex].finished = true;
+        anyVoicesFinished = true;
+    }
+
+    //==============================================================================
+    z0 renderVoices (AudioBuffer<f32>& outputAudio, i32 startSample, i32 numSamples) override
+    {
+        renderVoiceBank (outputAudio, startSample, numSamples);
+    }
+
+    z0 renderVoices (AudioBuffer<f64>& outputAudio, i32 startSample, i32 numSamples) override
+    {
+        renderVoiceBank (outputAudio, startSample, numSamples);
+    }
+
+private:
+    //==============================================================================
+    struct VoiceInfo
+    {
+        i32 channel = 0, note = 0;
+        u32 noteOnTime = 0;
+        b8 keyDown = false, released = false, finished = false;
+    };
+
+    static constexpr i32 renderChunkSize = 64;
+
+    i32* getTableSlot (i32 midiChannel, i32 midiNoteNumber) noexcept
+    {
+        return isPositiveAndBelow (midiChannel - 1, 16) && isPositiveAndBelow (midiNoteNumber, 128)
+                 ? voiceTable + (midiChannel - 1) * 128 + midiNoteNumber : nullptr;
+    }
+
+    z0 releaseVoice (i32 index, f32 velocity, b8 allowTailOff)
+    {
+        auto& info = voiceInfo[(size_t) index];
+
+        if (auto* slot = getTableSlot (info.channel, info.note); slot != nullptr && *slot == index)
+            *slot = -1;
+
+        if (! allowTailOff)
+        {
+            finishVoice (index);
+            return;
+        }
+
+        if (! info.released)
+        {
+            info.released = true;
+            voiceReleased (index, velocity);
+        }
+    }
+
+    i32 findOldestVoice() const noexcept
+    {
+        i32 oldest = 0;
+
+        for (i32 i = 1; i < numActive; ++i)
+            if (voiceInfo[(size_t) i].noteOnTime < voiceInfo[(size_t) oldest].noteOnTime)
+                oldest = i;
+
+        return oldest;
+    }
+
+    z0 removeVoice (i32 index) noexcept
+    {
+        const auto last = --numActive;
+
+        if (auto* slot = getTableSlot (voiceInfo[(size_t) index].channel, voiceInfo[(size_t) index].note); slot != nullptr && *slot == index)
+            *slot = -1;
+
+        if (index != last)
+        {
+            for (auto* array : laneArrays)
+                (*array)[index] = (*array)[last];
+
+            voiceInfo[(size_t) index] = voiceInfo[(size_t) last];
+
+            if (auto* slot = getTableSlot (voiceInfo[(size_t) index].channel, voiceInfo[(size_t) index].note); slot != nullptr && *slot == last)
+                *slot = index;
+        }
+    }
+
+    z0 removeFinishedVoices() noexcept
+    {
+        if (! anyVoicesFinished)
+            return;
+
+        anyVoicesFinished = false;
+
+        // Working backwards means that the voice moved into a removed voice's place has
+        // already been checked
+        for (auto i = numActive; --i >= 0;)
+            if (voiceInfo[(size_t) i].finished)
+                removeVoice (i);
+    }
+
+    typename Vec::vMaskType getPartialGroupMask (i32 numLanesInGroup) noexcept
+    {
+        if (numLanesInGroup != partialGroupMaskSize)
+        {
+            for (i32 lane = 0; lane < numLanes; ++lane)
+                partialGroupMask.set ((size_t) lane, lane < numLanesInGroup ? ~typename Vec::MaskType() : typename Vec::MaskType());
+
+            partialGroupMaskSize = numLanesInGroup;
+        }
+
+        return partialGroupMask;
+    }
+
+    template <typename FloatType>
+    z0 renderVoiceBank (AudioBuffer<FloatType>& outputAudio, i32 startSample, i32 numSamples)
+    {
+        const auto numChannels = outputAudio.getNumChannels();
+
+        while (numSamples > 0 && numActive > 0)
+        {
+            const auto numThisTime = jmin (numSamples, renderChunkSize);
+            const auto numGroups = (numActive + numLanes - 1) / numLanes;
+
+            std::fill (mixBuffer, mixBuffer + numThisTime, Vec::expand (SampleType()));
+
+            for (i32 group = 0; group < numGroups; ++group)
+            {
+                renderGroup (group, groupBuffer, numThisTime);
+
+                const auto numLanesInGroup = numActive - group * numLanes;
+
+                if (numLanesInGroup >= numLanes)
+                {
+                    for (i32 i = 0; i < numThisTime; ++i)
+                        mixBuffer[i] += groupBuffer[i];
+                }
+                else
+                {
+                    // Inactive lanes can hold anything, including NaNs, so they're cleared
+                    // with a bitwise mask rather than multiplied by zero
+                    const auto laneMask = getPartialGroupMask (numLanesInGroup);
+
+                    for (i32 i = 0; i < numThisTime; ++i)
+                        mixBuffer[i] += groupBuffer[i] & laneMask;
+                }
+            }
+
+            for (i32 i = 0; i < numThisTime; ++i)
+                monoBuffer[i] = mixBuffer[i].sum();
+
+            for (i32 ch = 0; ch < numChannels; ++ch)
+            {
+                auto* out = outputAudio.getWritePointer (ch, startSample);
+
+                for (i32 i = 0; i < numThisTime; ++i)
+                    out[i] += (FloatType) monoBuffer[i];
+            }
+
+            removeFinishedVoices();
+
+            startSample += numThisTime;
+            numSamples -= numThisTime;
+        }
+    }
+
+    //==============================================================================
+    const i32 capacity;
+    i32 numActive = 0;
+    u32 lastNoteOnCounter = 0;
+    b8 anyVoicesFinished = false;
+    std::vector<VoiceInfo> voiceInfo;
+    std::vector<LaneArray*> laneArrays;
+    i32 voiceTable[16 * 128];
+    BigInteger sustainedChannels;
+    Vec mixBuffer[renderChunkSize], groupBuffer[renderChunkSize];
+    typename Vec::vMaskType partialGroupMask;
+    i32 partialGroupMaskSize = -1;
+    SampleType monoBuffer[renderChunkSize];
+
+    DRX_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (VoiceBankSynthesiser)
+};
+
+} // namespace drx::dsp
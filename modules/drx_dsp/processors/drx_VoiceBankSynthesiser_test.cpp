@@ -0,0 +1,374 @@
+/*
+  ==============================================================================
+
+   This file is part of the DRX framework.
+   Copyright (c) DinrusPro
+
+   DRX is an open source framework subject to commercial or open source
+   licensing.
+
+   By downloading, installing, or using the DRX framework, or combining the
+   DRX framework with any other source code, object code, content or any other
+   copyrightable work, you agree to the terms of the DRX End User Licence
+   Agreement, and all incorporated terms including the DRX Privacy Policy and
+   the DRX Website Terms of Service, as applicable, which will bind you. If you
+   do not agree to the terms of these agreements, we will not license the DRX
+   framework to you, and you must discontinue the installation or download
+   process and cease use of the DRX framework.
+
+   DRX End User Licence Agreement: https://drx.com/legal/drx-8-licence/
+   DRX Privacy Policy: https://drx.com/drx-privacy-policy
+   DRX Website Terms of Service: https://drx.com/drx-website-terms-of-service/
+
+   Or:
+
+   You may also use this code under the terms of the AGPLv3:
+   https://www.gnu.org/licenses/agpl-3.0.en.html
+
+   THE DRX FRAMEWORK IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL
+   WARRANTIES, WHETHER EXPRESSED OR IMPLIED, INCLUDING WARRANTY OF
+   MERCHANTABILITY OR FITNESS FOR A PARTICULAR PURPOSE, ARE DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace drx::dsp
+{
+
+class VoiceBankSynthesiserTests final : public UnitTest
+{
+public:
+    VoiceBankSynthesiserTests()
+        : UnitTest ("VoiceBankSynthesiser", UnitTestCategories::dsp)
+    {}
+
+    // A simple oscillator with a linear release, written once as a normal voice and once
+    // as a voice bank, doing the same arithmetic in the same order
+    static constexpr f64 releaseTime = 0.05;
+
+    static f64 getIncrement (i32 midiNoteNumber, f64 sampleRate)
+    {
+        return MidiMessage::getMidiNoteInHertz (midiNoteNumber) / sampleRate;
+    }
+
+    struct AnySound final : public SynthesiserSound
+    {
+        b8 appliesToNote (i32) override     { return true; }
+        b8 appliesToChannel (i32) override  { return true; }
+    };
+
+    class ScalarVoice final : public SynthesiserVoice
+    {
+    public:
+        b8 canPlaySound (SynthesiserSound*) override     { return true; }
+
+        z0 startNote (i32 midiNoteNumber, f32 velocity, SynthesiserSound*, i32) override
+        {
+            phase = 0;
+            increment = (f32) getIncrement (midiNoteNumber, getSampleRate());
+            gain = velocity * 0.1f;
+            envelope = 1.0f;
+            releaseStep = 0;
+        }
+
+        z0 stopNote (f32, b8 allowTailOff) override
+        {
+            if (allowTailOff)
+                releaseStep = (f32) (1.0 / (releaseTime * getSampleRate()));
+            else
+                clearCurrentNote();
+        }
+
+        z0 pitchWheelMoved (i32) override {}
+        z0 controllerMoved (i32, i32) override {}
+
+        z0 renderNextBlock (AudioBuffer<f32>& output, i32 startSample, i32 numSamples) override
+        {
+            if (! isVoiceActive())
+                return;
+
+            for (i32 i = startSample; i < startSample + numSamples; ++i)
+            {
+                phase = phase + increment;
+                phase = phase - (f32) (i32) phase;
+                const auto x = phase * 2.0f - 1.0f;
+                const auto y = x * (1.0f - std::abs (x)) * 4.0f;
+                envelope = jmax (0.0f, envelope - releaseStep);
+                const auto sample = y * (gain * envelope);
+
+                for (i32 ch = 0; ch < output.getNumChannels(); ++ch)
+                    output.addSample (ch, i, sample);
+
+                if (releaseStep > 0 && envelope <= 0)
+                {
+                    clearCurrentNote();
+                    break;
+                }
+            }
+        }
+
+        using SynthesiserVoice::renderNextBlock;
+
+    private:
+        f32 phase = 0, increment = 0, gain = 0, envelope = 0, releaseStep = 0;
+    };
+
+    template <typename SampleType>
+    class BankSynth final : public VoiceBankSynthesiser<SampleType>
+    {
+    public:
+        using Base = VoiceBankSynthesiser<SampleType>;
+        using Vec = typename Base::Vec;
+
+        explicit BankSynth (i32 maxNumVoices)  : Base (maxNumVoices)
+        {
+            for (auto* array : { &phase, &increment, &gain, &envelope, &releaseStep })
+                this->addLaneArray (*array);
+        }
+
+        z0 voiceStarted (i32 voiceIndex, i32 midiNoteNumber, f32 velocity) override
+        {
+            phase[voiceIndex] = 0;
+            increment[voiceIndex] = (SampleType) getIncrement (midiNoteNumber, this->getSampleRate());
+            gain[voiceIndex] = (SampleType) (velocity * 0.1f);
+            envelope[voiceIndex] = 1;
+            releaseStep[voiceIndex] = 0;
+        }
+
+        z0 voiceReleased (i32 voiceIndex, f32) override
+        {
+            releaseStep[voiceIndex] = (SampleType) (1.0 / (releaseTime * this->getSampleRate()));
+        }
+
+        z0 renderGroup (i32 group, Vec* output, i32 numSamples) override
+        {
+            auto p = phase.load (group), env = envelope.load (group);
+            const auto inc = increment.load (group), g = gain.load (group), step = releaseStep.load (group);
+            const auto zero = Vec::expand (0), one = Vec::expand (1);
+
+            for (i32 i = 0; i < numSamples; ++i)
+            {
+                p = p + inc;
+                p = p - Vec::truncate (p);
+                const auto x = p * (SampleType) 2 - (SampleType) 1;
+                const auto y = x * (one - Vec::abs (x)) * (SampleType) 4;
+                env = Vec::max (zero, env - step);
+                output[i] = y * (g * env);
+            }
+
+            phase.store (group, p);
+            envelope.store (group, env);
+
+            for (i32 lane = 0; lane < Base::numLanes; ++lane)
+            {
+                const auto voiceIndex = group * Base::numLanes + lane;
+
+                if (voiceIndex < this->getNumActiveVoices() && releaseStep[voiceIndex] > 0 && envelope[voiceIndex] <= 0)
+                    this->finishVoice (voiceIndex);
+            }
+        }
+
+        typename Base::LaneArray phase, increment, gain, envelope, releaseStep;
+    };
+
+    static z0 setUpReference (Synthesiser& synth, i32 numVoices, f64 sampleRate)
+    {
+        synth.setCurrentPlaybackSampleRate (sampleRate);
+        synth.addSound (new AnySound());
+
+        for (i32 i = 0; i < numVoices; ++i)
+            synth.addVoice (new ScalarVoice());
+    }
+
+    template <typename SampleType>
+    z0 testVoiceAllocation()
+    {
+        BankSynth<SampleType> synth (10);
+        synth.setCurrentPlaybackSampleRate (44100.0);
+
+        const auto capacity = synth.getMaxNumVoices();
+        expect (capacity >= 10 && capacity % BankSynth<SampleType>::numLanes == 0);
+
+        for (i32 note = 60; note < 65; ++note)
+            synth.noteOn (1, note, 1.0f);
+
+        expectEquals (synth.getNumActiveVoices(), 5);
+
+        for (i32 note = 60; note < 65; ++note)
+            expectEquals (synth.getVoiceNote (synth.findVoice (1, note)), note);
+
+        // Stopping a voice without a tail moves the last voice into its place
+        synth.noteOff (1, 61, 1.0f, false);
+        expectEquals (synth.getNumActiveVoices(), 4);
+        expectEquals (synth.findVoice (1, 61), -1);
+
+        for (auto note : { 60, 62, 63, 64 })
+            expectEquals (synth.getVoiceNote (synth.findVoice (1, note)), note);
+
+        // A released voice keeps playing until its tail has finished
+        synth.noteOff (1, 60, 1.0f, true);
+        expectEquals (synth.getNumActiveVoices(), 4);
+        expectEquals (synth.findVoice (1, 60), -1);
+
+        AudioBuffer<SampleType> buffer (2, 4410);
+        buffer.clear();
+        synth.renderNextBlock (buffer, MidiBuffer(), 0, buffer.getNumSamples());
+        expectEquals (synth.getNumActiveVoices(), 3);
+
+        for (auto note : { 62, 63, 64 })
+            expectEquals (synth.getVoiceNote (synth.findVoice (1, note)), note);
+
+        // Notes held by the sustain pedal are released when it's lifted
+        synth.handleSustainPedal (1, true);
+        synth.noteOff (1, 62, 1.0f, true);
+        expect (! synth.isVoiceReleased (synth.findVoice (1, 62)));
+        synth.handleSustainPedal (1, false);
+        expectEquals (synth.findVoice (1, 62), -1);
+        synth.allNotesOff (0, false);
+        expectEquals (synth.getNumActiveVoices(), 0);
+
+        // When every voice is busy, the oldest is stolen
+        for (i32 i = 0; i <= capacity; ++i)
+            synth.noteOn (1, 20 + i, 1.0f);
+
+        expectEquals (synth.getNumActiveVoices(), capacity);
+        expectEquals (synth.findVoice (1, 20), -1);
+        expect (synth.findVoice (1, 20 + capacity) >= 0);
+
+        synth.setNoteStealingEnabled (false);
+        synth.noteOn (2, 100, 1.0f);
+        expectEquals (synth.findVoice (2, 100), -1);
+        expect (synth.findVoice (1, 21) >= 0);
+    }
+
+    template <typename SampleType>
+    z0 testInactiveLanesAreIgnored()
+    {
+        BankSynth<SampleType> synth (BankSynth<SampleType>::numLanes);
+        synth.setCurrentPlaybackSampleRate (44100.0);
+        synth.noteOn (1, 60, 1.0f);
+
+        // Whatever is left in the unused lanes mustn't reach the output, even a NaN
+        for (i32 lane = 1; lane < BankSynth<SampleType>::numLanes; ++lane)
+            synth.gain[lane] = std::numeric_limits<SampleType>::quiet_NaN();
+
+        AudioBuffer<SampleType> buffer (1, 256);
+        buffer.clear();
+        synth.renderNextBlock (buffer, MidiBuffer(), 0, buffer.getNumSamples());
+
+        b8 allFinite = true;
+
+        for (i32 i = 0; i < buffer.getNumSamples(); ++i)
+            allFinite = allFinite && std::isfinite (buffer.getSample (0, i));
+
+        expect (allFinite);
+        expect (buffer.getMagnitude (0, buffer.getNumSamples()) > 0);
+    }
+
+    z0 runTest() override
+    {
+        beginTest ("Voices are allocated and recycled");
+        {
+            testVoiceAllocation<f32>();
+            testVoiceAllocation<f64>();
+        }
+
+        beginTest ("Inactive lanes are ignored");
+        {
+            testInactiveLanesAreIgnored<f32>();
+            testInactiveLanesAreIgnored<f64>();
+        }
+
+        beginTest ("Output matches a Synthesiser with one voice object per note");
+        {
+            const auto sampleRate = 48000.0;
+            const auto numSamples = 96000;
+
+            Synthesiser reference;
+            setUpReference (reference, 64, sampleRate);
+
+            BankSynth<f32> bank (64);
+            bank.setCurrentPlaybackSampleRate (sampleRate);
+
+            auto random = getRandom();
+            MidiBuffer midi;
+
+            for (i32 i = 0; i < 300; ++i)
+            {
+                const auto note = 36 + random.nextInt (48);
+                const auto start = random.nextInt (numSamples);
+                midi.addEvent (MidiMessage::noteOn (1, note, 0.2f + 0.8f * random.nextFloat()), start);
+                midi.addEvent (MidiMessage::noteOff (1, note), jmin (numSamples - 1, start + random.nextInt (4000)));
+            }
+
+            AudioBuffer<f32> expected (2, numSamples), actual (2, numSamples);
+            expected.clear();
+            actual.clear();
+
+            for (i32 pos = 0; pos < numSamples; pos += 480)
+            {
+                MidiBuffer blockMidi;
+                blockMidi.addEvents (midi, pos, 480, 0);
+                reference.renderNextBlock (expected, blockMidi, pos, 480);
+                bank.renderNextBlock (actual, blockMidi, pos, 480);
+            }
+
+            f32 maxError = 0;
+
+            for (i32 ch = 0; ch < 2; ++ch)
+                for (i32 i = 0; i < numSamples; ++i)
+                    maxError = jmax (maxError, std::abs (expected.getSample (ch, i) - actual.getSample (ch, i)));
+
+            expect (expected.getMagnitude (0, numSamples) > 0.1f);
+            expectLessThan (maxError, 1.0e-4f);
+        }
+
+        beginTest ("Performance");
+        {
+            const auto sampleRate = 44100.0;
+            const auto numVoices = 128;
+            const auto blockSize = 512;
+            const auto numBlocks = 10 * (i32) sampleRate / blockSize;
+
+            Synthesiser reference;
+            setUpReference (reference, numVoices, sampleRate);
+
+            BankSynth<f32> bank (numVoices);
+            bank.setCurrentPlaybackSampleRate (sampleRate);
+
+            for (i32 i = 0; i < numVoices; ++i)
+            {
+                reference.noteOn (1 + i / 64, i % 64 + 30, 0.5f);
+                bank.noteOn (1 + i / 64, i % 64 + 30, 0.5f);
+            }
+
+            expectEquals (bank.getNumActiveVoices(), numVoices);
+
+            AudioBuffer<f32> buffer (2, blockSize);
+
+            auto timeSynth = [&] (Synthesiser& synth)
+            {
+                const auto start = Time::getMillisecondCounterHiRes();
+
+                for (i32 i = 0; i < numBlocks; ++i)
+                {
+                    buffer.clear();
+                    synth.renderNextBlock (buffer, MidiBuffer(), 0, blockSize);
+                }
+
+                return Time::getMillisecondCounterHiRes() - start;
+            };
+
+            const auto referenceMs = timeSynth (reference);
+            const auto bankMs = timeSynth (bank);
+
+            logMessage ("  " + Txt (numVoices) + " voices, 10 seconds: one SynthesiserVoice per voice "
+                        + Txt (referenceMs, 1) + " ms, voice bank with " + Txt (BankSynth<f32>::numLanes)
+                        + " lanes " + Txt (bankMs, 1) + " ms");
+        }
+    }
+};
+
+static VoiceBankSynthesiserTests voiceBankSynthesiserTests;
+
+} // namespace drx::dsp
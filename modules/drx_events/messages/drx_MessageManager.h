@@ -261,6 +261,12 @@ public:
 
         using Ptr = ReferenceCountedObjectPtr<MessageBase>;
 
+    private:
+        // Lets a platform queue link pending messages together without allocating
+        friend class InternalMessageQueue;
+        std::atomic<MessageBase*> nextInQueue { nullptr };
+        std::atomic<b8> queued { false };
+
         DRX_DECLARE_NON_COPYABLE (MessageBase)
     };
 
@@ -36,6 +36,13 @@ namespace drx
 {
 
 //==============================================================================
+/*
+    Messages are posted from any thread and delivered on the message thread.
+
+    The queue itself is an intrusive multi-producer, single-consumer linked list, so posting
+    never blocks and delivery is O(1) per message. Producers only write to the socket when
+    the message thread isn't already due to wake up, and each wakeup delivers a whole batch.
+*/
 class InternalMessageQueue
 {
 public:
@@ -47,14 +54,7 @@ public:
         LinuxEventLoop::registerFdCallback (getReadHandle(),
                                             [this] (i32 fd)
                                             {
-                                                while (auto msg = popNextMessage (fd))
-                                                {
-                                                    DRX_TRY
-                                                    {
-                                                        msg->messageCallback();
-                                                    }
-                                                    DRX_CATCH_EXCEPTION
-                                                }
+                                                dispatchMessages (fd);
                                             });
     }
 
@@ -65,53 +65,138 @@ public:
         close (getReadHandle());
         close (getWriteHandle());
 
+        // Releases anything that was never delivered
+        for (auto* msg = tail; msg != nullptr;)
+        {
+            auto* next = msg->nextInQueue.load (std::memory_order_acquire);
+
+            if (msg != &stub)
+                msg->decReferenceCount();
+
+            msg = next;
+        }
+
         clearSingletonInstance();
     }
 
     //==============================================================================
     z0 postMessage (MessageManager::MessageBase* const msg) noexcept
     {
-        ScopedLock sl (lock);
-        queue.add (msg);
-
-        if (bytesInSocket < maxBytesInSocketQueue)
-        {
-            bytesInSocket++;
+        // A message that hasn't been delivered yet is still linked into the queue, so it can't
+        // be pushed again. It'll be delivered once, just as if the second post had arrived first.
+        if (msg->queued.exchange (true, std::memory_order_acq_rel))
+            return;
 
-            ScopedUnlock ul (lock);
-            u8 x = 0xff;
-            [[maybe_unused]] auto numBytes = write (getWriteHandle(), &x, 1);
-        }
+        msg->incReferenceCount();
+        push (msg);
+        wakeUpMessageThread();
     }
 
     //==============================================================================
     DRX_DECLARE_SINGLETON_INLINE (InternalMessageQueue, false)
 
 private:
-    CriticalSection lock;
-    ReferenceCountedArray <MessageManager::MessageBase> queue;
+    struct Stub final : public MessageManager::MessageBase
+    {
+        z0 messageCallback() override {}
+    };
+
+    // Messages are pushed at the head and popped from the tail, which always has a node
+    // in front of it: either a message that hasn't been delivered yet, or the stub.
+    Stub stub;
+    std::atomic<MessageManager::MessageBase*> head { &stub };
+    MessageManager::MessageBase* tail = &stub;
+
+    std::atomic<b8> wakeUpPending { false };
 
     i32 msgpipe[2];
-    i32 bytesInSocket = 0;
-    static constexpr i32 maxBytesInSocketQueue = 128;
+    static constexpr i32 maxMessagesPerWakeUp = 1024;
 
     i32 getWriteHandle() const noexcept  { return msgpipe[0]; }
     i32 getReadHandle() const noexcept   { return msgpipe[1]; }
 
-    MessageManager::MessageBase::Ptr popNextMessage (i32 fd) noexcept
+    z0 push (MessageManager::MessageBase* msg) noexcept
     {
-        const ScopedLock sl (lock);
+        msg->nextInQueue.store (nullptr, std::memory_order_relaxed);
+
+        auto* previous = head.exchange (msg, std::memory_order_acq_rel);
+        previous->nextInQueue.store (msg, std::memory_order_release);
+    }
 
-        if (bytesInSocket > 0)
+    z0 wakeUpMessageThread() noexcept
+    {
+        if (! wakeUpPending.exchange (true, std::memory_order_acq_rel))
         {
-            --bytesInSocket;
+            u8 x = 0xff;
+            [[maybe_unused]] auto numBytes = write (getWriteHandle(), &x, 1);
+        }
+    }
 
-            ScopedUnlock ul (lock);
-            u8 x;
-            [[maybe_unused]] auto numBytes = read (fd, &x, 1);
+    z0 dispatchMessages (i32 fd)
+    {
+        u8 buffer[16];
+        [[maybe_unused]] auto numBytes = read (fd, buffer, sizeof (buffer));
+
+        // Once this is cleared, anything posted afterwards is either delivered by the loop
+        // below or causes another wakeup, so nothing can get stranded in the queue.
+        wakeUpPending.exchange (false, std::memory_order_acq_rel);
+
+        for (i32 i = 0; i < maxMessagesPerWakeUp; ++i)
+        {
+            auto msg = popNextMessage();
+
+            if (msg == nullptr)
+                return;
+
+            DRX_TRY
+            {
+                msg->messageCallback();
+            }
+            DRX_CATCH_EXCEPTION
+        }
+
+        // There's more to do, but let the other fds have a look in first
+        wakeUpMessageThread();
+    }
+
+    // This must only be called from one thread at a time
+    MessageManager::MessageBase::Ptr popNextMessage() noexcept
+    {
+        auto* first = tail;
+        auto* next = first->nextInQueue.load (std::memory_order_acquire);
+
+        if (first == &stub)
+        {
+            if (next == nullptr)
+                return nullptr;
+
+            tail = first = next;
+            next = next->nextInQueue.load (std::memory_order_acquire);
+        }
+
+        if (next == nullptr)
+        {
+            // If a producer is half-way through posting, it'll wake us again when it's done
+            if (first != head.load (std::memory_order_acquire))
+                return nullptr;
+
+            // Otherwise this is the last message, so put the stub behind it before removing it
+            push (&stub);
+            next = first->nextInQueue.load (std::memory_order_acquire);
+
+            if (next == nullptr)
+                return nullptr;
         }
 
-        return queue.removeAndReturn (0);
+        tail = next;
+
+        // Takes over the reference that was added when the message was posted
+        MessageManager::MessageBase::Ptr result (*first);
+        first->decReferenceCountWithoutDeleting();
+
+        // The message is out of the list now, so it may be posted again, even from its own callback
+        first->queued.store (false, std::memory_order_release);
+        return result;
     }
 };
 
@@ -401,4 +486,141 @@ std::vector<i32> LinuxEventLoopInternal::getRegisteredFds()
     return {};
 }
 
+//==============================================================================
+//==============================================================================
+#if DRX_UNIT_TESTS
+
+class LinuxMessageQueueTests final : public UnitTest
+{
+public:
+    LinuxMessageQueueTests()
+        : UnitTest ("Linux message queue", UnitTestCategories::native)
+    {}
+
+    z0 runTest() override
+    {
+        const auto messageManagerExisted = MessageManager::getInstanceWithoutCreating() != nullptr;
+        auto* mm = MessageManager::getInstance();
+
+        if (! mm->isThisTheMessageThread())
+            return;
+
+        beginTest ("Messages posted from many threads are each delivered once, in order");
+        {
+            const auto result = postFromThreads (16, 2000);
+            expectEquals (result.numDelivered, result.numPosted);
+            expect (result.inOrder);
+        }
+
+        beginTest ("Stress test");
+        {
+            const auto result = postFromThreads (16, 65536);
+            expectEquals (result.numDelivered, result.numPosted);
+            expect (result.inOrder);
+
+            logMessage ("Delivered " + Txt (result.numDelivered) + " messages from 16 threads in "
+                          + Txt (result.seconds, 3) + " seconds ("
+                          + Txt (roundToInt ((f64) result.numDelivered / jmax (result.seconds, 1.0e-6))) + " per second)");
+        }
+
+        beginTest ("A message that's posted again before it's delivered is only delivered once");
+        {
+            std::vector<MessageManager::MessageBase::Ptr> messages;
+            std::vector<i32> numCallbacks (3, 0);
+
+            for (auto& count : numCallbacks)
+                messages.push_back (new CountingMessage (count));
+
+            // Re-post the first, middle and last messages while they're all still pending
+            for (auto& message : messages)
+                expect (message->post());
+
+            for (auto& message : messages)
+                expect (message->post());
+
+            dispatchAllPendingMessages();
+
+            for (const auto count : numCallbacks)
+                expectEquals (count, 1);
+
+            // Once delivered, a message can be posted again
+            for (auto& message : messages)
+                expect (message->post());
+
+            dispatchAllPendingMessages();
+
+            for (const auto count : numCallbacks)
+                expectEquals (count, 2);
+        }
+
+        if (! messageManagerExisted)
+            MessageManager::deleteInstance();
+    }
+
+private:
+    struct CountingMessage final : public MessageManager::MessageBase
+    {
+        explicit CountingMessage (i32& c) : count (c) {}
+        z0 messageCallback() override   { ++count; }
+
+        i32& count;
+    };
+
+    static z0 dispatchAllPendingMessages()
+    {
+        while (detail::dispatchNextMessageOnSystemQueue (true)) {}
+    }
+
+    struct Result
+    {
+        i32 numPosted = 0, numDelivered = 0;
+        b8 inOrder = true;
+        f64 seconds = 0;
+    };
+
+    static Result postFromThreads (i32 numThreads, i32 numMessagesPerThread)
+    {
+        Result result;
+        result.numPosted = numThreads * numMessagesPerThread;
+
+        // Only touched on the message thread
+        std::vector<i32> lastReceived ((size_t) numThreads, -1);
+
+        const auto start = Time::getHighResolutionTicks();
+        std::vector<std::thread> threads;
+
+        for (i32 t = 0; t < numThreads; ++t)
+        {
+            threads.emplace_back ([&, t]
+            {
+                for (i32 i = 0; i < numMessagesPerThread; ++i)
+                {
+                    MessageManager::callAsync ([&, t, i]
+                    {
+                        auto& last = lastReceived[(size_t) t];
+                        result.inOrder = result.inOrder && (last == i - 1);
+                        last = i;
+                        ++result.numDelivered;
+                    });
+                }
+            });
+        }
+
+        const auto timeout = Time::getMillisecondCounter() + 60000;
+
+        while (result.numDelivered < result.numPosted && Time::getMillisecondCounter() < timeout)
+            detail::dispatchNextMessageOnSystemQueue (true);
+
+        for (auto& thread : threads)
+            thread.join();
+
+        result.seconds = Time::highResolutionTicksToSeconds (Time::getHighResolutionTicks() - start);
+        return result;
+    }
+};
+
+static LinuxMessageQueueTests linuxMessageQueueTests;
+
+#endif
+
 } // namespace drx
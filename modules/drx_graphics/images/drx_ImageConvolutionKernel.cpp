@@ -112,6 +112,22 @@ z0 ImageConvolutionKernel::createGaussianBlur (const f32 radius)
 z0 ImageConvolutionKernel::applyToImage (Image& destImage,
                                            const Image& sourceImage,
                                            const Rectangle<i32>& destinationArea) const
+{
+    applyToArea (destImage, sourceImage, destinationArea, nullptr);
+}
+
+z0 ImageConvolutionKernel::applyToImage (Image& destImage,
+                                           const Image& sourceImage,
+                                           const Rectangle<i32>& destinationArea,
+                                           ThreadPool& threadPool) const
+{
+    applyToArea (destImage, sourceImage, destinationArea, &threadPool);
+}
+
+z0 ImageConvolutionKernel::applyToArea (Image& destImage,
+                                          const Image& sourceImage,
+                                          const Rectangle<i32>& destinationArea,
+                                          ThreadPool* threadPool) const
 {
     if (sourceImage == destImage)
     {
@@ -136,9 +152,12 @@ z0 ImageConvolutionKernel::applyToImage (Image& destImage,
     auto right = area.getRight();
     auto bottom = area.getBottom();
 
+    // Working in place, each row reads the ones around it, so they have to be done in order
+    if (sourceImage == destImage)
+        threadPool = nullptr;
+
     const Image::BitmapData destData (destImage, area.getX(), area.getY(), area.getWidth(), area.getHeight(),
                                       Image::BitmapData::writeOnly);
-    u8* line = destData.data;
 
     const Image::BitmapData srcData (sourceImage, Image::BitmapData::readOnly);
 
@@ -146,10 +165,9 @@ z0 ImageConvolutionKernel::applyToImage (Image& destImage,
     {
         constexpr auto pixelStride = stride.value;
 
-        for (i32 y = area.getY(); y < bottom; ++y)
+        const auto applyToRow = [&] (i32 y)
         {
-            u8* dest = line;
-            line += destData.lineStride;
+            u8* dest = destData.getLinePointer (y - area.getY());
 
             for (i32 x = area.getX(); x < right; ++x)
             {
@@ -192,6 +210,17 @@ z0 ImageConvolutionKernel::applyToImage (Image& destImage,
                 for (const auto& s : sum)
                     *dest++ = (u8) jmin (0xff, roundToInt (s));
             }
+        };
+
+        if (threadPool != nullptr)
+        {
+            TaskGraph graph (*threadPool);
+            graph.parallelFor (area.getY(), bottom, applyToRow).wait();
+        }
+        else
+        {
+            for (i32 y = area.getY(); y < bottom; ++y)
+                applyToRow (y);
         }
     };
 
@@ -110,8 +110,21 @@ public:
                        const Image& sourceImage,
                        const Rectangle<i32>& destinationArea) const;
 
+    /** Applies the kernel to an image, sharing the rows out between the threads of a pool.
+
+        This does the same as the other applyToImage() method, and returns once all the
+        rows have been done. If the source and destination are the same image, the rows
+        are done in order on the calling thread, as each one reads its neighbours.
+    */
+    z0 applyToImage (Image& destImage,
+                       const Image& sourceImage,
+                       const Rectangle<i32>& destinationArea,
+                       ThreadPool& threadPool) const;
+
 private:
     //==============================================================================
+    z0 applyToArea (Image&, const Image&, const Rectangle<i32>&, ThreadPool*) const;
+
     HeapBlock<f32> values;
     i32k size;
 